@@ -0,0 +1,224 @@
+////////////////////////////////////////////////////////////////
+//AssetArchive member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "AssetArchive.h"
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static char NameChar(char c)
+{
+	if(c == '\\')
+		return '/';
+	return c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c;
+}
+
+AssetArchive::AssetArchive()
+{
+	m_pData=0;
+	m_Size=0;
+	m_pEntries=0;
+	m_pNames=0;
+	m_Count=0;
+	m_bShadowed=false;
+#ifdef _WIN32
+	m_hFile=INVALID_HANDLE_VALUE;
+	m_hMapping=0;
+#endif
+}
+
+AssetArchive::~AssetArchive()
+{
+	Close();
+}
+
+bool AssetArchive::Open(const char* filename)
+{
+	Close();
+
+#ifdef _WIN32
+	m_hFile=CreateFileA(filename,GENERIC_READ,FILE_SHARE_READ,0,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS,0);
+	if(m_hFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if(!GetFileSizeEx(m_hFile,&size) || size.QuadPart < (LONGLONG)sizeof(ArchiveHeader) || size.QuadPart > 0xFFFFFFFF)
+	{
+		Close();
+		return false;
+	}
+	m_hMapping=CreateFileMappingA(m_hFile,0,PAGE_READONLY,0,0,0);
+	if(!m_hMapping)
+	{
+		Close();
+		return false;
+	}
+	m_pData=(const unsigned char*)MapViewOfFile(m_hMapping,FILE_MAP_READ,0,0,0);
+	m_Size=(size_t)size.QuadPart;
+#else
+	int file=open(filename,O_RDONLY);
+	if(file < 0)
+		return false;
+
+	struct stat info;
+	if(fstat(file,&info) != 0 || info.st_size < (off_t)sizeof(ArchiveHeader) || (unsigned long long)info.st_size > 0xFFFFFFFFull)
+	{
+		close(file);
+		return false;
+	}
+	void* mapping=mmap(0,(size_t)info.st_size,PROT_READ,MAP_PRIVATE,file,0);
+	close(file); //the mapping keeps the file open
+	if(mapping == MAP_FAILED)
+		return false;
+	m_pData=(const unsigned char*)mapping;
+	m_Size=(size_t)info.st_size;
+#endif
+	if(!m_pData)
+	{
+		Close();
+		return false;
+	}
+
+	//everything a lookup will touch has to be inside the file
+	const ArchiveHeader* header=(const ArchiveHeader*)m_pData;
+	size_t indexEnd=sizeof(ArchiveHeader) + (size_t)header->entryCount * sizeof(ArchiveEntry);
+	if(header->magic != ARCHIVE_MAGIC || header->version != ARCHIVE_VERSION || header->entryCount > m_Size / sizeof(ArchiveEntry) ||
+	   header->namesOffset < indexEnd || header->namesSize == 0 || (size_t)header->namesOffset + header->namesSize > m_Size ||
+	   m_pData[header->namesOffset + header->namesSize - 1] != 0)
+	{
+		Close();
+		return false;
+	}
+
+	m_pEntries=(const ArchiveEntry*)(m_pData + sizeof(ArchiveHeader));
+	m_pNames=(const char*)m_pData + header->namesOffset;
+	m_Count=(int)header->entryCount;
+	for(int i=0; i < m_Count; i++)
+	{
+		const ArchiveEntry& entry=m_pEntries[i];
+		if(entry.nameOffset >= header->namesSize || (size_t)entry.offset + entry.size > m_Size ||
+		   (i > 0 && entry.hash < m_pEntries[i - 1].hash))
+		{
+			Close();
+			return false;
+		}
+	}
+	return true;
+}
+
+void AssetArchive::Close()
+{
+#ifdef _WIN32
+	if(m_pData)
+		UnmapViewOfFile(m_pData);
+	if(m_hMapping)
+		CloseHandle(m_hMapping);
+	if(m_hFile != INVALID_HANDLE_VALUE)
+		CloseHandle(m_hFile);
+	m_hFile=INVALID_HANDLE_VALUE;
+	m_hMapping=0;
+#else
+	if(m_pData)
+		munmap((void*)m_pData,m_Size);
+#endif
+	m_pData=0;
+	m_Size=0;
+	m_pEntries=0;
+	m_pNames=0;
+	m_Count=0;
+}
+
+bool AssetArchive::IsOpen() const
+{
+	return m_pData != 0;
+}
+
+bool AssetArchive::Find(const char* name, AssetView& view) const
+{
+	if(!m_Count || !name)
+		return false;
+
+	//first entry with the hash, then through the ones that share it
+	unsigned int hash=HashName(name);
+	int low=0, high=m_Count;
+	while(low < high)
+	{
+		int middle=(low + high) / 2;
+		if(m_pEntries[middle].hash < hash)
+			low=middle + 1;
+		else
+			high=middle;
+	}
+
+	for(int i=low; i < m_Count && m_pEntries[i].hash == hash; i++)
+	{
+		if(SameName(m_pNames + m_pEntries[i].nameOffset,name))
+		{
+			if(m_bShadowed)
+			{
+				std::lock_guard<std::mutex> lock(m_ShadowMutex);
+				for(size_t j=0; j < m_Shadowed.size(); j++)
+				{
+					if(SameName(m_Shadowed[j].c_str(),name))
+						return false;
+				}
+			}
+			view.data=m_pData + m_pEntries[i].offset;
+			view.size=m_pEntries[i].size;
+			view.format=(AssetFormat)m_pEntries[i].format;
+			return true;
+		}
+	}
+	return false;
+}
+
+void AssetArchive::Shadow(const char* name)
+{
+	std::lock_guard<std::mutex> lock(m_ShadowMutex);
+	for(size_t i=0; i < m_Shadowed.size(); i++)
+	{
+		if(SameName(m_Shadowed[i].c_str(),name))
+			return;
+	}
+	m_Shadowed.push_back(name);
+	m_bShadowed=true;
+}
+
+int AssetArchive::Count() const
+{
+	return m_Count;
+}
+
+const char* AssetArchive::Name(int entry) const
+{
+	return entry >= 0 && entry < m_Count ? m_pNames + m_pEntries[entry].nameOffset : 0;
+}
+
+unsigned int AssetArchive::HashName(const char* name)
+{
+	unsigned int hash=2166136261u;
+	for(; *name; name++)
+	{
+		hash^=(unsigned char)NameChar(*name);
+		hash*=16777619u;
+	}
+	return hash;
+}
+
+bool AssetArchive::SameName(const char* a, const char* b)
+{
+	for(; *a && *b; a++, b++)
+	{
+		if(NameChar(*a) != NameChar(*b))
+			return false;
+	}
+	return *a == *b;
+}
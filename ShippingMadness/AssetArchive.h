@@ -0,0 +1,123 @@
+///////////////////////////////////////////////////////////////
+//Asset Archive, every game file packed into one file that is
+//memory mapped read only.  Assets are looked up by name through
+//a sorted hash index and read straight out of the mapping.
+//"assettool pack" writes it, see Tools/AssetTool.cpp
+//
+//Layout, little endian:
+//	ArchiveHeader
+//	ArchiveEntry[entryCount]	sorted by hash, then name
+//	names						NUL terminated, referenced by the entries
+//	data						each entry's bytes, ARCHIVE_ALIGNMENT aligned
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//what an entry holds, from its extension when packed
+enum AssetFormat
+{
+	ASSET_RAW,
+	ASSET_DDS,
+	ASSET_PNG,
+	ASSET_WAV,
+	ASSET_MP3,
+	ASSET_FONT
+};
+
+static const unsigned int	ARCHIVE_MAGIC		= 0x4B504D53; //"SMPK"
+static const unsigned int	ARCHIVE_VERSION		= 1;
+static const unsigned int	ARCHIVE_ALIGNMENT	= 64; //data offsets, a cache line and any SIMD load
+
+struct ArchiveHeader
+{
+	unsigned int	magic;
+	unsigned int	version;
+	unsigned int	entryCount;
+	unsigned int	namesOffset;	//from the start of the file
+	unsigned int	namesSize;
+	unsigned int	reserved[3];
+};
+
+struct ArchiveEntry
+{
+	unsigned int	hash;			//AssetArchive::HashName of the name
+	unsigned int	nameOffset;		//into the names
+	unsigned int	format;			//AssetFormat
+	unsigned int	offset;			//from the start of the file
+	unsigned int	size;
+	unsigned int	reserved;
+};
+
+//an asset in the mapping, valid until the archive is closed
+struct AssetView
+{
+	const unsigned char*	data;
+	size_t					size;
+	AssetFormat				format;
+};
+
+class AssetArchive
+{
+public:
+	AssetArchive();
+	~AssetArchive();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Open
+	// Parameters:	const char* filename - archive written by "assettool pack"
+	// Return:		bool - false if it is missing or fails the checks
+	// Description:	Maps the whole file read only and checks the header and
+	//				that every entry lies inside the file.  Nothing is read
+	//				until it is used, the OS pages it in on demand.
+	//////////////////////////////////////////////////////////////////////////
+	bool	Open(const char* filename);
+	void	Close();
+	bool	IsOpen() const;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Find
+	// Parameters:	const char* name - file name as it was in the asset
+	//					directory, case and slash direction don't matter
+	//				AssetView& view - where it is in the mapping
+	// Return:		bool - false if the archive has no such file
+	// Description:	Binary search on the hash, then the names of the entries
+	//				sharing it are compared.
+	//////////////////////////////////////////////////////////////////////////
+	bool	Find(const char* name, AssetView& view) const;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Shadow
+	// Parameters:	const char* name - as for Find
+	// Return:		void
+	// Description:	Find leaves the file to the loose copy from then on, for
+	//				hot reloading one that changed on disk.  Safe to call
+	//				while other threads are in Find.
+	//////////////////////////////////////////////////////////////////////////
+	void	Shadow(const char* name);
+
+	int			Count() const;
+	const char*	Name(int entry) const;
+
+	//FNV-1a of the lower case name with '\' as '/'
+	static unsigned int	HashName(const char* name);
+	static bool			SameName(const char* a, const char* b); //by the same rules
+
+private:
+	const unsigned char*	m_pData;
+	size_t					m_Size;
+	const ArchiveEntry*		m_pEntries;
+	const char*				m_pNames;
+	int						m_Count;
+	std::vector<std::string>	m_Shadowed;		//names Find skips
+	std::atomic<bool>		m_bShadowed;	//any at all, Find only locks then
+	mutable std::mutex		m_ShadowMutex;
+#ifdef _WIN32
+	void*					m_hFile;
+	void*					m_hMapping;
+#endif
+};
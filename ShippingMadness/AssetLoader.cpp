@@ -0,0 +1,278 @@
+////////////////////////////////////////////////////////////////
+//AssetLoader member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "AssetLoader.h"
+#include "TraceLog.h"
+#include <stdio.h>
+
+//the whole file, out of the archive mapping when it is there, else read into file
+static bool ReadSource(const AssetArchive* pArchive, const std::string& name, std::vector<unsigned char>& file, AssetView& view)
+{
+	if(pArchive && pArchive->Find(name.c_str(),view))
+		return true;
+
+	FILE* source=fopen(name.c_str(),"rb");
+	if(!source)
+		return false;
+	fseek(source,0,SEEK_END);
+	long size=ftell(source);
+	fseek(source,0,SEEK_SET);
+	file.resize(size > 0 ? (size_t)size : 0);
+	bool bRead=size > 0 && fread(&file[0],1,file.size(),source) == file.size();
+	fclose(source);
+
+	view.data=bRead ? &file[0] : 0;
+	view.size=bRead ? file.size() : 0;
+	return bRead;
+}
+
+//runs the conversion, source is the PNG file or dds the texture read from it
+static bool Convert(ImageConversion conversion, const AssetView& source, const DDSTexture& dds, Image& image)
+{
+	TraceScope trace(conversion == CONVERT_BC ? "Decompress DDS" : "Decode PNG");
+	if(conversion == CONVERT_BC)
+		return dds.Decompress(0,image);
+	return image.LoadPNGFromMemory(source.data,source.size);
+}
+
+//pixels from the cache, or converted and then stored for next time
+static bool ConvertCached(ImageCache* pCache, ImageConversion conversion, const AssetView& source, const DDSTexture& dds, Image& image)
+{
+	if(!pCache || !pCache->IsEnabled())
+		return Convert(conversion,source,dds,image);
+
+	unsigned long long key=ImageCache::Key(source.data,source.size,conversion);
+	if(pCache->Load(key,image))
+		return true;
+	if(!Convert(conversion,source,dds,image))
+		return false;
+	pCache->Store(key,image);
+	return true;
+}
+
+AssetLoader::AssetLoader()
+{
+	m_Queued=0;
+	m_Finished=0;
+	m_Taken=0;
+	m_bDecompress=false;
+	m_bStop=false;
+	m_pArchive=0;
+	m_pCache=0;
+}
+
+AssetLoader::~AssetLoader()
+{
+	Stop();
+}
+
+void AssetLoader::Start(int workers, bool bDecompress)
+{
+	Stop();
+
+	m_Jobs.clear();
+	m_Results.clear();
+	m_Status.clear();
+	m_Queued=0;
+	m_Finished=0;
+	m_Taken=0;
+	m_bDecompress=bDecompress;
+	m_bStop=false;
+
+	if(workers <= 0)
+	{
+		int cores=(int)std::thread::hardware_concurrency();
+		workers=cores > 1 ? cores - 1 : 1;
+	}
+	for(int i=0; i < workers; i++)
+		m_Workers.push_back(std::thread(&AssetLoader::Worker,this));
+}
+
+void AssetLoader::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_bStop=true;
+		m_Jobs.clear();
+	}
+	m_JobReady.notify_all();
+	m_Decoded.notify_all();
+
+	for(size_t i=0; i < m_Workers.size(); i++)
+		m_Workers[i].join();
+	m_Workers.clear();
+}
+
+void AssetLoader::SetArchive(const AssetArchive* pArchive)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_pArchive=pArchive;
+}
+
+void AssetLoader::SetCache(ImageCache* pCache)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_pCache=pCache;
+}
+
+void AssetLoader::Queue(int id, const char* baseName)
+{
+	if(id < 0)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		Job job={id,baseName,false};
+		m_Jobs.push_back(job);
+		if(id >= (int)m_Status.size())
+		{
+			Status unqueued={false,false,0,0};
+			m_Status.resize(id + 1,unqueued);
+		}
+		m_Status[id].bQueued=true;
+		m_Status[id].bFinished=false;
+		m_Queued++;
+	}
+	m_JobReady.notify_one();
+}
+
+void AssetLoader::Reload(int id, const char* baseName)
+{
+	if(id < 0)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		Job job={id,baseName,true};
+		m_Jobs.push_back(job);
+		if(id >= (int)m_Status.size())
+		{
+			Status unqueued={false,false,0,0};
+			m_Status.resize(id + 1,unqueued);
+		}
+		m_Queued++;
+	}
+	m_JobReady.notify_one();
+}
+
+bool AssetLoader::Take(DecodedTexture& texture, bool bWait)
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	while(bWait && m_Results.empty() && m_Taken < m_Queued && !m_bStop)
+		m_Decoded.wait(lock);
+
+	if(m_Results.empty())
+		return false;
+
+	texture=std::move(m_Results.front());
+	m_Results.pop_front();
+	m_Taken++;
+	return true;
+}
+
+bool AssetLoader::IsFinished(int id, int* width, int* height) const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	if(id < 0 || id >= (int)m_Status.size() || !m_Status[id].bFinished)
+		return false;
+
+	if(width) *width=m_Status[id].width;
+	if(height) *height=m_Status[id].height;
+	return true;
+}
+
+bool AssetLoader::IsPending(int id) const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return id >= 0 && id < (int)m_Status.size() && m_Status[id].bQueued && !m_Status[id].bFinished;
+}
+
+int AssetLoader::Queued() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Queued;
+}
+
+int AssetLoader::Finished() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Finished;
+}
+
+bool AssetLoader::Decode(const AssetArchive* pArchive, ImageCache* pCache, const char* baseName, bool bDecompress, DecodedTexture& texture)
+{
+	std::string name=baseName ? baseName : "";
+	TraceScope trace("Load texture",name);
+	texture.bReload=false;
+	texture.bDDS=false;
+	texture.dds.Release();
+	texture.image.Release();
+	texture.width=0;
+	texture.height=0;
+
+	//same order of preference the hosts always had, the compressed file first.
+	//Packed DDS blocks stay in the mapping, loose ones are copied out of file
+	std::vector<unsigned char> file;
+	AssetView source;
+	bool bPacked=pArchive && pArchive->Find((name + ".dds").c_str(),source);
+	if((bPacked || ReadSource(0,name + ".dds",file,source)) &&
+	   (bPacked ? texture.dds.ViewMemory(source.data,source.size) : texture.dds.LoadFromMemory(source.data,source.size)))
+	{
+		if(!bDecompress || ConvertCached(pCache,CONVERT_BC,source,texture.dds,texture.image))
+		{
+			texture.bDDS=true;
+			texture.width=texture.dds.ContentWidth();
+			texture.height=texture.dds.ContentHeight();
+			return true;
+		}
+	}
+
+	texture.dds.Release();
+	if(!ReadSource(pArchive,name + ".pma.png",file,source) || !ConvertCached(pCache,CONVERT_PNG,source,texture.dds,texture.image))
+		return false;
+
+	texture.width=texture.image.Width();
+	texture.height=texture.image.Height();
+	return true;
+}
+
+void AssetLoader::Worker()
+{
+	TraceLog::NameThread("Asset loader");
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	for(;;)
+	{
+		while(m_Jobs.empty() && !m_bStop)
+			m_JobReady.wait(lock);
+		if(m_bStop)
+			return;
+
+		Job job=m_Jobs.front();
+		m_Jobs.pop_front();
+		bool bDecompress=m_bDecompress;
+		const AssetArchive* pArchive=m_pArchive;
+		ImageCache* pCache=m_pCache;
+
+		//the file reading and decoding is the slow part, done unlocked
+		lock.unlock();
+		DecodedTexture texture;
+		texture.id=job.id;
+		Decode(pArchive,pCache,job.baseName.c_str(),bDecompress,texture);
+		texture.bReload=job.bReload;
+		lock.lock();
+
+		//the result goes in before the status so IsFinished means Take has it.
+		//A broken reload leaves the old texture, and its size, in use
+		Status& status=m_Status[job.id];
+		if(!job.bReload || texture.width)
+		{
+			status.width=texture.width;
+			status.height=texture.height;
+		}
+		m_Results.push_back(std::move(texture));
+		status.bFinished=true;
+		m_Finished++;
+		m_Decoded.notify_all();
+	}
+}
@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////
+//Asset Loader, reads and decodes texture files on a pool of
+//worker threads.  The owner queues the files and takes the
+//decoded results back on its own thread, the one that owns the
+//device, to upload them.  Files come out of an AssetArchive when
+//there is one, loose files otherwise.  Nothing here touches Direct3D
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include "AssetArchive.h"
+#include "ImageCache.h"
+#include "DDSTexture.h"
+#include "Image.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//a texture file as it came off disk
+struct DecodedTexture
+{
+	int			id;			//as queued
+	bool		bReload;	//queued by Reload, replaces a texture that may still be loaded
+	bool		bDDS;		//dds holds the file's blocks (in the archive mapping if packed), otherwise it was a PNG
+	DDSTexture	dds;
+	Image		image;		//decoded pixels, of the PNG or of a DDS when decompressing
+	int			width;		//content size, 0 if neither file loaded
+	int			height;
+};
+
+class AssetLoader
+{
+public:
+	AssetLoader();
+	~AssetLoader();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Start
+	// Parameters:	int workers - decoding threads, 0 for one per core less
+	//					the one the caller keeps for itself
+	//				bool bDecompress - also decode DDS blocks into pixels, for
+	//					renderers that can't sample compressed textures
+	// Return:		void
+	//////////////////////////////////////////////////////////////////////////
+	void	Start(int workers, bool bDecompress);
+	void	Stop();		//drops whatever is still queued and joins the workers
+
+	//looked in before the loose files, set before Start and keep it open while
+	//anything decoded from it is in use, DDS blocks are read from the mapping
+	void	SetArchive(const AssetArchive* pArchive);
+
+	//decoded pixels are looked up here first and stored after a decode, set
+	//before Start, 0 (the default) decodes every time
+	void	SetCache(ImageCache* pCache);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Queue
+	// Parameters:	int id - returned with the result, 0 or more
+	//				const char* baseName - file without extension, <name>.dds
+	//					is tried first then <name>.pma.png
+	// Return:		void
+	// Description:	Files are picked up in the order they are queued, so
+	//				queue what is needed first, first.  An id can be queued
+	//				again once it has finished, to load a released file back.
+	//////////////////////////////////////////////////////////////////////////
+	void	Queue(int id, const char* baseName);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Reload
+	// Parameters:	int id, const char* baseName - as for Queue
+	// Return:		void
+	// Description:	For a file that changed on disk.  The result comes back
+	//				through Take with bReload set, and until then IsFinished
+	//				keeps reporting the old one.  If the new file fails to
+	//				decode the old size stays too.
+	//////////////////////////////////////////////////////////////////////////
+	void	Reload(int id, const char* baseName);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Take
+	// Parameters:	DecodedTexture& texture - the next finished file, failed
+	//					ones too (with an empty dds and image)
+	//				bool bWait - block until one finishes
+	// Return:		bool - false if none has finished, or when waiting, once
+	//				every queued file has been taken
+	//////////////////////////////////////////////////////////////////////////
+	bool	Take(DecodedTexture& texture, bool bWait);
+
+	bool	IsFinished(int id, int* width, int* height) const;	//decoded or failed, with the content size
+	bool	IsPending(int id) const;	//queued and not finished yet
+	int		Queued() const;
+	int		Finished() const;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Decode
+	// Parameters:	const AssetArchive* pArchive - looked in first, may be 0
+	//				ImageCache* pCache - decoded pixels from earlier runs, may be 0
+	//				const char* baseName - as for Queue
+	//				bool bDecompress - as for Start
+	//				DecodedTexture& texture - filled in, the id is left alone
+	// Return:		bool - false if neither file loaded
+	// Description:	What the workers run, also for reloading a single texture
+	//				on the calling thread.
+	//////////////////////////////////////////////////////////////////////////
+	static bool	Decode(const AssetArchive* pArchive, ImageCache* pCache, const char* baseName, bool bDecompress, DecodedTexture& texture);
+
+private:
+	void	Worker();
+
+private:
+	struct Job
+	{
+		int			id;
+		std::string	baseName;
+		bool		bReload;
+	};
+	struct Status
+	{
+		bool	bQueued;
+		bool	bFinished;
+		int		width;
+		int		height;
+	};
+
+	mutable std::mutex			m_Mutex;
+	std::condition_variable		m_JobReady;		//workers wait for a job or Stop
+	std::condition_variable		m_Decoded;		//Take waits for a result
+	std::deque<Job>				m_Jobs;
+	std::deque<DecodedTexture>	m_Results;		//finished and not taken yet
+	std::vector<Status>			m_Status;		//by id
+	std::vector<std::thread>	m_Workers;
+	const AssetArchive*			m_pArchive;
+	ImageCache*					m_pCache;
+	int							m_Queued;
+	int							m_Finished;
+	int							m_Taken;
+	bool						m_bDecompress;
+	bool						m_bStop;
+};
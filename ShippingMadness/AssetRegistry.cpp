@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////////
+//AssetRegistry member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "AssetRegistry.h"
+#include <ctype.h>
+
+static const int			MaxSlots=0x10000;
+static const unsigned int	SlotMask=0xFFFF;
+
+AssetHandle AssetRegistry::Add(int id, const char* name, unsigned int groups)
+{
+	int slot=(int)m_Names.size();
+	if(id < 0 || slot >= MaxSlots || Handle(id))
+		return 0;
+
+	m_Names.push_back(name ? name : "");
+	m_Ids.push_back(id);
+	m_Groups.push_back(groups);
+	m_Generations.push_back(1);
+
+	if(id >= (int)m_SlotById.size())
+		m_SlotById.resize(id + 1,-1);
+	m_SlotById[id]=slot;
+	return MakeHandle(slot,1);
+}
+
+void AssetRegistry::Clear()
+{
+	m_Names.clear();
+	m_Ids.clear();
+	m_Groups.clear();
+	m_Generations.clear();
+	m_SlotById.clear();
+}
+
+AssetHandle AssetRegistry::Handle(int id) const
+{
+	if(id < 0 || id >= (int)m_SlotById.size() || m_SlotById[id] < 0)
+		return 0;
+
+	int slot=m_SlotById[id];
+	return MakeHandle(slot,m_Generations[slot]);
+}
+
+AssetHandle AssetRegistry::Find(const char* name) const
+{
+	for(size_t slot=0; slot < m_Names.size(); slot++)
+	{
+		const char* a=m_Names[slot].c_str();
+		const char* b=name;
+		while(*a && tolower((unsigned char)*a) == tolower((unsigned char)*b))
+		{
+			a++;
+			b++;
+		}
+		if(!*a && !*b)
+			return MakeHandle((int)slot,m_Generations[slot]);
+	}
+	return 0;
+}
+
+int AssetRegistry::Slot(AssetHandle handle) const
+{
+	int slot=(int)(handle & SlotMask);
+	if(!handle || slot >= (int)m_Generations.size() || m_Generations[slot] != handle >> 16)
+		return -1;
+	return slot;
+}
+
+AssetHandle AssetRegistry::Reissue(AssetHandle handle)
+{
+	int slot=Slot(handle);
+	if(slot < 0)
+		return 0;
+
+	//skips 0 when it wraps, so a handle is never 0
+	unsigned int& generation=m_Generations[slot];
+	generation=generation == 0xFFFF ? 1 : generation + 1;
+	return MakeHandle(slot,generation);
+}
+
+int AssetRegistry::Count() const
+{
+	return (int)m_Names.size();
+}
+
+int AssetRegistry::Id(int slot) const
+{
+	return m_Ids[slot];
+}
+
+const char* AssetRegistry::Name(int slot) const
+{
+	return m_Names[slot].c_str();
+}
+
+unsigned int AssetRegistry::Groups(int slot) const
+{
+	return m_Groups[slot];
+}
+
+AssetHandle AssetRegistry::MakeHandle(int slot, unsigned int generation)
+{
+	return (generation << 16) | (unsigned int)slot;
+}
@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////
+//Asset Registry, the catalogue of a host's assets.  Each asset
+//is added once from a content table under the id the game uses
+//for it and gets a slot in flat arrays, the host keeps what it
+//loaded for the asset in its own arrays by slot.  Handles name a
+//slot and its generation, so work started with a handle (an
+//asset opening in the background) can tell the asset was
+//released meanwhile
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include <string>
+#include <vector>
+
+//slot in the low 16 bits, generation in the high 16, 0 is never a handle
+typedef unsigned int AssetHandle;
+
+class AssetRegistry
+{
+public:
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Add
+	// Parameters:	int id - the caller's id for it, 0 or more, unique
+	//				const char* name - file name
+	//				unsigned int groups - ASSETS_ bits it is loaded with, 0
+	//					for always
+	// Return:		AssetHandle - 0 if the id is taken or out of slots
+	// Description:	Slots are given out in order, so adding a table in id
+	//				order makes the slot the id.
+	//////////////////////////////////////////////////////////////////////////
+	AssetHandle	Add(int id, const char* name, unsigned int groups);
+	void		Clear();
+
+	AssetHandle	Handle(int id) const;				//current handle for the id, 0 if it wasn't added
+	AssetHandle	Find(const char* name) const;		//by file name, ignoring case, a scan for setup and hot reload
+	int			Slot(AssetHandle handle) const;		//-1 for 0 or a handle from an older generation
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Reissue
+	// Parameters:	AssetHandle handle - current handle of the asset
+	// Return:		AssetHandle - its new handle, 0 if handle was stale
+	// Description:	Call when the host releases what it loaded for the
+	//				asset.  Handles given out before stop resolving.
+	//////////////////////////////////////////////////////////////////////////
+	AssetHandle	Reissue(AssetHandle handle);
+
+	int				Count() const;					//slots, 0 to Count() - 1 are in use
+	int				Id(int slot) const;
+	const char*		Name(int slot) const;
+	unsigned int	Groups(int slot) const;
+
+private:
+	static AssetHandle	MakeHandle(int slot, unsigned int generation);
+
+private:
+	//records, one entry per slot
+	std::vector<std::string>	m_Names;
+	std::vector<int>			m_Ids;
+	std::vector<unsigned int>	m_Groups;
+	std::vector<unsigned int>	m_Generations;	//1 to 65535, bumped by Reissue
+
+	std::vector<int>			m_SlotById;		//-1 where no asset has the id
+};
@@ -0,0 +1,195 @@
+////////////////////////////////////////////////////////////////
+//AssetWatcher member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "AssetWatcher.h"
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <errno.h>
+#include <unistd.h>
+#else
+#include <chrono>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+static const double ScanInterval=0.5; //seconds between scans of the folder
+
+static double Seconds()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+AssetWatcher::AssetWatcher()
+{
+#ifdef __linux__
+	m_Inotify=-1;
+	m_Watch=-1;
+#else
+	m_NextScan=0.0;
+	m_bWatching=false;
+#endif
+}
+
+AssetWatcher::~AssetWatcher()
+{
+	Stop();
+}
+
+bool AssetWatcher::Start(const char* directory)
+{
+	Stop();
+	m_Directory=directory ? directory : ".";
+
+#ifdef __linux__
+	m_Inotify=inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(m_Inotify < 0)
+		return false;
+
+	//closed after writing, or saved elsewhere and renamed over the old one
+	m_Watch=inotify_add_watch(m_Inotify,m_Directory.c_str(),IN_CLOSE_WRITE | IN_MOVED_TO);
+	if(m_Watch < 0)
+	{
+		Stop();
+		return false;
+	}
+#else
+	//the first scan only remembers what is there
+	m_bWatching=true;
+	Scan(false);
+	m_NextScan=Seconds() + ScanInterval;
+#endif
+	return true;
+}
+
+void AssetWatcher::Stop()
+{
+#ifdef __linux__
+	if(m_Inotify >= 0)
+		close(m_Inotify); //drops the watch with it
+	m_Inotify=-1;
+	m_Watch=-1;
+#else
+	m_Files.clear();
+	m_bWatching=false;
+#endif
+	m_Changed.clear();
+}
+
+bool AssetWatcher::IsWatching() const
+{
+#ifdef __linux__
+	return m_Inotify >= 0;
+#else
+	return m_bWatching;
+#endif
+}
+
+const std::vector<std::string>& AssetWatcher::Poll()
+{
+	m_Changed.clear();
+	if(!IsWatching())
+		return m_Changed;
+
+#ifdef __linux__
+	//whole events only, the buffer is aligned for the structure
+	alignas(struct inotify_event) char buffer[4096];
+	for(;;)
+	{
+		ssize_t bytes=read(m_Inotify,buffer,sizeof(buffer));
+		if(bytes <= 0)
+			break; //EAGAIN, nothing more for now
+
+		for(ssize_t offset=0; offset < bytes;)
+		{
+			const struct inotify_event* event=(const struct inotify_event*)(buffer + offset);
+			if(event->len && !(event->mask & IN_ISDIR))
+				Report(event->name);
+			offset+=sizeof(struct inotify_event) + event->len;
+		}
+	}
+#else
+	double now=Seconds();
+	if(now >= m_NextScan)
+	{
+		Scan(true);
+		m_NextScan=now + ScanInterval;
+	}
+#endif
+	return m_Changed;
+}
+
+void AssetWatcher::Report(const std::string& name)
+{
+	if(std::find(m_Changed.begin(),m_Changed.end(),name) == m_Changed.end())
+		m_Changed.push_back(name);
+}
+
+#ifndef __linux__
+void AssetWatcher::Scan(bool bReport)
+{
+	std::vector<FileTime> files;
+	FileTime file;
+	file.bChanging=false;
+#ifdef _WIN32
+	struct _finddatai64_t found;
+	intptr_t search=_findfirsti64((m_Directory + "/*").c_str(),&found);
+	if(search != -1)
+	{
+		do
+		{
+			if(found.attrib & _A_SUBDIR)
+				continue;
+			file.name=found.name;
+			file.time=(long long)found.time_write;
+			file.size=(long long)found.size;
+			files.push_back(file);
+		}
+		while(_findnexti64(search,&found) == 0);
+		_findclose(search);
+	}
+#else
+	DIR* dir=opendir(m_Directory.c_str());
+	if(dir)
+	{
+		struct dirent* item;
+		while((item=readdir(dir)) != 0)
+		{
+			struct stat info;
+			if(stat((m_Directory + "/" + item->d_name).c_str(),&info) != 0 || !S_ISREG(info.st_mode))
+				continue;
+			file.name=item->d_name;
+			file.time=(long long)info.st_mtime;
+			file.size=(long long)info.st_size;
+			files.push_back(file);
+		}
+		closedir(dir);
+	}
+#endif
+
+	//a new or changed file waits a scan to settle, then it is reported
+	for(size_t i=0; i < files.size(); i++)
+	{
+		FileTime* previous=0;
+		for(size_t j=0; j < m_Files.size() && !previous; j++)
+		{
+			if(m_Files[j].name == files[i].name)
+				previous=&m_Files[j];
+		}
+
+		if(!previous)
+			files[i].bChanging=bReport;
+		else if(previous->time != files[i].time || previous->size != files[i].size)
+			files[i].bChanging=true;
+		else if(previous->bChanging)
+			Report(files[i].name);
+	}
+	m_Files.swap(files);
+}
+#endif
@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////
+//Asset Watcher, reports asset files written while the game runs
+//so the hosts can reload just those.  inotify on Linux, on other
+//systems the folder's write times and sizes are compared twice
+//a second.  Only names come out, what to reload is up to the host
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include <string>
+#include <vector>
+
+class AssetWatcher
+{
+public:
+	AssetWatcher();
+	~AssetWatcher();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Start
+	// Parameters:	const char* directory - folder to watch, not its subfolders
+	// Return:		bool - false if it can't be watched
+	//////////////////////////////////////////////////////////////////////////
+	bool	Start(const char* directory);
+	void	Stop();
+	bool	IsWatching() const;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Poll
+	// Parameters:	void
+	// Return:		const std::vector<std::string>& - names of the files
+	//				written or moved in since the last call, each once, valid
+	//				until the next call
+	// Description:	Never blocks, call it once a frame.  A file is reported
+	//				when the writer has closed it (inotify), or once its time
+	//				and size have stopped changing between two scans, so a half written
+	//				file is not picked up.
+	//////////////////////////////////////////////////////////////////////////
+	const std::vector<std::string>&	Poll();
+
+private:
+	void	Report(const std::string& name);
+
+private:
+	std::string					m_Directory;
+	std::vector<std::string>	m_Changed;		//returned by Poll
+#ifdef __linux__
+	int							m_Inotify;		//-1 when not watching
+	int							m_Watch;
+#else
+	void	Scan(bool bReport);
+
+	struct FileTime
+	{
+		std::string	name;
+		long long	time;		//last write and size, as scanned
+		long long	size;
+		bool		bChanging;	//differed at the last scan, reported once it settles
+	};
+	std::vector<FileTime>		m_Files;
+	double						m_NextScan;		//seconds, steady clock
+	bool						m_bWatching;
+#endif
+};
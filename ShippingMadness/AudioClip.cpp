@@ -0,0 +1,259 @@
+////////////////////////////////////////////////////////////////
+//AudioClip member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "AudioClip.h"
+#include "AudioResampler.h"
+#include <string.h>
+
+//WAVE format tags
+static const int FormatPCM=1;
+static const int FormatFloat=3;
+static const int FormatIMA=0x11;
+static const int FormatExtensible=0xFFFE;	//the real tag is the first two bytes of the sub format
+
+//IMA ADPCM step sizes and how each code moves through them
+static const int IMAStep[89]=
+{
+	7,8,9,10,11,12,13,14,16,17,19,21,23,25,28,31,34,37,41,45,50,55,60,66,73,80,88,97,107,118,
+	130,143,157,173,190,209,230,253,279,307,337,371,408,449,494,544,598,658,724,796,876,963,
+	1060,1166,1282,1411,1552,1707,1878,2066,2272,2499,2749,3024,3327,3660,4026,4428,4871,5358,
+	5894,6484,7132,7845,8630,9493,10442,11487,12635,13899,15289,16818,18500,20350,22385,24623,
+	27086,29794,32767
+};
+static const int IMAIndex[16]={-1,-1,-1,-1,2,4,6,8,-1,-1,-1,-1,2,4,6,8};
+
+static unsigned int Read16(const unsigned char* p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static unsigned int Read32(const unsigned char* p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+//one IMA ADPCM code, predictor and step index carried between calls
+static float DecodeIMA(int code, int& predictor, int& index)
+{
+	int step=IMAStep[index];
+	int diff=step >> 3;
+	if(code & 1)
+		diff+=step >> 2;
+	if(code & 2)
+		diff+=step >> 1;
+	if(code & 4)
+		diff+=step;
+	predictor+=code & 8 ? -diff : diff;
+	predictor=predictor < -32768 ? -32768 : predictor > 32767 ? 32767 : predictor;
+	index+=IMAIndex[code];
+	index=index < 0 ? 0 : index > 88 ? 88 : index;
+	return predictor * (1.0f / 32768.0f);
+}
+
+//every block, each starts with a header per channel, then eight codes per
+//channel in turn, low nibble first.  Appended to out
+static bool DecodeIMABlocks(const unsigned char* data, size_t size, int channels, int blockAlign, int samplesPerBlock, std::vector<float>& out)
+{
+	if(blockAlign < 4 * channels || samplesPerBlock < 1)
+		return false;
+
+	size_t start=out.size();
+	std::vector<float> block[2];
+	for(size_t offset=0; offset + blockAlign <= size; offset+=blockAlign)
+	{
+		const unsigned char* p=data + offset;
+		int predictor[2], index[2];
+		for(int c=0; c < channels; c++)
+		{
+			predictor[c]=(short)Read16(p + c * 4);
+			index[c]=p[c * 4 + 2] > 88 ? 88 : p[c * 4 + 2];
+			block[c].assign(1,predictor[c] * (1.0f / 32768.0f));
+		}
+
+		const unsigned char* codes=p + 4 * channels;
+		const unsigned char* end=p + blockAlign;
+		while(codes + 4 * channels <= end)
+		{
+			for(int c=0; c < channels; c++, codes+=4)
+			{
+				for(int i=0; i < 4; i++)
+				{
+					block[c].push_back(DecodeIMA(codes[i] & 15,predictor[c],index[c]));
+					block[c].push_back(DecodeIMA(codes[i] >> 4,predictor[c],index[c]));
+				}
+			}
+		}
+
+		int frames=(int)block[0].size() < samplesPerBlock ? (int)block[0].size() : samplesPerBlock;
+		for(int i=0; i < frames; i++)
+		{
+			out.push_back(block[0][i]);
+			out.push_back(block[channels - 1][i]);
+		}
+	}
+	return out.size() > start;
+}
+
+//PCM or float samples as stereo floats, mono goes to both sides, after
+//what out already holds
+static bool DecodeSamples(const unsigned char* data, size_t size, int format, int channels, int bits, std::vector<float>& out)
+{
+	int bytes=bits / 8;
+	if((format == FormatPCM && bits != 8 && bits != 16 && bits != 24) || (format == FormatFloat && bits != 32))
+		return false;
+
+	size_t frames=size / (bytes * channels);
+	size_t start=out.size() / 2;
+	out.resize((start + frames) * 2);
+	for(size_t i=0; i < frames; i++)
+	{
+		for(int c=0; c < 2; c++)
+		{
+			const unsigned char* p=data + (i * channels + (c < channels ? c : 0)) * bytes;
+			float sample;
+			if(format == FormatFloat)
+			{
+				unsigned int raw=Read32(p);
+				memcpy(&sample,&raw,sizeof(sample));
+			}
+			else if(bits == 8)
+				sample=(p[0] - 128) * (1.0f / 128.0f); //8 bit is unsigned
+			else if(bits == 16)
+				sample=(short)Read16(p) * (1.0f / 32768.0f);
+			else
+				sample=((int)((p[0] << 8) | (p[1] << 16) | ((unsigned int)p[2] << 24)) >> 8) * (1.0f / 8388608.0f);
+			out[(start + i) * 2 + c]=sample;
+		}
+	}
+	return frames > 0;
+}
+
+//band limited, the 8kHz and 22kHz effects come up to the mixer's rate
+//without the images linear interpolation leaves above their Nyquist
+static void Resample(const std::vector<float>& in, int inRate, int outRate, std::vector<float>& out)
+{
+	int inFrames=(int)(in.size() / 2);
+	int outFrames=(int)((double)inFrames * outRate / inRate);
+	double step=(double)inRate / outRate;
+	AudioResampler resampler;
+	resampler.Init(step);
+	out.resize((size_t)outFrames * 2);
+	double position=0.0;
+	out.resize((size_t)resampler.Process(&in[0],inFrames,false,position,step,out.empty() ? 0 : &out[0],outFrames) * 2);
+}
+
+AudioClip::AudioClip()
+{
+	m_Frames=0;
+	m_SourceRate=0;
+}
+
+bool AudioClip::LoadWave(const unsigned char* data, size_t size, int mixRate)
+{
+	Release();
+	WaveFormat format;
+	std::vector<float> decoded;
+	if(!data || mixRate <= 0 || !ReadFormat(data,size,size,format) || !Decode(format,data + format.dataOffset,format.dataSize,decoded))
+		return false;
+
+	if(format.rate == mixRate)
+		m_Samples.swap(decoded);
+	else
+		Resample(decoded,format.rate,mixRate,m_Samples);
+	m_Frames=(int)(m_Samples.size() / 2);
+	m_SourceRate=format.rate;
+	return m_Frames > 0;
+}
+
+void AudioClip::Release()
+{
+	std::vector<float>().swap(m_Samples);
+	m_Frames=0;
+	m_SourceRate=0;
+}
+
+bool AudioClip::IsEmpty() const
+{
+	return m_Frames == 0;
+}
+
+int AudioClip::Frames() const
+{
+	return m_Frames;
+}
+
+const float* AudioClip::Samples() const
+{
+	return m_Samples.empty() ? 0 : &m_Samples[0];
+}
+
+int AudioClip::SourceRate() const
+{
+	return m_SourceRate;
+}
+
+size_t AudioClip::Bytes() const
+{
+	return m_Samples.size() * sizeof(float);
+}
+
+bool AudioClip::ReadFormat(const unsigned char* data, size_t size, size_t fileSize, WaveFormat& format)
+{
+	if(!data || size < 12 || memcmp(data,"RIFF",4) || memcmp(data + 8,"WAVE",4))
+		return false;
+
+	//the chunks can come in any order, each is padded to an even length.  The
+	//fmt chunk has to be in what was read, the data chunk only starts there
+	const unsigned char* header=0;
+	size_t headerSize=0;
+	bool bSamples=false;
+	for(size_t offset=12; offset + 8 <= size;)
+	{
+		size_t chunkSize=Read32(data + offset + 4);
+		if(chunkSize > fileSize - offset - 8)
+			chunkSize=fileSize - offset - 8; //a truncated file keeps what is there
+		if(!memcmp(data + offset,"fmt ",4) && chunkSize <= size - offset - 8)
+		{
+			header=data + offset + 8;
+			headerSize=chunkSize;
+		}
+		else if(!memcmp(data + offset,"data",4))
+		{
+			format.dataOffset=offset + 8;
+			format.dataSize=chunkSize;
+			bSamples=true;
+		}
+		offset+=8 + chunkSize + (chunkSize & 1);
+	}
+	if(!header || headerSize < 16 || !bSamples)
+		return false;
+
+	format.tag=Read16(header);
+	format.channels=Read16(header + 2);
+	format.rate=(int)Read32(header + 4);
+	format.blockAlign=Read16(header + 12);
+	format.bits=Read16(header + 14);
+	format.samplesPerBlock=1;
+	if(format.tag == FormatExtensible && headerSize >= 26)
+		format.tag=Read16(header + 24);
+	if(format.channels < 1 || format.channels > 2 || format.rate <= 0)
+		return false;
+
+	if(format.tag == FormatIMA)
+	{
+		//samples per block from the extra format bytes, or worked out from the block size
+		format.samplesPerBlock=headerSize >= 20 ? Read16(header + 18) : (format.blockAlign - 4 * format.channels) * 2 / format.channels + 1;
+		return format.blockAlign >= 4 * format.channels && format.samplesPerBlock >= 1;
+	}
+	format.blockAlign=format.bits / 8 * format.channels;
+	return (format.tag == FormatPCM && (format.bits == 8 || format.bits == 16 || format.bits == 24)) ||
+		   (format.tag == FormatFloat && format.bits == 32);
+}
+
+bool AudioClip::Decode(const WaveFormat& format, const unsigned char* samples, size_t size, std::vector<float>& out)
+{
+	if(format.tag == FormatIMA)
+		return DecodeIMABlocks(samples,size,format.channels,format.blockAlign,format.samplesPerBlock,out);
+	return DecodeSamples(samples,size,format.tag,format.channels,format.bits,out);
+}
@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////
+//Audio Clip, a sound decoded once to float stereo at the mixer's
+//rate (through the AudioResampler) so a voice only has to scale
+//and add it.  Reads WAV files: 8, 16 and 24 bit PCM, 32 bit
+//float and IMA ADPCM, mono or stereo
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+//where a WAV file's samples are and how they are stored
+struct WaveFormat
+{
+	int		tag;				//1 PCM, 3 float, 0x11 IMA ADPCM
+	int		channels;			//1 or 2
+	int		rate;
+	int		bits;
+	int		blockAlign;			//bytes a frame, or an ADPCM block
+	int		samplesPerBlock;	//frames an ADPCM block holds, 1 otherwise
+	size_t	dataOffset;			//from the start of the file
+	size_t	dataSize;
+};
+
+class AudioClip
+{
+public:
+	AudioClip();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		LoadWave
+	// Parameters:	const unsigned char* data - the whole .wav file
+	//				size_t size - its length
+	//				int mixRate - the mixer's sample rate, the clip is
+	//					converted to it
+	// Return:		bool - false for a format it doesn't read, released
+	//////////////////////////////////////////////////////////////////////////
+	bool	LoadWave(const unsigned char* data, size_t size, int mixRate);
+	void	Release();
+	bool	IsEmpty() const;
+
+	int				Frames() const;		//stereo frames at the mixer's rate
+	const float*	Samples() const;	//left, right, left, ... Frames() * 2 of them
+	int				SourceRate() const;	//the file's sample rate
+	size_t			Bytes() const;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		ReadFormat
+	// Parameters:	const unsigned char* data - the start of a .wav file, up
+	//					to the data chunk's header at least
+	//				size_t size - bytes of it there
+	//				size_t fileSize - the whole file's length
+	//				WaveFormat& format - filled in
+	// Return:		bool - false for a format Decode doesn't read
+	// Description:	For AudioStream, which reads the file a piece at a time.
+	//////////////////////////////////////////////////////////////////////////
+	static bool	ReadFormat(const unsigned char* data, size_t size, size_t fileSize, WaveFormat& format);
+
+	//whole frames or ADPCM blocks of the data chunk appended to out as
+	//stereo floats at the file's rate, false if nothing came of them
+	static bool	Decode(const WaveFormat& format, const unsigned char* samples, size_t size, std::vector<float>& out);
+
+private:
+	std::vector<float>	m_Samples;
+	int					m_Frames;
+	int					m_SourceRate;
+};
@@ -0,0 +1,541 @@
+////////////////////////////////////////////////////////////////
+//AudioMixer member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "AudioMixer.h"
+#include <string.h>
+
+//SSE is always there on x64 and on x86 builds using /arch:SSE2,
+//AVX is only compiled in when the compiler targets it (/arch:AVX, -mavx)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUDIO_MIXER_SSE
+#include <emmintrin.h>
+#endif
+#if defined(__AVX__)
+#define AUDIO_MIXER_AVX
+#include <immintrin.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+// Adds frames of in to out, left scaled by gainL + stepL * i and right by
+// gainR + stepR * i for frame i, so a ramp is a straight line across the
+// span.  The wide loops take what they can and leave the rest to the next
+// narrower one, all of them work out the gain of frame i the same way.
+//////////////////////////////////////////////////////////////////////////
+static void MixSpan(AudioMixPath path, float* out, const float* in, int frames, float gainL, float gainR, float stepL, float stepR)
+{
+	int i=0;
+#ifdef AUDIO_MIXER_AVX
+	if(path == AUDIO_MIX_AVX && frames >= 4)
+	{
+		__m256 gain=_mm256_setr_ps(gainL,gainR,gainL + stepL,gainR + stepR,
+								   gainL + stepL * 2.0f,gainR + stepR * 2.0f,gainL + stepL * 3.0f,gainR + stepR * 3.0f);
+		__m256 step=_mm256_setr_ps(stepL * 4.0f,stepR * 4.0f,stepL * 4.0f,stepR * 4.0f,stepL * 4.0f,stepR * 4.0f,stepL * 4.0f,stepR * 4.0f);
+		for(; i + 4 <= frames; i+=4)
+		{
+			__m256 mixed=_mm256_add_ps(_mm256_loadu_ps(out + i * 2),_mm256_mul_ps(_mm256_loadu_ps(in + i * 2),gain));
+			_mm256_storeu_ps(out + i * 2,mixed);
+			gain=_mm256_add_ps(gain,step);
+		}
+	}
+#endif
+#ifdef AUDIO_MIXER_SSE
+	if(path != AUDIO_MIX_SCALAR && i + 2 <= frames)
+	{
+		float first=(float)i;
+		__m128 gain=_mm_setr_ps(gainL + stepL * first,gainR + stepR * first,gainL + stepL * (first + 1.0f),gainR + stepR * (first + 1.0f));
+		__m128 step=_mm_setr_ps(stepL * 2.0f,stepR * 2.0f,stepL * 2.0f,stepR * 2.0f);
+		for(; i + 2 <= frames; i+=2)
+		{
+			__m128 mixed=_mm_add_ps(_mm_loadu_ps(out + i * 2),_mm_mul_ps(_mm_loadu_ps(in + i * 2),gain));
+			_mm_storeu_ps(out + i * 2,mixed);
+			gain=_mm_add_ps(gain,step);
+		}
+	}
+#endif
+	for(; i < frames; i++)
+	{
+		out[i * 2]+=in[i * 2] * (gainL + stepL * i);
+		out[i * 2 + 1]+=in[i * 2 + 1] * (gainR + stepR * i);
+	}
+}
+
+AudioMixer::AudioMixer()
+{
+	m_Rate=0;
+	m_RampFrames=1;
+	m_Path=BestMixPath();
+	m_MaxVoices=0;
+	m_Steal=AUDIO_STEAL_OLDEST;
+	m_Plays=0;
+	m_Steals=0;
+
+	//the filters don't depend on the rate, they are only built once
+	for(int band=0; band < 3; band++)
+		m_Resamplers[band].Init(1.0 + band * 0.5);
+}
+
+void AudioMixer::Init(int rate, int voices)
+{
+	m_Rate=rate;
+	m_RampFrames=rate / 200 > 1 ? rate / 200 : 1;
+	m_Path=BestMixPath();
+	m_Block.assign(BlockFrames * 2,0.0f);
+	m_VoiceBlock.assign(BlockFrames * 2,0.0f);
+	for(int band=0; band < 3; band++)
+		m_Resamplers[band].SetMixPath(m_Path);
+	m_MaxVoices=voices > 0 ? (voices < 0xC000 ? voices : 0xC000) : 0;
+	m_Plays=0;
+	m_Steals=0;
+
+	Voice voice;
+	memset(&voice,0,sizeof(voice));
+	voice.generation=1;
+	m_Voices.assign(m_MaxVoices ? m_MaxVoices + m_MaxVoices / 4 + 1 : 0,voice);
+}
+
+int AudioMixer::Rate() const
+{
+	return m_Rate;
+}
+
+void AudioMixer::SetStealPolicy(AudioSteal steal)
+{
+	m_Steal=steal;
+}
+
+AudioVoice AudioMixer::Play(const AudioClip* clip, float volume, AudioLoop loop, bool bPaused, const AudioLimit& limit)
+{
+	if(!clip || clip->IsEmpty())
+		return 0;
+
+	//a burst of the same trigger in one frame is one voice
+	int heard=0, clipHeard=0;
+	for(size_t slot=0; slot < m_Voices.size(); slot++)
+	{
+		Voice& voice=m_Voices[slot];
+		if(IsFree(voice) || voice.bStopping)
+			continue;
+		if(voice.clip == clip && !voice.bMixed && !voice.bPaused && !bPaused && voice.loop == loop)
+		{
+			if(volume > voice.volume)
+			{
+				SetTarget(voice,volume,voice.pan);
+				voice.gain[0]=voice.target[0];
+				voice.gain[1]=voice.target[1];
+				voice.ramp=0;
+			}
+			return (voice.generation << 16) | (unsigned int)slot;
+		}
+		heard++;
+		if(voice.clip == clip)
+			clipHeard++;
+	}
+
+	//over the clip's cap one of its own fades out, over the mixer's cap the
+	//least important voice does if the new sound matters as much
+	Voice* pVictim=0;
+	if(limit.maxVoices > 0 && clipHeard >= limit.maxVoices)
+		pVictim=Victim(clip,0x7FFFFFFF);
+	else if(heard >= m_MaxVoices && !(pVictim=Victim(0,limit.priority)))
+		return 0;
+	Voice* pSlot=Claim(pVictim);
+	if(!pSlot)
+		return 0;
+	return Start((size_t)(pSlot - &m_Voices[0]),clip,volume,loop,bPaused,limit.priority);
+}
+
+AudioVoice AudioMixer::Play(const AudioClip* clip, float volume, AudioLoop loop, bool bPaused)
+{
+	AudioLimit limit={0,0};
+	return Play(clip,volume,loop,bPaused,limit);
+}
+
+AudioVoice AudioMixer::PlayStream(AudioStream* stream, float volume, bool bPaused, const AudioLimit& limit)
+{
+	if(!stream || !stream->IsOpen())
+		return 0;
+
+	//a stream has one reader, playing it again takes its voice over
+	int heard=0;
+	for(size_t slot=0; slot < m_Voices.size(); slot++)
+	{
+		Voice& voice=m_Voices[slot];
+		if(voice.stream == stream)
+			End(voice);
+		else if(!IsFree(voice) && !voice.bStopping)
+			heard++;
+	}
+
+	Voice* pVictim=0;
+	if(heard >= m_MaxVoices && !(pVictim=Victim(0,limit.priority)))
+		return 0;
+	Voice* pSlot=Claim(pVictim);
+	if(!pSlot)
+		return 0;
+	AudioVoice voice=Start((size_t)(pSlot - &m_Voices[0]),0,volume,AUDIO_LOOP_OFF,bPaused,limit.priority);
+	pSlot->stream=stream;
+	stream->SetWanted(!bPaused);
+	return voice;
+}
+
+void AudioMixer::Stop(AudioVoice voice)
+{
+	Voice* pVoice=Find(voice);
+	if(!pVoice)
+		return;
+
+	if(pVoice->bPaused)
+	{
+		End(*pVoice); //silent already
+		return;
+	}
+	SetTarget(*pVoice,0.0f,pVoice->pan);
+	pVoice->bStopping=true;
+}
+
+void AudioMixer::StopAll()
+{
+	for(size_t slot=0; slot < m_Voices.size(); slot++)
+	{
+		if(!IsFree(m_Voices[slot]))
+			End(m_Voices[slot]);
+	}
+}
+
+void AudioMixer::StopClip(const AudioClip* clip)
+{
+	for(size_t slot=0; slot < m_Voices.size(); slot++)
+	{
+		if(clip && m_Voices[slot].clip == clip)
+			End(m_Voices[slot]);
+	}
+}
+
+void AudioMixer::SetVolume(AudioVoice voice, float volume)
+{
+	Voice* pVoice=Find(voice);
+	if(pVoice && !pVoice->bStopping)
+		SetTarget(*pVoice,volume,pVoice->pan);
+}
+
+void AudioMixer::SetPan(AudioVoice voice, float pan)
+{
+	Voice* pVoice=Find(voice);
+	if(pVoice && !pVoice->bStopping)
+		SetTarget(*pVoice,pVoice->volume,pan < -1.0f ? -1.0f : pan > 1.0f ? 1.0f : pan);
+}
+
+void AudioMixer::SetPitch(AudioVoice voice, float pitch)
+{
+	Voice* pVoice=Find(voice);
+	if(pVoice)
+		pVoice->pitch=pitch < 0.125f ? 0.125f : pitch > 2.0f ? 2.0f : pitch;
+}
+
+void AudioMixer::SetPaused(AudioVoice voice, bool bPaused)
+{
+	Voice* pVoice=Find(voice);
+	if(!pVoice)
+		return;
+	pVoice->bPaused=bPaused;
+	if(pVoice->stream)
+		pVoice->stream->SetWanted(!bPaused);
+}
+
+bool AudioMixer::IsPlaying(AudioVoice voice) const
+{
+	return const_cast<AudioMixer*>(this)->Find(voice) != 0;
+}
+
+int AudioMixer::Steals() const
+{
+	return m_Steals;
+}
+
+int AudioMixer::Voices() const
+{
+	int playing=0;
+	for(size_t slot=0; slot < m_Voices.size(); slot++)
+	{
+		if(!IsFree(m_Voices[slot]))
+			playing++;
+	}
+	return playing;
+}
+
+void AudioMixer::Mix(float* out, int frames)
+{
+	memset(out,0,(size_t)frames * 2 * sizeof(float));
+	for(size_t slot=0; slot < m_Voices.size(); slot++)
+	{
+		Voice& voice=m_Voices[slot];
+		if(!IsFree(voice) && !voice.bPaused)
+			MixVoice(voice,out,frames);
+		voice.bMixed=true;
+	}
+}
+
+bool AudioMixer::Render(AudioSink& sink, int frames)
+{
+	bool bWritten=true;
+	while(frames > 0)
+	{
+		int block=frames < BlockFrames ? frames : BlockFrames;
+		Mix(&m_Block[0],block);
+		if(!sink.Write(&m_Block[0],block))
+			bWritten=false;
+		frames-=block;
+	}
+	return bWritten;
+}
+
+bool AudioMixer::SetMixPath(AudioMixPath path)
+{
+	if(path > BestMixPath())
+		return false;
+	m_Path=path;
+	for(int band=0; band < 3; band++)
+		m_Resamplers[band].SetMixPath(path);
+	return true;
+}
+
+AudioMixPath AudioMixer::MixPath() const
+{
+	return m_Path;
+}
+
+AudioMixPath AudioMixer::BestMixPath()
+{
+#if defined(AUDIO_MIXER_AVX)
+	return AUDIO_MIX_AVX;
+#elif defined(AUDIO_MIXER_SSE)
+	return AUDIO_MIX_SSE;
+#else
+	return AUDIO_MIX_SCALAR;
+#endif
+}
+
+bool AudioMixer::IsFree(const Voice& voice)
+{
+	return !voice.clip && !voice.stream;
+}
+
+AudioMixer::Voice* AudioMixer::Find(AudioVoice voice)
+{
+	size_t slot=voice & 0xFFFF;
+	if(!voice || slot >= m_Voices.size())
+		return 0;
+	Voice& found=m_Voices[slot];
+	return !IsFree(found) && found.generation == voice >> 16 ? &found : 0;
+}
+
+AudioMixer::Voice* AudioMixer::Victim(const AudioClip* clip, int priority)
+{
+	Voice* pVictim=0;
+	for(size_t slot=0; slot < m_Voices.size(); slot++)
+	{
+		Voice& voice=m_Voices[slot];
+		if(IsFree(voice) || voice.bStopping || (clip && voice.clip != clip) || voice.priority > priority)
+			continue;
+		if(!pVictim || voice.priority < pVictim->priority)
+		{
+			pVictim=&voice;
+			continue;
+		}
+		if(voice.priority > pVictim->priority)
+			continue;
+
+		//the same priority, the policy decides.  Ages are counted back from
+		//the latest Play so the counter can wrap
+		bool bTake;
+		if(m_Steal == AUDIO_STEAL_QUIETEST)
+			bTake=(voice.gain[0] > voice.gain[1] ? voice.gain[0] : voice.gain[1]) <
+				  (pVictim->gain[0] > pVictim->gain[1] ? pVictim->gain[0] : pVictim->gain[1]);
+		else
+			bTake=m_Plays - voice.started > m_Plays - pVictim->started;
+		if(bTake)
+			pVictim=&voice;
+	}
+	return pVictim;
+}
+
+AudioMixer::Voice* AudioMixer::Claim(Voice* pVictim)
+{
+	if(pVictim)
+	{
+		m_Steals++;
+		if(pVictim->bPaused)
+			End(*pVictim); //silent already
+		else
+			Stop((pVictim->generation << 16) | (unsigned int)(pVictim - &m_Voices[0]));
+	}
+
+	//a free voice, or the one closest to the end of its fade cut short
+	Voice* pSlot=0;
+	for(size_t slot=0; slot < m_Voices.size() && (!pSlot || !IsFree(*pSlot)); slot++)
+	{
+		Voice& voice=m_Voices[slot];
+		if(IsFree(voice) || (voice.bStopping && (!pSlot || voice.ramp < pSlot->ramp)))
+			pSlot=&voice;
+	}
+	if(pSlot && !IsFree(*pSlot))
+		End(*pSlot);
+	return pSlot;
+}
+
+AudioVoice AudioMixer::Start(size_t slot, const AudioClip* clip, float volume, AudioLoop loop, bool bPaused, int priority)
+{
+	//starts at its volume, clips start from silence anyway
+	Voice& voice=m_Voices[slot];
+	voice.clip=clip;
+	voice.stream=0;
+	voice.position=0;
+	voice.pitch=1.0f;
+	voice.phase=0.0;
+	voice.loop=loop;
+	voice.bPaused=bPaused;
+	voice.bStopping=false;
+	SetTarget(voice,volume,0.0f);
+	voice.gain[0]=voice.target[0];
+	voice.gain[1]=voice.target[1];
+	voice.ramp=0;
+	voice.priority=priority;
+	voice.started=m_Plays++;
+	voice.bMixed=false;
+	return (voice.generation << 16) | (unsigned int)slot;
+}
+
+void AudioMixer::SetTarget(Voice& voice, float volume, float pan)
+{
+	//linear pan, the centre plays both sides at the full volume
+	voice.volume=volume;
+	voice.pan=pan;
+	voice.target[0]=volume * (pan > 0.0f ? 1.0f - pan : 1.0f);
+	voice.target[1]=volume * (pan < 0.0f ? 1.0f + pan : 1.0f);
+	voice.ramp=m_RampFrames;
+}
+
+void AudioMixer::MixVoice(Voice& voice, float* out, int frames)
+{
+	if(voice.stream)
+	{
+		MixStream(voice,out,frames);
+		return;
+	}
+
+	const AudioClip* clip=voice.clip;
+	bool bPitched=voice.pitch != 1.0f || voice.phase != 0.0;
+	while(frames > 0)
+	{
+		//up to the end of the clip or the ramp, whichever comes first.  A
+		//pitched voice is resampled a block at most at a time, the
+		//resampler says where the clip ends
+		int span=bPitched ? BlockFrames : clip->Frames() - voice.position;
+		if(span > frames)
+			span=frames;
+		float step[2]={0.0f,0.0f};
+		if(voice.ramp > 0)
+		{
+			if(span > voice.ramp)
+				span=voice.ramp;
+			step[0]=(voice.target[0] - voice.gain[0]) / voice.ramp;
+			step[1]=(voice.target[1] - voice.gain[1]) / voice.ramp;
+		}
+
+		const float* in=clip->Samples() + voice.position * 2;
+		if(bPitched)
+		{
+			double position=voice.position + voice.phase;
+			span=Resampler(voice.pitch).Process(clip->Samples(),clip->Frames(),voice.loop == AUDIO_LOOP_NORMAL,position,voice.pitch,&m_VoiceBlock[0],span);
+			voice.position=(int)position;
+			voice.phase=position - voice.position;
+			in=&m_VoiceBlock[0];
+		}
+
+		//a silent voice still moves on
+		if(voice.ramp > 0 || voice.gain[0] != 0.0f || voice.gain[1] != 0.0f)
+			MixSpan(m_Path,out,in,span,voice.gain[0],voice.gain[1],step[0],step[1]);
+
+		if(voice.ramp > 0)
+		{
+			voice.ramp-=span;
+			for(int side=0; side < 2; side++)
+				voice.gain[side]=voice.ramp ? voice.gain[side] + step[side] * span : voice.target[side];
+			if(!voice.ramp && voice.bStopping)
+			{
+				End(voice);
+				return;
+			}
+		}
+
+		if(!bPitched)
+			voice.position+=span;
+		out+=span * 2;
+		frames-=span;
+		if(voice.position >= clip->Frames() || !span)
+		{
+			if(voice.loop != AUDIO_LOOP_NORMAL)
+			{
+				End(voice);
+				return;
+			}
+			voice.position=0;
+		}
+	}
+}
+
+void AudioMixer::MixStream(Voice& voice, float* out, int frames)
+{
+	//a silent stream holds its place rather than decoding what nobody hears,
+	//one that hasn't decoded enough yet is silent until it has
+	bool bAudible=voice.ramp > 0 || voice.gain[0] != 0.0f || voice.gain[1] != 0.0f;
+	voice.stream->SetWanted(bAudible);
+	while(bAudible && frames > 0)
+	{
+		int span=frames < BlockFrames ? frames : BlockFrames;
+		float step[2]={0.0f,0.0f};
+		if(voice.ramp > 0)
+		{
+			if(span > voice.ramp)
+				span=voice.ramp;
+			step[0]=(voice.target[0] - voice.gain[0]) / voice.ramp;
+			step[1]=(voice.target[1] - voice.gain[1]) / voice.ramp;
+		}
+		span=voice.stream->Read(&m_VoiceBlock[0],span);
+		if(!span)
+			break;
+		MixSpan(m_Path,out,&m_VoiceBlock[0],span,voice.gain[0],voice.gain[1],step[0],step[1]);
+
+		if(voice.ramp > 0)
+		{
+			voice.ramp-=span;
+			for(int side=0; side < 2; side++)
+				voice.gain[side]=voice.ramp ? voice.gain[side] + step[side] * span : voice.target[side];
+			if(!voice.ramp && voice.bStopping)
+			{
+				End(voice);
+				return;
+			}
+		}
+		out+=span * 2;
+		frames-=span;
+	}
+	if(voice.stream->IsFinished())
+		End(voice);
+}
+
+const AudioResampler& AudioMixer::Resampler(float pitch) const
+{
+	return m_Resamplers[pitch <= 1.0f ? 0 : pitch <= 1.5f ? 1 : 2];
+}
+
+void AudioMixer::End(Voice& voice)
+{
+	//handles to it stop working, skipping 0 when the generation wraps
+	if(voice.stream)
+		voice.stream->SetWanted(false);
+	voice.clip=0;
+	voice.stream=0;
+	voice.generation=voice.generation == 0xFFFF ? 1 : voice.generation + 1;
+}
@@ -0,0 +1,166 @@
+///////////////////////////////////////////////////////////////
+//Audio Mixer, the in-house replacement for FMOD's channels on
+//the portable builds.  Voices play AudioClips into a float
+//stereo block with SSE or AVX, volume and pan changes ramp over
+//a few milliseconds so they don't click, and the blocks go to an
+//AudioSink.  A voice played at another pitch goes through an
+//AudioResampler first, music comes out of an AudioStream's ring.  Past the voice cap, or a clip's own cap, a new
+//sound takes over an old one so mixing costs the same however
+//busy the game gets.  It doesn't start a thread or open a
+//device, the host calls Render with the frames the sink needs
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include "AudioClip.h"
+#include "AudioSink.h"
+#include "AudioResampler.h"
+#include "AudioStream.h"
+#include <vector>
+
+enum AudioLoop
+{
+	AUDIO_LOOP_OFF,		//the voice ends with its clip
+	AUDIO_LOOP_NORMAL	//back to the start, like FMOD_LOOP_NORMAL
+};
+
+//which voice a new sound takes over, among the least important ones
+enum AudioSteal
+{
+	AUDIO_STEAL_OLDEST,		//started longest ago
+	AUDIO_STEAL_QUIETEST	//lowest volume now
+};
+
+//how a sound competes for voices
+struct AudioLimit
+{
+	int		priority;	//a sound only takes over voices of the same or a lower one
+	int		maxVoices;	//of this clip at once, 0 for no cap of its own
+};
+
+//slot in the low 16 bits, generation in the high 16, 0 is never a voice
+typedef unsigned int AudioVoice;
+
+class AudioMixer
+{
+public:
+	static const int	BlockFrames=256;	//frames Render mixes at a time
+
+	AudioMixer();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Init
+	// Parameters:	int rate - output sample rate, clips are loaded at it
+	//				int voices - how many can be heard at once
+	// Return:		void
+	// Description:	Stops everything.  A quarter more voices are kept for
+	//				the ones fading out after being taken over, when those
+	//				run out too the fade is cut short.  Mixing uses the best
+	//				path built in, taking over the oldest voice.
+	//////////////////////////////////////////////////////////////////////////
+	void	Init(int rate, int voices);
+	int		Rate() const;
+	void	SetStealPolicy(AudioSteal steal);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Play
+	// Parameters:	const AudioClip* clip - must outlive the voice
+	//				float volume - 1 plays it as it is
+	//				AudioLoop loop - AUDIO_LOOP_ mode
+	//				bool bPaused - start paused, for music waiting its turn
+	//				const AudioLimit& limit - priority and the clip's cap
+	// Return:		AudioVoice - 0 if the clip is empty or every voice is
+	//				more important
+	// Description:	The same clip played again before the next Mix is
+	//				merged into the voice already started, at the louder of
+	//				the two volumes, and that voice is returned.
+	//////////////////////////////////////////////////////////////////////////
+	AudioVoice	Play(const AudioClip* clip, float volume, AudioLoop loop, bool bPaused, const AudioLimit& limit);
+	AudioVoice	Play(const AudioClip* clip, float volume, AudioLoop loop, bool bPaused); //lowest priority, no cap of its own
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		PlayStream
+	// Parameters:	AudioStream* stream - open, must outlive the voice
+	//				float volume, bool bPaused, const AudioLimit& limit - as
+	//					for Play, the stream's own loop setting is used
+	// Return:		AudioVoice - 0 if every voice is more important
+	// Description:	Goes on from wherever the stream is.  Its voice stops if
+	//				it had one.  The stream decodes only while its voice is
+	//				playing and can be heard, a silent one holds its place
+	//				and a paused one keeps what it has decoded.  Pitch is
+	//				ignored.
+	//////////////////////////////////////////////////////////////////////////
+	AudioVoice	PlayStream(AudioStream* stream, float volume, bool bPaused, const AudioLimit& limit);
+
+	//the voice calls do nothing for a voice that has ended
+	void	Stop(AudioVoice voice);						//fades out over the ramp, then ends
+	void	StopAll();									//at once, before clips are released
+	void	StopClip(const AudioClip* clip);			//every voice of it at once, before it is released
+	void	SetVolume(AudioVoice voice, float volume);	//ramped
+	void	SetPan(AudioVoice voice, float pan);		//-1 left to 1 right, ramped
+	void	SetPitch(AudioVoice voice, float pitch);	//1 as recorded, 2 an octave up and the most, 1/8 the least
+	void	SetPaused(AudioVoice voice, bool bPaused);
+	bool	IsPlaying(AudioVoice voice) const;			//paused ones too
+	int		Voices() const;								//playing now, fading out ones too
+	int		Steals() const;								//voices taken over since Init
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Mix
+	// Parameters:	float* out - frames * 2 floats, left then right
+	//				int frames - how many to mix
+	// Return:		void
+	// Description:	Overwrites out with the sum of every voice and moves
+	//				them on.  Not clipped, the sink does that.
+	//////////////////////////////////////////////////////////////////////////
+	void	Mix(float* out, int frames);
+	bool	Render(AudioSink& sink, int frames); //Mix in blocks to the sink, false if it failed
+
+	bool				SetMixPath(AudioMixPath path); //false if it isn't built in, for benchmarks, the resampling too
+	AudioMixPath		MixPath() const;
+	static AudioMixPath	BestMixPath();
+
+private:
+	struct Voice
+	{
+		const AudioClip*	clip;		//0 when free, unless stream is set
+		AudioStream*		stream;
+		unsigned int		generation;	//1 to 65535, bumped when it ends
+		int					position;	//next frame of the clip
+		AudioLoop			loop;
+		bool				bPaused;
+		bool				bStopping;	//ends when the ramp does
+		float				volume;
+		float				pan;
+		float				gain[2];	//left and right now
+		float				target[2];	//what the ramp is heading for
+		int					ramp;		//frames left on the ramp, 0 when at the target
+		int					priority;
+		unsigned int		started;	//Play count when it started, for stealing the oldest
+		bool				bMixed;		//Mix has been through it since Play
+		float				pitch;
+		double				phase;		//how far past position a pitched voice is, 0 to 1
+	};
+
+	static bool	IsFree(const Voice& voice);
+	Voice*	Find(AudioVoice voice);
+	Voice*	Victim(const AudioClip* clip, int priority);	//least important of the clip's, or of all with clip 0
+	Voice*	Claim(Voice* pVictim);	//the victim stopped and a voice to start on, 0 if there are none
+	AudioVoice	Start(size_t slot, const AudioClip* clip, float volume, AudioLoop loop, bool bPaused, int priority);
+	void	SetTarget(Voice& voice, float volume, float pan);
+	void	MixVoice(Voice& voice, float* out, int frames);
+	void	MixStream(Voice& voice, float* out, int frames);
+	const AudioResampler&	Resampler(float pitch) const;
+	void	End(Voice& voice);
+
+private:
+	std::vector<Voice>	m_Voices;
+	std::vector<float>	m_Block;		//Render's buffer
+	std::vector<float>	m_VoiceBlock;	//a pitched voice's block resampled, or a stream's
+	AudioResampler		m_Resamplers[3];	//for pitches up to 1, 1.5 and 2, a higher step needs a lower cutoff
+	int					m_Rate;
+	int					m_RampFrames;	//5ms at the rate
+	AudioMixPath		m_Path;
+	int					m_MaxVoices;	//heard at once, the rest of m_Voices are for fading out
+	AudioSteal			m_Steal;
+	unsigned int		m_Plays;
+	int					m_Steals;
+};
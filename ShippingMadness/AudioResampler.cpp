@@ -0,0 +1,217 @@
+////////////////////////////////////////////////////////////////
+//AudioResampler member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "AudioResampler.h"
+#include <math.h>
+
+//the same switches as the mixer's loops
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AUDIO_RESAMPLER_SSE
+#include <emmintrin.h>
+#endif
+#if defined(__AVX__)
+#define AUDIO_RESAMPLER_AVX
+#include <immintrin.h>
+#endif
+
+//passband edge as a fraction of the input's Nyquist, the Kaiser window's
+//transition band sits around it.  Beta 7 puts the stopband near -70dB
+static const double Cutoff=0.86;
+static const double KaiserBeta=7.0;
+static const double Pi=3.14159265358979323846;
+
+//zeroth order modified Bessel function, the series converges quickly
+static double BesselI0(double x)
+{
+	double sum=1.0, term=1.0;
+	for(int k=1; k < 32; k++)
+	{
+		term*=(x / (2.0 * k)) * (x / (2.0 * k));
+		sum+=term;
+	}
+	return sum;
+}
+
+//the windowed sinc t input frames from the output frame, cutoff a fraction
+//of the input's Nyquist
+static double Kernel(double t, double cutoff)
+{
+	double half=AudioResampler::Taps / 2;
+	if(t <= -half || t >= half)
+		return 0.0;
+	double x=Pi * cutoff * t;
+	double sinc=x == 0.0 ? 1.0 : sin(x) / x;
+	double edge=t / half;
+	return cutoff * sinc * BesselI0(KaiserBeta * sqrt(1.0 - edge * edge)) / BesselI0(KaiserBeta);
+}
+
+AudioResampler::AudioResampler()
+{
+	m_MaxStep=0.0;
+	m_Path=BestMixPath();
+}
+
+void AudioResampler::Init(double maxStep)
+{
+	m_MaxStep=maxStep;
+	m_Path=BestMixPath();
+	double cutoff=maxStep > 1.0 ? Cutoff / maxStep : Cutoff;
+
+	//the window starts Taps/2 - 1 frames before the one the output falls
+	//after, each phase is scaled to a gain of 1 so a flat input stays flat
+	std::vector<double> filters((Phases + 1) * Taps);
+	for(int phase=0; phase <= Phases; phase++)
+	{
+		double* filter=&filters[phase * Taps];
+		double sum=0.0;
+		for(int tap=0; tap < Taps; tap++)
+		{
+			filter[tap]=Kernel(tap - (Taps / 2 - 1) - (double)phase / Phases,cutoff);
+			sum+=filter[tap];
+		}
+		for(int tap=0; tap < Taps; tap++)
+			filter[tap]/=sum;
+	}
+
+	m_Filters.resize(Phases * Taps * 4);
+	for(int phase=0; phase < Phases; phase++)
+	{
+		float* coefficients=&m_Filters[phase * Taps * 4];
+		float* steps=coefficients + Taps * 2;
+		for(int tap=0; tap < Taps; tap++)
+		{
+			double value=filters[phase * Taps + tap];
+			double next=filters[(phase + 1) * Taps + tap];
+			coefficients[tap * 2]=coefficients[tap * 2 + 1]=(float)value;
+			steps[tap * 2]=steps[tap * 2 + 1]=(float)(next - value);
+		}
+	}
+}
+
+double AudioResampler::MaxStep() const
+{
+	return m_MaxStep;
+}
+
+int AudioResampler::Process(const float* in, int inFrames, bool bLoop, double& position, double step, float* out, int frames) const
+{
+	if(m_Filters.empty() || inFrames <= 0)
+		return 0;
+
+	float window[Taps * 2];
+	int made=0;
+	for(; made < frames; made++)
+	{
+		if(position >= inFrames || position < 0.0)
+		{
+			if(!bLoop)
+				break;
+			position-=floor(position / inFrames) * inFrames;
+		}
+
+		int frame=(int)position;
+		double fraction=(position - frame) * Phases;
+		int phase=(int)fraction;
+		int first=frame - (Taps / 2 - 1);
+
+		//inside the clip the filter reads it in place, near the ends it reads a
+		//copy with silence or the other end filled in
+		const float* source=in + first * 2;
+		if(first < 0 || first + Taps > inFrames)
+		{
+			for(int tap=0; tap < Taps; tap++)
+			{
+				int index=first + tap;
+				if(bLoop)
+					index=(index % inFrames + inFrames) % inFrames;
+				bool bInside=index >= 0 && index < inFrames;
+				window[tap * 2]=bInside ? in[index * 2] : 0.0f;
+				window[tap * 2 + 1]=bInside ? in[index * 2 + 1] : 0.0f;
+			}
+			source=window;
+		}
+
+		Filter(source,phase,(float)(fraction - phase),out + made * 2);
+		position+=step;
+	}
+	return made;
+}
+
+void AudioResampler::Filter(const float* window, int phase, float fraction, float* out) const
+{
+	//the coefficients for the fraction are worked out as they are used,
+	//coefficient + step * fraction, so the table only holds whole phases
+	const float* coefficients=&m_Filters[phase * Taps * 4];
+	const float* steps=coefficients + Taps * 2;
+#ifdef AUDIO_RESAMPLER_AVX
+	if(m_Path == AUDIO_MIX_AVX)
+	{
+		__m256 blend=_mm256_set1_ps(fraction);
+		__m256 sum0=_mm256_setzero_ps(), sum1=_mm256_setzero_ps();
+		for(int i=0; i < Taps * 2; i+=16)
+		{
+			__m256 c0=_mm256_add_ps(_mm256_loadu_ps(coefficients + i),_mm256_mul_ps(_mm256_loadu_ps(steps + i),blend));
+			__m256 c1=_mm256_add_ps(_mm256_loadu_ps(coefficients + i + 8),_mm256_mul_ps(_mm256_loadu_ps(steps + i + 8),blend));
+			sum0=_mm256_add_ps(sum0,_mm256_mul_ps(_mm256_loadu_ps(window + i),c0));
+			sum1=_mm256_add_ps(sum1,_mm256_mul_ps(_mm256_loadu_ps(window + i + 8),c1));
+		}
+		sum0=_mm256_add_ps(sum0,sum1);
+		__m128 sum=_mm_add_ps(_mm256_castps256_ps128(sum0),_mm256_extractf128_ps(sum0,1));
+		sum=_mm_add_ps(sum,_mm_movehl_ps(sum,sum)); //left and right pairs
+		_mm_storel_pi((__m64*)out,sum);
+		return;
+	}
+#endif
+#ifdef AUDIO_RESAMPLER_SSE
+	if(m_Path != AUDIO_MIX_SCALAR)
+	{
+		__m128 blend=_mm_set1_ps(fraction);
+		__m128 sum0=_mm_setzero_ps(), sum1=_mm_setzero_ps();
+		for(int i=0; i < Taps * 2; i+=8)
+		{
+			__m128 c0=_mm_add_ps(_mm_loadu_ps(coefficients + i),_mm_mul_ps(_mm_loadu_ps(steps + i),blend));
+			__m128 c1=_mm_add_ps(_mm_loadu_ps(coefficients + i + 4),_mm_mul_ps(_mm_loadu_ps(steps + i + 4),blend));
+			sum0=_mm_add_ps(sum0,_mm_mul_ps(_mm_loadu_ps(window + i),c0));
+			sum1=_mm_add_ps(sum1,_mm_mul_ps(_mm_loadu_ps(window + i + 4),c1));
+		}
+		sum0=_mm_add_ps(sum0,sum1);
+		sum0=_mm_add_ps(sum0,_mm_movehl_ps(sum0,sum0));
+		_mm_storel_pi((__m64*)out,sum0);
+		return;
+	}
+#endif
+	float left=0.0f, right=0.0f;
+	for(int tap=0; tap < Taps; tap++)
+	{
+		float coefficient=coefficients[tap * 2] + steps[tap * 2] * fraction;
+		left+=window[tap * 2] * coefficient;
+		right+=window[tap * 2 + 1] * coefficient;
+	}
+	out[0]=left;
+	out[1]=right;
+}
+
+bool AudioResampler::SetMixPath(AudioMixPath path)
+{
+	if(path > BestMixPath())
+		return false;
+	m_Path=path;
+	return true;
+}
+
+AudioMixPath AudioResampler::MixPath() const
+{
+	return m_Path;
+}
+
+AudioMixPath AudioResampler::BestMixPath()
+{
+#if defined(AUDIO_RESAMPLER_AVX)
+	return AUDIO_MIX_AVX;
+#elif defined(AUDIO_RESAMPLER_SSE)
+	return AUDIO_MIX_SSE;
+#else
+	return AUDIO_MIX_SCALAR;
+#endif
+}
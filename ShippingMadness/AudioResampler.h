@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////
+//Audio Resampler, rate conversion of float stereo with a band
+//limited polyphase filter.  Every output frame is a windowed
+//sinc over Taps input frames, the filter for where it falls
+//between two input frames interpolated from a table of Phases
+//of them.  Clips loaded at another rate go through it once, the
+//mixer runs it on a voice that plays at another pitch
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include <vector>
+
+//the SIMD loops of the mixer and the resampler, only the ones the
+//compiler targets are built in
+enum AudioMixPath
+{
+	AUDIO_MIX_SCALAR,
+	AUDIO_MIX_SSE,		//two frames a step, any x64 or /arch:SSE2 build
+	AUDIO_MIX_AVX		//four frames a step, /arch:AVX or -mavx builds
+};
+
+class AudioResampler
+{
+public:
+	static const int	Taps=32;	//input frames behind each output frame
+	static const int	Phases=128;	//filters tabled between two input frames
+
+	AudioResampler();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Init
+	// Parameters:	double maxStep - the most input frames per output frame
+	//					it will be used for.  Above 1 the cutoff comes down
+	//					with it so nothing folds back past the output's
+	//					Nyquist, 1 or less keeps the whole input band
+	// Return:		void
+	// Description:	Builds the filter table, 64KB.  Uses the best path
+	//				built in.
+	//////////////////////////////////////////////////////////////////////////
+	void	Init(double maxStep);
+	double	MaxStep() const;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Process
+	// Parameters:	const float* in - stereo frames, left then right
+	//				int inFrames - how many
+	//				bool bLoop - the filter reads round the ends of in, for
+	//					a looping voice, instead of silence past them
+	//				double& position - input frame the first output lands
+	//					on, moved past the last one.  Kept inside in when
+	//					looping
+	//				double step - input frames per output frame, above
+	//					MaxStep it aliases
+	//				float* out - frames * 2 floats, overwritten
+	//				int frames - how many to make
+	// Return:		int - frames made, fewer once position passes the end
+	//				of in when it doesn't loop
+	//////////////////////////////////////////////////////////////////////////
+	int		Process(const float* in, int inFrames, bool bLoop, double& position, double step, float* out, int frames) const;
+
+	bool				SetMixPath(AudioMixPath path); //false if it isn't built in, for benchmarks
+	AudioMixPath		MixPath() const;
+	static AudioMixPath	BestMixPath();
+
+private:
+	void	Filter(const float* window, int phase, float fraction, float* out) const;
+
+private:
+	std::vector<float>	m_Filters;	//a phase is Taps*2 coefficients, each twice for left and right, then Taps*2 steps to the next phase
+	double				m_MaxStep;
+	AudioMixPath		m_Path;
+};
@@ -0,0 +1,118 @@
+////////////////////////////////////////////////////////////////
+//AudioSink member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "AudioSink.h"
+#include <string.h>
+
+static void Put16(unsigned char* p, unsigned int value)
+{
+	p[0]=(unsigned char)value;
+	p[1]=(unsigned char)(value >> 8);
+}
+
+static void Put32(unsigned char* p, unsigned int value)
+{
+	Put16(p,value);
+	Put16(p + 2,value >> 16);
+}
+
+NullAudioSink::NullAudioSink()
+{
+	m_Frames=0;
+}
+
+bool NullAudioSink::Open(int rate)
+{
+	m_Frames=0;
+	return rate > 0;
+}
+
+bool NullAudioSink::Write(const float* /*samples*/, int frames)
+{
+	m_Frames+=frames;
+	return true;
+}
+
+void NullAudioSink::Close()
+{
+}
+
+long long NullAudioSink::Frames() const
+{
+	return m_Frames;
+}
+
+WaveFileSink::WaveFileSink(const char* filename)
+{
+	m_Filename=filename ? filename : "";
+	m_pFile=0;
+	m_Rate=0;
+	m_DataBytes=0;
+}
+
+WaveFileSink::~WaveFileSink()
+{
+	Close();
+}
+
+bool WaveFileSink::Open(int rate)
+{
+	Close();
+	m_pFile=fopen(m_Filename.c_str(),"wb");
+	if(!m_pFile || rate <= 0)
+	{
+		Close();
+		return false;
+	}
+	m_Rate=rate;
+	m_DataBytes=0;
+
+	//room for the header, Close writes it once the length is known
+	unsigned char header[44]={0};
+	return fwrite(header,1,sizeof(header),m_pFile) == sizeof(header);
+}
+
+bool WaveFileSink::Write(const float* samples, int frames)
+{
+	if(!m_pFile)
+		return false;
+	if(frames <= 0)
+		return true;
+
+	m_Buffer.resize((size_t)frames * 4);
+	unsigned char* out=&m_Buffer[0];
+	for(int i=0; i < frames * 2; i++)
+	{
+		float sample=samples[i] * 32767.0f;
+		sample=sample < -32768.0f ? -32768.0f : sample > 32767.0f ? 32767.0f : sample;
+		int value=(int)(sample < 0.0f ? sample - 0.5f : sample + 0.5f);
+		Put16(out + i * 2,(unsigned int)value);
+	}
+	m_DataBytes+=(unsigned int)m_Buffer.size();
+	return fwrite(out,1,m_Buffer.size(),m_pFile) == m_Buffer.size();
+}
+
+void WaveFileSink::Close()
+{
+	if(!m_pFile)
+		return;
+
+	unsigned char header[44];
+	memcpy(header,"RIFF",4);
+	Put32(header + 4,36 + m_DataBytes);
+	memcpy(header + 8,"WAVEfmt ",8);
+	Put32(header + 16,16);
+	Put16(header + 20,1);					//PCM
+	Put16(header + 22,2);					//stereo
+	Put32(header + 24,m_Rate);
+	Put32(header + 28,m_Rate * 4);			//bytes a second
+	Put16(header + 32,4);					//bytes a frame
+	Put16(header + 34,16);
+	memcpy(header + 36,"data",4);
+	Put32(header + 40,m_DataBytes);
+	fseek(m_pFile,0,SEEK_SET);
+	fwrite(header,1,sizeof(header),m_pFile);
+	fclose(m_pFile);
+	m_pFile=0;
+}
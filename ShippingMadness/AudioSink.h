@@ -0,0 +1,61 @@
+///////////////////////////////////////////////////////////////
+//Audio Sink, where the mixer's output goes.  Float stereo frames
+//in blocks, a sink turns them into whatever its device wants.
+//The null sink throws them away (benchmarks, headless runs) and
+//the WAV sink records them to a file to listen to or compare
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+class AudioSink
+{
+public:
+	virtual ~AudioSink() {}
+
+	virtual bool	Open(int rate) = 0;	//stereo at the mixer's rate
+	virtual bool	Write(const float* samples, int frames) = 0; //left, right, left, ... full scale at 1
+	virtual void	Close() = 0;
+};
+
+class NullAudioSink : public AudioSink
+{
+public:
+	NullAudioSink();
+
+	bool	Open(int rate);
+	bool	Write(const float* samples, int frames);
+	void	Close();
+
+	long long	Frames() const; //written since Open
+
+private:
+	long long	m_Frames;
+};
+
+class WaveFileSink : public AudioSink
+{
+public:
+	explicit WaveFileSink(const char* filename);
+	~WaveFileSink();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Open
+	// Parameters:	int rate - sample rate of what will be written
+	// Return:		bool - false if the file can't be created
+	// Description:	16 bit stereo PCM, clipped.  The header's sizes are
+	//				filled in by Close.
+	//////////////////////////////////////////////////////////////////////////
+	bool	Open(int rate);
+	bool	Write(const float* samples, int frames);
+	void	Close();
+
+private:
+	std::string					m_Filename;
+	FILE*						m_pFile;
+	int							m_Rate;
+	unsigned int				m_DataBytes;
+	std::vector<unsigned char>	m_Buffer;	//converted samples of one Write
+};
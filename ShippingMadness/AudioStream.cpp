@@ -0,0 +1,274 @@
+////////////////////////////////////////////////////////////////
+//AudioStream member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "AudioStream.h"
+#include "TraceLog.h"
+#include <math.h>
+#include <string.h>
+#include <chrono>
+
+//the filter reads this many frames either side of an output frame
+static const int HalfTaps=AudioResampler::Taps / 2;
+
+//enough of the start of a file for the format, the data chunk only has
+//to start in it
+static const size_t HeaderBytes=65536;
+
+AudioStream::AudioStream()
+{
+	m_pFile=0;
+	m_pData=0;
+	m_Size=0;
+	memset(&m_Format,0,sizeof(m_Format));
+	m_MixRate=0;
+	m_bLoop=false;
+	m_Position=0;
+	m_Step=1.0;
+	m_Phase=0.0;
+	m_Write=0;
+	m_Read=0;
+	m_bWanted=false;
+	m_bEnded=false;
+	m_bQuit=false;
+	m_bStarving=true;
+	m_Underruns=0;
+}
+
+AudioStream::~AudioStream()
+{
+	Close();
+}
+
+bool AudioStream::Open(const char* filename, int mixRate, bool bLoop)
+{
+	Close();
+	m_pFile=fopen(filename,"rb");
+	if(!m_pFile)
+		return false;
+	fseek(m_pFile,0,SEEK_END);
+	long size=ftell(m_pFile);
+	m_Size=size > 0 ? (size_t)size : 0;
+
+	std::vector<unsigned char> header(m_Size < HeaderBytes ? m_Size : HeaderBytes);
+	if(header.empty() || !ReadSource(0,header.size(),&header[0]) ||
+	   !AudioClip::ReadFormat(&header[0],header.size(),m_Size,m_Format) || !Start(mixRate,bLoop))
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+bool AudioStream::Open(const unsigned char* data, size_t size, int mixRate, bool bLoop)
+{
+	Close();
+	m_pData=data;
+	m_Size=size;
+	if(!data || !AudioClip::ReadFormat(data,size,size,m_Format) || !Start(mixRate,bLoop))
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void AudioStream::Close()
+{
+	if(m_Thread.joinable())
+	{
+		m_bQuit=true;
+		m_Thread.join();
+	}
+	if(m_pFile)
+		fclose(m_pFile);
+	m_pFile=0;
+	m_pData=0;
+	m_Size=0;
+	std::vector<float>().swap(m_Ring);
+	std::vector<float>().swap(m_Source);
+	std::vector<float>().swap(m_Output);
+	std::vector<unsigned char>().swap(m_Chunk);
+}
+
+bool AudioStream::IsOpen() const
+{
+	return m_Thread.joinable();
+}
+
+int AudioStream::Read(float* out, int frames)
+{
+	//ended is set after the last write, seen first it means that write is too
+	bool bEnded=m_bEnded;
+	unsigned int read=m_Read.load(std::memory_order_relaxed);
+	int ready=(int)(m_Write.load(std::memory_order_acquire) - read);
+	if(m_bStarving && ready < PrerollFrames && !bEnded)
+		return 0;
+	m_bStarving=false;
+
+	int count=frames < ready ? frames : ready;
+	int index=(int)(read & (RingFrames - 1));
+	int first=count < RingFrames - index ? count : RingFrames - index;
+	memcpy(out,&m_Ring[index * 2],(size_t)first * 2 * sizeof(float));
+	memcpy(out + first * 2,&m_Ring[0],(size_t)(count - first) * 2 * sizeof(float));
+	m_Read.store(read + count,std::memory_order_release);
+
+	if(count < frames && !bEnded)
+	{
+		m_bStarving=true;
+		m_Underruns++;
+	}
+	return count;
+}
+
+void AudioStream::SetWanted(bool bWanted)
+{
+	m_bWanted=bWanted;
+}
+
+bool AudioStream::IsFinished() const
+{
+	return m_bEnded && m_Read == m_Write;
+}
+
+int AudioStream::Underruns() const
+{
+	return m_Underruns;
+}
+
+bool AudioStream::Start(int mixRate, bool bLoop)
+{
+	if(mixRate <= 0)
+		return false;
+
+	m_MixRate=mixRate;
+	m_bLoop=bLoop;
+	m_Position=0;
+	m_Step=(double)m_Format.rate / mixRate;
+	if(m_Format.rate != mixRate)
+		m_Resampler.Init(m_Step);
+
+	//a chunk is about ChunkFrames once converted, whole frames or ADPCM blocks
+	int sourceFrames=(int)(ChunkFrames * m_Step);
+	sourceFrames=sourceFrames > 0 ? sourceFrames : 1;
+	int blocks=sourceFrames / m_Format.samplesPerBlock;
+	blocks=blocks > 0 ? blocks : 1;
+	m_Chunk.resize((size_t)blocks * m_Format.blockAlign);
+
+	//the filter starts on silence so the first output frame is the file's
+	//first, everything is allocated here and never grows
+	int decodedFrames=blocks * m_Format.samplesPerBlock;
+	m_Source.reserve((size_t)(decodedFrames + AudioResampler::Taps * 2) * 2);
+	m_Source.assign((size_t)(HalfTaps - 1) * 2,0.0f);
+	m_Phase=HalfTaps - 1;
+	int outputFrames=(int)((decodedFrames + AudioResampler::Taps * 2) / m_Step) + 2;
+	if(outputFrames > RingFrames)
+		return false; //a chunk would never fit in the ring
+	m_Output.reserve((size_t)outputFrames * 2);
+
+	m_Ring.assign((size_t)RingFrames * 2,0.0f);
+	m_Write=0;
+	m_Read=0;
+	m_bWanted=false;
+	m_bEnded=false;
+	m_bQuit=false;
+	m_bStarving=true;
+	m_Underruns=0;
+	m_Thread=std::thread(&AudioStream::Run,this);
+	return true;
+}
+
+bool AudioStream::ReadSource(size_t offset, size_t bytes, unsigned char* out)
+{
+	if(offset > m_Size || bytes > m_Size - offset)
+		return false;
+	if(m_pData)
+	{
+		memcpy(out,m_pData + offset,bytes);
+		return true;
+	}
+	return fseek(m_pFile,(long)offset,SEEK_SET) == 0 && fread(out,1,bytes,m_pFile) == bytes;
+}
+
+void AudioStream::Run()
+{
+	TraceLog::NameThread("Audio stream");
+	bool bEnd=false;
+	while(!m_bQuit)
+	{
+		//what was converted goes in as soon as it fits
+		int pending=(int)(m_Output.size() / 2);
+		int space=RingFrames - (int)(m_Write.load(std::memory_order_relaxed) - m_Read.load(std::memory_order_acquire));
+		if(pending && pending <= space)
+		{
+			Write(&m_Output[0],pending);
+			m_Output.clear();
+			continue;
+		}
+		if(!pending && bEnd)
+		{
+			m_bEnded=true;
+		}
+		else if(!pending && m_bWanted)
+		{
+			//paused or silent streams never get here, they keep what they have
+			bEnd=!DecodeChunk();
+			continue;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+}
+
+bool AudioStream::DecodeChunk()
+{
+	//whole frames or blocks only, a looping stream goes round at the end
+	size_t left=m_Format.dataSize - m_Position;
+	left-=left % m_Format.blockAlign;
+	if(!left && m_bLoop && m_Position)
+	{
+		m_Position=0;
+		left=m_Format.dataSize - m_Format.dataSize % m_Format.blockAlign;
+	}
+	size_t bytes=left < m_Chunk.size() ? left : m_Chunk.size();
+	bool bDecoded=bytes && ReadSource(m_Format.dataOffset + m_Position,bytes,&m_Chunk[0]) &&
+				  AudioClip::Decode(m_Format,&m_Chunk[0],bytes,m_Source);
+	m_Position+=bytes;
+	bool bMore=bDecoded && (m_bLoop || m_Position + m_Format.blockAlign <= m_Format.dataSize);
+	if(!bMore)
+		m_Source.resize(m_Source.size() + AudioResampler::Taps * 2,0.0f); //the filter's tail, then silence
+
+	if(m_Format.rate == m_MixRate)
+	{
+		//nothing to convert, the history is never used
+		m_Output.insert(m_Output.end(),m_Source.begin() + (HalfTaps - 1) * 2,m_Source.end());
+		m_Source.resize((size_t)(HalfTaps - 1) * 2);
+		return bMore;
+	}
+
+	//every output frame the filter has all its input for, then the history
+	//the next one needs moves to the front
+	int available=(int)(m_Source.size() / 2);
+	double limit=available - HalfTaps;
+	int frames=limit > m_Phase ? (int)ceil((limit - m_Phase) / m_Step) : 0;
+	size_t start=m_Output.size();
+	m_Output.resize(start + (size_t)frames * 2);
+	frames=m_Resampler.Process(&m_Source[0],available,false,m_Phase,m_Step,frames ? &m_Output[start] : 0,frames);
+	m_Output.resize(start + (size_t)frames * 2);
+	int used=(int)m_Phase - (HalfTaps - 1);
+	if(used > 0)
+	{
+		m_Source.erase(m_Source.begin(),m_Source.begin() + (size_t)used * 2);
+		m_Phase-=used;
+	}
+	return bMore;
+}
+
+void AudioStream::Write(const float* samples, int frames)
+{
+	unsigned int write=m_Write.load(std::memory_order_relaxed);
+	int index=(int)(write & (RingFrames - 1));
+	int first=frames < RingFrames - index ? frames : RingFrames - index;
+	memcpy(&m_Ring[index * 2],samples,(size_t)first * 2 * sizeof(float));
+	memcpy(&m_Ring[0],samples + first * 2,(size_t)(frames - first) * 2 * sizeof(float));
+	m_Write.store(write + frames,std::memory_order_release); //the frames are there before the index says so
+}
@@ -0,0 +1,99 @@
+///////////////////////////////////////////////////////////////
+//Audio Stream, music too long to decode up front.  A thread of
+//its own reads the WAV file a piece at a time, converts it to
+//the mixer's rate and keeps a fixed size ring of it decoded
+//ahead.  The mixer reads the ring without locking.  The thread
+//only works while the mixer wants the stream, a paused or
+//silent stream costs nothing but the ring's memory
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include "AudioClip.h"
+#include "AudioResampler.h"
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class AudioStream
+{
+public:
+	static const int	RingFrames=16384;	//at the mixer's rate, about 370ms at 44.1kHz
+	static const int	PrerollFrames=2048;	//decoded before the mixer starts, and again after it runs dry
+	static const int	ChunkFrames=4096;	//decoded at a time, at the mixer's rate
+
+	AudioStream();
+	~AudioStream();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Open
+	// Parameters:	const char* filename - a .wav file, read as it plays
+	//				const unsigned char* data, size_t size - or one already
+	//					in memory (the archive's mapping) that outlives it
+	//				int mixRate - the mixer's rate, it is converted to it
+	//				bool bLoop - back to the start at the end, like music
+	// Return:		bool - false for a file AudioClip doesn't read
+	// Description:	Starts the decoding thread, which waits for the mixer
+	//				to want the stream before filling the ring.
+	//////////////////////////////////////////////////////////////////////////
+	bool	Open(const char* filename, int mixRate, bool bLoop);
+	bool	Open(const unsigned char* data, size_t size, int mixRate, bool bLoop);
+
+	//stops the thread, the mixer must be done with it
+	void	Close();
+	bool	IsOpen() const;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Read
+	// Parameters:	float* out - frames * 2 floats, left then right
+	//				int frames - how many are wanted
+	// Return:		int - how many are in out.  Nothing until PrerollFrames
+	//				are ready when starting or after running dry, and fewer
+	//				than asked when it runs dry
+	// Description:	The mixer's side, one reader only.
+	//////////////////////////////////////////////////////////////////////////
+	int		Read(float* out, int frames);
+
+	//the mixer's side too, the thread stops decoding when it isn't wanted
+	void	SetWanted(bool bWanted);
+	bool	IsFinished() const;	//a stream that doesn't loop has been read to the end
+	int		Underruns() const;	//times Read ran dry since Open, from any thread
+
+private:
+	bool	Start(int mixRate, bool bLoop);
+	bool	ReadSource(size_t offset, size_t bytes, unsigned char* out);
+	void	Run();
+	bool	DecodeChunk();		//false once a stream that doesn't loop has ended
+	void	Write(const float* samples, int frames);
+
+private:
+	//where the file comes from
+	FILE*						m_pFile;
+	const unsigned char*		m_pData;
+	size_t						m_Size;
+	WaveFormat					m_Format;
+
+	//the decoding thread's own
+	std::thread					m_Thread;
+	int							m_MixRate;
+	bool						m_bLoop;
+	size_t						m_Position;	//bytes into the data chunk
+	double						m_Step;		//file frames per mixer frame
+	double						m_Phase;	//where the next output frame falls in m_Source
+	AudioResampler				m_Resampler;
+	std::vector<unsigned char>	m_Chunk;	//read from the file
+	std::vector<float>			m_Source;	//decoded at the file's rate, the filter's history first
+	std::vector<float>			m_Output;	//converted, waiting to go into the ring
+
+	//shared, the ring is written by the thread and read by Read
+	std::vector<float>			m_Ring;
+	std::atomic<unsigned int>	m_Write;	//frames written ever, wraps
+	std::atomic<unsigned int>	m_Read;
+	std::atomic<bool>			m_bWanted;
+	std::atomic<bool>			m_bEnded;	//everything the file holds is in the ring
+	std::atomic<bool>			m_bQuit;
+
+	//written by the reader
+	bool						m_bStarving;
+	std::atomic<int>			m_Underruns;
+};
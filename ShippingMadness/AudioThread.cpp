@@ -0,0 +1,336 @@
+////////////////////////////////////////////////////////////////
+//AudioThread member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "AudioThread.h"
+#include "FramePacer.h"
+#include "TraceLog.h"
+#include <chrono>
+
+static const int CueSlots=256;
+
+AudioCommandQueue::AudioCommandQueue(int capacity)
+{
+	unsigned int size=2;
+	while(size < (unsigned int)capacity)
+		size*=2;
+	m_Ring.resize(size);
+	m_Mask=size - 1;
+	m_Write=0;
+	m_ReadCache=0;
+	m_Read=0;
+	m_WriteCache=0;
+}
+
+bool AudioCommandQueue::Push(const AudioCommand& command)
+{
+	//the indices only ever count up, the difference is how full it is
+	unsigned int write=m_Write.load(std::memory_order_relaxed);
+	if(write - m_ReadCache > m_Mask)
+	{
+		m_ReadCache=m_Read.load(std::memory_order_acquire);
+		if(write - m_ReadCache > m_Mask)
+			return false;
+	}
+	m_Ring[write & m_Mask]=command;
+	m_Write.store(write + 1,std::memory_order_release); //the command is visible before the index
+	return true;
+}
+
+bool AudioCommandQueue::Pop(AudioCommand& command)
+{
+	unsigned int read=m_Read.load(std::memory_order_relaxed);
+	if(read == m_WriteCache)
+	{
+		m_WriteCache=m_Write.load(std::memory_order_acquire);
+		if(read == m_WriteCache)
+			return false;
+	}
+	command=m_Ring[read & m_Mask];
+	m_Read.store(read + 1,std::memory_order_release); //the slot is free once copied
+	return true;
+}
+
+AudioThread::AudioThread()
+	: m_Commands(QueueCommands), m_Released(QueueCommands)
+{
+	m_Clock=AUDIO_CLOCK_REALTIME;
+	m_NextCue=1;
+	m_Unsent=0;
+	m_Dropped=0;
+	m_Releasing=0;
+	m_pSink=0;
+	m_MixedFrames=0;
+	m_MixSeconds=0.0;
+	m_Voices=0;
+	m_Steals=0;
+	m_bFailed=false;
+}
+
+AudioThread::~AudioThread()
+{
+	Shutdown();
+}
+
+bool AudioThread::Start(AudioSink* sink, int rate, int voices, AudioClock clock)
+{
+	if(m_Thread.joinable() || !sink)
+		return false;
+
+	//set up before the thread exists, from then on only it touches these
+	m_Mixer.Init(rate,voices);
+	m_pSink=sink;
+	m_Clock=clock;
+	CueVoice none={0,0};
+	m_Cues.assign(CueSlots,none);
+	m_MixedFrames=0;
+	m_MixSeconds=0.0;
+	m_Voices=0;
+	m_Steals=0;
+	m_bFailed=false;
+	m_Thread=std::thread(&AudioThread::Run,this);
+	return true;
+}
+
+void AudioThread::Shutdown()
+{
+	if(!m_Thread.joinable())
+		return;
+
+	//these two can't be dropped, the thread is emptying the queue
+	AudioCommand command={AUDIO_COMMAND_ADVANCE,0,0,0.0f,AUDIO_LOOP_OFF,false,{0,0},0,0,0,0};
+	command.frames=m_Unsent;
+	while(m_Unsent && !m_Commands.Push(command))
+		std::this_thread::yield();
+	m_Unsent=0;
+	command.type=AUDIO_COMMAND_QUIT;
+	while(!m_Commands.Push(command))
+		std::this_thread::yield();
+	m_Thread.join();
+}
+
+AudioCue AudioThread::Play(const AudioClip* clip, float volume, AudioLoop loop, bool bPaused, const AudioLimit& limit)
+{
+	AudioCommand command={AUDIO_COMMAND_PLAY,m_NextCue,clip,volume,loop,bPaused,limit,0,0,0,0};
+	if(!Post(command))
+		return 0;
+	m_NextCue=m_NextCue + 1 ? m_NextCue + 1 : 1;
+	return command.cue;
+}
+
+AudioCue AudioThread::PlayStream(AudioStream* stream, float volume, bool bPaused, const AudioLimit& limit)
+{
+	AudioCommand command={AUDIO_COMMAND_PLAY_STREAM,m_NextCue,0,volume,AUDIO_LOOP_OFF,bPaused,limit,0,stream,0,0};
+	if(!Post(command))
+		return 0;
+	m_NextCue=m_NextCue + 1 ? m_NextCue + 1 : 1;
+	return command.cue;
+}
+
+void AudioThread::Stop(AudioCue cue)
+{
+	AudioCommand command={AUDIO_COMMAND_STOP,cue,0,0.0f,AUDIO_LOOP_OFF,false,{0,0},0,0,0,0};
+	Post(command);
+}
+
+void AudioThread::StopAll()
+{
+	AudioCommand command={AUDIO_COMMAND_STOP_ALL,0,0,0.0f,AUDIO_LOOP_OFF,false,{0,0},0,0,0,0};
+	Post(command);
+}
+
+void AudioThread::SetVolume(AudioCue cue, float volume)
+{
+	AudioCommand command={AUDIO_COMMAND_VOLUME,cue,0,volume,AUDIO_LOOP_OFF,false,{0,0},0,0,0,0};
+	Post(command);
+}
+
+void AudioThread::SetPan(AudioCue cue, float pan)
+{
+	AudioCommand command={AUDIO_COMMAND_PAN,cue,0,pan,AUDIO_LOOP_OFF,false,{0,0},0,0,0,0};
+	Post(command);
+}
+
+void AudioThread::SetPitch(AudioCue cue, float pitch)
+{
+	AudioCommand command={AUDIO_COMMAND_PITCH,cue,0,pitch,AUDIO_LOOP_OFF,false,{0,0},0,0,0,0};
+	Post(command);
+}
+
+void AudioThread::SetPaused(AudioCue cue, bool bPaused)
+{
+	AudioCommand command={AUDIO_COMMAND_PAUSE,cue,0,0.0f,AUDIO_LOOP_OFF,bPaused,{0,0},0,0,0,0};
+	Post(command);
+}
+
+bool AudioThread::ReleaseClip(const AudioClip* clip)
+{
+	//no more out than the way back holds, so the audio thread never waits on it
+	if(!clip || m_Releasing >= QueueCommands)
+		return false;
+	AudioCommand command={AUDIO_COMMAND_RELEASE_CLIP,0,clip,0.0f,AUDIO_LOOP_OFF,false,{0,0},0,0,0,0};
+	if(!Post(command))
+		return false;
+	m_Releasing++;
+	return true;
+}
+
+const AudioClip* AudioThread::TakeReleased()
+{
+	AudioCommand command;
+	if(!m_Released.Pop(command))
+		return 0;
+	m_Releasing--;
+	return command.clip;
+}
+
+void AudioThread::Advance(int frames)
+{
+	if(m_Clock != AUDIO_CLOCK_GAME || frames + m_Unsent <= 0)
+		return;
+
+	AudioCommand command={AUDIO_COMMAND_ADVANCE,0,0,0.0f,AUDIO_LOOP_OFF,false,{0,0},0,0,0,0};
+	command.frames=frames + m_Unsent;
+	m_Unsent=m_Commands.Push(command) ? 0 : command.frames;
+}
+
+long long AudioThread::MixedFrames() const
+{
+	return m_MixedFrames;
+}
+
+double AudioThread::MixSeconds() const
+{
+	return m_MixSeconds;
+}
+
+int AudioThread::Voices() const
+{
+	return m_Voices;
+}
+
+int AudioThread::Steals() const
+{
+	return m_Steals;
+}
+
+bool AudioThread::HasFailed() const
+{
+	return m_bFailed;
+}
+
+int AudioThread::Dropped() const
+{
+	return m_Dropped;
+}
+
+bool AudioThread::Post(const AudioCommand& command)
+{
+	//never waits, a sound lost when the audio thread is that far behind is
+	//better than a frame held up
+	if(!m_Thread.joinable() || !m_Commands.Push(command))
+	{
+		m_Dropped++;
+		return false;
+	}
+	return true;
+}
+
+void AudioThread::Run()
+{
+	TraceLog::NameThread("Audio thread");
+	double start=FramePacer::Now();
+	for(;;)
+	{
+		//the game clock mixes inside Apply, between the commands either side
+		AudioCommand command;
+		while(m_Commands.Pop(command))
+		{
+			if(!Apply(command))
+				return;
+		}
+
+		if(m_Clock == AUDIO_CLOCK_REALTIME)
+		{
+			long long due=(long long)((FramePacer::Now() - start) * m_Mixer.Rate()) + LatencyFrames - m_MixedFrames;
+			if(due >= AudioMixer::BlockFrames)
+			{
+				Render((int)(due - due % AudioMixer::BlockFrames));
+				continue;
+			}
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+bool AudioThread::Apply(const AudioCommand& command)
+{
+	switch(command.type)
+	{
+	case AUDIO_COMMAND_PLAY:
+	case AUDIO_COMMAND_PLAY_STREAM:
+		{
+			CueVoice& entry=m_Cues[command.cue & (CueSlots - 1)];
+			entry.cue=command.cue;
+			if(command.type == AUDIO_COMMAND_PLAY)
+				entry.voice=m_Mixer.Play(command.clip,command.value,command.loop,command.bPaused,command.limit);
+			else
+				entry.voice=m_Mixer.PlayStream(command.stream,command.value,command.bPaused,command.limit);
+			m_Steals=m_Mixer.Steals();
+		}
+		break;
+	case AUDIO_COMMAND_STOP:
+		m_Mixer.Stop(Voice(command.cue));
+		break;
+	case AUDIO_COMMAND_STOP_ALL:
+		m_Mixer.StopAll();
+		break;
+	case AUDIO_COMMAND_VOLUME:
+		m_Mixer.SetVolume(Voice(command.cue),command.value);
+		break;
+	case AUDIO_COMMAND_PAN:
+		m_Mixer.SetPan(Voice(command.cue),command.value);
+		break;
+	case AUDIO_COMMAND_PITCH:
+		m_Mixer.SetPitch(Voice(command.cue),command.value);
+		break;
+	case AUDIO_COMMAND_PAUSE:
+		m_Mixer.SetPaused(Voice(command.cue),command.bPaused);
+		break;
+	case AUDIO_COMMAND_RELEASE_CLIP:
+		m_Mixer.StopClip(command.clip);
+		m_Released.Push(command); //ReleaseClip made sure there is room
+		break;
+	case AUDIO_COMMAND_ADVANCE:
+		if(m_Clock == AUDIO_CLOCK_GAME)
+			Render(command.frames);
+		break;
+	case AUDIO_COMMAND_QUIT:
+		m_Mixer.StopAll(); //the clips and streams go away after Shutdown
+		m_Voices=0;
+		return false;
+	default:
+		break; //FmodThread's
+	}
+	m_Voices=m_Mixer.Voices();
+	return true;
+}
+
+AudioVoice AudioThread::Voice(AudioCue cue) const
+{
+	const CueVoice& entry=m_Cues[cue & (CueSlots - 1)];
+	return cue && entry.cue == cue ? entry.voice : 0;
+}
+
+void AudioThread::Render(int frames)
+{
+	if(m_bFailed)
+		return;
+
+	double start=FramePacer::Now();
+	if(!m_Mixer.Render(*m_pSink,frames))
+		m_bFailed=true;
+	m_MixSeconds=m_MixSeconds + (FramePacer::Now() - start);
+	m_MixedFrames=m_MixedFrames + frames;
+	m_Voices=m_Mixer.Voices();
+}
@@ -0,0 +1,200 @@
+///////////////////////////////////////////////////////////////
+//Audio Thread, owns an AudioMixer and its sink on a thread of
+//its own.  The game thread never touches the mixer, it posts
+//commands through a lock-free ring that only it writes and only
+//the audio thread reads, so a slow mix never holds up a frame
+//and a slow frame never holds up the mix
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include "AudioMixer.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+//game side name for a voice, the mixer's own handles stay on the audio
+//thread.  0 is never a cue
+typedef unsigned int AudioCue;
+
+//what moves the mix on
+enum AudioClock
+{
+	AUDIO_CLOCK_REALTIME,	//the wall clock, a little ahead, for a device
+	AUDIO_CLOCK_GAME		//only Advance, so a recording follows game time exactly
+};
+
+enum AudioCommandType
+{
+	AUDIO_COMMAND_PLAY,
+	AUDIO_COMMAND_PLAY_STREAM,
+	AUDIO_COMMAND_STOP,
+	AUDIO_COMMAND_STOP_ALL,
+	AUDIO_COMMAND_VOLUME,
+	AUDIO_COMMAND_PAN,
+	AUDIO_COMMAND_PITCH,
+	AUDIO_COMMAND_PAUSE,
+	AUDIO_COMMAND_RELEASE_CLIP,
+	AUDIO_COMMAND_ADVANCE,
+	AUDIO_COMMAND_QUIT,
+
+	//FmodThread's, which plays sounds by SND_ id
+	AUDIO_COMMAND_PLAY_SOUND,
+	AUDIO_COMMAND_MUSIC,
+	AUDIO_COMMAND_SOUND_GROUPS,
+	AUDIO_COMMAND_RELOAD_SOUND
+};
+
+struct AudioCommand
+{
+	AudioCommandType	type;
+	AudioCue			cue;
+	const AudioClip*	clip;		//PLAY and RELEASE_CLIP
+	float				value;		//PLAY and VOLUME volume, PAN pan, PITCH pitch
+	AudioLoop			loop;		//PLAY
+	bool				bPaused;	//PLAY and PAUSE
+	AudioLimit			limit;		//PLAY
+	int					frames;		//ADVANCE
+	AudioStream*		stream;		//PLAY_STREAM, with the PLAY settings but the loop
+	int					sound;		//PLAY_SOUND, MUSIC and RELOAD_SOUND, SND_ id
+	unsigned int		groups;		//SOUND_GROUPS, ASSETS_ bits
+};
+
+///////////////////////////////////////////////////////////////
+//Audio Command Queue, a single producer single consumer ring.
+//Each side owns one index and only reads the other's, with a
+//cached copy so most calls touch no shared cache line at all
+///////////////////////////////////////////////////////////////
+class AudioCommandQueue
+{
+public:
+	explicit AudioCommandQueue(int capacity); //rounded up to a power of two
+
+	bool	Push(const AudioCommand& command);	//producer only, false when full
+	bool	Pop(AudioCommand& command);			//consumer only, false when empty
+
+private:
+	std::vector<AudioCommand>	m_Ring;
+	unsigned int				m_Mask;
+	char						m_Pad0[64];		//the indices on lines of their own
+	std::atomic<unsigned int>	m_Write;		//next slot the producer fills
+	unsigned int				m_ReadCache;	//producer's last look at m_Read
+	char						m_Pad1[64];
+	std::atomic<unsigned int>	m_Read;			//next slot the consumer takes
+	unsigned int				m_WriteCache;	//consumer's last look at m_Write
+	char						m_Pad2[64];
+};
+
+class AudioThread
+{
+public:
+	static const int	QueueCommands=1024;
+	static const int	LatencyFrames=AudioMixer::BlockFrames * 2;	//mixed ahead of the clock in AUDIO_CLOCK_REALTIME
+
+	AudioThread();
+	~AudioThread();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Start
+	// Parameters:	AudioSink* sink - opened at rate, only the audio thread
+	//					writes to it until Shutdown
+	//				int rate - clips must be loaded at it
+	//				int voices - heard at once, see AudioMixer::Init
+	//				AudioClock clock - AUDIO_CLOCK_ mode
+	// Return:		bool - false if it is already running
+	//////////////////////////////////////////////////////////////////////////
+	bool	Start(AudioSink* sink, int rate, int voices, AudioClock clock);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Shutdown
+	// Parameters:	void
+	// Return:		void
+	// Description:	Waits for the commands already posted, every voice stops
+	//				and the thread ends.  Clips and streams can be released
+	//				and the sink closed after it.
+	//////////////////////////////////////////////////////////////////////////
+	void	Shutdown();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Play
+	// Parameters:	as AudioMixer::Play
+	// Return:		AudioCue - for the calls below, the last 256 played can
+	//				still be reached.  0 if the queue was full
+	// Description:	Game thread only, like every call that posts.  The sound
+	//				starts with the audio thread's next mix, a cue whose sound
+	//				was refused or has ended is ignored.
+	//////////////////////////////////////////////////////////////////////////
+	AudioCue	Play(const AudioClip* clip, float volume, AudioLoop loop, bool bPaused, const AudioLimit& limit);
+	AudioCue	PlayStream(AudioStream* stream, float volume, bool bPaused, const AudioLimit& limit); //as AudioMixer::PlayStream
+	void		Stop(AudioCue cue);
+	void		StopAll();
+	void		SetVolume(AudioCue cue, float volume);
+	void		SetPan(AudioCue cue, float pan);
+	void		SetPitch(AudioCue cue, float pitch);
+	void		SetPaused(AudioCue cue, bool bPaused);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		ReleaseClip
+	// Parameters:	const AudioClip* clip - one that is being replaced, by a
+	//					hot reload
+	// Return:		bool - false if it couldn't be posted, keep playing it
+	// Description:	The audio thread stops every voice of the clip and hands
+	//				it back through TakeReleased, it can be deleted then.  Play
+	//				its replacement from now on, sounds posted before this
+	//				still start on the old clip and are stopped with it.
+	//////////////////////////////////////////////////////////////////////////
+	bool				ReleaseClip(const AudioClip* clip);
+	const AudioClip*	TakeReleased(); //one the audio thread is done with, 0 if none, also after Shutdown
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Advance
+	// Parameters:	int frames - game time that has passed, at the rate
+	// Return:		void
+	// Description:	AUDIO_CLOCK_GAME mixes exactly this much between the
+	//				commands posted before and after it, whenever the thread
+	//				gets to it.  Frames that don't fit in a full queue go with
+	//				the next Advance.  The real time clock ignores it.
+	//////////////////////////////////////////////////////////////////////////
+	void		Advance(int frames);
+
+	//written by the audio thread, read from anywhere
+	long long	MixedFrames() const;
+	double		MixSeconds() const;		//CPU time spent mixing
+	int			Voices() const;
+	int			Steals() const;
+	bool		HasFailed() const;		//the sink refused a block, nothing more is mixed
+	int			Dropped() const;		//commands lost to a full queue, game thread only
+
+private:
+	struct CueVoice
+	{
+		AudioCue	cue;
+		AudioVoice	voice;
+	};
+
+	bool		Post(const AudioCommand& command);
+	void		Run();
+	bool		Apply(const AudioCommand& command); //false for QUIT
+	AudioVoice	Voice(AudioCue cue) const;
+	void		Render(int frames);
+
+private:
+	AudioCommandQueue		m_Commands;
+	std::thread				m_Thread;
+	AudioClock				m_Clock;
+	AudioCue				m_NextCue;		//game thread
+	int						m_Unsent;		//Advance frames waiting for room, game thread
+	int						m_Dropped;		//game thread
+	int						m_Releasing;	//clips posted to ReleaseClip and not taken back, game thread
+	AudioCommandQueue		m_Released;		//RELEASE_CLIP commands handed back, the other way round
+
+	//the audio thread's own
+	AudioMixer				m_Mixer;
+	AudioSink*				m_pSink;
+	std::vector<CueVoice>	m_Cues;			//cue & 255 to its voice
+
+	std::atomic<long long>	m_MixedFrames;
+	std::atomic<double>		m_MixSeconds;
+	std::atomic<int>		m_Voices;
+	std::atomic<int>		m_Steals;
+	std::atomic<bool>		m_bFailed;
+};
@@ -0,0 +1,787 @@
+////////////////////////////////////////////////////////////////
+//DDSTexture class member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "DDSTexture.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+namespace
+{
+	inline unsigned int MakeFourCC(char a, char b, char c, char d)
+	{
+		return (unsigned int)(unsigned char)a | ((unsigned int)(unsigned char)b << 8) |
+			   ((unsigned int)(unsigned char)c << 16) | ((unsigned int)(unsigned char)d << 24);
+	}
+
+	const unsigned int DDS_MAGIC		= 0x20534444; //"DDS "
+	const unsigned int DDS_HEADER_SIZE	= 124;
+	const unsigned int DDS_FILE_HEADER	= 4 + DDS_HEADER_SIZE;
+
+	//header flags, DDSD_CAPS | HEIGHT | WIDTH | PIXELFORMAT | MIPMAPCOUNT | LINEARSIZE
+	const unsigned int DDSD_FLAGS		= 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000;
+	const unsigned int DDSD_MIPMAPCOUNT	= 0x20000;
+	const unsigned int DDPF_FOURCC		= 0x4;
+	const unsigned int DDSCAPS_TEXTURE	= 0x1000;
+	const unsigned int DDSCAPS_COMPLEX	= 0x8;
+	const unsigned int DDSCAPS_MIPMAP	= 0x400000;
+
+	//dwReserved1 is free for tools, the first three hold the unpadded size
+	const unsigned int CONTENT_SIZE_TAG	= MakeFourCC('S','M','C','S');
+
+	//header field offsets, counted from the start of the file
+	enum
+	{
+		OFFSET_FLAGS		= 8,
+		OFFSET_HEIGHT		= 12,
+		OFFSET_WIDTH		= 16,
+		OFFSET_LINEARSIZE	= 20,
+		OFFSET_MIPCOUNT		= 28,
+		OFFSET_RESERVED1	= 32,
+		OFFSET_PF_SIZE		= 76,
+		OFFSET_PF_FLAGS		= 80,
+		OFFSET_PF_FOURCC	= 84,
+		OFFSET_CAPS			= 108
+	};
+
+	inline unsigned int ReadU32(const unsigned char* p)
+	{
+		return (unsigned int)p[0] | ((unsigned int)p[1] << 8) | ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+	}
+
+	inline void WriteU32(unsigned char* p, unsigned int v)
+	{
+		p[0]=(unsigned char)v;
+		p[1]=(unsigned char)(v >> 8);
+		p[2]=(unsigned char)(v >> 16);
+		p[3]=(unsigned char)(v >> 24);
+	}
+
+	inline int BlockBytes(DDSFormat format)
+	{
+		return format == DDS_BC1 ? 8 : 16;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Colour endpoints, 5:6:5 packed like the blocks store them
+	//////////////////////////////////////////////////////////////////////////
+	inline unsigned short To565(float r, float g, float b)
+	{
+		int r5=(int)(r * 31.0f / 255.0f + 0.5f);
+		int g6=(int)(g * 63.0f / 255.0f + 0.5f);
+		int b5=(int)(b * 31.0f / 255.0f + 0.5f);
+		r5=r5 < 0 ? 0 : (r5 > 31 ? 31 : r5);
+		g6=g6 < 0 ? 0 : (g6 > 63 ? 63 : g6);
+		b5=b5 < 0 ? 0 : (b5 > 31 ? 31 : b5);
+		return (unsigned short)((r5 << 11) | (g6 << 5) | b5);
+	}
+
+	inline unsigned int Expand565(unsigned short c)
+	{
+		unsigned int r=(c >> 11) & 31, g=(c >> 5) & 63, b=c & 31;
+		return 0xFF000000 | (((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+	}
+
+	inline unsigned int Mix(unsigned int c0, unsigned int c1, int w0, int w1, int divisor)
+	{
+		unsigned int result=0xFF000000;
+		for(int shift=0; shift < 24; shift+=8)
+			result|=((((c0 >> shift) & 0xFF) * w0 + ((c1 >> shift) & 0xFF) * w1) / divisor) << shift;
+		return result;
+	}
+
+	//the four colours a block can pick from, decoded the way D3D9 hardware
+	//does: BC1 with c0 <= c1 has three colours and transparent black
+	void ColorPalette(unsigned short c0, unsigned short c1, bool bBC1, unsigned int palette[4])
+	{
+		palette[0]=Expand565(c0);
+		palette[1]=Expand565(c1);
+		if(!bBC1 || c0 > c1)
+		{
+			palette[2]=Mix(palette[0],palette[1],2,1,3);
+			palette[3]=Mix(palette[0],palette[1],1,2,3);
+		}
+		else
+		{
+			palette[2]=Mix(palette[0],palette[1],1,1,2);
+			palette[3]=0;
+		}
+	}
+
+	void AlphaPalette(int a0, int a1, int palette[8])
+	{
+		palette[0]=a0;
+		palette[1]=a1;
+		if(a0 > a1)
+		{
+			for(int i=1; i < 7; i++)
+				palette[i + 1]=((7 - i) * a0 + i * a1) / 7;
+		}
+		else
+		{
+			for(int i=1; i < 5; i++)
+				palette[i + 1]=((5 - i) * a0 + i * a1) / 5;
+			palette[6]=0;
+			palette[7]=255;
+		}
+	}
+
+	inline int ColorError(unsigned int a, unsigned int b)
+	{
+		int dr=(int)((a >> 16) & 0xFF) - (int)((b >> 16) & 0xFF);
+		int dg=(int)((a >> 8) & 0xFF) - (int)((b >> 8) & 0xFF);
+		int db=(int)(a & 0xFF) - (int)(b & 0xFF);
+		return dr * dr + dg * dg + db * db;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Colour block.  Endpoints start at the ends of the pixels' principal
+	// axis, then a couple of least squares passes refit them to the indices
+	// picked; the best candidate wins.
+	//////////////////////////////////////////////////////////////////////////
+	struct ColorCandidate
+	{
+		unsigned short	c0;
+		unsigned short	c1;
+		unsigned int	indices;
+		int				error;
+	};
+
+	//orders the endpoints for the block mode, picks indices and scores them
+	ColorCandidate EvaluateColor(const unsigned int* pixels, const bool* transparent, bool bThreeColor, bool bBC1,
+								 const float* e0, const float* e1)
+	{
+		ColorCandidate result;
+		result.c0=To565(e0[0],e0[1],e0[2]);
+		result.c1=To565(e1[0],e1[1],e1[2]);
+		if(bThreeColor ? result.c0 > result.c1 : result.c0 < result.c1)
+		{
+			unsigned short swap=result.c0;
+			result.c0=result.c1;
+			result.c1=swap;
+		}
+
+		unsigned int palette[4];
+		ColorPalette(result.c0,result.c1,bBC1,palette);
+		int usable=(bBC1 && result.c0 <= result.c1) ? 3 : 4; //entry 3 is transparent black
+
+		result.indices=0;
+		result.error=0;
+		for(int i=0; i < 16; i++)
+		{
+			int best=3;
+			if(!transparent[i])
+			{
+				int bestError=0x7FFFFFFF;
+				for(int p=0; p < usable; p++)
+				{
+					int error=ColorError(pixels[i],palette[p]);
+					if(error < bestError)
+					{
+						bestError=error;
+						best=p;
+					}
+				}
+				result.error+=bestError;
+			}
+			result.indices|=(unsigned int)best << (i * 2);
+		}
+		return result;
+	}
+
+	void EncodeColorBlock(const unsigned int* pixels, bool bBC1, unsigned char* out)
+	{
+		bool transparent[16];
+		bool bThreeColor=false;
+		int count=0;
+		float mean[3]={0,0,0};
+		for(int i=0; i < 16; i++)
+		{
+			transparent[i]=bBC1 && (pixels[i] >> 24) < 128;
+			if(transparent[i])
+			{
+				bThreeColor=true;
+				continue;
+			}
+			mean[0]+=(float)((pixels[i] >> 16) & 0xFF);
+			mean[1]+=(float)((pixels[i] >> 8) & 0xFF);
+			mean[2]+=(float)(pixels[i] & 0xFF);
+			count++;
+		}
+
+		if(count == 0)
+		{
+			//all transparent: c0 == c1 selects three colour mode, every index 3
+			memset(out,0,4);
+			WriteU32(out + 4,0xFFFFFFFF);
+			return;
+		}
+		for(int c=0; c < 3; c++)
+			mean[c]/=(float)count;
+
+		//covariance of the opaque pixels
+		float cov[6]={0,0,0,0,0,0};
+		for(int i=0; i < 16; i++)
+		{
+			if(transparent[i])
+				continue;
+			float r=(float)((pixels[i] >> 16) & 0xFF) - mean[0];
+			float g=(float)((pixels[i] >> 8) & 0xFF) - mean[1];
+			float b=(float)(pixels[i] & 0xFF) - mean[2];
+			cov[0]+=r * r; cov[1]+=r * g; cov[2]+=r * b;
+			cov[3]+=g * g; cov[4]+=g * b; cov[5]+=b * b;
+		}
+
+		//principal axis by power iteration
+		float axis[3]={1.0f,1.0f,1.0f};
+		for(int iteration=0; iteration < 8; iteration++)
+		{
+			float x=cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+			float y=cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+			float z=cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+			float length=sqrtf(x * x + y * y + z * z);
+			if(length < 1e-6f)
+				break; //flat block, any axis will do
+			axis[0]=x / length;
+			axis[1]=y / length;
+			axis[2]=z / length;
+		}
+
+		float minProjection=1e30f, maxProjection=-1e30f;
+		for(int i=0; i < 16; i++)
+		{
+			if(transparent[i])
+				continue;
+			float projection=((float)((pixels[i] >> 16) & 0xFF) - mean[0]) * axis[0] +
+							 ((float)((pixels[i] >> 8) & 0xFF) - mean[1]) * axis[1] +
+							 ((float)(pixels[i] & 0xFF) - mean[2]) * axis[2];
+			if(projection < minProjection) minProjection=projection;
+			if(projection > maxProjection) maxProjection=projection;
+		}
+
+		float e0[3], e1[3];
+		for(int c=0; c < 3; c++)
+		{
+			e0[c]=mean[c] + axis[c] * maxProjection;
+			e1[c]=mean[c] + axis[c] * minProjection;
+		}
+		ColorCandidate best=EvaluateColor(pixels,transparent,bThreeColor,bBC1,e0,e1);
+
+		//refit the endpoints to the chosen indices
+		for(int pass=0; pass < 2 && best.error > 0; pass++)
+		{
+			unsigned int palette[4];
+			ColorPalette(best.c0,best.c1,bBC1,palette);
+			bool bFour=!bBC1 || best.c0 > best.c1;
+
+			float aa=0, bb=0, ab=0, ax[3]={0,0,0}, bx[3]={0,0,0};
+			for(int i=0; i < 16; i++)
+			{
+				if(transparent[i])
+					continue;
+				int index=(best.indices >> (i * 2)) & 3;
+				static const float fourWeights[4]={1.0f,0.0f,2.0f / 3.0f,1.0f / 3.0f};
+				static const float threeWeights[4]={1.0f,0.0f,0.5f,0.0f};
+				float alpha=bFour ? fourWeights[index] : threeWeights[index];
+				float beta=1.0f - alpha;
+				float x[3]={(float)((pixels[i] >> 16) & 0xFF),(float)((pixels[i] >> 8) & 0xFF),(float)(pixels[i] & 0xFF)};
+				aa+=alpha * alpha;
+				bb+=beta * beta;
+				ab+=alpha * beta;
+				for(int c=0; c < 3; c++)
+				{
+					ax[c]+=alpha * x[c];
+					bx[c]+=beta * x[c];
+				}
+			}
+
+			float det=aa * bb - ab * ab;
+			if(fabsf(det) < 1e-6f)
+				break;
+			for(int c=0; c < 3; c++)
+			{
+				e0[c]=(ax[c] * bb - bx[c] * ab) / det;
+				e1[c]=(bx[c] * aa - ax[c] * ab) / det;
+			}
+
+			ColorCandidate candidate=EvaluateColor(pixels,transparent,bThreeColor,bBC1,e0,e1);
+			if(candidate.error >= best.error)
+				break;
+			best=candidate;
+		}
+
+		out[0]=(unsigned char)best.c0;
+		out[1]=(unsigned char)(best.c0 >> 8);
+		out[2]=(unsigned char)best.c1;
+		out[3]=(unsigned char)(best.c1 >> 8);
+		WriteU32(out + 4,best.indices);
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// BC3 alpha block.  Tries the 8 value ramp over the whole range and the
+	// 6 value ramp with exact 0 and 255, which suits colour keyed edges.
+	//////////////////////////////////////////////////////////////////////////
+	int EvaluateAlpha(const int* alphas, int a0, int a1, unsigned long long& indices)
+	{
+		int palette[8];
+		AlphaPalette(a0,a1,palette);
+
+		int error=0;
+		indices=0;
+		for(int i=0; i < 16; i++)
+		{
+			int best=0, bestError=0x7FFFFFFF;
+			for(int p=0; p < 8; p++)
+			{
+				int difference=alphas[i] - palette[p];
+				if(difference * difference < bestError)
+				{
+					bestError=difference * difference;
+					best=p;
+				}
+			}
+			error+=bestError;
+			indices|=(unsigned long long)best << (i * 3);
+		}
+		return error;
+	}
+
+	void EncodeAlphaBlock(const unsigned int* pixels, unsigned char* out)
+	{
+		int alphas[16];
+		int lo=255, hi=0, innerLo=255, innerHi=0;
+		for(int i=0; i < 16; i++)
+		{
+			alphas[i]=pixels[i] >> 24;
+			if(alphas[i] < lo) lo=alphas[i];
+			if(alphas[i] > hi) hi=alphas[i];
+			if(alphas[i] != 0 && alphas[i] != 255)
+			{
+				if(alphas[i] < innerLo) innerLo=alphas[i];
+				if(alphas[i] > innerHi) innerHi=alphas[i];
+			}
+		}
+		if(innerLo > innerHi)
+			innerLo=innerHi=0; //only 0 and 255, which the 6 value ramp has exactly
+
+		//6 value ramp needs a0 <= a1
+		unsigned long long indices;
+		int a0=innerLo, a1=innerHi;
+		int error=EvaluateAlpha(alphas,a0,a1,indices);
+
+		//8 value ramp needs a0 > a1
+		if(hi > lo && error > 0)
+		{
+			unsigned long long rampIndices;
+			int rampError=EvaluateAlpha(alphas,hi,lo,rampIndices);
+			if(rampError < error)
+			{
+				a0=hi;
+				a1=lo;
+				indices=rampIndices;
+			}
+		}
+
+		out[0]=(unsigned char)a0;
+		out[1]=(unsigned char)a1;
+		for(int i=0; i < 6; i++)
+			out[2 + i]=(unsigned char)(indices >> (i * 8));
+	}
+
+	void DecodeBlock(const unsigned char* block, DDSFormat format, unsigned int* pixels)
+	{
+		const unsigned char* color=block;
+		int alphaPalette[8];
+		unsigned long long alphaIndices=0;
+		if(format == DDS_BC3)
+		{
+			AlphaPalette(block[0],block[1],alphaPalette);
+			for(int i=0; i < 6; i++)
+				alphaIndices|=(unsigned long long)block[2 + i] << (i * 8);
+			color=block + 8;
+		}
+
+		unsigned short c0=(unsigned short)(color[0] | (color[1] << 8));
+		unsigned short c1=(unsigned short)(color[2] | (color[3] << 8));
+		unsigned int palette[4];
+		ColorPalette(c0,c1,format == DDS_BC1,palette);
+		unsigned int indices=ReadU32(color + 4);
+
+		for(int i=0; i < 16; i++)
+		{
+			unsigned int pixel=palette[(indices >> (i * 2)) & 3];
+			if(format == DDS_BC3)
+			{
+				unsigned int alpha=(unsigned int)alphaPalette[(alphaIndices >> (i * 3)) & 7];
+				unsigned int rgb=0;
+				for(int shift=0; shift < 24; shift+=8)
+				{
+					unsigned int channel=(pixel >> shift) & 0xFF;
+					rgb|=(channel > alpha ? alpha : channel) << shift; //keep it premultiplied
+				}
+				pixel=(alpha << 24) | rgb;
+			}
+			pixels[i]=pixel;
+		}
+	}
+}
+
+DDSTexture::DDSTexture()
+{
+	Release();
+}
+
+void DDSTexture::Release()
+{
+	m_Format=DDS_BC1;
+	m_Width=0;
+	m_Height=0;
+	m_ContentWidth=0;
+	m_ContentHeight=0;
+	m_LevelOffsets.clear();
+	m_Blocks.clear();
+	m_pView=0;
+}
+
+void DDSTexture::SetLayout(DDSFormat format, int width, int height, int levels)
+{
+	m_Format=format;
+	m_Width=width;
+	m_Height=height;
+	m_LevelOffsets.resize(levels + 1);
+
+	size_t offset=0;
+	for(int level=0; level < levels; level++)
+	{
+		m_LevelOffsets[level]=offset;
+		int blocksWide=(LevelWidth(level) + 3) / 4;
+		int blocksHigh=(LevelHeight(level) + 3) / 4;
+		offset+=(size_t)blocksWide * blocksHigh * BlockBytes(format);
+	}
+	m_LevelOffsets[levels]=offset;
+}
+
+void DDSTexture::Create(const Image& image, DDSFormat format, bool bMips)
+{
+	Release();
+	if(image.IsEmpty())
+		return;
+
+	//pad to whole blocks with transparent black
+	Image level;
+	level.Create((image.Width() + 3) & ~3,(image.Height() + 3) & ~3,0);
+	for(int y=0; y < image.Height(); y++)
+		memcpy(level.Row(y),image.Row(y),image.Width() * sizeof(unsigned int));
+
+	int levels=1;
+	if(bMips)
+	{
+		for(int size=level.Width() > level.Height() ? level.Width() : level.Height(); size > 1; size>>=1)
+			levels++;
+	}
+	SetLayout(format,level.Width(),level.Height(),levels);
+	m_ContentWidth=image.Width();
+	m_ContentHeight=image.Height();
+	m_Blocks.resize(m_LevelOffsets[levels]);
+
+	for(int l=0; l < levels; l++)
+	{
+		if(l > 0)
+		{
+			Image smaller;
+			Downsample(level,smaller);
+			level=smaller;
+		}
+
+		unsigned char* out=&m_Blocks[m_LevelOffsets[l]];
+		for(int by=0; by < level.Height(); by+=4)
+		{
+			for(int bx=0; bx < level.Width(); bx+=4)
+			{
+				//levels under 4 texels wide repeat their edge texels
+				unsigned int pixels[16];
+				for(int y=0; y < 4; y++)
+				{
+					const unsigned int* row=level.Row(by + y < level.Height() ? by + y : level.Height() - 1);
+					for(int x=0; x < 4; x++)
+						pixels[y * 4 + x]=row[bx + x < level.Width() ? bx + x : level.Width() - 1];
+				}
+
+				if(format == DDS_BC3)
+				{
+					EncodeAlphaBlock(pixels,out);
+					EncodeColorBlock(pixels,false,out + 8);
+				}
+				else
+				{
+					EncodeColorBlock(pixels,true,out);
+				}
+				out+=BlockBytes(format);
+			}
+		}
+	}
+}
+
+bool DDSTexture::Load(const char* filename)
+{
+	FILE* file=fopen(filename,"rb");
+	if(!file)
+		return false;
+
+	std::vector<unsigned char> data;
+	fseek(file,0,SEEK_END);
+	long size=ftell(file);
+	fseek(file,0,SEEK_SET);
+	if(size > 0)
+	{
+		data.resize((size_t)size);
+		if(fread(&data[0],1,data.size(),file) != data.size())
+			data.clear();
+	}
+	fclose(file);
+
+	return !data.empty() && LoadFromMemory(&data[0],data.size());
+}
+
+bool DDSTexture::LoadFromMemory(const unsigned char* data, size_t size)
+{
+	if(!ReadHeader(data,size))
+		return false;
+
+	m_Blocks.assign(data + DDS_FILE_HEADER,data + DDS_FILE_HEADER + m_LevelOffsets.back());
+	return true;
+}
+
+bool DDSTexture::ViewMemory(const unsigned char* data, size_t size)
+{
+	if(!ReadHeader(data,size))
+		return false;
+
+	m_pView=data + DDS_FILE_HEADER;
+	return true;
+}
+
+bool DDSTexture::ReadHeader(const unsigned char* data, size_t size)
+{
+	Release();
+	if(size < DDS_FILE_HEADER || ReadU32(data) != DDS_MAGIC || ReadU32(data + 4) != DDS_HEADER_SIZE)
+		return false;
+	if(!(ReadU32(data + OFFSET_PF_FLAGS) & DDPF_FOURCC))
+		return false;
+
+	DDSFormat format;
+	unsigned int fourCC=ReadU32(data + OFFSET_PF_FOURCC);
+	if(fourCC == MakeFourCC('D','X','T','1'))
+		format=DDS_BC1;
+	else if(fourCC == MakeFourCC('D','X','T','5'))
+		format=DDS_BC3;
+	else
+		return false;
+
+	int width=(int)ReadU32(data + OFFSET_WIDTH);
+	int height=(int)ReadU32(data + OFFSET_HEIGHT);
+	int levels=(ReadU32(data + OFFSET_FLAGS) & DDSD_MIPMAPCOUNT) ? (int)ReadU32(data + OFFSET_MIPCOUNT) : 1;
+	if(width <= 0 || height <= 0 || width > 16384 || height > 16384 || levels < 1 || levels > 15)
+		return false;
+
+	SetLayout(format,width,height,levels);
+	if(size - DDS_FILE_HEADER < m_LevelOffsets[levels])
+	{
+		Release();
+		return false;
+	}
+
+	m_ContentWidth=width;
+	m_ContentHeight=height;
+	if(ReadU32(data + OFFSET_RESERVED1) == CONTENT_SIZE_TAG)
+	{
+		int contentWidth=(int)ReadU32(data + OFFSET_RESERVED1 + 4);
+		int contentHeight=(int)ReadU32(data + OFFSET_RESERVED1 + 8);
+		if(contentWidth > 0 && contentWidth <= width && contentHeight > 0 && contentHeight <= height)
+		{
+			m_ContentWidth=contentWidth;
+			m_ContentHeight=contentHeight;
+		}
+	}
+	return true;
+}
+
+bool DDSTexture::Save(const char* filename) const
+{
+	if(IsEmpty())
+		return false;
+
+	unsigned char header[DDS_FILE_HEADER];
+	memset(header,0,sizeof(header));
+	WriteU32(header,DDS_MAGIC);
+	WriteU32(header + 4,DDS_HEADER_SIZE);
+	WriteU32(header + OFFSET_FLAGS,DDSD_FLAGS);
+	WriteU32(header + OFFSET_HEIGHT,(unsigned int)m_Height);
+	WriteU32(header + OFFSET_WIDTH,(unsigned int)m_Width);
+	WriteU32(header + OFFSET_LINEARSIZE,(unsigned int)LevelSize(0));
+	WriteU32(header + OFFSET_MIPCOUNT,(unsigned int)LevelCount());
+	WriteU32(header + OFFSET_RESERVED1,CONTENT_SIZE_TAG);
+	WriteU32(header + OFFSET_RESERVED1 + 4,(unsigned int)m_ContentWidth);
+	WriteU32(header + OFFSET_RESERVED1 + 8,(unsigned int)m_ContentHeight);
+	WriteU32(header + OFFSET_PF_SIZE,32);
+	WriteU32(header + OFFSET_PF_FLAGS,DDPF_FOURCC);
+	WriteU32(header + OFFSET_PF_FOURCC,m_Format == DDS_BC1 ? MakeFourCC('D','X','T','1') : MakeFourCC('D','X','T','5'));
+	WriteU32(header + OFFSET_CAPS,DDSCAPS_TEXTURE | (LevelCount() > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0));
+
+	FILE* file=fopen(filename,"wb");
+	if(!file)
+		return false;
+	bool bWritten=fwrite(header,1,sizeof(header),file) == sizeof(header) &&
+				  fwrite(LevelData(0),1,m_LevelOffsets.back(),file) == m_LevelOffsets.back();
+	fclose(file);
+	return bWritten;
+}
+
+bool DDSTexture::Decompress(int level, Image& image) const
+{
+	if(level < 0 || level >= LevelCount())
+		return false;
+
+	int width=LevelWidth(level);
+	int height=LevelHeight(level);
+	Image decoded;
+	decoded.Create((width + 3) & ~3,(height + 3) & ~3,0);
+
+	const unsigned char* block=LevelData(level);
+	for(int by=0; by < decoded.Height(); by+=4)
+	{
+		for(int bx=0; bx < decoded.Width(); bx+=4)
+		{
+			unsigned int pixels[16];
+			DecodeBlock(block,m_Format,pixels);
+			for(int y=0; y < 4; y++)
+				memcpy(decoded.Row(by + y) + bx,pixels + y * 4,4 * sizeof(unsigned int));
+			block+=BlockBytes(m_Format);
+		}
+	}
+
+	//drop the block padding, and on level 0 the padding added to the source
+	if(level == 0)
+	{
+		width=m_ContentWidth;
+		height=m_ContentHeight;
+	}
+	image.Create(width,height,0);
+	for(int y=0; y < height; y++)
+		memcpy(image.Row(y),decoded.Row(y),width * sizeof(unsigned int));
+	image.UpdateOpaque();
+	return true;
+}
+
+bool DDSTexture::IsEmpty() const
+{
+	return m_LevelOffsets.empty();
+}
+
+DDSFormat DDSTexture::Format() const
+{
+	return m_Format;
+}
+
+int DDSTexture::Width() const
+{
+	return m_Width;
+}
+
+int DDSTexture::Height() const
+{
+	return m_Height;
+}
+
+int DDSTexture::ContentWidth() const
+{
+	return m_ContentWidth;
+}
+
+int DDSTexture::ContentHeight() const
+{
+	return m_ContentHeight;
+}
+
+int DDSTexture::LevelCount() const
+{
+	return m_LevelOffsets.empty() ? 0 : (int)m_LevelOffsets.size() - 1;
+}
+
+int DDSTexture::LevelWidth(int level) const
+{
+	int width=m_Width >> level;
+	return width > 0 ? width : 1;
+}
+
+int DDSTexture::LevelHeight(int level) const
+{
+	int height=m_Height >> level;
+	return height > 0 ? height : 1;
+}
+
+int DDSTexture::LevelPitch(int level) const
+{
+	return (LevelWidth(level) + 3) / 4 * BlockBytes(m_Format);
+}
+
+const unsigned char* DDSTexture::LevelData(int level) const
+{
+	return (m_pView ? m_pView : &m_Blocks[0]) + m_LevelOffsets[level];
+}
+
+size_t DDSTexture::LevelSize(int level) const
+{
+	return m_LevelOffsets[level + 1] - m_LevelOffsets[level];
+}
+
+bool DDSTexture::FitsBC1(const Image& image, bool bMips)
+{
+	Image level=image;
+	for(;;)
+	{
+		const unsigned int* pixels=level.Pixels();
+		size_t count=(size_t)level.Width() * level.Height();
+		for(size_t i=0; i < count; i++)
+		{
+			unsigned int alpha=pixels[i] >> 24;
+			if(alpha != 0 && alpha != 255)
+				return false;
+		}
+
+		if(!bMips || (level.Width() <= 1 && level.Height() <= 1))
+			return true;
+		Image smaller;
+		Downsample(level,smaller);
+		level=smaller;
+	}
+}
+
+void DDSTexture::Downsample(const Image& source, Image& result)
+{
+	int width=source.Width() > 1 ? source.Width() / 2 : 1;
+	int height=source.Height() > 1 ? source.Height() / 2 : 1;
+	result.Create(width,height,0);
+
+	for(int y=0; y < height; y++)
+	{
+		const unsigned int* row0=source.Row(y * 2 < source.Height() ? y * 2 : source.Height() - 1);
+		const unsigned int* row1=source.Row(y * 2 + 1 < source.Height() ? y * 2 + 1 : source.Height() - 1);
+		unsigned int* out=result.Row(y);
+		for(int x=0; x < width; x++)
+		{
+			int x0=x * 2 < source.Width() ? x * 2 : source.Width() - 1;
+			int x1=x * 2 + 1 < source.Width() ? x * 2 + 1 : source.Width() - 1;
+			unsigned int pixel=0;
+			for(int shift=0; shift < 32; shift+=8)
+			{
+				unsigned int sum=((row0[x0] >> shift) & 0xFF) + ((row0[x1] >> shift) & 0xFF) +
+								 ((row1[x0] >> shift) & 0xFF) + ((row1[x1] >> shift) & 0xFF);
+				pixel|=((sum + 2) >> 2) << shift;
+			}
+			out[x]=pixel;
+		}
+	}
+	result.UpdateOpaque();
+}
@@ -0,0 +1,95 @@
+///////////////////////////////////////////////////////////////
+//DDS Texture, BC1 (DXT1) and BC3 (DXT5) block compressed images
+//with their mip chain, written offline by the asset tool and
+//uploaded as is by the game
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Image.h"
+#include <vector>
+
+enum DDSFormat
+{
+	DDS_BC1,	//4 bits per pixel, opaque or fully transparent texels only
+	DDS_BC3		//8 bits per pixel, BC1 colour plus interpolated alpha
+};
+
+class DDSTexture
+{
+public:
+	DDSTexture();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Create
+	// Parameters:	const Image& image - premultiplied source pixels
+	//				DDSFormat format - block format for every level
+	//				bool bMips - also build and compress the mip chain
+	// Return:		void
+	// Description:	Pads the image to a multiple of 4 with transparent texels
+	//				(D3D9 needs whole blocks on the top level) and remembers the
+	//				unpadded size, box filters each mip from the level above,
+	//				then compresses every level.
+	//////////////////////////////////////////////////////////////////////////
+	void	Create(const Image& image, DDSFormat format, bool bMips);
+
+	bool	Load(const char* filename);
+	bool	LoadFromMemory(const unsigned char* data, size_t size);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		ViewMemory
+	// Parameters:	const unsigned char* data - a whole DDS file, e.g. in a
+	//					mapped AssetArchive
+	//				size_t size - its length in bytes
+	// Return:		bool - false if it is not a DDS this class reads
+	// Description:	Like LoadFromMemory but the levels are read from data in
+	//				place rather than copied, so data has to stay valid for as
+	//				long as the texture (and any copy of it) is used.
+	//////////////////////////////////////////////////////////////////////////
+	bool	ViewMemory(const unsigned char* data, size_t size);
+	bool	Save(const char* filename) const;
+	void	Release();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Decompress
+	// Parameters:	int level - mip level to decode
+	//				Image& image - receives the texels, cropped to the unpadded
+	//					size for level 0
+	// Return:		bool - false if there is no such level
+	// Description:	Used by the software renderer.  Colour is clamped to alpha
+	//				so the premultiplied blend never sees a channel above alpha.
+	//////////////////////////////////////////////////////////////////////////
+	bool	Decompress(int level, Image& image) const;
+
+	bool					IsEmpty() const;
+	DDSFormat				Format() const;
+	int						Width() const;			//padded, what the texture is created with
+	int						Height() const;
+	int						ContentWidth() const;	//size of the source image
+	int						ContentHeight() const;
+	int						LevelCount() const;
+	int						LevelWidth(int level) const;
+	int						LevelHeight(int level) const;
+	int						LevelPitch(int level) const;	//bytes per row of blocks
+	const unsigned char*	LevelData(int level) const;
+	size_t					LevelSize(int level) const;
+
+	//true when every texel is 0 or 255 alpha on every level, so BC1 loses nothing
+	static bool				FitsBC1(const Image& image, bool bMips);
+
+	//half size box filter, odd edges are clamped
+	static void				Downsample(const Image& source, Image& result);
+
+private:
+	void					SetLayout(DDSFormat format, int width, int height, int levels);
+	bool					ReadHeader(const unsigned char* data, size_t size); //layout and content size, no blocks
+
+private:
+	DDSFormat					m_Format;
+	int							m_Width;
+	int							m_Height;
+	int							m_ContentWidth;
+	int							m_ContentHeight;
+	std::vector<size_t>			m_LevelOffsets;	//into m_Blocks, one extra entry for the end
+	std::vector<unsigned char>	m_Blocks;		//every level back to back, as stored in the file
+	const unsigned char*		m_pView;		//someone else's blocks instead, see ViewMemory
+};
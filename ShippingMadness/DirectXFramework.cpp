@@ -14,7 +14,8 @@
 //////////////////////////////////////////////////////////////////////////
 #include "DirectXFramework.h"
 
-
+#define ArchiveFile "assets.pak" //written by "assettool pack"
+#define ImageCacheDirectory "texturecache" //decoded pixels from earlier runs
 
 CDirectXFramework::CDirectXFramework(void)
 {
@@ -22,8 +23,30 @@ CDirectXFramework::CDirectXFramework(void)
 	m_bVsync		= false;
 	m_pD3DObject	= 0;
 	m_pD3DDevice	= 0;
+	m_pD3DSprite	= 0;
+	m_pD3DFont		= 0;
+	m_bSoftware		= false;
+	m_bHeadless		= false;
+	m_pSoftRenderer	= 0;
+	m_pFrame		= 0;
+	m_pStaticSurface= 0;
+	m_bStaticValid	= false;
+	m_StaticWidth	= 0;
+	m_StaticHeight	= 0;
+	m_bDynamicResolution=true;
+	m_TextureBudget	= 64 * 1024 * 1024;
+	m_bSerialLoad	= false;
+	m_bImageCache	= true;
+	m_AssetGroups	= 0;
+	m_TextureGroups	= 0;
+	m_InitStart		= 0.0;
+	m_bAllLoaded	= false;
+	m_hFont			= 0;
+	m_pSceneSurface	= 0;
+	m_RenderScale	= 1.0f;
+	m_DrawMs		= 0.0f;
+	m_FPS			= 0;
 	g_DInput		= 0;
-	system			= 0; //initialize FMOD pointer to 0 first
 
 	//Set Direct Show pointers to null and bool to false
 	m_pGraphBuilder	= 0;
@@ -39,24 +62,42 @@ CDirectXFramework::~CDirectXFramework(void)
 {
 	// If Shutdown is not explicitly called correctly, call it when 
 	// this class is destroyed or falls out of scope as an error check.
-	system->release(); //release FMOD sound info
+	m_Audio.Shutdown(); //release FMOD sound info, before the archive its streams read
 	CoUninitialize(); //Release COM library used by DirectShow
 	Shutdown(); //release DirectX COM objects
 }
 
 void CDirectXFramework::Init(HWND& hWnd, HINSTANCE& hInst, bool bWindowed)
 {
+	m_InitStart=FramePacer::Now();
+	TraceLog::NameThread("Game thread");
+	TraceScope trace("Init");
+
+	//one mapped file instead of opening each asset by name, the loose files
+	//are still used when it isn't there (or doesn't have one)
+	double phaseStart=FramePacer::Now();
+	if(m_Archive.Open(ArchiveFile))
+		OutputDebugStringA("Assets from " ArchiveFile "\n");
+	TraceLog::Record("Open archive",std::string(),phaseStart,FramePacer::Now());
+
+	//assets saved while the game runs are reloaded, headless runs compare
+	//against fixed goldens so they don't watch
+	if(!m_bHeadless && m_Watcher.Start("."))
+		OutputDebugStringA("Watching the asset folder for changes\n");
+
 	//Initialize a DirectInput Object
 	//Declare it static so it doesn't go out of scope when Init finishes, its a singleton class so this is okay
+	phaseStart=FramePacer::Now();
 	static DirectInput di(DISCL_NONEXCLUSIVE | DISCL_FOREGROUND, DISCL_NONEXCLUSIVE | DISCL_FOREGROUND,hInst,hWnd);
 	g_DInput=&di; //g_DInput is our pointer to a DirectInput object in our framework
+	TraceLog::Record("DirectInput",std::string(),phaseStart,FramePacer::Now());
 
 	InitFmod(); //Initialize FMOD
 
 
 	//Initialize all private variables
 	m_hWnd			= hWnd;
-	m_bVsync		=false;
+	m_bVsync		=m_Pacer.Mode() == PACE_VSYNC;
 	m_pD3DObject	=0;
 	m_pD3DDevice	=0;
 	m_currTime		=0;
@@ -66,6 +107,7 @@ void CDirectXFramework::Init(HWND& hWnd, HINSTANCE& hInst, bool bWindowed)
 	//////////////////////////////////////////////////////////////////////////
 
 	// Create the D3D Object
+	phaseStart=FramePacer::Now();
 	m_pD3DObject = Direct3DCreate9(D3D_SDK_VERSION);
 
 	// Find the width and height of window using hWnd and GetWindowRect()
@@ -116,13 +158,45 @@ void CDirectXFramework::Init(HWND& hWnd, HINSTANCE& hInst, bool bWindowed)
 	}
 	
 	// Create the D3D Device with the present parameters and device flags above
-	m_pD3DObject->CreateDevice(
-		D3DADAPTER_DEFAULT,		// which adapter to use, set to primary
-		D3DDEVTYPE_HAL,			// device type to use, set to hardware rasterization
-		hWnd,					// handle to the focus window
-		deviceBehaviorFlags,	// behavior flags
-		&D3Dpp,					// presentation parameters
-		&m_pD3DDevice);			// returned device pointer
+	if(!m_bSoftware)
+	{
+		m_pD3DObject->CreateDevice(
+			D3DADAPTER_DEFAULT,		// which adapter to use, set to primary
+			D3DDEVTYPE_HAL,			// device type to use, set to hardware rasterization
+			hWnd,					// handle to the focus window
+			deviceBehaviorFlags,	// behavior flags
+			&D3Dpp,					// presentation parameters
+			&m_pD3DDevice);			// returned device pointer
+	}
+
+	// No hardware device (GPU-less machine) or software asked for, render on the CPU
+	if(!m_pD3DDevice)
+	{
+		m_bSoftware=true;
+
+		RECT client;
+		GetClientRect(hWnd,&client);
+		m_pSoftRenderer=new SoftwareRenderer;
+		m_pSoftRenderer->Resize(client.right - client.left,client.bottom - client.top);
+
+		//GDI presents can't wait for vblank, cap at the refresh rate instead
+		if(m_bVsync)
+		{
+			HDC hdc=GetDC(hWnd);
+			int refresh=GetDeviceCaps(hdc,VREFRESH);
+			ReleaseDC(hWnd,hdc);
+			m_bVsync=false;
+			m_Pacer.SetMode(PACE_CAPPED,refresh > 1 ? refresh : 60);
+		}
+	}
+	else if(m_bVsync)
+	{
+		//the pacer only measures in vsync mode, give it the refresh rate to measure against
+		D3DDISPLAYMODE displayMode;
+		m_pD3DObject->GetAdapterDisplayMode(D3DADAPTER_DEFAULT,&displayMode);
+		m_Pacer.SetMode(PACE_VSYNC,displayMode.RefreshRate ? displayMode.RefreshRate : 60);
+	}
+	TraceLog::Record("Create device",std::string(),phaseStart,FramePacer::Now());
 
 	//*************************************************************************
 	
@@ -132,6 +206,7 @@ void CDirectXFramework::Init(HWND& hWnd, HINSTANCE& hInst, bool bWindowed)
 	//////////////////////////////////////////////////////////////////////////
 	
 	// Load a font for private use for this process
+	phaseStart=FramePacer::Now();
 	D3DXFONT_DESC fontDesc;
 	fontDesc.Height			=30;
 	fontDesc.Width			=10;
@@ -143,418 +218,88 @@ void CDirectXFramework::Init(HWND& hWnd, HINSTANCE& hInst, bool bWindowed)
 	fontDesc.Quality		=DEFAULT_QUALITY;
 	fontDesc.PitchAndFamily	=DEFAULT_PITCH | FF_DONTCARE;
 	
-	AddFontResourceEx(L"Delicious-Roman.otf",FR_PRIVATE,0); //add our custom font
+	AssetView font;
+	if(m_Archive.Find("Delicious-Roman.otf",font))
+	{
+		DWORD fonts=0;
+		m_hFont=AddFontMemResourceEx((void*)font.data,(DWORD)font.size,0,&fonts); //GDI copies it, private to the process
+	}
+	if(!m_hFont)
+		AddFontResourceEx(L"Delicious-Roman.otf",FR_PRIVATE,0); //add our custom font
 	_tcscpy(fontDesc.FaceName,L"Delicious-Roman.otf");
 
-	// Load D3DXFont, each font style you want to support will need an ID3DXFont
-	D3DXCreateFontIndirect(m_pD3DDevice,&fontDesc,&m_pD3DFont); //Create create font and assign it to our font device pointer m_pD3DFont
+	if(!m_bSoftware) //the software renderer has its own bitmap font and sprite blitter
+	{
+		// Load D3DXFont, each font style you want to support will need an ID3DXFont
+		D3DXCreateFontIndirect(m_pD3DDevice,&fontDesc,&m_pD3DFont); //Create create font and assign it to our font device pointer m_pD3DFont
+
+		// Create a sprite object, note you will only need one for all 2D sprites
+		D3DXCreateSprite(m_pD3DDevice,&m_pD3DSprite);
+	}
+	TraceLog::Record("Create font and sprite",std::string(),phaseStart,FramePacer::Now());
 
 
 	//////////////////////////////////////////////////////////////////////////
-	// Create Sprite Object and Textures
+	// Create Textures
 	//////////////////////////////////////////////////////////////////////////
+	LoadTextures();
 
-	// Create a sprite object, note you will only need one for all 2D sprites
-	D3DXCreateSprite(m_pD3DDevice,&m_pD3DSprite);
-
-	//Create Background Image
-	D3DXCreateTextureFromFileEx
-		(m_pD3DDevice,L"shipping_madness_background.png",0,0,0,0,D3DFMT_UNKNOWN,D3DPOOL_MANAGED,D3DX_DEFAULT,D3DX_DEFAULT,D3DCOLOR_XRGB(0,255,0),&img_menuBackground,0,&menuBackground);
-
-	//Level 1 Boundary
-	D3DXCreateTextureFromFileEx
-		(m_pD3DDevice,L"PlayingBounds.png",0,0,0,0,D3DFMT_UNKNOWN,D3DPOOL_MANAGED,D3DX_DEFAULT,D3DX_DEFAULT,D3DCOLOR_XRGB(0,255,0),&img_LevelOnePlayBoundary,0,&LevelOnePlayBoundary);
-
-	//Player Ship Texture
-	D3DXCreateTextureFromFileEx
-		(m_pD3DDevice,L"PlayerShip.png",0,0,0,0,D3DFMT_UNKNOWN,D3DPOOL_MANAGED,D3DX_DEFAULT,D3DX_DEFAULT,D3DCOLOR_XRGB(0,255,0),&Player_Ship,0,&PlayerShip_Texture);
-	
-	//Enemy Ship Texture
-	D3DXCreateTextureFromFileEx
-		(m_pD3DDevice,L"EnemyShip.png",0,0,0,0,D3DFMT_UNKNOWN,D3DPOOL_MANAGED,D3DX_DEFAULT,D3DX_DEFAULT,D3DCOLOR_XRGB(0,255,0),&Enemy_Ship,0,&EnemyShip_Texture);
-
-	//Bullet Texture
-	D3DXCreateTextureFromFileEx
-		(m_pD3DDevice,L"Bullet.png",0,0,0,0,D3DFMT_UNKNOWN,D3DPOOL_MANAGED,D3DX_DEFAULT,D3DX_DEFAULT,D3DCOLOR_XRGB(0,255,0),&Bullet_Image,0,&Bullet_Texture);
-	
-	///////////////////////////////////////////////////////////////////
-	//Menu Button Textures
-	///////////////////////////////////////////////////////////////////
-	D3DXCreateTextureFromFileEx
-		(m_pD3DDevice,L"playgame.png",0,0,0,0,D3DFMT_UNKNOWN,D3DPOOL_MANAGED,D3DX_DEFAULT,D3DX_DEFAULT,D3DCOLOR_XRGB(0,255,0),&img_PlayGameButton,0,&PlayGameButton);
-
-	D3DXCreateTextureFromFileEx
-		(m_pD3DDevice,L"hl_playgame.png",0,0,0,0,D3DFMT_UNKNOWN,D3DPOOL_MANAGED,D3DX_DEFAULT,D3DX_DEFAULT,D3DCOLOR_XRGB(0,255,0),&img_HL_PlayGameButton,0,&HL_PlayGameButton);
-
-	D3DXCreateTextureFromFileEx
-		(m_pD3DDevice,L"credits.png",0,0,0,0,D3DFMT_UNKNOWN,D3DPOOL_MANAGED,D3DX_DEFAULT,D3DX_DEFAULT,D3DCOLOR_XRGB(0,255,0),&img_CreditsButton,0,&CreditsButton);
-	D3DXCreateTextureFromFileEx
-		(m_pD3DDevice,L"hl_credits.png",0,0,0,0,D3DFMT_UNKNOWN,D3DPOOL_MANAGED,D3DX_DEFAULT,D3DX_DEFAULT,D3DCOLOR_XRGB(0,255,0),&img_HL_CreditsButton,0,&HL_CreditsButton);
-	D3DXCreateTextureFromFileEx
-		(m_pD3DDevice,L"options.png",0,0,0,0,D3DFMT_UNKNOWN,D3DPOOL_MANAGED,D3DX_DEFAULT,D3DX_DEFAULT,D3DCOLOR_XRGB(0,255,0),&img_OptionsButton,0,&OptionsButton);
-
-	D3DXCreateTextureFromFileEx
-		(m_pD3DDevice,L"hl_options.png",0,0,0,0,D3DFMT_UNKNOWN,D3DPOOL_MANAGED,D3DX_DEFAULT,D3DX_DEFAULT,D3DCOLOR_XRGB(0,255,0),&img_HL_OptionsButton,0,&HL_OptionsButton);
-	D3DXCreateTextureFromFileEx
-		(m_pD3DDevice,L"quit.png",0,0,0,0,D3DFMT_UNKNOWN,D3DPOOL_MANAGED,D3DX_DEFAULT,D3DX_DEFAULT,D3DCOLOR_XRGB(0,255,0),&img_QuitButton,0,&QuitButton);
-	D3DXCreateTextureFromFileEx
-		(m_pD3DDevice,L"hl_quit.png",0,0,0,0,D3DFMT_UNKNOWN,D3DPOOL_MANAGED,D3DX_DEFAULT,D3DX_DEFAULT,D3DCOLOR_XRGB(0,255,0),&img_HL_QuitButton,0,&HL_QuitButton);
 	//////////////////////////////////////////////////////////////////////////
-	//Set All Enemy and Player positions, setup EnemyList
+	//Start the game at the main menu, laid out for the textures loaded so
+	//far, UpdateLoading passes the rest on as they come in
 	//////////////////////////////////////////////////////////////////////////
-	RECT padrect;
-	GetClientRect(m_hWnd,&padrect);
-	
-	Enemies[0].pos=D3DXVECTOR3(padrect.left + 100.0f,padrect.top + 150.0f,0.0f);
-	D3DXVECTOR3 prevPos=Enemies[0].pos;
-	for(int i=1; i < MAX_ENEMIES; i++)
-	{
-		Enemies[i].pos=D3DXVECTOR3(prevPos.x + (Enemy_Ship.Width + 50.0f),padrect.top + 150.0f,0.0f);
-		prevPos=Enemies[i].pos;
-	}
-	MovementDirection=RIGHT; //Set initial movement of all enemies to right of screen
-
-	//Starting Player Position
-	PlayerPosition=D3DXVECTOR3(float(padrect.right / 2 ), float(padrect.bottom - 100.0f),0.0f);
-
-	//Construct list from initialized array of enemies
-	std::list<EnemyPositions> ENEMIES (Enemies,Enemies + sizeof(Enemies) / sizeof(EnemyPositions) ); //create list of enemies called ENEMIES
-
-	EnemyList=ENEMIES; //assign ENEMIES list to our main list EnemyList
-	//bullets.push_back(Bullet(D3DXVECTOR3(PlayerPosition.x,PlayerPosition.y - 25.0f,0.0f) ) );
-
-	//Set Game and Menu States
-	gameState=MENU;
-	menuState=PLAY;
-	//Timers to move enemies in the game
-	enemyCurrTimer=0.0f;
-	enemyPrevTimer=0.0f;
-	bulletCurrTimer=0.0f;
-	bulletPrevTimer=0.0f;
-
-	SideReached=false; //enemies haven't moved to edge of screen yet
-	GameEnded  =false; //game has not ended yet
+	phaseStart=FramePacer::Now();
+	for(int i=0; i < TEX_COUNT; i++)
+		m_Game.SetTextureSize(i,m_TextureInfo[i].Width,m_TextureInfo[i].Height);
+	RECT client;
+	GetClientRect(m_hWnd,&client);
+	m_Game.SetViewport(client.right - client.left,client.bottom - client.top);
+	m_Game.Init();
+	UpdateLoading(); //starts the music too if its streams are open already
+	TraceLog::Record("Start game",std::string(),phaseStart,FramePacer::Now());
 	
 	//Now that everything is initialized call directShow to play video
 	//InitDirectShow();
 
-	//Start playing background music
-	system->playSound(FMOD_CHANNEL_FREE,sound_Wave,true,&channel_Wave); //played but paused
-	channel_Wave->setMode(FMOD_LOOP_NORMAL);
-	channel_Wave->setVolume(0.5f);
-	channel_Wave->setPaused(false);
-
-	system->playSound(FMOD_CHANNEL_FREE,sound_background,true,&channel_background); //played but paused
-	channel_background->setMode(FMOD_LOOP_NORMAL);
-	channel_background->setVolume(0.8f);
-	channel_background->setPaused(true);
+	//the draw time budget is a whole frame at the paced rate, the game thread
+	//records the next frame meanwhile
+	if(m_bDynamicResolution && !m_bHeadless && m_Pacer.TargetHz() > 0.0)
+		m_Resolution.SetBudget(1000.0 / m_Pacer.TargetHz(),0.5f);
 
+	//Everything the renderer needs is loaded, from here on only the render thread touches it
+	if(m_pD3DDevice || m_pSoftRenderer)
+		m_RenderThread=std::thread(&CDirectXFramework::RenderThread,this);
 }
 
 void CDirectXFramework::Update(float dt)
 {
-	
-
-	//Operates movement and collision of enemy objects in main game area. 
-	if(gameState == GAME)
-	{
-		/*
-		if(EnemyList.size() < 1)
-		{
-			//all enemies gone 
-			gameState=END;
-			return;
-		}
-		std::list<EnemyPositions>::iterator it; //iterator for EnemyList
-		std::list<Bullet>::iterator bulletIter; //iterator for bulletList
-		std::list<EnemyPositions>::iterator iter; //for testing end element
-		enemyCurrTimer=timeGetTime();
-		if( (enemyCurrTimer - enemyPrevTimer) >= 800.0f)
-		{
-			enemyPrevTimer=enemyCurrTimer;
-			RECT rect;
-			GetClientRect(m_hWnd,&rect);
-
-			//CHECK TO SEE IF ENEMIES MOVED TO EDGE OF SCREEN
-			for (it=EnemyList.begin(); it != EnemyList.end(); ++it)
-			{
-				if(MovementDirection == RIGHT && ((it->pos.x ) > rect.right - 50.0f) )
-				{
-					MovementDirection= LEFT;
-					SideReached=true;
-				}
-				else if(MovementDirection == LEFT && ( (it->pos.x) < rect.left + 50.0f) )
-				{
-					MovementDirection= RIGHT;
-					SideReached=true;
-				}
-			}
-			//IF SIDE IS REACHED MOVE DOWN AND SWITCH DIRECTIONS
-			if(SideReached)//enemies on edge of screen bounds
-			{
-				for(it=EnemyList.begin(); it != EnemyList.end(); ++it)
-				{
-					it->pos.y= it->pos.y + Enemy_Ship.Height;
-				}
-				SideReached=false; //we moved them down one
-			}
-
-			//MOVE SWARM IN DIRECTION OF MOVEMENT
-			if(MovementDirection==RIGHT)
-			{
-				for(it=EnemyList.begin(); it != EnemyList.end(); ++it)
-				{
-					it->pos.x= it->pos.x + Enemy_Ship.Width;
-				}
-			}
-			else if(MovementDirection==LEFT)
-			{
-				for(it=EnemyList.begin(); it != EnemyList.end(); ++it)
-				{
-					it->pos.x= it->pos.x - Enemy_Ship.Width;
-				}
-			}
-		
-		}//end if time passed > 2.0 seconds
-
-		//Test bullet logic
-		
-		if(bullets.size() < 1) //if bullets less than 0 nothing to test
-			{
-				//do nothing
-			}
-		else //test collisions
-		{
-			//for(it=EnemyList.begin(); it != EnemyList.end();
-
-			it=EnemyList.begin();
-			int enemySize=EnemyList.size();
-			//while( it != EnemyList.end() )
-			for(int i=0; i < enemySize; i++)
-			{
-				for(bulletIter=bullets.begin(); bulletIter != bullets.end();)
-				{
-					bulletIter->pos.y= bulletIter->pos.y - (120 * dt); //move each bullet up fast
-					//euclidean distance
-					float dist= sqrt( (it->pos.x - bulletIter->pos.x) * (it->pos.x - bulletIter->pos.x) + (it->pos.y - bulletIter->pos.y) * (it->pos.y - bulletIter->pos.y) );
-					//if distance is shorter than half length of both texture images, collision has occurred destroy both
-					if (dist < (Bullet_Image.Height / 2) + (Enemy_Ship.Height /2) )
-					{		
-						//collision happened destroy bullet and enemy and play sound
-						enemySize--;
-						HRESULT result=system->playSound(FMOD_CHANNEL_FREE,sound_explode,false, 0);
-						bulletIter=bullets.erase(bulletIter);
-						it=EnemyList.erase(it);			
-					}
-					else
-					{
-						++bulletIter;
-					}
-				}//end inner for loop
-				if(it != EnemyList.end() )
-					++it;
-			}//end primary for loop for bullet tests
-
-		}//end if else for bullet collision logic
-
-		//Test to see if invaders made it.
-		RECT rect;
-		GetClientRect(m_hWnd,&rect);
-		for(it=EnemyList.begin(); it != EnemyList.end(); ++it)
-				{
-					float dist= sqrt( (it->pos.x - PlayerPosition.x) * (it->pos.x - PlayerPosition.x) + (it->pos.y - PlayerPosition.y) * (it->pos.y - PlayerPosition.y) );
-					if (dist < (Player_Ship.Height / 2) + (Enemy_Ship.Height /2) )
-					{
-						gameState=ENDFAIL;
-					}
-					else if( it->pos.y > rect.bottom - 50.0f )
-					{
-						gameState=ENDFAIL;
-					}
-				}
-    */
-	}//end gameState decision logic
-	
-	ProcessKeyboard(dt); //process keyboard input
+	UpdateHotReload(); //files saved since the last frame
+	UpdateLoading(); //until everything is in
+	ProcessKeyboard(dt); //process keyboard input and step the game
 	UpdateFmod();
 }
 
 void CDirectXFramework::Render(float dt)
 {
-	// If the device was not created successfully, return
-	if(!m_pD3DDevice)
+	// If neither the device nor the software renderer was created, return
+	if(!m_pD3DDevice && !m_pSoftRenderer)
 		return;
 	//*************************************************************************
 
 
 	//////////////////////////////////////////////////////////////////////////
-	// All draw calls between swap chain's functions, and pre-render and post- 
-	// render functions (Clear and Present, BeginScene and EndScene)
+	// Record every draw call for this frame, the render thread does the
+	// Clear, BeginScene, sprite and text drawing, EndScene and Present
 	//////////////////////////////////////////////////////////////////////////
 
-	// Clear the back buffer, call BeginScene()
-	m_pD3DDevice->Clear(0,0,D3DCLEAR_TARGET | D3DCLEAR_ZBUFFER,D3DXCOLOR(0.0f,0.4f,0.9f,1.0f),1.0f,0);
+	//timings would make every headless frame different
+	m_Game.SetHud(!m_bHeadless,m_FPS.load(),m_Pacer.Stats(),m_RenderScale.load(),m_DrawMs.load());
 
-	m_pD3DDevice->BeginScene(); //start scene
-			//////////////////////////////////////////////////////////////////////////
-			// Draw 3D Objects (for future labs - not used in Week #1)
-			//////////////////////////////////////////////////////////////////////////
-
-			//////////////////////////////////////////////////////////////////////////
-			// Draw 2D sprites
-			//////////////////////////////////////////////////////////////////////////
-			
-			// Call Sprite's Begin to start rendering 2D sprite objects
-	m_pD3DSprite->Begin(D3DXSPRITE_ALPHABLEND | D3DXSPRITE_SORT_DEPTH_FRONTTOBACK);
-				//////////////////////////////////////////////////////////////////////////
-				// Matrix Transformations to control sprite position, scale, and rotate
-				// Set these matrices for each object you want to render to the screen
-				//////////////////////////////////////////////////////////////////////////
-				
-				RECT mRect;
-				GetClientRect(m_hWnd,&mRect);
-				float m_width= ( mRect.right-mRect.left) / 2;
-				float m_height=(mRect.bottom - mRect.top) /2;
-				float width= ( mRect.right-mRect.left) ;
-				float height=(mRect.bottom - mRect.top);
-				if(gameState == MENU) //if state is menu state
-				{
-					
-					if(menuState == PLAY) //if play
-						{
-							m_pD3DSprite->Draw(menuBackground,0,&D3DXVECTOR3(0.0f,0.0f,0.0f),&D3DXVECTOR3(0,0.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-							m_pD3DSprite->Draw(HL_PlayGameButton,0,&D3DXVECTOR3(img_HL_PlayGameButton.Width * 0.5f,img_HL_PlayGameButton.Height * 0.5f,0.0f),&D3DXVECTOR3((float)m_width - 20.0f,150.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-							m_pD3DSprite->Draw(CreditsButton,0,&D3DXVECTOR3(img_CreditsButton.Width * 0.5f,img_CreditsButton.Height * 0.5f,0.0f),&D3DXVECTOR3((float)m_width - 20.0f,225.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-							m_pD3DSprite->Draw(OptionsButton,0,&D3DXVECTOR3(img_OptionsButton.Width * 0.5f,img_OptionsButton.Height * 0.5f,0.0f),&D3DXVECTOR3((float)m_width - 20.0f,300.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-							m_pD3DSprite->Draw(QuitButton,0,&D3DXVECTOR3(img_QuitButton.Width * 0.5f,img_QuitButton.Height * 0.5f,0.0f),&D3DXVECTOR3((float)m_width - 20.0f,375.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-						}
-					if(menuState== CREDITS)
-						{
-							m_pD3DSprite->Draw(menuBackground,0,&D3DXVECTOR3(0.0f,0.0f,0.0f),&D3DXVECTOR3(0,0.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-							m_pD3DSprite->Draw(PlayGameButton,0,&D3DXVECTOR3(img_PlayGameButton.Width * 0.5f,img_PlayGameButton.Height * 0.5f,0.0f),&D3DXVECTOR3((float)m_width - 20.0f,150.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-							m_pD3DSprite->Draw(HL_CreditsButton,0,&D3DXVECTOR3(img_HL_CreditsButton.Width * 0.5f,img_HL_CreditsButton.Height * 0.5f,0.0f),&D3DXVECTOR3((float)m_width - 20.0f,225.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-							m_pD3DSprite->Draw(OptionsButton,0,&D3DXVECTOR3(img_OptionsButton.Width * 0.5f,img_OptionsButton.Height * 0.5f,0.0f),&D3DXVECTOR3((float)m_width - 20.0f,300.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-							m_pD3DSprite->Draw(QuitButton,0,&D3DXVECTOR3(img_QuitButton.Width * 0.5f,img_QuitButton.Height * 0.5f,0.0f),&D3DXVECTOR3((float)m_width - 20.0f,375.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-						}
-					if(menuState == OPTIONS)
-						{
-							m_pD3DSprite->Draw(menuBackground,0,&D3DXVECTOR3(0.0f,0.0f,0.0f),&D3DXVECTOR3(0,0.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-							m_pD3DSprite->Draw(PlayGameButton,0,&D3DXVECTOR3(img_PlayGameButton.Width * 0.5f,img_PlayGameButton.Height * 0.5f,0.0f),&D3DXVECTOR3((float)m_width - 20.0f,150.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-							m_pD3DSprite->Draw(CreditsButton,0,&D3DXVECTOR3(img_CreditsButton.Width * 0.5f,img_CreditsButton.Height * 0.5f,0.0f),&D3DXVECTOR3((float)m_width - 20.0f,225.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-							m_pD3DSprite->Draw(HL_OptionsButton,0,&D3DXVECTOR3(img_HL_OptionsButton.Width * 0.5f,img_HL_OptionsButton.Height * 0.5f,0.0f),&D3DXVECTOR3((float)m_width - 20.0f,300.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-							m_pD3DSprite->Draw(QuitButton,0,&D3DXVECTOR3(img_QuitButton.Width * 0.5f,img_QuitButton.Height * 0.5f,0.0f),&D3DXVECTOR3((float)m_width - 20.0f,375.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-						}
-					if(menuState == QUITGAME)
-						{
-							m_pD3DSprite->Draw(menuBackground,0,&D3DXVECTOR3(0.0f,0.0f,0.0f),&D3DXVECTOR3(0,0.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-							m_pD3DSprite->Draw(PlayGameButton,0,&D3DXVECTOR3(img_PlayGameButton.Width * 0.5f,img_PlayGameButton.Height * 0.5f,0.0f),&D3DXVECTOR3((float)m_width - 20.0f,150.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-							m_pD3DSprite->Draw(CreditsButton,0,&D3DXVECTOR3(img_CreditsButton.Width * 0.5f,img_CreditsButton.Height * 0.5f,0.0f),&D3DXVECTOR3((float)m_width - 20.0f,225.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-							m_pD3DSprite->Draw(OptionsButton,0,&D3DXVECTOR3(img_OptionsButton.Width * 0.5f,img_OptionsButton.Height * 0.5f,0.0f),&D3DXVECTOR3((float)m_width - 20.0f,300.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-							m_pD3DSprite->Draw(HL_QuitButton,0,&D3DXVECTOR3(img_HL_QuitButton.Width * 0.5f,img_HL_QuitButton.Height * 0.5f,0.0f),&D3DXVECTOR3((float)m_width - 20.0f,375.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-						}	
-				}//end menu draw
-				else if(gameState == GAME) //if current game state is game draw game screen
-				{
-					m_pD3DSprite->Draw(menuBackground,0,&D3DXVECTOR3(0.0f,0.0f,0.0f),&D3DXVECTOR3(0,0.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-					m_pD3DSprite->Draw(LevelOnePlayBoundary,0,&D3DXVECTOR3(0.0f,0.0f,0.0f),&D3DXVECTOR3(150.0f,50.0f,0.0f),D3DCOLOR_ARGB(255,255,255,255));
-
-
-					/*
-					std::list<EnemyPositions>::iterator it; //iterator for EnemyList
-					std::list<Bullet>::iterator bulletIter; //iterator for bullets list
-					//Draw All Enemies in EnemyList
-					for(it=EnemyList.begin(); it != EnemyList.end(); ++it)
-					{
-						m_pD3DSprite->Draw(EnemyShip_Texture,0,&D3DXVECTOR3(Enemy_Ship.Width * 0.5f,Enemy_Ship.Height * 0.5f,0.0f),&it->pos,D3DCOLOR_ARGB(255,255,255,255));
-					}
-					m_pD3DSprite->Draw(PlayerShip_Texture,0,&D3DXVECTOR3(Player_Ship.Width * 0.5f,Player_Ship.Height * 0.5f,0.0f),&PlayerPosition,D3DCOLOR_ARGB(255,255,255,255));
-					//Draw all player bullets if they exist
-					for(bulletIter=bullets.begin(); bulletIter != bullets.end(); ++bulletIter)
-					{
-						m_pD3DSprite->Draw(Bullet_Texture,0,&D3DXVECTOR3(Bullet_Image.Width * 0.5f,Bullet_Image.Height * 0.5f,0.0f),&bulletIter->pos,D3DCOLOR_ARGB(255,255,255,255));
-					}
-
-					*/
-					
-				}
-				
-
-				m_pD3DSprite->End();
-
-			//////////////////////////////////////////////////////////////////////////
-			// Draw Text
-			//////////////////////////////////////////////////////////////////////////
-
-			// Calculate RECT structure for text drawing placement, using whole screen
-			RECT rect;
-			//GetClientRect(m_hWnd,&formatRect);
-			GetClientRect(m_hWnd, &rect);
-			
-			// Draw Text, using DT_TOP, DT_RIGHT for placement in the top right of the
-			// screen.  DT_NOCLIP can improve speed of text rendering, but allows text
-			// to be drawn outside of the rect specified to draw text in.
-			m_pD3DFont->DrawTextW(NULL,L"GSP 362 - Course Project!",-1,&rect,DT_TOP | DT_RIGHT | DT_WORDBREAK,D3DCOLOR_ARGB(255,255,0,0) ); //draw text in upper right hand corner
-
-
-			//Draw FPS Counter
-			wchar_t buffer[64];
-			wchar_t bufferBig[512];
-			swprintf(buffer,64,L"FPS: %d",m_FPS);//m_FPS
-			m_pD3DFont->DrawTextW(0,buffer,-1,&rect,DT_TOP | DT_NOCLIP ,D3DCOLOR_ARGB(255,255,0,0));
-
-			swprintf(buffer,64,L"Press F1 for Menu/Pause");
-			m_pD3DFont->DrawTextW(0,buffer,-1,&rect,DT_BOTTOM | DT_LEFT | DT_NOCLIP ,D3DCOLOR_ARGB(255,255,0,0));
-
-			if(gameState == MENU)
-			{
-				RECT rectangle;
-				GetClientRect(m_hWnd,&rectangle);
-				rectangle.left=(float)m_width -80.0f;
-				rectangle.right=(float)m_width - 20.0f + 220.0f;
-				rectangle.top=50.0f;
-				rectangle.bottom=200.0f;
-				m_pD3DFont->DrawTextW(NULL,L"Shipping Madness!!!",-1,&rectangle,  DT_CALCRECT,D3DCOLOR_ARGB(255,255,0,0) ); //draw text in upper right hand corner
-				m_pD3DFont->DrawTextW(NULL,L"Shipping Madness!!!",-1,&rectangle, DT_CENTER,D3DCOLOR_ARGB(255,255,0,0) );
-			}
+	m_pFrame=&m_FrameQueue.BeginWrite();
+	m_Game.Record(*m_pFrame);
 
-			if(gameState == CREDS) //if current game state is credits
-				{
-					swprintf(bufferBig,512,L"\n\nCredits!\n\n\n Design, Development, Programming, and Testing done by...\n Team A\n Robert Evans\nNicholas Grande\nJustin Atkinson\nTylor Emmett\nJeromy Jones\nLeseth Mitchell");
-					m_pD3DFont->DrawTextW(0,bufferBig,-1,&rect,DT_CENTER | DT_NOCLIP ,D3DCOLOR_ARGB(255,25,255,255));
-				}
-			if(gameState == OPTS)
-			{
-				swprintf(buffer,64,L"\n\nOPTIONS\n\n\n\n FULL SCREEN - Press Y for FullScreen or N for Windowed Mode\n");
-				m_pD3DFont->DrawTextW(0,buffer,-1,&rect,DT_CENTER | DT_NOCLIP ,D3DCOLOR_ARGB(255,25,255,255));
-			}
-			if(gameState == END)
-			{
-				swprintf(buffer,64,L"\n\nCONGRATULATIONS!\n\n\n\n YOU HAVE DEFEATED THE ATTACKERS\n");
-				m_pD3DFont->DrawTextW(0,buffer,-1,&rect,DT_CENTER | DT_NOCLIP ,D3DCOLOR_ARGB(255,25,255,255));
-			}
-			if(gameState == ENDFAIL)
-			{
-				swprintf(buffer,64,L"\n\nYOU LOST!!!!!\n\n\n\n YOU WERE DOMINATED!\n");
-				m_pD3DFont->DrawTextW(0,buffer,-1,&rect,DT_CENTER | DT_NOCLIP ,D3DCOLOR_ARGB(255,25,255,255));
-			}
-			
-			// EndScene, and Present the back buffer to the display buffer
-			m_pD3DDevice->EndScene();
-			m_pD3DDevice->Present(0,0,0,0);
-
-	//Calculate Frames Per Second
-	m_currTime = timeGetTime();
-	static int fpsCounter = 0;
-	if( (m_currTime - m_prevTime) >= 1000.0f)
-	{
-		m_prevTime=m_currTime;
-		m_FPS=fpsCounter;
-		fpsCounter=0;
-	}
-	else
-	{
-		fpsCounter++;
-	}
+	// Hand the finished list to the render thread
+	EndFrame();
 	//*************************************************************************
 	
 }
@@ -562,16 +307,34 @@ void CDirectXFramework::Render(float dt)
 void CDirectXFramework::Shutdown()
 {
 	//*************************************************************************
+	// Stop the render thread first, it is the only user of everything below
+	StopRenderThread();
+	m_Loader.Stop();
+
 	// Release COM objects in the opposite order they were created in
-	SAFE_RELEASE(m_pTexture);//texture com for test.tga
+	// Static layer cache and the scaled scene target
+	ReleaseStaticLayers();
+	SAFE_RELEASE(m_pSceneSurface);
+	// Textures
+	for(int i=0; i < TEX_COUNT; i++)
+	{
+		SAFE_RELEASE(m_Textures[i]);
+	}
+	// Software renderer
+	delete m_pSoftRenderer;
+	m_pSoftRenderer=0;
 	// Sprite
-	m_pD3DSprite->Release();//for sprite com for rendering various sprites
+	SAFE_RELEASE(m_pD3DSprite);//for sprite com for rendering various sprites
 	// Font
-	m_pD3DFont->Release();
+	SAFE_RELEASE(m_pD3DFont);
 	// 3DDevice	
-	m_pD3DDevice->Release();
+	SAFE_RELEASE(m_pD3DDevice);
 	// 3DObject
-	m_pD3DObject->Release();
+	SAFE_RELEASE(m_pD3DObject);
+	// Font added from the archive, the archive itself stays mapped for FMOD
+	if(m_hFont)
+		RemoveFontMemResourceEx(m_hFont);
+	m_hFont=0;
 	//*************************************************************************
 }
 
@@ -579,163 +342,57 @@ void CDirectXFramework::Shutdown()
 
 void CDirectXFramework::ProcessKeyboard(float dt)
 {
-	//Rect used by code to limit leaving viewing area
-	RECT rect;
-	GetClientRect(m_hWnd,&rect);
-	//used a speed  because I thought of the roughly 5000 fps I was getting
-	float speed = 100.0f * dt; 
-	float mouseSpeed=2.0f ;
 	//poll mouse and keyboard states
 	g_DInput->poll();
 
-	////////////////////////////////////////////////////////////////////
-	//GAME STATE MENU
-	////////////////////////////////////////////////////////////////////
-
-	//MENU STATE INPUT PROCESSING
-	if(gameState == MENU) //if current state is menu
-	{
-		//turn off main game background music and play menu music
-		channel_background->setPaused(true);
-		channel_Wave->setPaused(false);
+	//DirectInput key codes for each GAME_KEY_
+	static const int keyCodes[GAME_KEY_COUNT]={DIK_UP,DIK_DOWN,DIK_LEFT,DIK_RIGHT,DIK_RETURN,DIK_SPACE,DIK_F1};
+	GameInput input;
+	for(int i=0; i < GAME_KEY_COUNT; i++)
+		input.keys[i]=g_DInput->keyDown(keyCodes[i]);
 
-		//handles menu selection
-		if(g_DInput->keyDown(DIK_UP) && menuState == PLAY) //if up key pressed and current selected is Play
-		{
-			menuState=QUITGAME;
-			PlayMenuSound();
-			Sleep(150);
-		}
-		else if(g_DInput->keyDown(DIK_DOWN) && menuState == QUITGAME) //if up key pressed and current selected is QUIT
-		{
-			menuState=PLAY;
-			PlayMenuSound();
-			Sleep(150);
-		}
-		else if(g_DInput->keyDown(DIK_DOWN) && (menuState < QUITGAME) ) //otherwise just decrement
-		{
-			menuState+=1;
-			PlayMenuSound();
-			Sleep(150);
-		}
-		else if(g_DInput->keyDown(DIK_UP) && menuState > PLAY)
-		{
-			menuState-= 1;
-			PlayMenuSound();
-			Sleep(150);
-		}
-
-		//HANDLE SELECTION OF MENU ITEMS
-		if(g_DInput->keyDown(DIK_RETURN) )// enter was pressed in the menu
-		{
-			if(menuState == PLAY )//if play
-			{
-				gameState=GAME; //game state to play game
-			}
-			else if(menuState == CREDITS ) //if credits selected
-			{
-				gameState=CREDS; //CREDS game state display credits
-			}
-			else if(menuState== OPTIONS) //if options selected
-			{
-				gameState=OPTS; //game state OPTS options
-			}
-			else if(menuState == QUITGAME) //if quit entered exit game
-			{
-				PostQuitMessage(0);
-				
-			}
-		}
-	} //END MENU STATE PROCESSING
-	//START GAME STATE INPUT PROCESSING
-	else if(gameState== GAME)
-	{
-		channel_Wave->setPaused(true);
-		channel_background->setPaused(false);
-
-		RECT rect;
-		GetClientRect(m_hWnd,&rect);
-		//if left arrow is pressed
-
-		/*
-		if(g_DInput->keyDown(DIK_LEFT) )
-		{
-			PlayerPosition.x= PlayerPosition.x - 100.0f * dt;
-			if(PlayerPosition.x < rect.left + 10.0f)
-			{
-				PlayerPosition.x=rect.left + 10.0f;
-			}
-		}
+	//the window may have been resized since the last frame
+	RECT rect;
+	GetClientRect(m_hWnd,&rect);
+	m_Game.SetViewport(rect.right - rect.left,rect.bottom - rect.top);
 
-		//if Right arrow is pressed
-		if(g_DInput->keyDown(DIK_RIGHT) )
-		{
-			PlayerPosition.x= PlayerPosition.x + 100.0f * dt;
-			if(PlayerPosition.x > rect.right - 10.0f)
-			{
-				PlayerPosition.x=rect.right - 10.0f;
-			}
-		}
+	m_Game.Update(dt,input);
 
-		//if Space key is pressed
-		if(g_DInput->keyDown(DIK_SPACE) )//g_DInput->keyDown(DIK_SPACE
-		{
-			//if(canFire == true)
-			//{
-				bullets.push_back(Bullet(D3DXVECTOR3(PlayerPosition.x,PlayerPosition.y - 50.0f,0.0f) ) );
-				Sleep(200);
-			//}
-			
-		}
-		*/
-		//IF f1 pressed set menu
-		if(g_DInput->keyDown(DIK_F1) )
-		{
-			gameState=MENU;
-			menuState=PLAY;
-			Sleep(50);
-		}
-	}//END GAME STATE KEYBOARD PROCESSING
+	//the screen's music plays and the others pause, posted only when the
+	//screen's music changes
+	m_Audio.SetMusic(m_Game.Music());
 
-	if(g_DInput->keyDown(DIK_F1) )
-		{
-			gameState=MENU;
-			menuState=PLAY;
-			Sleep(50);
-		}
+	unsigned int sounds=m_Game.TakeSounds();
+	for(int sound=0; sound < SND_COUNT; sound++)
+	{
+		if(sounds & (1u << sound))
+			m_Audio.Play(sound);
+	}
 
+	if(m_Game.IsQuitRequested())
+		PostQuitMessage(0);
 }
 
 
 void CDirectXFramework::InitFmod()
 {
-	FMOD_RESULT result;
+	TraceScope trace("InitFmod");
 
-	result=FMOD::System_Create(&system); //system is a CDirectXFramework data member
-
-	if(result != FMOD_OK)
-	{
-		printf("FMOD Error! (%d) %s\n",result);
+	//FMOD is only called from its own thread, from here on the game thread
+	//just posts to it.  Sounds open in the background unless the whole load
+	//is meant to finish before the first frame
+	bool bBlocking=m_bSerialLoad || m_bHeadless;
+	if(!m_Audio.Start(&m_Archive,m_bHeadless,bBlocking))
 		exit(-1);
-	}
-	
-	result=system->init(100,FMOD_INIT_NORMAL,0); //initialize FMOD
 
-	if(result != FMOD_OK)
-	{
-		printf("FMOD Error! (%d) %s\n",result);
-		exit(-1);
-	}
-
-	//Load sounds
-	system->createSound("tada.wav",FMOD_DEFAULT,0,&sound_Tada);
-	system->createSound("chord.wav",FMOD_DEFAULT,0,&sound_Chord);
-	system->createSound("ding.wav",FMOD_DEFAULT,0,&sound_Ding);
-	system->createSound("jaguar.wav",FMOD_DEFAULT,0,&sound_Jaguar);
-	system->createSound("swish.wav",FMOD_DEFAULT,0,&sound_Swish);
-	system->createStream("wave.mp3",FMOD_DEFAULT,0,&sound_Wave);
-	system->createSound("Explosion1.wav",FMOD_DEFAULT,0,&sound_explode);
-	system->createStream("DXclub.mp3",FMOD_DEFAULT,0,&sound_background);
+	//Load sounds, each is open while the game wants its asset group, the
+	//menu music comes first
+	m_SoundAssets.Clear();
+	for(int i=0; i < SND_COUNT; i++)
+		m_SoundAssets.Add(i,Game::SoundInfo(i).file,Game::SoundInfo(i).groups);
+	m_Audio.SetSoundGroups(WantedAssetGroups());
+	while(bBlocking && m_Audio.Opened() < SND_COUNT)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
 
 	//initialize bool keyboard press tracker array for UpdateFmod function to false
 	for(int i=0; i < 256 ; i++)
@@ -747,124 +404,35 @@ void CDirectXFramework::InitFmod()
 
 void CDirectXFramework::UpdateFmod()
 {
-	
-	FMOD_RESULT result; //for error checking
-	g_DInput->poll(); //get kb data
-
-
-	//////////////////////////////////////////////////////////
-	//Space Key
-	/////////////////////////////////////////////////////////
-	if(g_DInput->keyDown(DIK_SPACE) ) //if space key pressed
+	//test keys, each plays its sound once per press
+	static const struct
 	{
-		if(! m_bKeydown[DIK_SPACE] ) //if the space key wasn't held down previously
-		{
-			m_bKeydown[DIK_SPACE]=true; //mark key as pressed in bool array
-
-			result=system->playSound(FMOD_CHANNEL_FREE,sound_Tada,false, 0); //last param for channel if wanted for manipulation
-			//FMOD::ERRCHECK(result);
-
-		}
-	}
-	else //if space key isn't down
-	{
-		if(m_bKeydown[DIK_SPACE] ) //if space key was previously down, then a key up event just happened
-		{
-			m_bKeydown[DIK_SPACE]=false;
-		}
-	}
-	////////////////////////////////////////////////////////////////
-	//1 Key Press
-	////////////////////////////////////////////////////////////////
-	if(g_DInput->keyDown(DIK_1) ) //if space key pressed
-	{
-		if(! m_bKeydown[DIK_1] ) //if the space key wasn't held down previously
-		{
-			m_bKeydown[DIK_1]=true; //mark key as pressed in bool array
-
-			result=system->playSound(FMOD_CHANNEL_FREE,sound_Chord,false, 0); //last param for channel if wanted for manipulation
-			//FMOD::ERRCHECK(result);
-
-		}
+		int		key;
+		int		sound;
 	}
-	else //if space key isn't down
+	testKeys[]=
 	{
-		if(m_bKeydown[DIK_1] ) //if space key was previously down, then a key up event just happened
-		{
-			m_bKeydown[DIK_1]=false;
-		}
-	}
-	////////////////////////////////////////////////////////////////
-	//2 Key Press
-	////////////////////////////////////////////////////////////////
-	if(g_DInput->keyDown(DIK_2) ) //if space key pressed
-	{
-		if(! m_bKeydown[DIK_2] ) //if the space key wasn't held down previously
-		{
-			m_bKeydown[DIK_2]=true; //mark key as pressed in bool array
-
-			result=system->playSound(FMOD_CHANNEL_FREE,sound_Ding,false, 0); //last param for channel if wanted for manipulation
-			//FMOD::ERRCHECK(result);
+		{DIK_SPACE,SND_TADA},
+		{DIK_1,SND_CHORD},
+		{DIK_2,SND_MENU_MOVE},
+		{DIK_3,SND_JAGUAR},
+		{DIK_4,SND_SWISH}
+	};
 
-		}
-	}
-	else //if space key isn't down
-	{
-		if(m_bKeydown[DIK_2] ) //if space key was previously down, then a key up event just happened
-		{
-			m_bKeydown[DIK_2]=false;
-		}
-	}
-	////////////////////////////////////////////////////////////////
-	//3 Key Press
-	////////////////////////////////////////////////////////////////
-	if(g_DInput->keyDown(DIK_3) ) //if space key pressed
-	{
-		if(! m_bKeydown[DIK_3] ) //if the space key wasn't held down previously
-		{
-			m_bKeydown[DIK_3]=true; //mark key as pressed in bool array
-
-			result=system->playSound(FMOD_CHANNEL_FREE,sound_Jaguar,false, 0); //last param for channel if wanted for manipulation
-			//FMOD::ERRCHECK(result);
-
-		}
-	}
-	else //if space key isn't down
-	{
-		if(m_bKeydown[DIK_3] ) //if space key was previously down, then a key up event just happened
-		{
-			m_bKeydown[DIK_3]=false;
-		}
-	}
-	////////////////////////////////////////////////////////////////
-	//4 Key Press
-	////////////////////////////////////////////////////////////////
-	if(g_DInput->keyDown(DIK_4) ) //if space key pressed
-	{
-		if(! m_bKeydown[DIK_4] ) //if the space key wasn't held down previously
-		{
-			m_bKeydown[DIK_4]=true; //mark key as pressed in bool array
-
-			result=system->playSound(FMOD_CHANNEL_FREE,sound_Swish,false, 0); //last param for channel if wanted for manipulation
-			//FMOD::ERRCHECK(result);
-
-		}
-	}
-	else //if space key isn't down
+	g_DInput->poll(); //get kb data
+	for(int i=0; i < (int)(sizeof(testKeys) / sizeof(testKeys[0])); i++)
 	{
-		if(m_bKeydown[DIK_4] ) //if space key was previously down, then a key up event just happened
-		{
-			m_bKeydown[DIK_4]=false;
-		}
+		int key=testKeys[i].key;
+		bool bDown=g_DInput->keyDown(key) != 0;
+		if(bDown && !m_bKeydown[key]) //a key down event just happened
+			m_Audio.Play(testKeys[i].sound);
+		m_bKeydown[key]=bDown;
 	}
-
-	//////////////////////////////////////////
-	system->update(); //FMOD object update
-
 }
 
 void CDirectXFramework::InitDirectShow()
 {
+	TraceScope trace("InitDirectShow");
 
 	CoInitialize(NULL); //init COM library
 
@@ -955,7 +523,696 @@ bool CDirectXFramework::KeyPressed(char key)
 
 void CDirectXFramework::PlayMenuSound()
 {
-	system->playSound(FMOD_CHANNEL_FREE,sound_Ding,false, 0);
+	m_Audio.Play(SND_MENU_MOVE);
+
+}
+
+void CDirectXFramework::UseSoftwareRenderer(bool bSoftware)
+{
+	m_bSoftware=bSoftware;
+}
+
+void CDirectXFramework::SetPacing(PaceMode mode, double targetHz)
+{
+	m_Pacer.SetMode(mode,targetHz);
+}
+
+void CDirectXFramework::Pace()
+{
+	//vsynced Present blocks the render thread, waiting for it to take the
+	//frame holds the game loop to the display without a second timer
+	if(m_Pacer.Mode() == PACE_VSYNC)
+		m_FrameQueue.WaitUntilTaken();
+
+	m_Pacer.Wait();
+}
+
+void CDirectXFramework::SetSerialLoad(bool bSerial)
+{
+	m_bSerialLoad=bSerial;
+}
+
+void CDirectXFramework::SetImageCache(bool bCache)
+{
+	m_bImageCache=bCache;
+}
+
+void CDirectXFramework::SetTextureBudget(size_t bytes)
+{
+	m_TextureBudget=bytes;
+}
+
+void CDirectXFramework::SetDynamicResolution(bool bEnabled)
+{
+	m_bDynamicResolution=bEnabled;
+}
+
+void CDirectXFramework::SetHeadless(bool bHeadless)
+{
+	m_bHeadless=bHeadless;
+	if(m_bHeadless)
+	{
+		m_bSoftware=true;
+		m_Pacer.SetMode(PACE_UNLIMITED,0.0);
+	}
+}
+
+int CDirectXFramework::RunRegression(const char* goldenDir, const char* outputDir, int tolerance, bool bUpdate)
+{
+	//every scenario is recorded and drawn on this thread, one frame at a time
+	StopRenderThread();
+	m_FrameQueue.Restart();
+	if(!m_pSoftRenderer)
+		return -1;
+
+	const int timedFrames=100;
+
+	int savedGameState=m_Game.State();
+	int savedMenuState=m_Game.Menu();
+	FrameRegression regression(goldenDir,outputDir,tolerance,bUpdate);
+
+	for(int i=0; i < Game::ScenarioCount(); i++)
+	{
+		const GameScenario& scenario=Game::Scenario(i);
+		m_Game.SetState(scenario.gameState,scenario.menuState);
+
+		//frame 0 warms the caches and isn't timed
+		double recordTime=0.0;
+		double drawTime=0.0;
+		for(int frame=0; frame <= timedFrames; frame++)
+		{
+			double start=FramePacer::Now();
+			Render(0.0f);
+			const RenderCommandList* commands=m_FrameQueue.Acquire();
+			double recorded=FramePacer::Now();
+			DrawFrame(*commands);
+			double drawn=FramePacer::Now();
+			if(frame > 0)
+			{
+				recordTime+=recorded - start;
+				drawTime+=drawn - recorded;
+			}
+		}
+
+		regression.Check(scenario.name,m_pSoftRenderer->BackBuffer(),recordTime * 1000.0 / timedFrames,drawTime * 1000.0 / timedFrames);
+	}
+
+	m_Game.SetState(savedGameState,savedMenuState);
+
+	std::string report=regression.WriteReport();
+	printf("%s",report.c_str());
+	OutputDebugStringA(report.c_str());
+	return regression.Failures();
+}
+
+bool CDirectXFramework::SaveFrame(const char* filename)
+{
+	if(!m_bSoftware)
+		return false;
+
+	m_CaptureFile=filename; //attached to the next frame EndFrame submits
+	return true;
+}
+
+void CDirectXFramework::LoadTextures()
+{
+	TraceScope trace("LoadTextures");
+	m_Residency.Reset(TEX_COUNT,m_TextureBudget);
+	for(int i=0; i < TEX_COUNT; i++)
+	{
+		m_Textures[i]=0;
+		ZeroMemory(&m_TextureInfo[i],sizeof(D3DXIMAGE_INFO));
+	}
+
+	//the software renderer can't sample blocks, have the workers decode those too
+	m_ImageCache.SetDirectory(m_bImageCache ? ImageCacheDirectory : 0);
+	m_Loader.SetArchive(&m_Archive);
+	m_Loader.SetCache(&m_ImageCache);
+	m_Loader.Start(m_bSerialLoad ? 1 : 0,m_bSoftware);
+
+	//the groups the game starts out wanting, the menu's textures first
+	m_TextureGroups=WantedAssetGroups();
+	m_AssetGroups=m_TextureGroups;
+	for(int i=0; i < TEX_COUNT; i++)
+	{
+		if(Game::IsMenuTexture(i) && (Game::TextureGroups(i) & m_TextureGroups))
+			m_Loader.Queue(i,Game::TextureFile(i));
+	}
+	for(int i=0; i < TEX_COUNT; i++)
+	{
+		if(!Game::IsMenuTexture(i) && (Game::TextureGroups(i) & m_TextureGroups))
+			m_Loader.Queue(i,Game::TextureFile(i));
+	}
+
+	//only the menu has to be there for the first frame, headless runs
+	//compare every frame so they wait for everything
+	bool bAll=m_bSerialLoad || m_bHeadless;
+	int waiting=0;
+	for(int i=0; i < TEX_COUNT; i++)
+	{
+		if((Game::TextureGroups(i) & m_TextureGroups) && (bAll || Game::IsMenuTexture(i)))
+			waiting++;
+	}
+
+	DecodedTexture decoded;
+	while(waiting > 0 && m_Loader.Take(decoded,true))
+	{
+		if(bAll || Game::IsMenuTexture(decoded.id))
+			waiting--;
+		UploadTexture(decoded);
+	}
+}
+
+bool CDirectXFramework::LoadTexture(int texture)
+{
+	DecodedTexture decoded;
+	decoded.id=texture;
+	AssetLoader::Decode(&m_Archive,&m_ImageCache,Game::TextureFile(texture),m_bSoftware,decoded);
+	return UploadTexture(decoded);
+}
+
+bool CDirectXFramework::UploadTexture(DecodedTexture& decoded)
+{
+	int texture=decoded.id;
+	if(texture < 0 || texture >= TEX_COUNT)
+		return false;
+	TraceScope trace("Upload texture",Game::TextureFile(texture));
+	if(!decoded.width)
+	{
+		std::string report=std::string("Missing texture ") + Game::TextureFile(texture) + "\n";
+		OutputDebugStringA(report.c_str());
+		return false;
+	}
+
+	if(m_bSoftware)
+	{
+		//decoded already, only has to move in
+		if(decoded.image.IsEmpty())
+			return false;
+		m_Images[texture]=std::move(decoded.image);
+
+		m_TextureInfo[texture].Width			=m_Images[texture].Width();
+		m_TextureInfo[texture].Height			=m_Images[texture].Height();
+		m_TextureInfo[texture].Depth			=1;
+		m_TextureInfo[texture].MipLevels		=1;
+		m_TextureInfo[texture].Format			=D3DFMT_A8R8G8B8;
+		m_TextureInfo[texture].ResourceType		=D3DRTYPE_TEXTURE;
+		m_TextureInfo[texture].ImageFileFormat	=decoded.bDDS ? D3DXIFF_DDS : D3DXIFF_PNG;
+		m_Residency.SetLoaded(texture,(size_t)m_Images[texture].Width() * m_Images[texture].Height() * sizeof(unsigned int));
+		return true;
+	}
+
+	if(!decoded.bDDS || !CreateCompressedTexture(texture,decoded.dds))
+	{
+		//a PNG, or blocks the device can't take
+		if(decoded.bDDS && decoded.image.IsEmpty())
+			decoded.dds.Decompress(0,decoded.image);
+		if(decoded.image.IsEmpty() || !CreateImageTexture(texture,decoded.image))
+			return false;
+	}
+	m_Residency.SetLoaded(texture,TextureBytes(m_Textures[texture]));
+	return true;
+}
+
+void CDirectXFramework::UploadFinishedTextures()
+{
+	//dropped if the game moved on while it was decoding, or if a frame drew it
+	//in by then.  Failed ones go through to be reported
+	DecodedTexture decoded;
+	while(m_Loader.Take(decoded,false))
+	{
+		int texture=decoded.id;
+		if(!decoded.width)
+		{
+			UploadTexture(decoded); //a broken reload leaves the old one in
+		}
+		else if(decoded.bReload && m_Residency.IsResident(texture))
+		{
+			//a changed file, swapped in between two frames.  The static layer
+			//cache may have the old pixels
+			ReleaseTexture(texture);
+			UploadTexture(decoded);
+			m_StaticLayers.Invalidate();
+			if(m_pSoftRenderer)
+				m_pSoftRenderer->InvalidateStaticLayers();
+			std::string report=std::string("Reloaded ") + Game::TextureFile(texture) + "\n";
+			OutputDebugStringA(report.c_str());
+		}
+		else if((Game::TextureGroups(texture) & m_TextureGroups) && !m_Residency.IsResident(texture))
+		{
+			UploadTexture(decoded);
+		}
+	}
+}
+
+void CDirectXFramework::ApplyTextureGroups(unsigned int groups)
+{
+	if(groups == m_TextureGroups)
+		return;
 
+	//queue what the new groups add, textures that failed before are not
+	//retried.  Ones in a group that stays are left to the budget
+	for(int i=0; i < TEX_COUNT; i++)
+	{
+		unsigned int textureGroups=Game::TextureGroups(i);
+		int width=0;
+		if(!(textureGroups & groups))
+		{
+			if(m_Residency.IsResident(i))
+				ReleaseTexture(i);
+		}
+		else if(!(textureGroups & m_TextureGroups) && !m_Residency.IsResident(i) && !m_Loader.IsPending(i) &&
+				!(m_Loader.IsFinished(i,&width,0) && !width))
+		{
+			m_Loader.Queue(i,Game::TextureFile(i));
+		}
+	}
+	m_TextureGroups=groups;
 }
 
+unsigned int CDirectXFramework::WantedAssetGroups() const
+{
+	//headless runs jump between screens and compare every frame
+	return m_bHeadless ? ASSETS_ALL : m_Game.AssetGroups();
+}
+
+void CDirectXFramework::ReleaseTexture(int texture)
+{
+	//m_TextureInfo stays, the game keeps laying the texture out from it
+	SAFE_RELEASE(m_Textures[texture]);
+	m_Images[texture].Release();
+	m_Residency.SetEvicted(texture);
+}
+
+size_t CDirectXFramework::TextureBytes(IDirect3DTexture9* pTexture)
+{
+	//every mip level, the device copy only, managed textures keep a second
+	//copy in system memory
+	size_t bytes=0;
+	for(DWORD level=0; level < pTexture->GetLevelCount(); level++)
+	{
+		D3DSURFACE_DESC desc;
+		if(FAILED(pTexture->GetLevelDesc(level,&desc)))
+			break;
+
+		size_t blocks=(size_t)((desc.Width + 3) / 4) * ((desc.Height + 3) / 4);
+		if(desc.Format == D3DFMT_DXT1)
+			bytes+=blocks * 8;
+		else if(desc.Format == D3DFMT_DXT5)
+			bytes+=blocks * 16;
+		else
+			bytes+=(size_t)desc.Width * desc.Height * 4;
+	}
+	return bytes;
+}
+
+bool CDirectXFramework::CreateCompressedTexture(int texture, const DDSTexture& dds)
+{
+	//the DDS is only padded to whole blocks, cards that need power of two
+	//sizes get the PNG and let D3DX round it up instead
+	bool bPow2=(dds.Width() & (dds.Width() - 1)) == 0 && (dds.Height() & (dds.Height() - 1)) == 0;
+	if((m_D3DCaps.TextureCaps & D3DPTEXTURECAPS_POW2) && !bPow2)
+		return false;
+
+	D3DFORMAT format=dds.Format() == DDS_BC1 ? D3DFMT_DXT1 : D3DFMT_DXT5;
+	if(FAILED(m_pD3DObject->CheckDeviceFormat(D3DADAPTER_DEFAULT,D3DDEVTYPE_HAL,D3DFMT_X8R8G8B8,0,D3DRTYPE_TEXTURE,format)))
+		return false;
+
+	IDirect3DTexture9* pTexture=0;
+	if(FAILED(m_pD3DDevice->CreateTexture(dds.Width(),dds.Height(),dds.LevelCount(),0,format,D3DPOOL_MANAGED,&pTexture,0)))
+		return false;
+
+	//copy each level a row of blocks at a time, the driver's pitch can be wider
+	for(int level=0; level < dds.LevelCount(); level++)
+	{
+		D3DLOCKED_RECT locked;
+		if(FAILED(pTexture->LockRect(level,&locked,0,0)))
+		{
+			pTexture->Release();
+			return false;
+		}
+
+		int pitch=dds.LevelPitch(level);
+		int rows=(dds.LevelHeight(level) + 3) / 4;
+		const unsigned char* source=dds.LevelData(level);
+		unsigned char* destination=(unsigned char*)locked.pBits;
+		for(int row=0; row < rows; row++)
+			memcpy(destination + row * locked.Pitch,source + row * pitch,pitch);
+
+		pTexture->UnlockRect(level);
+	}
+
+	//sprites are placed from the image size, not the padded texture size
+	m_Textures[texture]=pTexture;
+	m_TextureInfo[texture].Width			=dds.ContentWidth();
+	m_TextureInfo[texture].Height			=dds.ContentHeight();
+	m_TextureInfo[texture].Depth			=1;
+	m_TextureInfo[texture].MipLevels		=dds.LevelCount();
+	m_TextureInfo[texture].Format			=format;
+	m_TextureInfo[texture].ResourceType		=D3DRTYPE_TEXTURE;
+	m_TextureInfo[texture].ImageFileFormat	=D3DXIFF_DDS;
+	return true;
+}
+
+bool CDirectXFramework::CreateImageTexture(int texture, const Image& image)
+{
+	//already premultiplied, 0xAARRGGBB is D3DFMT_A8R8G8B8 in memory
+	IDirect3DTexture9* pTexture=0;
+	if(FAILED(m_pD3DDevice->CreateTexture(image.Width(),image.Height(),1,0,D3DFMT_A8R8G8B8,D3DPOOL_MANAGED,&pTexture,0)))
+		return false;
+
+	D3DLOCKED_RECT locked;
+	if(FAILED(pTexture->LockRect(0,&locked,0,0)))
+	{
+		pTexture->Release();
+		return false;
+	}
+	for(int y=0; y < image.Height(); y++)
+		memcpy((unsigned char*)locked.pBits + y * locked.Pitch,image.Row(y),image.Width() * sizeof(unsigned int));
+	pTexture->UnlockRect(0);
+
+	m_Textures[texture]=pTexture;
+	m_TextureInfo[texture].Width			=image.Width();
+	m_TextureInfo[texture].Height			=image.Height();
+	m_TextureInfo[texture].Depth			=1;
+	m_TextureInfo[texture].MipLevels		=1;
+	m_TextureInfo[texture].Format			=D3DFMT_A8R8G8B8;
+	m_TextureInfo[texture].ResourceType		=D3DRTYPE_TEXTURE;
+	m_TextureInfo[texture].ImageFileFormat	=D3DXIFF_PNG;
+	return true;
+}
+
+void CDirectXFramework::UpdateLoading()
+{
+	//the render thread picks the textures up before its next frame
+	unsigned int groups=WantedAssetGroups();
+	m_AssetGroups=groups;
+	m_Audio.SetSoundGroups(groups);
+
+	//FMOD's thread starts the music as each stream opens.  Progress is over
+	//the wanted groups, released sounds count as open
+	int loaded=m_Audio.Opened();
+	int total=m_SoundAssets.Count();
+
+	//the render thread uploads each one before drawing a frame that uses it,
+	//the sizes stay the same when a released texture comes back
+	for(int i=0; i < TEX_COUNT; i++)
+	{
+		if(!(Game::TextureGroups(i) & groups))
+			continue;
+		total++;
+		int width=0, height=0;
+		if(m_Loader.IsFinished(i,&width,&height))
+		{
+			m_Game.SetTextureSize(i,width,height);
+			loaded++;
+		}
+	}
+	m_Game.SetLoadProgress((float)loaded / total);
+
+	if(loaded == total && !m_bAllLoaded)
+	{
+		TraceLog::Mark("All assets loaded");
+		m_bAllLoaded=true;
+	}
+}
+
+void CDirectXFramework::UpdateHotReload()
+{
+	//a changed file shadows its packed copy from now on, textures decode on
+	//the loader's workers and sounds open on FMOD's thread, which swaps them in
+	const std::vector<std::string>& changed=m_Watcher.Poll();
+	for(size_t i=0; i < changed.size(); i++)
+	{
+		const char* filename=changed[i].c_str();
+		m_Archive.Shadow(filename);
+		int texture=Game::FindTexture(filename);
+		int sound=m_SoundAssets.Slot(m_SoundAssets.Find(filename));
+		if(texture >= 0)
+			m_Loader.Reload(texture,Game::TextureFile(texture));
+		else if(sound >= 0)
+			m_Audio.Reload(m_SoundAssets.Id(sound));
+	}
+}
+
+void CDirectXFramework::EndFrame()
+{
+	if(!m_CaptureFile.empty())
+	{
+		m_pFrame->SetCapture(m_CaptureFile);
+		m_CaptureFile.clear();
+	}
+
+	//layer, texture, depth order, the render thread just walks the list
+	m_pFrame->Sort();
+	m_FrameQueue.Submit();
+	m_pFrame=0;
+}
+
+void CDirectXFramework::RenderThread()
+{
+	TraceLog::NameThread("Render thread");
+	int fpsCounter=0;
+	bool bFirstFrame=true;
+	const RenderCommandList* frame;
+	while((frame=m_FrameQueue.Acquire()) != 0)
+	{
+		//Present is left out, with vsync it is mostly waiting for the display
+		double start=FramePacer::Now();
+		DrawFrame(*frame);
+		m_Resolution.Update((FramePacer::Now() - start) * 1000.0);
+		m_RenderScale=m_Resolution.Scale();
+		m_DrawMs=(float)m_Resolution.AverageMs();
+		PresentFrame();
+
+		if(bFirstFrame)
+		{
+			TraceLog::Record("First frame",std::string(),start,FramePacer::Now());
+			TraceLog::Mark("First frame presented");
+			char report[128];
+			sprintf(report,"First frame %.1fms after Init began, %d of %d textures loaded, %d from the image cache\n",
+				(FramePacer::Now() - m_InitStart) * 1000.0,m_Loader.Finished(),m_Loader.Queued(),m_ImageCache.Hits());
+			OutputDebugStringA(report);
+			bFirstFrame=false;
+		}
+
+		//Calculate Frames Per Second, counting frames actually presented
+		m_currTime = timeGetTime();
+		if( (m_currTime - m_prevTime) >= 1000.0f)
+		{
+			m_prevTime=m_currTime;
+			m_FPS=fpsCounter;
+			fpsCounter=0;
+		}
+		else
+		{
+			fpsCounter++;
+		}
+	}
+}
+
+void CDirectXFramework::StopRenderThread()
+{
+	m_FrameQueue.Shutdown();
+	if(m_RenderThread.joinable())
+		m_RenderThread.join();
+}
+
+void CDirectXFramework::DrawFrame(const RenderCommandList& frame)
+{
+	//the asset groups the game last asked for, textures the workers finished
+	//since the last frame, then whatever the frame needs that was evicted,
+	//from the files again.  Textures that never loaded have no size and are
+	//not retried
+	ApplyTextureGroups(m_AssetGroups);
+	UploadFinishedTextures();
+	const std::vector<int>& missing=m_Residency.BeginFrame(frame);
+	for(size_t i=0; i < missing.size(); i++)
+	{
+		if(m_TextureInfo[missing[i]].Width)
+			LoadTexture(missing[i]);
+	}
+
+	DrawScene(frame);
+
+	//then drop the textures used longest ago until back under budget
+	int evict;
+	while((evict=m_Residency.NextEviction()) >= 0)
+		ReleaseTexture(evict);
+}
+
+void CDirectXFramework::DrawScene(const RenderCommandList& frame)
+{
+	float scale=m_Resolution.Scale();
+
+	if(m_pSoftRenderer)
+	{
+		//keeps its own static layer cache
+		m_pSoftRenderer->SetRenderScale(scale);
+		m_pSoftRenderer->DrawFrame(frame,m_Images,TEX_COUNT);
+
+		if(!frame.Capture().empty())
+			m_pSoftRenderer->SaveFrame(frame.Capture().c_str());
+		return;
+	}
+
+	// Below full scale the sprites go into the top left of the scene surface,
+	// which is stretched over the back buffer before the text goes on
+	int width=(int)D3Dpp.BackBufferWidth;
+	int height=(int)D3Dpp.BackBufferHeight;
+	IDirect3DSurface9* pBackBuffer=0;
+	bool bScaled=scale < 1.0f;
+	if(bScaled && !m_pSceneSurface)
+		m_pD3DDevice->CreateRenderTarget(width,height,D3Dpp.BackBufferFormat,D3DMULTISAMPLE_NONE,0,FALSE,&m_pSceneSurface,0);
+	if(bScaled && (!m_pSceneSurface || FAILED(m_pD3DDevice->GetRenderTarget(0,&pBackBuffer))))
+		bScaled=false;
+
+	if(bScaled)
+	{
+		width=(int)(width * scale + 0.5f);
+		height=(int)(height * scale + 0.5f);
+		m_pD3DDevice->SetRenderTarget(0,m_pSceneSurface);
+	}
+	else
+		scale=1.0f;
+
+	// Clear, or copy the cached static layers in, then the rest of the sprites
+	size_t firstSprite=DrawStaticLayers(frame,width,height,scale);
+
+	m_pD3DDevice->BeginScene(); //start scene
+
+	DrawSprites(frame,firstSprite,frame.SpriteCount(),scale);
+
+	if(bScaled)
+	{
+		m_pD3DDevice->EndScene();
+		m_pD3DDevice->SetRenderTarget(0,pBackBuffer);
+		RECT scene={0,0,width,height};
+		D3DTEXTUREFILTERTYPE filter=(m_D3DCaps.StretchRectFilterCaps & D3DPTFILTERCAPS_MAGFLINEAR) ? D3DTEXF_LINEAR : D3DTEXF_POINT;
+		m_pD3DDevice->StretchRect(m_pSceneSurface,&scene,pBackBuffer,0,filter);
+		pBackBuffer->Release();
+		m_pD3DDevice->BeginScene();
+	}
+
+	for(size_t i=0; i < frame.TextCount(); i++)
+	{
+		const TextCommand& text=frame.Text(i);
+		RECT rect={text.rect.left,text.rect.top,text.rect.right,text.rect.bottom};
+		m_pD3DFont->DrawTextW(NULL,frame.TextString(text),-1,&rect,text.format,text.color);
+	}
+
+	m_pD3DDevice->EndScene();
+}
+
+void CDirectXFramework::DrawSprites(const RenderCommandList& frame, size_t first, size_t last, float scale)
+{
+	if(first >= last)
+		return;
+
+	// Call Sprite's Begin to start rendering 2D sprite objects, the list is
+	// already sorted so D3DX batches runs of the same texture as they come
+	m_pD3DSprite->Begin(D3DXSPRITE_ALPHABLEND);
+	// Textures are premultiplied, One instead of SrcAlpha; End restores the state
+	m_pD3DDevice->SetRenderState(D3DRS_SRCBLEND,D3DBLEND_ONE);
+	// Scales positions and sprites alike, identity at full resolution
+	D3DXMATRIX transform;
+	D3DXMatrixScaling(&transform,scale,scale,1.0f);
+	m_pD3DSprite->SetTransform(&transform);
+	for(size_t i=first; i < last; i++)
+	{
+		const SpriteCommand& sprite=frame.Sprite(i);
+		D3DXVECTOR3 center(sprite.centerX,sprite.centerY,0.0f);
+		D3DXVECTOR3 position(sprite.x,sprite.y,0.0f);
+		RECT source={sprite.source.left,sprite.source.top,sprite.source.right,sprite.source.bottom};
+		m_pD3DSprite->Draw(m_Textures[sprite.texture],sprite.source.right ? &source : 0,&center,&position,sprite.color);
+	}
+	m_pD3DSprite->End();
+}
+
+size_t CDirectXFramework::DrawStaticLayers(const RenderCommandList& frame, int width, int height, float scale)
+{
+	size_t count=frame.StaticSpriteCount();
+
+	//remembered even if building fails, so a failure is not retried every frame
+	if(count && m_StaticLayers.Update(frame,width,height))
+		m_bStaticValid=BuildStaticLayers(frame,count,width,height,scale);
+
+	if(count && m_bStaticValid)
+	{
+		IDirect3DSurface9* pTarget=0;
+		if(SUCCEEDED(m_pD3DDevice->GetRenderTarget(0,&pTarget)))
+		{
+			RECT scene={0,0,width,height};
+			HRESULT hr=m_pD3DDevice->StretchRect(m_pStaticSurface,0,pTarget,&scene,D3DTEXF_NONE);
+			pTarget->Release();
+			if(SUCCEEDED(hr))
+			{
+				m_pD3DDevice->Clear(0,0,D3DCLEAR_ZBUFFER,0,1.0f,0);
+				return count;
+			}
+		}
+	}
+
+	//nothing static, or no cache to copy, draw every sprite as before
+	m_pD3DDevice->Clear(0,0,D3DCLEAR_TARGET | D3DCLEAR_ZBUFFER,frame.ClearColor(),1.0f,0);
+	return 0;
+}
+
+bool CDirectXFramework::BuildStaticLayers(const RenderCommandList& frame, size_t count, int width, int height, float scale)
+{
+	if(width != m_StaticWidth || height != m_StaticHeight)
+	{
+		SAFE_RELEASE(m_pStaticSurface);
+		m_StaticWidth=width;
+		m_StaticHeight=height;
+	}
+
+	if(!m_pStaticSurface && FAILED(m_pD3DDevice->CreateRenderTarget(width,height,D3Dpp.BackBufferFormat,D3DMULTISAMPLE_NONE,0,FALSE,&m_pStaticSurface,0)))
+		return false;
+
+	IDirect3DSurface9* pTarget=0;
+	if(FAILED(m_pD3DDevice->GetRenderTarget(0,&pTarget)))
+		return false;
+
+	//the same clear and blends the scene would have had
+	m_pD3DDevice->SetRenderTarget(0,m_pStaticSurface);
+	m_pD3DDevice->Clear(0,0,D3DCLEAR_TARGET,frame.ClearColor(),1.0f,0);
+	m_pD3DDevice->BeginScene();
+	DrawSprites(frame,0,count,scale);
+	m_pD3DDevice->EndScene();
+	m_pD3DDevice->SetRenderTarget(0,pTarget);
+	pTarget->Release();
+	return true;
+}
+
+void CDirectXFramework::ReleaseStaticLayers()
+{
+	SAFE_RELEASE(m_pStaticSurface);
+	m_StaticLayers.Invalidate();
+	m_bStaticValid=false;
+}
+
+void CDirectXFramework::PresentFrame()
+{
+	if(!m_pSoftRenderer)
+	{
+		// Present the back buffer to the display buffer
+		m_pD3DDevice->Present(0,0,0,0);
+		return;
+	}
+
+	//copy the CPU back buffer to the window, negative height means top-down rows
+	const Image& backBuffer=m_pSoftRenderer->BackBuffer();
+	BITMAPINFO bmi;
+	ZeroMemory(&bmi,sizeof(bmi));
+	bmi.bmiHeader.biSize		=sizeof(BITMAPINFOHEADER);
+	bmi.bmiHeader.biWidth		=backBuffer.Width();
+	bmi.bmiHeader.biHeight		=-backBuffer.Height();
+	bmi.bmiHeader.biPlanes		=1;
+	bmi.bmiHeader.biBitCount	=32;
+	bmi.bmiHeader.biCompression	=BI_RGB;
+
+	HDC hdc=GetDC(m_hWnd);
+	StretchDIBits(hdc,0,0,backBuffer.Width(),backBuffer.Height(),0,0,backBuffer.Width(),backBuffer.Height(),backBuffer.Pixels(),&bmi,DIB_RGB_COLORS,SRCCOPY);
+	ReleaseDC(m_hWnd,hdc);
+}
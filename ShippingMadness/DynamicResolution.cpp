@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////////
+//DynamicResolution member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "DynamicResolution.h"
+
+namespace
+{
+	const float		StepSize		= 0.05f;
+	const double	DownThreshold	= 0.90;	//of the budget, average above this scales down
+	const double	UpThreshold		= 0.75;	//predicted cost one step up must stay under this
+	const double	Smoothing		= 0.1;	//weight of the newest frame in the average
+	const double	ReturnMargin	= 0.9;	//how much cheaper the previous step must have been to go back
+	const int		SettleFrames	= 30;	//after a change or a new budget, so the average reflects the scale
+	const int		CostLifetime	= 600;	//frames a remembered step cost stays valid
+
+	float StepScale(int step)
+	{
+		return 1.0f - step * StepSize;
+	}
+}
+
+DynamicResolution::DynamicResolution()
+{
+	m_BudgetMs=0.0;
+	m_MinStep=0;
+	m_Scale=1.0f;
+	m_AverageMs=0.0;
+	m_Settle=0;
+	m_FromStep=0;
+	m_Frame=0;
+	for(int i=0; i < STEPS; i++)
+	{
+		m_CostMs[i]=0.0;
+		m_CostFrame[i]=-CostLifetime;
+	}
+}
+
+void DynamicResolution::SetBudget(double budgetMs, float minScale)
+{
+	m_BudgetMs=budgetMs > 0.0 ? budgetMs : 0.0;
+
+	m_MinStep=(int)((1.0f - minScale) / StepSize + 0.5f);
+	if(m_MinStep < 0) m_MinStep=0;
+	if(m_MinStep > STEPS - 1) m_MinStep=STEPS - 1;
+
+	m_Scale=1.0f;
+	m_AverageMs=0.0;
+	m_Settle=SettleFrames;
+	m_FromStep=0;
+	for(int i=0; i < STEPS; i++)
+		m_CostFrame[i]=m_Frame - CostLifetime;
+}
+
+bool DynamicResolution::Update(double drawMs)
+{
+	//averaged even when off, for the stats
+	m_Frame++;
+	m_AverageMs=m_AverageMs > 0.0 ? m_AverageMs + (drawMs - m_AverageMs) * Smoothing : drawMs;
+	if(m_BudgetMs <= 0.0)
+		return false;
+
+	if(m_Settle > 0)
+	{
+		m_Settle--;
+		return false;
+	}
+
+	int step=Step();
+	m_CostMs[step]=m_AverageMs;
+	m_CostFrame[step]=m_Frame;
+
+	if(m_AverageMs > m_BudgetMs * DownThreshold)
+	{
+		//came down to here and it costs clearly more than where it came from, a
+		//fixed cost such as the upscale is what dominates, go back
+		if(m_FromStep < step && IsKnown(m_FromStep) && m_CostMs[m_FromStep] < m_AverageMs * ReturnMargin)
+		{
+			ChangeStep(m_FromStep);
+			return true;
+		}
+		if(step >= m_MinStep)
+			return false;
+
+		//straight to the scale the pixel count says fits, at least one step
+		double fit=m_BudgetMs * UpThreshold / m_AverageMs;
+		int target=step + 1;
+		while(target < m_MinStep && StepScale(target) * StepScale(target) > fit * m_Scale * m_Scale)
+			target++;
+
+		//a lower scale that was no cheaper a moment ago won't be now either
+		for(int i=step + 1; i <= target; i++)
+		{
+			if(IsKnown(i) && m_CostMs[i] >= m_AverageMs)
+				return false;
+		}
+
+		ChangeStep(target);
+		return true;
+	}
+
+	if(m_AverageMs < m_BudgetMs * UpThreshold && step > 0)
+	{
+		//fill rate grows with the pixel count, unless the next step up was seen recently
+		double ratio=(double)StepScale(step - 1) / m_Scale;
+		double predicted=m_AverageMs * ratio * ratio;
+		if(IsKnown(step - 1))
+			predicted=m_CostMs[step - 1];
+
+		if(predicted < m_BudgetMs * UpThreshold)
+		{
+			ChangeStep(step - 1);
+			return true;
+		}
+	}
+	return false;
+}
+
+float DynamicResolution::Scale() const
+{
+	return m_Scale;
+}
+
+double DynamicResolution::AverageMs() const
+{
+	return m_AverageMs;
+}
+
+double DynamicResolution::BudgetMs() const
+{
+	return m_BudgetMs;
+}
+
+bool DynamicResolution::IsEnabled() const
+{
+	return m_BudgetMs > 0.0;
+}
+
+int DynamicResolution::Step() const
+{
+	return (int)((1.0f - m_Scale) / StepSize + 0.5f);
+}
+
+bool DynamicResolution::IsKnown(int step) const
+{
+	return m_Frame - m_CostFrame[step] < CostLifetime;
+}
+
+void DynamicResolution::ChangeStep(int step)
+{
+	m_FromStep=Step();
+	m_Scale=StepScale(step);
+	m_Settle=SettleFrames;
+}
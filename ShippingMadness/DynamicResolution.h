@@ -0,0 +1,60 @@
+///////////////////////////////////////////////////////////////
+//Dynamic Resolution, picks the scale the scene is rendered at
+//from measured draw times so each frame fits its time budget.
+//Only decides the scale, the renderers do the scaling
+///////////////////////////////////////////////////////////////
+#pragma once
+
+class DynamicResolution
+{
+public:
+	DynamicResolution();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		SetBudget
+	// Parameters:	double budgetMs - draw time a frame may take, 0 turns
+	//					scaling off and goes back to full resolution
+	//				float minScale - smallest scale allowed, 0.5 is a quarter
+	//					of the pixels
+	// Return:		void
+	//////////////////////////////////////////////////////////////////////////
+	void	SetBudget(double budgetMs, float minScale);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Update
+	// Parameters:	double drawMs - time the last frame took to draw
+	// Return:		bool - true if Scale changed
+	// Description:	Call once per frame.  The scale drops when the average
+	//				draw time runs over 90% of the budget and climbs one step
+	//				at a time when the next step up is expected to stay under
+	//				75%.  The gap between the two, and a settling period after
+	//				every change, keep it from flipping between two scales.
+	//				A step down that did not make the frame cheaper (a fixed
+	//				cost such as the upscale itself dominating) is undone and
+	//				not tried again for about ten seconds.
+	//////////////////////////////////////////////////////////////////////////
+	bool	Update(double drawMs);
+
+	float	Scale() const;			//of the render target width and height, 1 is full size
+	double	AverageMs() const;		//smoothed draw time the decisions are made on
+	double	BudgetMs() const;
+	bool	IsEnabled() const;
+
+private:
+	int		Step() const;			//index of m_Scale in the scale steps
+	bool	IsKnown(int step) const;	//its cost was seen recently enough to go on
+	void	ChangeStep(int step);
+
+private:
+	static const int	STEPS = 11;	//1.0 down to 0.5 in 0.05 steps
+
+	double	m_BudgetMs;
+	int		m_MinStep;
+	float	m_Scale;
+	double	m_AverageMs;
+	int		m_Settle;				//frames left before the next decision
+	int		m_FromStep;				//step before the last change
+	int		m_Frame;
+	double	m_CostMs[STEPS];		//last average seen at each step, for the model
+	int		m_CostFrame[STEPS];		//when it was seen, old costs are not trusted
+};
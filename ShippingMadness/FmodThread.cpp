@@ -0,0 +1,390 @@
+////////////////////////////////////////////////////////////////
+//FmodThread member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "FmodThread.h"
+#include "Game.h"
+#include "TraceLog.h"
+#include <chrono>
+#include <string>
+#include <string.h>
+#include <stdio.h>
+#include <windows.h>
+
+#pragma comment(lib,"Fmodex_vc.lib")
+
+//FMOD's channel priority for a SOUND_PRIORITY_, 0 is the most important
+static int FmodPriority(int priority)
+{
+	return 128 - priority * 64;
+}
+
+FmodThread::FmodThread()
+	: m_Commands(QueueCommands)
+{
+	m_pArchive=0;
+	m_PostedGroups=~0u;
+	m_PostedMusic=-1;
+	m_Dropped=0;
+	m_pSystem=0;
+	m_SoundMode=FMOD_DEFAULT;
+	m_SoundGroups=~0u;
+	m_Music=-1;
+	m_State=0;
+	m_Opened=0xffffu << 16; //groups no SetSoundGroups posts
+}
+
+FmodThread::~FmodThread()
+{
+	Shutdown();
+}
+
+bool FmodThread::Start(const AssetArchive* pArchive, bool bNoSound, bool bBlocking)
+{
+	if(m_Thread.joinable())
+		return false;
+
+	m_pArchive=pArchive;
+	m_State=0;
+	m_Thread=std::thread(&FmodThread::Run,this,bNoSound,bBlocking);
+	while(m_State == 0)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	if(m_State < 0)
+	{
+		m_Thread.join();
+		return false;
+	}
+	return true;
+}
+
+void FmodThread::Shutdown()
+{
+	if(!m_Thread.joinable())
+		return;
+
+	//can't be dropped, the thread is emptying the queue
+	AudioCommand command={AUDIO_COMMAND_QUIT,0,0,0.0f,AUDIO_LOOP_OFF,false,{0,0},0,0,0,0};
+	while(!m_Commands.Push(command))
+		std::this_thread::yield();
+	m_Thread.join();
+}
+
+void FmodThread::SetSoundGroups(unsigned int groups)
+{
+	if(groups == m_PostedGroups)
+		return;
+	AudioCommand command={AUDIO_COMMAND_SOUND_GROUPS,0,0,0.0f,AUDIO_LOOP_OFF,false,{0,0},0,0,0,groups};
+	if(Post(command))
+		m_PostedGroups=groups;
+}
+
+void FmodThread::SetMusic(int music)
+{
+	if(music < 0 || music == m_PostedMusic)
+		return;
+	AudioCommand command={AUDIO_COMMAND_MUSIC,0,0,0.0f,AUDIO_LOOP_OFF,false,{0,0},0,0,music,0};
+	if(Post(command))
+		m_PostedMusic=music;
+}
+
+void FmodThread::Play(int sound)
+{
+	AudioCommand command={AUDIO_COMMAND_PLAY_SOUND,0,0,0.0f,AUDIO_LOOP_OFF,false,{0,0},0,0,sound,0};
+	Post(command);
+}
+
+void FmodThread::Reload(int sound)
+{
+	AudioCommand command={AUDIO_COMMAND_RELOAD_SOUND,0,0,0.0f,AUDIO_LOOP_OFF,false,{0,0},0,0,sound,0};
+	Post(command);
+}
+
+int FmodThread::Opened() const
+{
+	unsigned int opened=m_Opened;
+	if(m_PostedGroups == ~0u || (opened >> 16) != (m_PostedGroups & 0xffffu))
+		return 0;
+	return (int)(opened & 0xffffu);
+}
+
+int FmodThread::Dropped() const
+{
+	return m_Dropped;
+}
+
+bool FmodThread::Post(const AudioCommand& command)
+{
+	//never waits, a sound lost when FMOD is that far behind is better than
+	//a frame held up
+	if(!m_Thread.joinable() || !m_Commands.Push(command))
+	{
+		m_Dropped++;
+		return false;
+	}
+	return true;
+}
+
+void FmodThread::Run(bool bNoSound, bool bBlocking)
+{
+	TraceLog::NameThread("FMOD thread");
+	if(!Init(bNoSound))
+	{
+		m_State=-1;
+		return;
+	}
+
+	//FMOD opens the sounds on a thread of its own as well unless the load is
+	//meant to finish before the game goes on.  Playing one that hasn't opened
+	//yet just fails with FMOD_ERR_NOTREADY
+	m_SoundMode=bBlocking ? FMOD_DEFAULT : FMOD_DEFAULT | FMOD_NONBLOCKING;
+	m_State=1;
+	for(;;)
+	{
+		AudioCommand command;
+		while(m_Commands.Pop(command))
+		{
+			if(!Apply(command))
+				return;
+		}
+		UpdateSounds();
+		m_pSystem->update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(UpdateMs));
+	}
+}
+
+bool FmodThread::Init(bool bNoSound)
+{
+	TraceScope trace("InitFmod");
+	FMOD_RESULT result=FMOD::System_Create(&m_pSystem);
+	if(result != FMOD_OK)
+	{
+		printf("FMOD Error! (%d)\n",result);
+		m_pSystem=0;
+		return false;
+	}
+
+	if(bNoSound)
+		m_pSystem->setOutput(FMOD_OUTPUTTYPE_NOSOUND); //build machines may have no audio device
+
+	result=m_pSystem->init(Channels,FMOD_INIT_NORMAL,0);
+	if(result != FMOD_OK)
+	{
+		printf("FMOD Error! (%d)\n",result);
+		m_pSystem->release();
+		m_pSystem=0;
+		return false;
+	}
+
+	//each sound is open while the game wants its asset group
+	m_SoundAssets.Clear();
+	for(int i=0; i < SND_COUNT; i++)
+		m_SoundAssets.Add(i,Game::SoundInfo(i).file,Game::SoundInfo(i).groups);
+	m_Sounds.assign(m_SoundAssets.Count(),(FMOD::Sound*)0);
+	m_MusicChannels.assign(m_SoundAssets.Count(),(FMOD::Channel*)0);
+
+	//each sound's own cap is a sound group, past it the quietest of its
+	//channels is taken over.  FMOD has no oldest first behaviour
+	m_SoundLimits.assign(m_SoundAssets.Count(),(FMOD::SoundGroup*)0);
+	for(int slot=0; slot < m_SoundAssets.Count(); slot++)
+	{
+		const GameSoundInfo& info=Game::SoundInfo(m_SoundAssets.Id(slot));
+		if(m_pSystem->createSoundGroup(info.file,&m_SoundLimits[slot]) == FMOD_OK)
+		{
+			m_SoundLimits[slot]->setMaxAudible(info.maxVoices > 0 ? info.maxVoices : -1);
+			m_SoundLimits[slot]->setMaxAudibleBehavior(FMOD_SOUNDGROUP_BEHAVIOR_STEALLOWEST);
+		}
+	}
+	return true;
+}
+
+bool FmodThread::Apply(const AudioCommand& command)
+{
+	switch(command.type)
+	{
+	case AUDIO_COMMAND_PLAY_SOUND:
+		PlaySound(command.sound);
+		break;
+	case AUDIO_COMMAND_MUSIC:
+		//streams that open later start the right way in UpdateSounds
+		m_Music=command.sound;
+		for(int slot=0; slot < m_SoundAssets.Count(); slot++)
+		{
+			if(m_MusicChannels[slot])
+				m_MusicChannels[slot]->setPaused(m_SoundAssets.Id(slot) != m_Music);
+		}
+		break;
+	case AUDIO_COMMAND_SOUND_GROUPS:
+		ApplySoundGroups(command.groups);
+		break;
+	case AUDIO_COMMAND_RELOAD_SOUND:
+		ReloadSound(command.sound);
+		break;
+	case AUDIO_COMMAND_QUIT:
+		m_pSystem->release(); //with every sound, channel and sound group
+		m_pSystem=0;
+		return false;
+	default:
+		break; //AudioThread's
+	}
+	return true;
+}
+
+void FmodThread::ApplySoundGroups(unsigned int groups)
+{
+	if(groups == m_SoundGroups)
+		return;
+
+	for(int slot=0; slot < m_SoundAssets.Count(); slot++)
+	{
+		unsigned int soundGroups=m_SoundAssets.Groups(slot);
+		SetSoundOpen(slot,!soundGroups || (soundGroups & groups));
+	}
+	m_SoundGroups=groups;
+}
+
+void FmodThread::SetSoundOpen(int slot, bool bOpen)
+{
+	FMOD::Sound*& pSound=m_Sounds[slot];
+	if(bOpen && !pSound)
+	{
+		CreateSound(slot,m_SoundMode,&pSound);
+	}
+	else if(!bOpen && pSound)
+	{
+		//music restarts from UpdateSounds once the stream is open again, a
+		//reload still opening for it is dropped
+		if(m_MusicChannels[slot])
+			m_MusicChannels[slot]->stop();
+		m_MusicChannels[slot]=0;
+		pSound->release();
+		pSound=0;
+		m_SoundAssets.Reissue(m_SoundAssets.Handle(m_SoundAssets.Id(slot)));
+	}
+}
+
+void FmodThread::CreateSound(int slot, FMOD_MODE mode, FMOD::Sound** ppSound)
+{
+	const char* filename=m_SoundAssets.Name(slot);
+	bool bStream=Game::SoundInfo(m_SoundAssets.Id(slot)).bMusic;
+	TraceScope trace(mode & FMOD_NONBLOCKING ? "Queue sound" : "Open sound",filename);
+	*ppSound=0;
+
+	//samples are decoded into FMOD's own buffers, streams read the mapping as
+	//they play.  Either way it goes into its sound group as it is created
+	FMOD_CREATESOUNDEXINFO info;
+	memset(&info,0,sizeof(info));
+	info.cbsize=sizeof(info);
+	info.initialsoundgroup=(FMOD_SOUNDGROUP*)m_SoundLimits[slot]; //the C++ and C handles are the same object
+	AssetView view;
+	FMOD_RESULT result;
+	if(m_pArchive && m_pArchive->Find(filename,view))
+	{
+		info.length=(unsigned int)view.size;
+		result=bStream ? m_pSystem->createStream((const char*)view.data,mode | FMOD_OPENMEMORY,&info,ppSound)
+					   : m_pSystem->createSound((const char*)view.data,mode | FMOD_OPENMEMORY,&info,ppSound);
+	}
+	else
+	{
+		result=bStream ? m_pSystem->createStream(filename,mode,&info,ppSound) : m_pSystem->createSound(filename,mode,&info,ppSound);
+	}
+
+	if(result != FMOD_OK)
+	{
+		std::string report=std::string("Missing sound ") + filename + "\n";
+		OutputDebugStringA(report.c_str());
+	}
+}
+
+void FmodThread::PlaySound(int sound)
+{
+	//started paused so the priority is set before FMOD next picks channels to
+	//take over.  The game raises each sound once a frame however many times
+	//it was triggered
+	int slot=m_SoundAssets.Slot(m_SoundAssets.Handle(sound));
+	FMOD::Channel* pChannel=0;
+	if(slot < 0 || !m_Sounds[slot] || m_pSystem->playSound(FMOD_CHANNEL_FREE,m_Sounds[slot],true,&pChannel) != FMOD_OK)
+		return;
+	pChannel->setPriority(FmodPriority(Game::SoundInfo(sound).priority));
+	pChannel->setPaused(false);
+}
+
+void FmodThread::ReloadSound(int sound)
+{
+	//one that isn't open (its group released) opens from the new file next time
+	int slot=m_SoundAssets.Slot(m_SoundAssets.Handle(sound));
+	if(slot < 0 || !m_Sounds[slot])
+		return;
+
+	SoundReload reload={m_SoundAssets.Handle(sound),0};
+	CreateSound(slot,FMOD_DEFAULT | FMOD_NONBLOCKING,&reload.pSound);
+	if(reload.pSound)
+		m_SoundReloads.push_back(reload);
+}
+
+void FmodThread::UpdateSounds()
+{
+	//reopened sounds go in first, their music starts over below
+	for(size_t i=0; i < m_SoundReloads.size();)
+	{
+		SoundReload& reload=m_SoundReloads[i];
+		if(!IsSoundOpen(reload.pSound))
+		{
+			i++;
+			continue;
+		}
+
+		FMOD_OPENSTATE state;
+		bool bOpened=reload.pSound->getOpenState(&state,0,0,0) == FMOD_OK && state == FMOD_OPENSTATE_READY;
+		int slot=m_SoundAssets.Slot(reload.handle);
+		if(bOpened && slot >= 0) //not released with its group meanwhile
+		{
+			if(m_MusicChannels[slot])
+				m_MusicChannels[slot]->stop();
+			m_MusicChannels[slot]=0;
+			m_Sounds[slot]->release();
+			m_Sounds[slot]=reload.pSound;
+		}
+		else
+		{
+			reload.pSound->release(); //broken file, the old sound stays
+		}
+		m_SoundReloads.erase(m_SoundReloads.begin() + i);
+	}
+
+	if(m_SoundGroups == ~0u)
+		return; //nothing asked for yet
+
+	//music as soon as each stream opens, paused unless the screen wants it.
+	//Released sounds count as open, the progress is over the wanted groups
+	int opened=0;
+	for(int slot=0; slot < m_SoundAssets.Count(); slot++)
+	{
+		FMOD::Sound* pSound=m_Sounds[slot];
+		if(!IsSoundOpen(pSound))
+			continue;
+		opened++;
+
+		const GameSoundInfo& info=Game::SoundInfo(m_SoundAssets.Id(slot));
+		if(pSound && info.bMusic && !m_MusicChannels[slot])
+		{
+			m_pSystem->playSound(FMOD_CHANNEL_FREE,pSound,true,&m_MusicChannels[slot]); //played but paused
+			if(m_MusicChannels[slot])
+			{
+				m_MusicChannels[slot]->setMode(FMOD_LOOP_NORMAL);
+				m_MusicChannels[slot]->setVolume(info.volume);
+				m_MusicChannels[slot]->setPriority(FmodPriority(info.priority));
+				m_MusicChannels[slot]->setPaused(m_SoundAssets.Id(slot) != m_Music);
+			}
+		}
+	}
+	m_Opened=(m_SoundGroups & 0xffffu) << 16 | (unsigned int)opened;
+}
+
+bool FmodThread::IsSoundOpen(FMOD::Sound* pSound)
+{
+	//a sound that failed to open counts, nothing more will happen to it
+	FMOD_OPENSTATE state;
+	if(!pSound || pSound->getOpenState(&state,0,0,0) != FMOD_OK)
+		return true;
+	return state == FMOD_OPENSTATE_READY || state == FMOD_OPENSTATE_ERROR;
+}
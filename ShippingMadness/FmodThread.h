@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////
+//Fmod Thread, FMOD on a thread of its own for the Windows
+//build.  It creates the FMOD system, opens and releases the
+//sounds with the game's asset groups, plays them and calls
+//update.  The game thread only posts commands through an
+//AudioCommandQueue, so FMOD is only ever called from this one
+//thread and a slow open or update never holds up a frame
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include "AudioThread.h"
+#include "AssetArchive.h"
+#include "AssetRegistry.h"
+#include "fmod.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class FmodThread
+{
+public:
+	static const int	QueueCommands=256;
+	static const int	Channels=32;	//heard at once, past it FMOD takes over the least important channel
+	static const int	UpdateMs=5;		//between passes over the queue and FMOD's update
+
+	FmodThread();
+	~FmodThread();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Start
+	// Parameters:	const AssetArchive* pArchive - sounds are opened from it
+	//					first, streams play straight out of its mapping so it
+	//					must outlive Shutdown
+	//				bool bNoSound - FMOD's no sound output, for headless runs
+	//				bool bBlocking - each sound is open before the next
+	//					command is taken, for serial and headless loads.
+	//					Otherwise FMOD opens them in the background
+	// Return:		bool - false if FMOD couldn't be started
+	// Description:	Waits for the thread to create and initialise FMOD.
+	//				Nothing is open until SetSoundGroups.
+	//////////////////////////////////////////////////////////////////////////
+	bool	Start(const AssetArchive* pArchive, bool bNoSound, bool bBlocking);
+
+	//waits for the commands already posted, then releases FMOD and every sound
+	void	Shutdown();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		SetSoundGroups
+	// Parameters:	unsigned int groups - ASSETS_ bits the game wants
+	// Return:		void
+	// Description:	Game thread only, like every call that posts.  Opens the
+	//				sounds of these groups and the ungrouped ones, releases
+	//				the rest.  Only a change is posted, one that didn't fit in
+	//				the queue goes with the next call.
+	//////////////////////////////////////////////////////////////////////////
+	void	SetSoundGroups(unsigned int groups);
+
+	void	SetMusic(int music);	//SND_ music to hear, the others pause.  Only a change is posted, -1 leaves it
+	void	Play(int sound);		//SND_ id, nothing if it isn't open
+	void	Reload(int sound);		//opens the changed file next to the one playing, it takes over once open
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Opened
+	// Parameters:	void
+	// Return:		int - sounds open, failed or released, for the load
+	//				progress.  0 until the groups last set are applied
+	// Description:	Game thread only, it compares with what was posted.
+	//////////////////////////////////////////////////////////////////////////
+	int		Opened() const;
+	int		Dropped() const;	//commands lost to a full queue, game thread only
+
+private:
+	struct SoundReload //a changed sound opening in the background
+	{
+		AssetHandle		handle;		//of the sound it replaces, stale if that was released meanwhile
+		FMOD::Sound*	pSound;		//the new one
+	};
+
+	bool	Post(const AudioCommand& command);
+	void	Run(bool bNoSound, bool bBlocking);
+	bool	Init(bool bNoSound);
+	bool	Apply(const AudioCommand& command); //false for QUIT
+	void	ApplySoundGroups(unsigned int groups);
+	void	SetSoundOpen(int slot, bool bOpen);
+	void	CreateSound(int slot, FMOD_MODE mode, FMOD::Sound** ppSound);
+	void	PlaySound(int sound);
+	void	ReloadSound(int sound);
+	void	UpdateSounds();		//reloads that have opened go in, music starts once its stream is open
+	static bool	IsSoundOpen(FMOD::Sound* pSound);
+
+private:
+	AudioCommandQueue				m_Commands;
+	std::thread						m_Thread;
+	const AssetArchive*				m_pArchive;
+	unsigned int					m_PostedGroups;	//game thread, ~0 before the first
+	int								m_PostedMusic;	//game thread
+	int								m_Dropped;		//game thread
+
+	//the FMOD thread's own
+	FMOD::System*					m_pSystem;
+	FMOD_MODE						m_SoundMode;
+	AssetRegistry					m_SoundAssets;		//every sound in Game::SoundInfo, SND_ order
+	std::vector<FMOD::Sound*>		m_Sounds;			//by slot, 0 while its group is released
+	std::vector<FMOD::Channel*>		m_MusicChannels;	//by slot, 0 until the music has started
+	std::vector<FMOD::SoundGroup*>	m_SoundLimits;		//by slot, caps the channels each sound plays on
+	std::vector<SoundReload>		m_SoundReloads;
+	unsigned int					m_SoundGroups;		//applied, ~0 before the first
+	int								m_Music;			//SND_ music playing, -1 before the first
+
+	std::atomic<int>				m_State;		//0 starting, 1 running, -1 FMOD failed
+	std::atomic<unsigned int>		m_Opened;		//groups << 16 | sounds open, both in one so they agree
+};
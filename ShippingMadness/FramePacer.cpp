@@ -0,0 +1,161 @@
+////////////////////////////////////////////////////////////////
+//FramePacer member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "FramePacer.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#pragma comment(lib, "winmm.lib")
+#else
+#include <time.h>
+#endif
+
+#include <math.h>
+#include <string.h>
+
+namespace
+{
+	//plain OS sleep, it may wake late which is what the spin margin covers
+	void SleepFor(double seconds)
+	{
+#ifdef _WIN32
+		Sleep((DWORD)(seconds * 1000.0));
+#else
+		timespec ts;
+		ts.tv_sec=(time_t)seconds;
+		ts.tv_nsec=(long)((seconds - (double)ts.tv_sec) * 1e9);
+		nanosleep(&ts,0);
+#endif
+	}
+
+	void ResetStats(PacingStats& stats)
+	{
+		memset(&stats,0,sizeof(stats));
+	}
+}
+
+FramePacer::FramePacer()
+{
+#ifdef _WIN32
+	timeBeginPeriod(1); //Sleep(1) otherwise lasts a whole 15.6ms scheduler tick
+#endif
+	m_SpinMargin=0.002;
+	SetMode(PACE_CAPPED,60.0);
+}
+
+FramePacer::~FramePacer()
+{
+#ifdef _WIN32
+	timeEndPeriod(1);
+#endif
+}
+
+void FramePacer::SetMode(PaceMode mode, double targetHz)
+{
+	m_Mode=mode;
+	m_TargetHz=mode == PACE_UNLIMITED ? 0.0 : targetHz;
+	m_Period=m_TargetHz > 0.0 ? 1.0 / m_TargetHz : 0.0;
+
+	m_LastFrame=Now();
+	m_Deadline=m_LastFrame + m_Period;
+	m_WindowStart=m_LastFrame;
+	ResetStats(m_Window);
+	ResetStats(m_Stats);
+}
+
+PaceMode FramePacer::Mode() const
+{
+	return m_Mode;
+}
+
+double FramePacer::TargetHz() const
+{
+	return m_TargetHz;
+}
+
+void FramePacer::SetSpinMargin(double seconds)
+{
+	m_SpinMargin=seconds;
+}
+
+double FramePacer::Wait()
+{
+	double now=Now();
+
+	if(m_Mode == PACE_CAPPED && m_Period > 0.0)
+	{
+		if(now > m_Deadline + m_Period)
+		{
+			//more than a whole frame late, start again from here
+			m_Deadline=now;
+		}
+		else
+		{
+			//sleep while the scheduler can't make us late, then spin to the deadline
+			while(m_Deadline - now > m_SpinMargin)
+			{
+				SleepFor(m_Deadline - now - m_SpinMargin);
+				now=Now();
+			}
+			while(now < m_Deadline)
+				now=Now();
+		}
+		m_Deadline+=m_Period;
+	}
+
+	double frameTime=now - m_LastFrame;
+	m_LastFrame=now;
+	Record(frameTime);
+	return frameTime;
+}
+
+const PacingStats& FramePacer::Stats() const
+{
+	return m_Stats;
+}
+
+double FramePacer::Now()
+{
+#ifdef _WIN32
+	static LARGE_INTEGER frequency={0};
+	if(!frequency.QuadPart)
+		QueryPerformanceFrequency(&frequency);
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC,&ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+void FramePacer::Record(double frameTime)
+{
+	double frameMs=frameTime * 1000.0;
+	double errorMs=m_Period > 0.0 ? fabs(frameTime - m_Period) * 1000.0 : 0.0;
+
+	if(m_Window.frames == 0 || frameMs < m_Window.minFrameMs)
+		m_Window.minFrameMs=frameMs;
+	if(frameMs > m_Window.maxFrameMs)
+		m_Window.maxFrameMs=frameMs;
+	if(errorMs > m_Window.maxErrorMs)
+		m_Window.maxErrorMs=errorMs;
+	if(m_Period > 0.0 && frameTime > m_Period * 1.5)
+		m_Window.missed++;
+
+	//keep running sums until the window closes, then turn them into means
+	m_Window.meanFrameMs+=frameMs;
+	m_Window.meanErrorMs+=errorMs;
+	m_Window.frames++;
+
+	if(m_LastFrame - m_WindowStart >= 1.0)
+	{
+		m_Stats=m_Window;
+		m_Stats.meanFrameMs/=m_Stats.frames;
+		m_Stats.meanErrorMs/=m_Stats.frames;
+		ResetStats(m_Window);
+		m_WindowStart=m_LastFrame;
+	}
+}
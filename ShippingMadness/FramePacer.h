@@ -0,0 +1,80 @@
+///////////////////////////////////////////////////////////////
+//Frame Pacer, holds the game loop to a target frame rate and
+//keeps statistics on how far each frame lands from its slot
+///////////////////////////////////////////////////////////////
+#pragma once
+
+enum PaceMode
+{
+	PACE_VSYNC,		//the display paces frames, Wait only measures
+	PACE_CAPPED,	//sleep then spin until the next frame slot
+	PACE_UNLIMITED	//no waiting at all, for benchmarking
+};
+
+//one second window of frame timings, all in milliseconds
+struct PacingStats
+{
+	int		frames;
+	double	meanFrameMs;
+	double	minFrameMs;
+	double	maxFrameMs;
+	double	meanErrorMs;	//average distance from the target frame time
+	double	maxErrorMs;
+	int		missed;			//frames that ran past half a frame over the target
+};
+
+class FramePacer
+{
+public:
+	FramePacer();
+	~FramePacer();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		SetMode
+	// Parameters:	PaceMode mode - how frames are paced
+	//				double targetHz - frame rate for PACE_CAPPED, expected
+	//					refresh rate for PACE_VSYNC (only used for the error
+	//					statistics), ignored for PACE_UNLIMITED
+	// Return:		void
+	//////////////////////////////////////////////////////////////////////////
+	void		SetMode(PaceMode mode, double targetHz);
+
+	PaceMode	Mode() const;
+	double		TargetHz() const;
+
+	//time left before the deadline when Wait stops sleeping and starts
+	//spinning, covers the scheduler waking us late (default 2ms)
+	void		SetSpinMargin(double seconds);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Wait
+	// Parameters:	void
+	// Return:		double - seconds since the previous Wait returned
+	// Description:	Call once at the end of every frame.  In PACE_CAPPED it
+	//				sleeps most of the remaining time and spins the rest so the
+	//				frame ends on its slot; a frame that ran long starts a new
+	//				schedule instead of rushing the following ones.
+	//////////////////////////////////////////////////////////////////////////
+	double		Wait();
+
+	//statistics of the last complete one second window
+	const PacingStats&	Stats() const;
+
+	//seconds from an arbitrary fixed point, high resolution
+	static double		Now();
+
+private:
+	void		Record(double frameTime);
+
+private:
+	PaceMode	m_Mode;
+	double		m_TargetHz;
+	double		m_Period;		//seconds per frame, 0 when not capped
+	double		m_SpinMargin;
+	double		m_Deadline;		//when the current frame slot ends
+	double		m_LastFrame;	//when Wait last returned
+
+	PacingStats	m_Window;		//being accumulated
+	double		m_WindowStart;
+	PacingStats	m_Stats;		//last finished window
+};
@@ -0,0 +1,173 @@
+////////////////////////////////////////////////////////////////
+//FrameRegression member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "FrameRegression.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define MakeDirectory(name) _mkdir(name)
+#else
+#include <sys/stat.h>
+#define MakeDirectory(name) mkdir(name,0755)
+#endif
+
+FrameRegression::FrameRegression(const std::string& goldenDir, const std::string& outputDir, int tolerance, bool bUpdate)
+{
+	m_GoldenDir=goldenDir;
+	m_OutputDir=outputDir;
+	m_Tolerance=tolerance;
+	m_bUpdate=bUpdate;
+
+	if(!m_OutputDir.empty())
+		MakeDirectory(m_OutputDir.c_str()); //fails harmlessly when it is there already
+
+	if(!m_GoldenDir.empty() && m_GoldenDir[m_GoldenDir.size() - 1] != '/' && m_GoldenDir[m_GoldenDir.size() - 1] != '\\')
+		m_GoldenDir+='/';
+	if(!m_OutputDir.empty() && m_OutputDir[m_OutputDir.size() - 1] != '/' && m_OutputDir[m_OutputDir.size() - 1] != '\\')
+		m_OutputDir+='/';
+}
+
+bool FrameRegression::Check(const std::string& name, const Image& frame, double recordMs, double drawMs)
+{
+	RegressionResult result;
+	result.name=name;
+	result.bPassed=true;
+	result.bNewGolden=false;
+	result.differing=0;
+	result.maxDelta=0;
+	result.recordMs=recordMs;
+	result.drawMs=drawMs;
+
+	std::string goldenFile=m_GoldenDir + name + ".png";
+	Image golden;
+	if(m_bUpdate)
+	{
+		//this frame becomes the golden
+		result.bNewGolden=true;
+		result.bPassed=frame.SavePNG(goldenFile.c_str());
+	}
+	else if(!golden.LoadPNG(goldenFile.c_str()))
+	{
+		//a missing golden is a failure, -update makes one from the actual frame
+		result.bPassed=false;
+		result.differing=frame.Width() * frame.Height();
+		result.maxDelta=255;
+		frame.SavePNG((m_OutputDir + name + ".actual.png").c_str());
+	}
+	else
+	{
+		Image diff;
+		result.differing=Compare(frame,golden,m_Tolerance,&result.maxDelta,&diff);
+		result.bPassed=result.differing == 0;
+		if(!result.bPassed)
+		{
+			frame.SavePNG((m_OutputDir + name + ".actual.png").c_str());
+			if(!diff.IsEmpty())
+				diff.SavePNG((m_OutputDir + name + ".diff.png").c_str());
+		}
+	}
+
+	m_Results.push_back(result);
+	return result.bPassed;
+}
+
+std::string FrameRegression::WriteReport() const
+{
+	std::string report;
+	char line[256];
+	sprintf(line,"%-24s %-6s %10s %9s %10s %10s\n","scenario","result","differing","max delta","record ms","draw ms");
+	report+=line;
+
+	for(size_t i=0; i < m_Results.size(); i++)
+	{
+		const RegressionResult& r=m_Results[i];
+		const char* status=!r.bPassed ? "FAIL" : (r.bNewGolden ? "NEW" : "PASS");
+		sprintf(line,"%-24s %-6s %10d %9d %10.4f %10.4f\n",r.name.c_str(),status,r.differing,r.maxDelta,r.recordMs,r.drawMs);
+		report+=line;
+	}
+
+	sprintf(line,"%d of %d scenarios failed (tolerance %d)\n",Failures(),(int)m_Results.size(),m_Tolerance);
+	report+=line;
+
+	FILE* file=fopen((m_OutputDir + "report.txt").c_str(),"w");
+	if(file)
+	{
+		fputs(report.c_str(),file);
+		fclose(file);
+	}
+	return report;
+}
+
+int FrameRegression::Failures() const
+{
+	int failures=0;
+	for(size_t i=0; i < m_Results.size(); i++)
+	{
+		if(!m_Results[i].bPassed)
+			failures++;
+	}
+	return failures;
+}
+
+const std::vector<RegressionResult>& FrameRegression::Results() const
+{
+	return m_Results;
+}
+
+int FrameRegression::Compare(const Image& actual, const Image& golden, int tolerance, int* maxDelta, Image* diff)
+{
+	if(maxDelta)
+		*maxDelta=0;
+
+	if(actual.Width() != golden.Width() || actual.Height() != golden.Height())
+	{
+		if(maxDelta)
+			*maxDelta=255;
+		if(diff)
+			diff->Release();
+		return actual.Width() * actual.Height() > golden.Width() * golden.Height() ? actual.Width() * actual.Height() : golden.Width() * golden.Height();
+	}
+
+	if(diff)
+		diff->Create(golden.Width(),golden.Height(),0xFF000000);
+
+	int differing=0;
+	int largest=0;
+	for(int y=0; y < golden.Height(); y++)
+	{
+		const unsigned int* a=actual.Row(y);
+		const unsigned int* g=golden.Row(y);
+		unsigned int* d=diff ? diff->Row(y) : 0;
+		for(int x=0; x < golden.Width(); x++)
+		{
+			int delta=0;
+			for(int shift=0; shift < 32; shift+=8)
+			{
+				int channel=abs((int)((a[x] >> shift) & 0xFF) - (int)((g[x] >> shift) & 0xFF));
+				if(channel > delta)
+					delta=channel;
+			}
+			if(delta > largest)
+				largest=delta;
+
+			if(delta > tolerance)
+			{
+				differing++;
+				if(d)
+					d[x]=0xFFFF0000;
+			}
+			else if(d)
+			{
+				//golden at a quarter brightness so the red stands out
+				d[x]=0xFF000000 | ((g[x] >> 2) & 0x003F3F3F);
+			}
+		}
+	}
+
+	if(maxDelta)
+		*maxDelta=largest;
+	return differing;
+}
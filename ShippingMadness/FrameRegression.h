@@ -0,0 +1,71 @@
+///////////////////////////////////////////////////////////////
+//Frame Regression, compares rendered frames against stored
+//golden PNGs and collects per scenario timings into a report
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Image.h"
+#include <string>
+#include <vector>
+
+struct RegressionResult
+{
+	std::string	name;
+	bool		bPassed;
+	bool		bNewGolden;		//updating, the frame became the golden
+	int			differing;		//pixels with a channel further than the tolerance
+	int			maxDelta;		//largest channel difference seen
+	double		recordMs;		//game thread, building the command list
+	double		drawMs;			//render thread, playing it back
+};
+
+class FrameRegression
+{
+public:
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		FrameRegression
+	// Parameters:	const std::string& goldenDir - folder holding <scenario>.png
+	//				const std::string& outputDir - the report and failed
+	//					frames go here, made if it isn't there.  Keep it out
+	//					of goldenDir, the goldens are committed
+	//				int tolerance - largest per channel difference still a match
+	//				bool bUpdate - overwrite the goldens instead of comparing
+	//////////////////////////////////////////////////////////////////////////
+	FrameRegression(const std::string& goldenDir, const std::string& outputDir, int tolerance, bool bUpdate);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Check
+	// Parameters:	const std::string& name - scenario, also the golden file name
+	//				const Image& frame - what the renderer produced
+	//				double recordMs, drawMs - average cost of the scenario
+	// Return:		bool - false if the frame differs from its golden
+	// Description:	A failed frame is written to the output folder as
+	//				<name>.actual.png along with <name>.diff.png, which marks the
+	//				differing pixels red over a dimmed copy of the golden.  A
+	//				missing golden fails too, only updating writes one.
+	//////////////////////////////////////////////////////////////////////////
+	bool	Check(const std::string& name, const Image& frame, double recordMs, double drawMs);
+
+	//writes the table to <outputDir>/report.txt and returns the same text
+	std::string	WriteReport() const;
+
+	int		Failures() const;
+	const std::vector<RegressionResult>& Results() const;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Compare
+	// Parameters:	const Image& actual, golden - frames to compare
+	//				int tolerance - largest per channel difference still a match
+	//				int* maxDelta - receives the largest channel difference
+	//				Image* diff - optional, receives the difference image
+	// Return:		int - pixels out of tolerance, every pixel if sizes differ
+	//////////////////////////////////////////////////////////////////////////
+	static int	Compare(const Image& actual, const Image& golden, int tolerance, int* maxDelta, Image* diff);
+
+private:
+	std::string						m_GoldenDir;
+	std::string						m_OutputDir;
+	int								m_Tolerance;
+	bool							m_bUpdate;
+	std::vector<RegressionResult>	m_Results;
+};
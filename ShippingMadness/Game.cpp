@@ -0,0 +1,649 @@
+////////////////////////////////////////////////////////////////
+//Game member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "Game.h"
+#include "SoftwareRenderer.h" //TEXT_ flags
+#include <ctype.h>
+#include <math.h>
+#include <string.h>
+#include <wchar.h>
+
+//Texture files, in the same order as the TEX_ enum, without extension.
+//Each is loaded from <name>.dds, block compressed with its mips by
+//"assettool dds", or <name>.pma.png if there is no usable DDS.  Both come
+//from the green colour keyed source PNGs through "assettool premultiply",
+//rerun the two after editing a source image
+static const char* TextureFiles[]=
+{
+	"shipping_madness_background",	//Background Image
+	"PlayingBounds",				//Level 1 Boundary
+	"PlayerShip",					//Player Ship Texture
+	"EnemyShip",					//Enemy Ship Texture
+	"Bullet",						//Bullet Texture
+	"playgame",						//Menu Button Textures
+	"hl_playgame",
+	"credits",
+	"hl_credits",
+	"options",
+	"hl_options",
+	"quit",
+	"hl_quit"
+};
+
+//Sound files, in the same order as the SND_ enum.  A wave of enemies going
+//at once is still only a few explosions
+static const GameSoundInfo SoundFiles[]=
+{
+	{"wave.mp3",		ASSETS_MENU,	true,	0.5f,	SOUND_PRIORITY_MUSIC,	1},	//menu music
+	{"DXclub.mp3",		ASSETS_PLAY,	true,	0.8f,	SOUND_PRIORITY_MUSIC,	1},	//play music
+	{"ding.wav",		ASSETS_MENU,	false,	1.0f,	SOUND_PRIORITY_UI,		2},	//menu selection moved
+	{"Explosion1.wav",	ASSETS_PLAY,	false,	1.0f,	SOUND_PRIORITY_EFFECT,	4},
+	{"tada.wav",		0,				false,	1.0f,	SOUND_PRIORITY_EFFECT,	2},
+	{"chord.wav",		0,				false,	1.0f,	SOUND_PRIORITY_EFFECT,	2},
+	{"jaguar.wav",		0,				false,	1.0f,	SOUND_PRIORITY_EFFECT,	2},
+	{"swish.wav",		0,				false,	1.0f,	SOUND_PRIORITY_EFFECT,	2}
+};
+
+//Golden frame scenarios, the same on every host so their goldens agree
+static const GameScenario Scenarios[]=
+{
+	{"menu_play",		Game::MENU,		Game::PLAY},
+	{"menu_credits",	Game::MENU,		Game::CREDITS},
+	{"menu_options",	Game::MENU,		Game::OPTIONS},
+	{"menu_quit",		Game::MENU,		Game::QUITGAME},
+	{"game",			Game::GAME,		Game::PLAY},
+	{"credits",			Game::CREDS,	Game::CREDITS},
+	{"options",			Game::OPTS,		Game::OPTIONS},
+	{"end_win",			Game::END,		Game::PLAY},
+	{"end_fail",		Game::ENDFAIL,	Game::PLAY}
+};
+
+//top left of the level 1 boundary image, the play area
+static const float PlayBoundaryX=150.0f;
+static const float PlayBoundaryY=50.0f;
+
+//D3DXCOLOR(0.0f,0.4f,0.9f,1.0f), what the frame is cleared to
+static const unsigned int ClearColor=0xFF0066E6;
+static const unsigned int White=0xFFFFFFFF;
+static const unsigned int Red=0xFFFF0000;
+static const unsigned int Cyan=0xFF19FFFF;
+
+static const float MenuRepeatDelay=0.15f;
+
+Game::Game()
+{
+	gameState=MENU;
+	menuState=PLAY;
+	m_bQuit=false;
+	m_Sounds=0;
+	m_MenuRepeat=0.0f;
+	m_LoadProgress=1.0f;
+	m_bSizesChanged=false;
+	m_bPlayPending=false;
+	m_ViewWidth=0;
+	m_ViewHeight=0;
+	m_bHudTimings=false;
+	m_FPS=0;
+	memset(&m_Pacing,0,sizeof(m_Pacing));
+	m_RenderScale=1.0f;
+	m_DrawMs=0.0f;
+	memset(m_PrevKeys,0,sizeof(m_PrevKeys));
+	memset(m_TextureWidth,0,sizeof(m_TextureWidth));
+	memset(m_TextureHeight,0,sizeof(m_TextureHeight));
+	m_EnemyClip=-1;
+	MovementDirection=RIGHT;
+	SideReached=false;
+	GameEnded=false;
+	PlayerPosition.x=0.0f;
+	PlayerPosition.y=0.0f;
+	enemyMoveTimer=0.0f;
+	bulletTimer=0.0f;
+}
+
+const char* Game::TextureFile(int texture)
+{
+	return texture >= 0 && texture < TEX_COUNT ? TextureFiles[texture] : 0;
+}
+
+const GameSoundInfo& Game::SoundInfo(int sound)
+{
+	return SoundFiles[sound >= 0 && sound < SND_COUNT ? sound : 0];
+}
+
+int Game::ScenarioCount()
+{
+	return sizeof(Scenarios) / sizeof(Scenarios[0]);
+}
+
+const GameScenario& Game::Scenario(int scenario)
+{
+	return Scenarios[scenario >= 0 && scenario < ScenarioCount() ? scenario : 0];
+}
+
+int Game::FindTexture(const char* filename)
+{
+	//<name>.dds or <name>.pma.png, Windows file names ignore case
+	static const char* Extensions[]={".dds",".pma.png"};
+	for(int texture=0; texture < TEX_COUNT; texture++)
+	{
+		const char* name=TextureFiles[texture];
+		size_t i=0;
+		while(name[i] && filename[i] && tolower((unsigned char)name[i]) == tolower((unsigned char)filename[i]))
+			i++;
+		if(name[i])
+			continue;
+
+		for(int j=0; j < 2; j++)
+		{
+			const char* extension=Extensions[j];
+			size_t k=0;
+			while(extension[k] && tolower((unsigned char)filename[i + k]) == extension[k])
+				k++;
+			if(!extension[k] && !filename[i + k])
+				return texture;
+		}
+	}
+	return -1;
+}
+
+bool Game::IsMenuTexture(int texture)
+{
+	return (TextureGroups(texture) & ASSETS_MENU) != 0;
+}
+
+unsigned int Game::TextureGroups(int texture)
+{
+	//the background is behind the play field too
+	if(texture == TEX_MENU_BACKGROUND)
+		return ASSETS_MENU | ASSETS_PLAY;
+	if(texture >= TEX_PLAYGAME && texture <= TEX_HL_QUIT)
+		return ASSETS_MENU;
+	return texture >= 0 && texture < TEX_COUNT ? ASSETS_PLAY : 0;
+}
+
+unsigned int Game::AssetGroups() const
+{
+	if(gameState == MENU)
+		return ASSETS_MENU | ASSETS_PLAY;
+	if(gameState == GAME)
+		return ASSETS_PLAY;
+	if(gameState == QUIT)
+		return 0;
+	return ASSETS_MENU; //credits, options and the end screens are text over the clear colour
+}
+
+int Game::Music() const
+{
+	if(gameState == MENU)
+		return SND_MENU_MUSIC;
+	if(gameState == GAME)
+		return SND_PLAY_MUSIC;
+	return -1;
+}
+
+void Game::SetTextureSize(int texture, int width, int height)
+{
+	if(texture < 0 || texture >= TEX_COUNT)
+		return;
+
+	if(m_TextureWidth[texture] != width || m_TextureHeight[texture] != height)
+		m_bSizesChanged=true;
+	m_TextureWidth[texture]=width;
+	m_TextureHeight[texture]=height;
+}
+
+void Game::SetViewport(int width, int height)
+{
+	m_ViewWidth=width;
+	m_ViewHeight=height;
+}
+
+void Game::SetLoadProgress(float progress)
+{
+	bool bWasLoading=m_LoadProgress < 1.0f;
+	m_LoadProgress=progress < 1.0f ? progress : 1.0f;
+	if(m_LoadProgress < 1.0f)
+		return;
+
+	//the play field textures are in, or one was reloaded at another size,
+	//start over with the new sizes.  Reloading a released group brings the
+	//same sizes back and leaves a paused game alone
+	if(m_bSizesChanged)
+		ResetPlayField();
+	if(!bWasLoading)
+		return;
+	if(m_bPlayPending && gameState == MENU)
+		gameState=GAME;
+	m_bPlayPending=false;
+}
+
+void Game::Init()
+{
+	ResetPlayField();
+
+	//Set Game and Menu States
+	gameState=MENU;
+	menuState=PLAY;
+	m_bQuit=false;
+	m_bPlayPending=false;
+	m_Sounds=0;
+}
+
+void Game::ResetPlayField()
+{
+	//////////////////////////////////////////////////////////////////////////
+	//Cut the animation clips, a ship texture is a strip of square frames
+	//(a plain single image is a one frame clip)
+	//////////////////////////////////////////////////////////////////////////
+	m_bSizesChanged=false;
+	m_Animations.Clear();
+	m_EnemyClip=m_Animations.AddStripClip(m_TextureWidth[TEX_ENEMY_SHIP],m_TextureHeight[TEX_ENEMY_SHIP],8.0f,true);
+	m_EnemyAnimation.SetTable(&m_Animations);
+	m_EnemyAnimation.Clear();
+	float enemyWidth=m_EnemyClip >= 0 ? (float)m_Animations.Frame(m_Animations.Clip(m_EnemyClip).firstFrame).right : 0.0f;
+
+	//////////////////////////////////////////////////////////////////////////
+	//Set All Enemy and Player positions, setup EnemyList
+	//////////////////////////////////////////////////////////////////////////
+	Enemies[0].pos.x=100.0f;
+	Enemies[0].pos.y=150.0f;
+	for(int i=1; i < MAX_ENEMIES; i++)
+	{
+		Enemies[i].pos.x=Enemies[i - 1].pos.x + (enemyWidth + 50.0f);
+		Enemies[i].pos.y=150.0f;
+	}
+	for(int i=0; i < MAX_ENEMIES; i++)
+	{
+		//staggered so the row doesn't animate in lock step
+		Enemies[i].animation=m_EnemyAnimation.Add(m_EnemyClip,i * 0.3f);
+	}
+	MovementDirection=RIGHT; //Set initial movement of all enemies to right of screen
+
+	//Starting Player Position
+	PlayerPosition.x=(float)(m_ViewWidth / 2);
+	PlayerPosition.y=m_ViewHeight - 100.0f;
+
+	//Construct list from initialized array of enemies
+	EnemyList.assign(Enemies,Enemies + MAX_ENEMIES);
+	bullets.Clear();
+
+	//Timers to move enemies in the game
+	enemyMoveTimer=0.0f;
+	bulletTimer=0.0f;
+
+	SideReached=false; //enemies haven't moved to edge of screen yet
+	GameEnded  =false; //game has not ended yet
+}
+
+void Game::Update(float dt, const GameInput& input)
+{
+	if(gameState == MENU)
+		UpdateMenu(dt,input);
+	else if(gameState == GAME)
+		UpdatePlay(dt,input);
+
+	//F1 goes back to the menu from every screen
+	if(input.keys[GAME_KEY_F1])
+	{
+		gameState=MENU;
+		menuState=PLAY;
+	}
+
+	memcpy(m_PrevKeys,input.keys,sizeof(m_PrevKeys));
+}
+
+bool Game::Pressed(const GameInput& input, int key) const
+{
+	return input.keys[key] && !m_PrevKeys[key];
+}
+
+void Game::UpdateMenu(float dt, const GameInput& input)
+{
+	//handles menu selection, wrapping from Play to Quit and back.  A held
+	//arrow repeats on a timer rather than sleeping the whole game thread
+	int move=input.keys[GAME_KEY_DOWN] ? 1 : (input.keys[GAME_KEY_UP] ? -1 : 0);
+	if(!move)
+	{
+		m_MenuRepeat=0.0f;
+	}
+	else
+	{
+		m_MenuRepeat-=dt;
+		if(Pressed(input,GAME_KEY_DOWN) || Pressed(input,GAME_KEY_UP) || m_MenuRepeat <= 0.0f)
+		{
+			menuState=(menuState + move + (QUITGAME + 1)) % (QUITGAME + 1);
+			m_Sounds|=GAME_SOUND_MENU;
+			m_MenuRepeat=MenuRepeatDelay;
+		}
+	}
+
+	//HANDLE SELECTION OF MENU ITEMS
+	if(Pressed(input,GAME_KEY_RETURN)) // enter was pressed in the menu
+	{
+		if(menuState == PLAY )//if play
+		{
+			if(m_LoadProgress < 1.0f)
+				m_bPlayPending=true; //starts once the rest has loaded
+			else
+				gameState=GAME; //game state to play game
+		}
+		else if(menuState == CREDITS ) //if credits selected
+		{
+			gameState=CREDS; //CREDS game state display credits
+		}
+		else if(menuState== OPTIONS) //if options selected
+		{
+			gameState=OPTS; //game state OPTS options
+		}
+		else if(menuState == QUITGAME) //if quit entered exit game
+		{
+			m_bQuit=true;
+		}
+	}
+}
+
+void Game::UpdatePlay(float dt, const GameInput& /*input*/)
+{
+	//animations run on the simulation clock, they stop with the game
+	m_EnemyAnimation.Advance(dt);
+
+	//bullets fly, and the ones that left the play area are dropped
+	bullets.Step(dt);
+	bullets.Retire(PlayBounds(),m_TextureWidth[TEX_BULLET] * 0.5f,m_TextureHeight[TEX_BULLET] * 0.5f);
+
+	/*
+	//Player movement and firing
+	if(input.keys[GAME_KEY_LEFT])
+	{
+		PlayerPosition.x= PlayerPosition.x - 100.0f * dt;
+		if(PlayerPosition.x < 10.0f)
+		{
+			PlayerPosition.x=10.0f;
+		}
+	}
+
+	//if Right arrow is pressed
+	if(input.keys[GAME_KEY_RIGHT])
+	{
+		PlayerPosition.x= PlayerPosition.x + 100.0f * dt;
+		if(PlayerPosition.x > m_ViewWidth - 10.0f)
+		{
+			PlayerPosition.x=m_ViewWidth - 10.0f;
+		}
+	}
+
+	//if Space key is pressed, at most one shot every 0.2 seconds
+	bulletTimer-=dt;
+	if(input.keys[GAME_KEY_SPACE] && bulletTimer <= 0.0f)
+	{
+		bullets.Add(PlayerPosition.x,PlayerPosition.y - 50.0f,0.0f,-(float)BULLET_SPEED);
+		bulletTimer=0.2f;
+	}
+
+	//Operates movement and collision of enemy objects in main game area.
+	if(EnemyList.size() < 1)
+	{
+		//all enemies gone
+		gameState=END;
+		return;
+	}
+	std::list<EnemyPositions>::iterator it; //iterator for EnemyList
+	enemyMoveTimer+=dt;
+	if(enemyMoveTimer >= 0.8f)
+	{
+		enemyMoveTimer=0.0f;
+
+		//CHECK TO SEE IF ENEMIES MOVED TO EDGE OF SCREEN
+		for (it=EnemyList.begin(); it != EnemyList.end(); ++it)
+		{
+			if(MovementDirection == RIGHT && ((it->pos.x ) > m_ViewWidth - 50.0f) )
+			{
+				MovementDirection= LEFT;
+				SideReached=true;
+			}
+			else if(MovementDirection == LEFT && ( (it->pos.x) < 50.0f) )
+			{
+				MovementDirection= RIGHT;
+				SideReached=true;
+			}
+		}
+		//IF SIDE IS REACHED MOVE DOWN AND SWITCH DIRECTIONS
+		if(SideReached)//enemies on edge of screen bounds
+		{
+			for(it=EnemyList.begin(); it != EnemyList.end(); ++it)
+			{
+				it->pos.y= it->pos.y + m_TextureHeight[TEX_ENEMY_SHIP];
+			}
+			SideReached=false; //we moved them down one
+		}
+
+		//MOVE SWARM IN DIRECTION OF MOVEMENT
+		float step=m_EnemyClip >= 0 ? (float)m_Animations.Frame(m_Animations.Clip(m_EnemyClip).firstFrame).right : 0.0f;
+		for(it=EnemyList.begin(); it != EnemyList.end(); ++it)
+		{
+			it->pos.x= it->pos.x + (MovementDirection == RIGHT ? step : -step);
+		}
+	}
+
+	//Test bullet logic
+	it=EnemyList.begin();
+	int enemySize=EnemyList.size();
+	for(int i=0; i < enemySize; i++)
+	{
+		for(int bullet=0; bullet < bullets.Count();) //already moved by Step above
+		{
+			//euclidean distance
+			float dist= sqrt( (it->pos.x - bullets.X(bullet)) * (it->pos.x - bullets.X(bullet)) + (it->pos.y - bullets.Y(bullet)) * (it->pos.y - bullets.Y(bullet)) );
+			//if distance is shorter than half length of both texture images, collision has occurred destroy both
+			if (dist < (m_TextureHeight[TEX_BULLET] / 2) + (m_TextureHeight[TEX_ENEMY_SHIP] /2) )
+			{
+				//collision happened destroy bullet and enemy and play sound
+				enemySize--;
+				m_Sounds|=GAME_SOUND_EXPLOSION;
+				bullets.Remove(bullet);
+				it=EnemyList.erase(it);
+				break;
+			}
+			else
+			{
+				++bullet;
+			}
+		}//end inner for loop
+		if(it != EnemyList.end() )
+			++it;
+	}//end primary for loop for bullet tests
+
+	//Test to see if invaders made it.
+	for(it=EnemyList.begin(); it != EnemyList.end(); ++it)
+	{
+		float dist= sqrt( (it->pos.x - PlayerPosition.x) * (it->pos.x - PlayerPosition.x) + (it->pos.y - PlayerPosition.y) * (it->pos.y - PlayerPosition.y) );
+		if (dist < (m_TextureHeight[TEX_PLAYER_SHIP] / 2) + (m_TextureHeight[TEX_ENEMY_SHIP] /2) )
+		{
+			gameState=ENDFAIL;
+		}
+		else if( it->pos.y > m_ViewHeight - 50.0f )
+		{
+			gameState=ENDFAIL;
+		}
+	}
+	*/
+}
+
+void Game::Record(RenderCommandList& frame)
+{
+	// Start a new command list, cleared to this colour
+	frame.Reset(ClearColor);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Draw 2D sprites
+	//////////////////////////////////////////////////////////////////////////
+	if(gameState == MENU) //if state is menu state
+	{
+		RecordMenu(frame);
+	}//end menu draw
+	else if(gameState == GAME) //if current game state is game draw game screen
+	{
+		frame.AddSprite(TEX_MENU_BACKGROUND,0,0.0f,0.0f,0.0f,0.0f,White,LAYER_BACKGROUND,0.0f);
+		frame.AddSprite(TEX_PLAY_BOUNDARY,0,0.0f,0.0f,PlayBoundaryX,PlayBoundaryY,White,LAYER_SCENERY,0.0f);
+
+		/*
+		std::list<EnemyPositions>::iterator it; //iterator for EnemyList
+		//Draw All Enemies in EnemyList
+		for(it=EnemyList.begin(); it != EnemyList.end(); ++it)
+		{
+			//one lookup for the frame, every enemy still shares the texture's batch
+			const ImageRect& enemyFrame=m_EnemyAnimation.Frame(it->animation);
+			frame.AddSprite(TEX_ENEMY_SHIP,&enemyFrame,(enemyFrame.right - enemyFrame.left) * 0.5f,(enemyFrame.bottom - enemyFrame.top) * 0.5f,it->pos.x,it->pos.y,White,LAYER_OBJECTS,0.0f);
+		}
+		frame.AddSprite(TEX_PLAYER_SHIP,0,m_TextureWidth[TEX_PLAYER_SHIP] * 0.5f,m_TextureHeight[TEX_PLAYER_SHIP] * 0.5f,PlayerPosition.x,PlayerPosition.y,White,LAYER_OBJECTS,0.0f);
+		//Draw the player bullets that are on screen
+		float bulletCenterX=m_TextureWidth[TEX_BULLET] * 0.5f;
+		float bulletCenterY=m_TextureHeight[TEX_BULLET] * 0.5f;
+		const std::vector<int>& visibleBullets=bullets.Cull(ViewBounds(),bulletCenterX,bulletCenterY);
+		for(size_t i=0; i < visibleBullets.size(); i++)
+		{
+			frame.AddSprite(TEX_BULLET,0,bulletCenterX,bulletCenterY,bullets.X(visibleBullets[i]),bullets.Y(visibleBullets[i]),White,LAYER_OBJECTS,0.0f);
+		}
+		*/
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+	// Draw Text
+	//////////////////////////////////////////////////////////////////////////
+
+	// Whole screen for text placement
+	ImageRect rect={0,0,m_ViewWidth,m_ViewHeight};
+
+	// Draw Text, using TEXT_TOP, TEXT_RIGHT for placement in the top right of the
+	// screen.  TEXT_NOCLIP can improve speed of text rendering, but allows text
+	// to be drawn outside of the rect specified to draw text in.
+	frame.AddText(L"GSP 362 - Course Project!",rect,TEXT_TOP | TEXT_RIGHT | TEXT_WORDBREAK,Red); //draw text in upper right hand corner
+
+	//Draw FPS Counter
+	wchar_t buffer[64];
+	if(m_bHudTimings) //timings would make every headless frame different
+	{
+		swprintf(buffer,64,L"FPS: %d",m_FPS);
+		frame.AddText(buffer,rect,TEXT_TOP | TEXT_NOCLIP,Red);
+
+		//Draw pacing statistics for the last second under the FPS counter
+		ImageRect pacingRect=rect;
+		pacingRect.top+=30;
+		swprintf(buffer,64,L"Frame: %.2fms Err: %.2fms Missed: %d",m_Pacing.meanFrameMs,m_Pacing.meanErrorMs,m_Pacing.missed);
+		frame.AddText(buffer,pacingRect,TEXT_TOP | TEXT_NOCLIP,Red);
+
+		//and what dynamic resolution is doing about it
+		ImageRect scaleRect=pacingRect;
+		scaleRect.top+=30;
+		swprintf(buffer,64,L"Scale: %d%% Draw: %.2fms",(int)(m_RenderScale * 100.0f + 0.5f),m_DrawMs);
+		frame.AddText(buffer,scaleRect,TEXT_TOP | TEXT_NOCLIP,Red);
+	}
+
+	frame.AddText(L"Press F1 for Menu/Pause",rect,TEXT_BOTTOM | TEXT_LEFT | TEXT_NOCLIP,Red);
+
+	if(gameState == MENU)
+	{
+		int halfWidth=m_ViewWidth / 2;
+		ImageRect rectangle={halfWidth - 80,50,halfWidth - 20 + 220,200};
+		//centering inside a DT_CALCRECT sized rect lands the text at its top left,
+		//so record that directly, the game thread has no font to measure with
+		frame.AddText(L"Shipping Madness!!!",rectangle,TEXT_TOP | TEXT_LEFT | TEXT_NOCLIP,Red);
+
+		if(m_LoadProgress < 1.0f)
+		{
+			ImageRect loadingRect={0,0,m_ViewWidth,m_ViewHeight - 30};
+			swprintf(buffer,64,m_bPlayPending ? L"Starting... %d%%" : L"Loading %d%%",(int)(m_LoadProgress * 100.0f));
+			frame.AddText(buffer,loadingRect,TEXT_BOTTOM | TEXT_CENTER | TEXT_NOCLIP,Cyan);
+		}
+	}
+
+	if(gameState == CREDS) //if current game state is credits
+	{
+		frame.AddText(L"\n\nCredits!\n\n\n Design, Development, Programming, and Testing done by...\n Team A\n Robert Evans\nNicholas Grande\nJustin Atkinson\nTylor Emmett\nJeromy Jones\nLeseth Mitchell",
+			rect,TEXT_CENTER | TEXT_NOCLIP,Cyan);
+	}
+	if(gameState == OPTS)
+	{
+		frame.AddText(L"\n\nOPTIONS\n\n\n\n FULL SCREEN - Press Y for FullScreen or N for Windowed Mode\n",rect,TEXT_CENTER | TEXT_NOCLIP,Cyan);
+	}
+	if(gameState == END)
+	{
+		frame.AddText(L"\n\nCONGRATULATIONS!\n\n\n\n YOU HAVE DEFEATED THE ATTACKERS\n",rect,TEXT_CENTER | TEXT_NOCLIP,Cyan);
+	}
+	if(gameState == ENDFAIL)
+	{
+		frame.AddText(L"\n\nYOU LOST!!!!!\n\n\n\n YOU WERE DOMINATED!\n",rect,TEXT_CENTER | TEXT_NOCLIP,Cyan);
+	}
+}
+
+void Game::RecordMenu(RenderCommandList& frame)
+{
+	float halfWidth=(float)(m_ViewWidth / 2);
+
+	//background, then each button with the selected one highlighted
+	frame.AddSprite(TEX_MENU_BACKGROUND,0,0.0f,0.0f,0.0f,0.0f,White,LAYER_BACKGROUND,0.0f);
+
+	int buttons[4]={menuState == PLAY ? TEX_HL_PLAYGAME : TEX_PLAYGAME,
+					menuState == CREDITS ? TEX_HL_CREDITS : TEX_CREDITS,
+					menuState == OPTIONS ? TEX_HL_OPTIONS : TEX_OPTIONS,
+					menuState == QUITGAME ? TEX_HL_QUIT : TEX_QUIT};
+	for(int i=0; i < 4; i++)
+	{
+		frame.AddSprite(buttons[i],0,m_TextureWidth[buttons[i]] * 0.5f,m_TextureHeight[buttons[i]] * 0.5f,
+			halfWidth - 20.0f,150.0f + 75.0f * i,White,LAYER_INTERFACE,0.0f);
+	}
+}
+
+void Game::SetHud(bool bTimings, int fps, const PacingStats& pacing, float renderScale, float drawMs)
+{
+	m_bHudTimings=bTimings;
+	m_FPS=fps;
+	m_Pacing=pacing;
+	m_RenderScale=renderScale;
+	m_DrawMs=drawMs;
+}
+
+int Game::State() const
+{
+	return gameState;
+}
+
+int Game::Menu() const
+{
+	return menuState;
+}
+
+void Game::SetState(int state, int menu)
+{
+	gameState=state;
+	menuState=menu;
+}
+
+unsigned int Game::TakeSounds()
+{
+	unsigned int sounds=m_Sounds;
+	m_Sounds=0;
+	return sounds;
+}
+
+bool Game::IsQuitRequested() const
+{
+	return m_bQuit;
+}
+
+CullRect Game::ViewBounds() const
+{
+	CullRect bounds={0.0f,0.0f,(float)m_ViewWidth,(float)m_ViewHeight};
+	return bounds;
+}
+
+CullRect Game::PlayBounds() const
+{
+	//where Record puts the boundary image, the whole view if it didn't load
+	if(!m_TextureWidth[TEX_PLAY_BOUNDARY] || !m_TextureHeight[TEX_PLAY_BOUNDARY])
+		return ViewBounds();
+
+	CullRect bounds={PlayBoundaryX,PlayBoundaryY,PlayBoundaryX + m_TextureWidth[TEX_PLAY_BOUNDARY],PlayBoundaryY + m_TextureHeight[TEX_PLAY_BOUNDARY]};
+	return bounds;
+}
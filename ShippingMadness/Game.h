@@ -0,0 +1,250 @@
+///////////////////////////////////////////////////////////////
+//Game, the Shipping Madness menus and play field: the state
+//machine, input handling and frame recording.  It knows nothing
+//about windows, devices or sound libraries, so the Windows
+//framework and the SDL build run exactly the same game
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include "RenderCommands.h"
+#include "SpriteAnimation.h"
+#include "SpriteCulling.h"
+#include "FramePacer.h"
+#include <list>
+
+//Textures, the hosts load them in this order from TextureFile
+enum
+{
+	TEX_MENU_BACKGROUND,TEX_PLAY_BOUNDARY,TEX_PLAYER_SHIP,TEX_ENEMY_SHIP,TEX_BULLET,
+	TEX_PLAYGAME,TEX_HL_PLAYGAME,TEX_CREDITS,TEX_HL_CREDITS,TEX_OPTIONS,TEX_HL_OPTIONS,
+	TEX_QUIT,TEX_HL_QUIT,TEX_COUNT //HL_ are the highlighted menu buttons
+};
+
+//Keys the game reads, each host maps its own key codes onto these
+enum
+{
+	GAME_KEY_UP,
+	GAME_KEY_DOWN,
+	GAME_KEY_LEFT,
+	GAME_KEY_RIGHT,
+	GAME_KEY_RETURN,
+	GAME_KEY_SPACE,
+	GAME_KEY_F1,
+	GAME_KEY_COUNT
+};
+
+//Sounds, the hosts open them from SoundInfo in this order
+enum
+{
+	SND_MENU_MUSIC,SND_PLAY_MUSIC,SND_MENU_MOVE,SND_EXPLOSION,
+	SND_TADA,SND_CHORD,SND_JAGUAR,SND_SWISH,SND_COUNT //the last four are on the Windows build's test keys
+};
+
+//Sounds for the host to play, TakeSounds returns them as bits, 1 << SND_
+enum
+{
+	GAME_SOUND_MENU			= 1 << SND_MENU_MOVE,	//menu selection moved
+	GAME_SOUND_EXPLOSION	= 1 << SND_EXPLOSION	//an enemy was shot
+};
+
+//Which sounds keep their voices when there are too many, higher wins
+enum
+{
+	SOUND_PRIORITY_EFFECT,	//explosions and the test sounds
+	SOUND_PRIORITY_UI,		//menu feedback
+	SOUND_PRIORITY_MUSIC
+};
+
+struct GameSoundInfo
+{
+	const char*		file;
+	unsigned int	groups;		//ASSETS_ bits it is open for, 0 for always
+	bool			bMusic;		//streamed and looped on its own channel
+	float			volume;
+	int				priority;	//SOUND_PRIORITY_
+	int				maxVoices;	//playing at once, another one replaces one of them
+};
+
+//Asset groups, what each screen draws and plays.  AssetGroups says which
+//the game may need next, hosts load those and release the rest
+enum
+{
+	ASSETS_MENU		= 0x1,	//menu background and buttons, menu music and selection sound
+	ASSETS_PLAY		= 0x2,	//background, boundary and sprites, explosion and game music
+	ASSETS_ALL		= ASSETS_MENU | ASSETS_PLAY
+};
+
+//A screen the regression runs render and check against <name>.png
+struct GameScenario
+{
+	const char*	name;
+	int			gameState;	//Game:: GAME STATES
+	int			menuState;	//Game:: MENU STATES
+};
+
+//keys held down this frame
+struct GameInput
+{
+	bool	keys[GAME_KEY_COUNT];
+};
+
+struct GamePosition
+{
+	float	x;
+	float	y;
+};
+
+class Game
+{
+public:
+	enum {MENU,GAME,QUIT,CREDS,OPTS,END,ENDFAIL}; //GAME STATES
+	enum {PLAY,CREDITS,OPTIONS,QUITGAME}; //MENU STATES
+
+	Game();
+
+	//file name without extension, the hosts try <name>.dds then <name>.pma.png
+	static const char*	TextureFile(int texture);
+	static bool			IsMenuTexture(int texture); //needed before the menu can be shown
+	static unsigned int	TextureGroups(int texture); //ASSETS_ bits of the groups it is in
+	static int			FindTexture(const char* filename); //texture loaded from the file, -1 if none
+	static const GameSoundInfo&	SoundInfo(int sound); //SND_ order
+	static int					ScenarioCount();
+	static const GameScenario&	Scenario(int scenario); //every menu selection, the game and each text screen
+
+	//sizes of the loaded textures, 0 for one that failed to load
+	void	SetTextureSize(int texture, int width, int height);
+
+	//client area in pixels, the layout follows it
+	void	SetViewport(int width, int height);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		SetLoadProgress
+	// Parameters:	float progress - share of the assets loaded, 1 when done
+	// Return:		void
+	// Description:	For hosts that show the menu while the rest loads.  The
+	//				menu shows the progress, Play waits for it, and at 1 the
+	//				play field is laid out again if texture sizes changed
+	//				since, whether by loading or by a hot reload.  1 until a
+	//				host says otherwise.
+	//////////////////////////////////////////////////////////////////////////
+	void	SetLoadProgress(float progress);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Init
+	// Parameters:	void
+	// Return:		void
+	// Description:	Starts at the main menu, cuts the animation clips and
+	//				places the player and the enemy rows.  Call once the
+	//				texture sizes and the viewport are set.
+	//////////////////////////////////////////////////////////////////////////
+	void	Init();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Update
+	// Parameters:	float dt - simulation step in seconds
+	//				const GameInput& input - keys held this frame
+	// Return:		void
+	// Description:	Menu navigation repeats every 0.15s while an arrow is
+	//				held, the selection and the play field run on dt.
+	//////////////////////////////////////////////////////////////////////////
+	void	Update(float dt, const GameInput& input);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Record
+	// Parameters:	RenderCommandList& frame - list to fill, reset first
+	// Return:		void
+	// Description:	Describes the current screen as sprite and text commands,
+	//				the host sorts the list and plays it back.  Text formats
+	//				are TEXT_ flags, which share the DT_ values.
+	//////////////////////////////////////////////////////////////////////////
+	void	Record(RenderCommandList& frame);
+
+	//frame rate, pacing, render scale and draw time lines in the corner, off for headless runs
+	void	SetHud(bool bTimings, int fps, const PacingStats& pacing, float renderScale, float drawMs);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		AssetGroups
+	// Parameters:	void
+	// Return:		unsigned int - ASSETS_ bits
+	// Description:	The groups the current screen uses and the ones the next
+	//				screen will, so they are in before the switch: the menu
+	//				is one key from play, the text screens only lead back to
+	//				the menu.  Play releases the menu, F1 brings it back.
+	//////////////////////////////////////////////////////////////////////////
+	unsigned int	AssetGroups() const;
+	int				Music() const; //SND_ music for the current screen, -1 to leave it as it is
+
+	int		State() const;
+	int		Menu() const;
+	void	SetState(int gameState, int menuState); //jumps straight to a screen, for the regression scenarios
+
+	unsigned int	TakeSounds();			//GAME_SOUND_ bits raised since the last call
+	bool			IsQuitRequested() const;	//Quit was picked from the menu
+
+private:
+	bool	Pressed(const GameInput& input, int key) const; //down now, up last frame
+	void	ResetPlayField();	//clips, enemy rows and the player, from the texture sizes
+	void	UpdateMenu(float dt, const GameInput& input);
+	void	UpdatePlay(float dt, const GameInput& input);
+	void	RecordMenu(RenderCommandList& frame);
+	CullRect	ViewBounds() const;	//client area
+	CullRect	PlayBounds() const;	//level 1 boundary, where bullets stay alive
+
+private:
+	//////////////////////////////////////////////////////////////////////////
+	//Game and Menu Finite State Machine Variables
+	//////////////////////////////////////////////////////////////////////////
+	int				gameState;
+	int				menuState;
+	bool			m_bQuit;
+	unsigned int	m_Sounds;
+	bool			m_PrevKeys[GAME_KEY_COUNT];
+	float			m_MenuRepeat;	//seconds until a held arrow moves the selection again
+	float			m_LoadProgress;
+	bool			m_bSizesChanged;	//texture sizes set since the play field was laid out
+	bool			m_bPlayPending;	//Play picked while still loading
+
+	int				m_ViewWidth;
+	int				m_ViewHeight;
+	int				m_TextureWidth[TEX_COUNT];
+	int				m_TextureHeight[TEX_COUNT];
+
+	bool			m_bHudTimings;
+	int				m_FPS;
+	PacingStats		m_Pacing;
+	float			m_RenderScale;	//dynamic resolution, 1 is full size
+	float			m_DrawMs;		//average time the renderer takes per frame
+
+	//////////////////////////////////////////////////////////////////////////
+	//Sprite sheet animation, clips are cut from the textures in Init and
+	//advanced with the simulation step in Update
+	//////////////////////////////////////////////////////////////////////////
+	SpriteAnimationTable	m_Animations;		//every clip's frame rects
+	int						m_EnemyClip;		//enemy ship strip, -1 if the texture is missing
+	SpriteAnimator			m_EnemyAnimation;	//one entry per Enemies slot
+
+	//////////////////////////////////////////////////////////////////////////
+	//Game Object Structures
+	//////////////////////////////////////////////////////////////////////////
+	struct EnemyPositions //stores all positions of each enemy used for drawing and collision tests
+	{
+		GamePosition pos;
+		int animation; //index in m_EnemyAnimation
+	};
+
+	enum						{LEFT,RIGHT}; //Used for movment direction of enemy units
+	static const int			MAX_ENEMIES = 6;
+	EnemyPositions				Enemies[MAX_ENEMIES];
+	std::list<EnemyPositions>	EnemyList; //list of enemies , arrays wouldn't allow removal from middle of array
+	int							MovementDirection;
+	bool						SideReached; //determines if enemies moved to side of screen and need to be turned around
+	bool						GameEnded;// Did game end?
+
+	GamePosition				PlayerPosition; //position of player ship
+	//player bullets, positions in flat arrays so they move, cull and retire in bulk
+	ProjectileArray				bullets;
+	static const int			BULLET_SPEED = 120; //pixels per second, straight up
+
+	float enemyMoveTimer; //enemies step every 0.8 seconds
+	float bulletTimer; //seconds until the player can fire again
+};
@@ -0,0 +1,775 @@
+////////////////////////////////////////////////////////////////
+//Image class member function definitions, includes a small
+//inflate/deflate so PNGs can be read and written without D3DX
+////////////////////////////////////////////////////////////////
+
+#include "Image.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+namespace
+{
+	////////////////////////////////////////////////////////////////
+	//Inflate (RFC 1951) - canonical huffman decoding, bit at a time
+	////////////////////////////////////////////////////////////////
+	struct BitReader
+	{
+		const unsigned char*	data;
+		size_t					size;
+		size_t					pos;
+		unsigned int			bitBuf;
+		int						bitCount;
+		bool					overrun;
+	};
+
+	unsigned int GetBits(BitReader& br, int n)
+	{
+		while(br.bitCount < n)
+		{
+			unsigned int byte=0;
+			if(br.pos < br.size)
+				byte=br.data[br.pos++];
+			else
+				br.overrun=true;
+			br.bitBuf |= byte << br.bitCount;
+			br.bitCount += 8;
+		}
+		unsigned int value=br.bitBuf & ((1u << n) - 1);
+		br.bitBuf >>= n;
+		br.bitCount -= n;
+		return value;
+	}
+
+	struct Huffman
+	{
+		short count[16];	//number of codes of each length
+		short symbol[288];	//symbols ordered by code
+	};
+
+	void BuildHuffman(Huffman& h, const unsigned char* lengths, int n)
+	{
+		short offsets[16];
+		memset(h.count,0,sizeof(h.count));
+		for(int i=0; i < n; i++)
+			h.count[lengths[i]]++;
+		h.count[0]=0;
+
+		offsets[1]=0;
+		for(int len=1; len < 15; len++)
+			offsets[len + 1]=offsets[len] + h.count[len];
+
+		for(int i=0; i < n; i++)
+		{
+			if(lengths[i] != 0)
+				h.symbol[offsets[lengths[i]]++]=(short)i;
+		}
+	}
+
+	int Decode(BitReader& br, const Huffman& h)
+	{
+		int code=0, first=0, index=0;
+		for(int len=1; len < 16; len++)
+		{
+			code |= GetBits(br,1);
+			int count=h.count[len];
+			if(code - count < first)
+				return h.symbol[index + (code - first)];
+			index += count;
+			first += count;
+			first <<= 1;
+			code <<= 1;
+		}
+		return -1; //ran out of codes
+	}
+
+	const short LengthBase[29]	= {3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258};
+	const short LengthExtra[29]	= {0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0};
+	const short DistBase[30]	= {1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,1025,1537,2049,3073,4097,6145,8193,12289,16385,24577};
+	const short DistExtra[30]	= {0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13};
+
+	bool InflateCodes(BitReader& br, const Huffman& lencode, const Huffman& distcode, std::vector<unsigned char>& out)
+	{
+		for(;;)
+		{
+			int symbol=Decode(br,lencode);
+			if(symbol < 0 || br.overrun)
+				return false;
+			if(symbol < 256)
+			{
+				out.push_back((unsigned char)symbol);
+			}
+			else if(symbol == 256)
+			{
+				return true; //end of block
+			}
+			else
+			{
+				symbol -= 257;
+				if(symbol >= 29)
+					return false;
+				int length=LengthBase[symbol] + GetBits(br,LengthExtra[symbol]);
+
+				symbol=Decode(br,distcode);
+				if(symbol < 0 || symbol >= 30)
+					return false;
+				size_t dist=DistBase[symbol] + GetBits(br,DistExtra[symbol]);
+				if(dist > out.size())
+					return false;
+
+				size_t from=out.size() - dist;
+				for(int i=0; i < length; i++)
+					out.push_back(out[from + i]); //overlapping copies repeat the run
+			}
+		}
+	}
+
+	//the fixed codes of BTYPE 1, built once during static initialisation so
+	//the loader's workers and the render thread only ever read them
+	struct FixedCodes
+	{
+		Huffman	len;
+		Huffman	dist;
+
+		FixedCodes()
+		{
+			unsigned char lengths[288];
+			int i=0;
+			for(; i < 144; i++) lengths[i]=8;
+			for(; i < 256; i++) lengths[i]=9;
+			for(; i < 280; i++) lengths[i]=7;
+			for(; i < 288; i++) lengths[i]=8;
+			BuildHuffman(len,lengths,288);
+			for(i=0; i < 30; i++) lengths[i]=5;
+			BuildHuffman(dist,lengths,30);
+		}
+	};
+	const FixedCodes Fixed;
+
+	bool Inflate(const unsigned char* src, size_t size, std::vector<unsigned char>& out)
+	{
+		BitReader br={src,size,0,0,0,false};
+
+		int last=0;
+		while(!last)
+		{
+			last=GetBits(br,1);
+			int type=GetBits(br,2);
+
+			if(type == 0) //stored block, skip to byte boundary
+			{
+				br.bitBuf=0;
+				br.bitCount=0;
+				if(br.pos + 4 > br.size)
+					return false;
+				unsigned int len=br.data[br.pos] | (br.data[br.pos + 1] << 8);
+				br.pos += 4;
+				if(br.pos + len > br.size)
+					return false;
+				out.insert(out.end(),br.data + br.pos,br.data + br.pos + len);
+				br.pos += len;
+			}
+			else if(type == 1)
+			{
+				if(!InflateCodes(br,Fixed.len,Fixed.dist,out))
+					return false;
+			}
+			else if(type == 2)
+			{
+				static const unsigned char order[19]={16,17,18,0,8,7,9,6,10,5,11,4,12,3,13,2,14,1,15};
+				unsigned char lengths[320];
+				int nlen=GetBits(br,5) + 257;
+				int ndist=GetBits(br,5) + 1;
+				int ncode=GetBits(br,4) + 4;
+				if(nlen > 286 || ndist > 30)
+					return false;
+
+				memset(lengths,0,sizeof(lengths));
+				for(int i=0; i < ncode; i++)
+					lengths[order[i]]=(unsigned char)GetBits(br,3);
+
+				Huffman lencode, distcode;
+				BuildHuffman(lencode,lengths,19);
+
+				int index=0;
+				while(index < nlen + ndist)
+				{
+					int symbol=Decode(br,lencode);
+					if(symbol < 0 || br.overrun)
+						return false;
+					if(symbol < 16)
+					{
+						lengths[index++]=(unsigned char)symbol;
+					}
+					else
+					{
+						unsigned char len=0;
+						int repeat;
+						if(symbol == 16)
+						{
+							if(index == 0)
+								return false;
+							len=lengths[index - 1];
+							repeat=3 + GetBits(br,2);
+						}
+						else if(symbol == 17)
+							repeat=3 + GetBits(br,3);
+						else
+							repeat=11 + GetBits(br,7);
+						if(index + repeat > nlen + ndist)
+							return false;
+						while(repeat--)
+							lengths[index++]=len;
+					}
+				}
+
+				BuildHuffman(lencode,lengths,nlen);
+				BuildHuffman(distcode,lengths + nlen,ndist);
+				if(!InflateCodes(br,lencode,distcode,out))
+					return false;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		return !br.overrun;
+	}
+
+	////////////////////////////////////////////////////////////////
+	//Deflate - greedy LZ77 with hash chains and the fixed huffman
+	//codes, plenty for frame captures with large flat areas
+	////////////////////////////////////////////////////////////////
+	struct BitWriter
+	{
+		std::vector<unsigned char>*	out;
+		unsigned int				bitBuf;
+		int							bitCount;
+	};
+
+	void PutBits(BitWriter& bw, unsigned int value, int n)
+	{
+		bw.bitBuf |= value << bw.bitCount;
+		bw.bitCount += n;
+		while(bw.bitCount >= 8)
+		{
+			bw.out->push_back((unsigned char)bw.bitBuf);
+			bw.bitBuf >>= 8;
+			bw.bitCount -= 8;
+		}
+	}
+
+	//huffman codes are sent most significant bit first
+	void PutCode(BitWriter& bw, unsigned int code, int n)
+	{
+		unsigned int reversed=0;
+		for(int i=0; i < n; i++)
+			reversed |= ((code >> i) & 1) << (n - 1 - i);
+		PutBits(bw,reversed,n);
+	}
+
+	void PutLiteral(BitWriter& bw, int symbol)
+	{
+		if(symbol < 144)		PutCode(bw,0x30 + symbol,8);
+		else if(symbol < 256)	PutCode(bw,0x190 + symbol - 144,9);
+		else if(symbol < 280)	PutCode(bw,symbol - 256,7);
+		else					PutCode(bw,0xC0 + symbol - 280,8);
+	}
+
+	void PutMatch(BitWriter& bw, int length, int dist)
+	{
+		int code=28;
+		while(LengthBase[code] > length)
+			code--;
+		PutLiteral(bw,257 + code);
+		PutBits(bw,length - LengthBase[code],LengthExtra[code]);
+
+		code=29;
+		while(DistBase[code] > dist)
+			code--;
+		PutCode(bw,code,5);
+		PutBits(bw,dist - DistBase[code],DistExtra[code]);
+	}
+
+	void Deflate(const unsigned char* src, size_t size, std::vector<unsigned char>& out)
+	{
+		const int WindowSize=32768;
+		const int HashSize=1 << 15;
+		const int MaxChain=32;
+
+		BitWriter bw={&out,0,0};
+		PutBits(bw,1,1); //single final block
+		PutBits(bw,1,2); //fixed huffman codes
+
+		std::vector<int> head(HashSize,-1);
+		std::vector<int> prev(WindowSize,-1);
+
+		size_t pos=0;
+		while(pos < size)
+		{
+			int bestLen=0, bestDist=0;
+			if(pos + 3 <= size)
+			{
+				unsigned int hash=((src[pos] << 10) ^ (src[pos + 1] << 5) ^ src[pos + 2]) & (HashSize - 1);
+				int candidate=head[hash];
+				int maxLen=(int)(size - pos < 258 ? size - pos : 258);
+				for(int chain=0; candidate >= 0 && chain < MaxChain; chain++)
+				{
+					int dist=(int)pos - candidate;
+					if(dist > WindowSize)
+						break;
+					int len=0;
+					while(len < maxLen && src[candidate + len] == src[pos + len])
+						len++;
+					if(len > bestLen)
+					{
+						bestLen=len;
+						bestDist=dist;
+						if(len == maxLen)
+							break;
+					}
+					candidate=prev[candidate & (WindowSize - 1)];
+				}
+			}
+
+			int advance=1;
+			if(bestLen >= 3)
+			{
+				PutMatch(bw,bestLen,bestDist);
+				advance=bestLen;
+			}
+			else
+			{
+				PutLiteral(bw,src[pos]);
+			}
+
+			//insert every position we step over into the hash chains
+			for(int i=0; i < advance; i++, pos++)
+			{
+				if(pos + 3 <= size)
+				{
+					unsigned int hash=((src[pos] << 10) ^ (src[pos + 1] << 5) ^ src[pos + 2]) & (HashSize - 1);
+					prev[pos & (WindowSize - 1)]=head[hash];
+					head[hash]=(int)pos;
+				}
+			}
+		}
+
+		PutLiteral(bw,256);
+		if(bw.bitCount > 0)
+			PutBits(bw,0,8 - bw.bitCount);
+	}
+
+	////////////////////////////////////////////////////////////////
+	//PNG helpers
+	////////////////////////////////////////////////////////////////
+	unsigned int ReadBE32(const unsigned char* p)
+	{
+		return ((unsigned int)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+	}
+
+	void WriteBE32(std::vector<unsigned char>& out, unsigned int value)
+	{
+		out.push_back((unsigned char)(value >> 24));
+		out.push_back((unsigned char)(value >> 16));
+		out.push_back((unsigned char)(value >> 8));
+		out.push_back((unsigned char)value);
+	}
+
+	//built during static initialisation like the fixed Huffman codes
+	struct CrcTable
+	{
+		unsigned int	entries[256];
+
+		CrcTable()
+		{
+			for(unsigned int i=0; i < 256; i++)
+			{
+				unsigned int c=i;
+				for(int k=0; k < 8; k++)
+					c=(c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+				entries[i]=c;
+			}
+		}
+	};
+	const CrcTable Crc;
+
+	unsigned int Crc32(const unsigned char* data, size_t size, unsigned int crc=0)
+	{
+		crc=~crc;
+		for(size_t i=0; i < size; i++)
+			crc=Crc.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+		return ~crc;
+	}
+
+	unsigned int Adler32(const unsigned char* data, size_t size)
+	{
+		unsigned int a=1, b=0;
+		for(size_t i=0; i < size; i++)
+		{
+			a=(a + data[i]) % 65521;
+			b=(b + a) % 65521;
+		}
+		return (b << 16) | a;
+	}
+
+	void WriteChunk(std::vector<unsigned char>& out, const char* type, const std::vector<unsigned char>& data)
+	{
+		WriteBE32(out,(unsigned int)data.size());
+		size_t start=out.size();
+		out.insert(out.end(),type,type + 4);
+		out.insert(out.end(),data.begin(),data.end());
+		WriteBE32(out,Crc32(&out[start],out.size() - start));
+	}
+
+	int Paeth(int a, int b, int c)
+	{
+		int p=a + b - c;
+		int pa=abs(p - a), pb=abs(p - b), pc=abs(p - c);
+		if(pa <= pb && pa <= pc)
+			return a;
+		return pb <= pc ? b : c;
+	}
+
+	bool ReadWholeFile(const char* filename, std::vector<unsigned char>& data)
+	{
+		FILE* file=fopen(filename,"rb");
+		if(!file)
+			return false;
+		fseek(file,0,SEEK_END);
+		long size=ftell(file);
+		fseek(file,0,SEEK_SET);
+		if(size > 0)
+		{
+			data.resize(size);
+			size=(long)fread(&data[0],1,size,file);
+		}
+		fclose(file);
+		return size > 0;
+	}
+
+	//the largest side accepted, as the DDS loader and the image cache
+	const int MaxDimension=16384;
+}
+
+Image::Image()
+{
+	m_Width=0;
+	m_Height=0;
+	m_bOpaque=true;
+}
+
+bool Image::LoadPNG(const char* filename)
+{
+	std::vector<unsigned char> data;
+	if(!ReadWholeFile(filename,data))
+	{
+		Release();
+		return false;
+	}
+	return LoadPNGFromMemory(&data[0],data.size());
+}
+
+bool Image::LoadPNGFromMemory(const unsigned char* data, size_t size)
+{
+	static const unsigned char signature[8]={137,80,78,71,13,10,26,10};
+	Release();
+	if(size < 8 || memcmp(data,signature,8) != 0)
+		return false;
+
+	int width=0, height=0, bitDepth=0, colorType=0, interlace=0;
+	unsigned int palette[256];
+	for(int i=0; i < 256; i++)
+		palette[i]=0xFF000000;
+	std::vector<unsigned char> compressed;
+
+	//walk the chunks, gathering header, palette and image data
+	size_t pos=8;
+	while(pos + 12 <= size)
+	{
+		unsigned int length=ReadBE32(data + pos);
+		const unsigned char* type=data + pos + 4;
+		const unsigned char* chunk=data + pos + 8;
+		if(length > size - pos - 12)
+			return false;
+
+		if(memcmp(type,"IHDR",4) == 0 && length >= 13)
+		{
+			width=(int)ReadBE32(chunk);
+			height=(int)ReadBE32(chunk + 4);
+			bitDepth=chunk[8];
+			colorType=chunk[9];
+			interlace=chunk[12];
+		}
+		else if(memcmp(type,"PLTE",4) == 0)
+		{
+			for(unsigned int i=0; i < length / 3 && i < 256; i++)
+				palette[i]=0xFF000000 | (chunk[i * 3] << 16) | (chunk[i * 3 + 1] << 8) | chunk[i * 3 + 2];
+		}
+		else if(memcmp(type,"tRNS",4) == 0 && colorType == 3)
+		{
+			for(unsigned int i=0; i < length && i < 256; i++)
+				palette[i]=(palette[i] & 0x00FFFFFF) | ((unsigned int)chunk[i] << 24);
+		}
+		else if(memcmp(type,"IDAT",4) == 0)
+		{
+			compressed.insert(compressed.end(),chunk,chunk + length);
+		}
+		else if(memcmp(type,"IEND",4) == 0)
+		{
+			break;
+		}
+		pos += length + 12;
+	}
+
+	//only the layouts our assets use: non-interlaced, 8 bit (16 bit for non palette)
+	int channels;
+	switch(colorType)
+	{
+		case 0: channels=1; break;
+		case 2: channels=3; break;
+		case 3: channels=1; break;
+		case 4: channels=2; break;
+		case 6: channels=4; break;
+		default: return false;
+	}
+	if(width <= 0 || height <= 0 || width > MaxDimension || height > MaxDimension || interlace != 0 || compressed.size() < 2)
+		return false;
+	if(bitDepth != 8 && !(bitDepth == 16 && colorType != 3))
+		return false;
+
+	//a corrupt header must not wrap the size on a 32 bit build
+	std::vector<unsigned char> raw;
+	int bpp=channels * bitDepth / 8;
+	size_t stride=(size_t)width * bpp;
+	if((stride + 1) > (size_t)-1 / height)
+		return false;
+	raw.reserve((stride + 1) * height);
+	if(!Inflate(&compressed[2],compressed.size() - 2,raw) || raw.size() < (stride + 1) * height)
+		return false;
+
+	//undo the per-row filters in place
+	for(int y=0; y < height; y++)
+	{
+		unsigned char* row=&raw[y * (stride + 1) + 1];
+		const unsigned char* prior=y > 0 ? row - (stride + 1) : 0;
+		int filter=row[-1];
+		for(size_t x=0; x < stride; x++)
+		{
+			int a=x >= (size_t)bpp ? row[x - bpp] : 0;
+			int b=prior ? prior[x] : 0;
+			int c=(prior && x >= (size_t)bpp) ? prior[x - bpp] : 0;
+			switch(filter)
+			{
+				case 0: break;
+				case 1: row[x]=(unsigned char)(row[x] + a); break;
+				case 2: row[x]=(unsigned char)(row[x] + b); break;
+				case 3: row[x]=(unsigned char)(row[x] + ((a + b) >> 1)); break;
+				case 4: row[x]=(unsigned char)(row[x] + Paeth(a,b,c)); break;
+				default: return false;
+			}
+		}
+	}
+
+	m_Width=width;
+	m_Height=height;
+	m_Pixels.resize((size_t)width * height);
+
+	int step=bitDepth / 8; //16 bit samples keep their high byte
+	for(int y=0; y < height; y++)
+	{
+		const unsigned char* src=&raw[y * (stride + 1) + 1];
+		unsigned int* dst=Row(y);
+		for(int x=0; x < width; x++, src += bpp)
+		{
+			unsigned int r, g, b, a=255;
+			switch(colorType)
+			{
+				case 0: r=g=b=src[0]; break;
+				case 2: r=src[0]; g=src[step]; b=src[2 * step]; break;
+				case 3: dst[x]=palette[src[0]]; continue;
+				case 4: r=g=b=src[0]; a=src[step]; break;
+				default: r=src[0]; g=src[step]; b=src[2 * step]; a=src[3 * step]; break;
+			}
+			dst[x]=(a << 24) | (r << 16) | (g << 8) | b;
+		}
+	}
+
+	UpdateOpaque();
+	return true;
+}
+
+bool Image::SavePNG(const char* filename) const
+{
+	if(IsEmpty())
+		return false;
+
+	//RGBA rows, each row takes whichever filter gives the smallest residuals
+	size_t stride=(size_t)m_Width * 4;
+	std::vector<unsigned char> raw((stride + 1) * m_Height);
+	std::vector<unsigned char> rgba(stride), prior(stride,0), trial(stride);
+	for(int y=0; y < m_Height; y++)
+	{
+		const unsigned int* src=Row(y);
+		for(int x=0; x < m_Width; x++)
+		{
+			rgba[x * 4]		=(unsigned char)(src[x] >> 16);
+			rgba[x * 4 + 1]	=(unsigned char)(src[x] >> 8);
+			rgba[x * 4 + 2]	=(unsigned char)src[x];
+			rgba[x * 4 + 3]	=(unsigned char)(src[x] >> 24);
+		}
+
+		unsigned char* dst=&raw[y * (stride + 1)];
+		long bestScore=-1;
+		for(int filter=0; filter < 5; filter++)
+		{
+			long score=0;
+			for(size_t x=0; x < stride; x++)
+			{
+				int a=x >= 4 ? rgba[x - 4] : 0;
+				int b=prior[x];
+				int c=x >= 4 ? prior[x - 4] : 0;
+				int predict=0;
+				switch(filter)
+				{
+					case 1: predict=a; break;
+					case 2: predict=b; break;
+					case 3: predict=(a + b) >> 1; break;
+					case 4: predict=Paeth(a,b,c); break;
+				}
+				trial[x]=(unsigned char)(rgba[x] - predict);
+				score += abs((signed char)trial[x]);
+			}
+			if(bestScore < 0 || score < bestScore)
+			{
+				bestScore=score;
+				dst[0]=(unsigned char)filter;
+				memcpy(dst + 1,&trial[0],stride);
+			}
+		}
+		prior.swap(rgba);
+		rgba.resize(stride);
+	}
+
+	std::vector<unsigned char> header, idat, png;
+	WriteBE32(header,(unsigned int)m_Width);
+	WriteBE32(header,(unsigned int)m_Height);
+	header.push_back(8);	//bit depth
+	header.push_back(6);	//RGBA
+	header.push_back(0);
+	header.push_back(0);
+	header.push_back(0);
+
+	idat.push_back(0x78);	//zlib header, deflate with 32K window
+	idat.push_back(0x01);
+	Deflate(&raw[0],raw.size(),idat);
+	WriteBE32(idat,Adler32(&raw[0],raw.size()));
+
+	static const unsigned char signature[8]={137,80,78,71,13,10,26,10};
+	png.insert(png.end(),signature,signature + 8);
+	WriteChunk(png,"IHDR",header);
+	WriteChunk(png,"IDAT",idat);
+	WriteChunk(png,"IEND",std::vector<unsigned char>());
+
+	FILE* file=fopen(filename,"wb");
+	if(!file)
+		return false;
+	bool ok=fwrite(&png[0],1,png.size(),file) == png.size();
+	fclose(file);
+	return ok;
+}
+
+void Image::Create(int width, int height, unsigned int color)
+{
+	m_Width=width;
+	m_Height=height;
+	m_Pixels.assign((size_t)width * height,color);
+	m_bOpaque=(color >> 24) == 255;
+}
+
+void Image::Release()
+{
+	m_Width=0;
+	m_Height=0;
+	m_bOpaque=true;
+	std::vector<unsigned int>().swap(m_Pixels);
+}
+
+void Image::ColorKey(unsigned int key)
+{
+	for(size_t i=0; i < m_Pixels.size(); i++)
+	{
+		if(m_Pixels[i] == key)
+			m_Pixels[i]=0;
+	}
+	UpdateOpaque();
+}
+
+void Image::Premultiply()
+{
+	for(size_t i=0; i < m_Pixels.size(); i++)
+	{
+		unsigned int p=m_Pixels[i];
+		unsigned int a=p >> 24;
+		if(a == 255)
+			continue;
+
+		unsigned int r=((p >> 16) & 0xFF) * a + 128;
+		unsigned int g=((p >> 8) & 0xFF) * a + 128;
+		unsigned int b=(p & 0xFF) * a + 128;
+		m_Pixels[i]=(a << 24) | (((r + (r >> 8)) >> 8) << 16) | (((g + (g >> 8)) >> 8) << 8) | ((b + (b >> 8)) >> 8);
+	}
+}
+
+void Image::UpdateOpaque()
+{
+	m_bOpaque=true;
+	for(size_t i=0; i < m_Pixels.size(); i++)
+	{
+		if((m_Pixels[i] >> 24) != 255)
+		{
+			m_bOpaque=false;
+			break;
+		}
+	}
+}
+
+int Image::Width() const
+{
+	return m_Width;
+}
+
+int Image::Height() const
+{
+	return m_Height;
+}
+
+bool Image::IsEmpty() const
+{
+	return m_Pixels.empty();
+}
+
+bool Image::IsOpaque() const
+{
+	return m_bOpaque;
+}
+
+unsigned int* Image::Pixels()
+{
+	return m_Pixels.empty() ? 0 : &m_Pixels[0];
+}
+
+const unsigned int* Image::Pixels() const
+{
+	return m_Pixels.empty() ? 0 : &m_Pixels[0];
+}
+
+unsigned int* Image::Row(int y)
+{
+	return &m_Pixels[(size_t)y * m_Width];
+}
+
+const unsigned int* Image::Row(int y) const
+{
+	return &m_Pixels[(size_t)y * m_Width];
+}
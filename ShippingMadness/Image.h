@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////
+//Image class, 32-bit ARGB pixels decoded without Direct3D so
+//the software renderer and asset tools can run on any machine
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+//Pixel rectangle, same layout as a Win32 RECT (right and bottom exclusive)
+struct ImageRect
+{
+	int left;
+	int top;
+	int right;
+	int bottom;
+};
+
+class Image
+{
+public:
+	Image();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		LoadPNG
+	// Parameters:	const char* filename - PNG file to decode
+	// Return:		bool - false if the file is missing or not a supported PNG
+	// Description:	Decodes 8 or 16 bit grey, RGB, palette and alpha PNGs into
+	//				0xAARRGGBB pixels, the same layout as D3DFMT_A8R8G8B8.
+	//////////////////////////////////////////////////////////////////////////
+	bool	LoadPNG(const char* filename);
+	bool	LoadPNGFromMemory(const unsigned char* data, size_t size);
+
+	//writes the image as a compressed RGBA PNG, used for frame captures
+	bool	SavePNG(const char* filename) const;
+
+	void	Create(int width, int height, unsigned int color);
+	void	Release();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		ColorKey
+	// Parameters:	unsigned int key - ARGB colour to make transparent
+	// Return:		void
+	// Description:	Replaces every pixel equal to key with transparent black,
+	//				matching the ColorKey argument of D3DXCreateTextureFromFileEx
+	//////////////////////////////////////////////////////////////////////////
+	void	ColorKey(unsigned int key);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Premultiply
+	// Parameters:	void
+	// Return:		void
+	// Description:	Scales each colour channel by its alpha (rounded, exact /255)
+	//				so the image can be drawn with the premultiplied blend
+	//				(One, InvSrcAlpha).  Only call once per image.
+	//////////////////////////////////////////////////////////////////////////
+	void	Premultiply();
+
+	int		Width() const;
+	int		Height() const;
+	bool	IsEmpty() const;
+	bool	IsOpaque() const; //true when every pixel has alpha 255, lets blits skip blending
+
+	unsigned int*		Pixels();
+	const unsigned int*	Pixels() const;
+	unsigned int*		Row(int y);
+	const unsigned int*	Row(int y) const;
+
+	void	UpdateOpaque(); //call after writing to Pixels() directly
+
+private:
+	int							m_Width;
+	int							m_Height;
+	bool						m_bOpaque;
+	std::vector<unsigned int>	m_Pixels;
+};
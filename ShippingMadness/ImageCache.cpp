@@ -0,0 +1,177 @@
+////////////////////////////////////////////////////////////////
+//ImageCache member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "ImageCache.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define MakeDirectory(name) _mkdir(name)
+#else
+#include <sys/stat.h>
+#define MakeDirectory(name) mkdir(name,0755)
+#endif
+
+//entry file layout, the pixels follow the header row by row
+namespace
+{
+	const unsigned int	CacheMagic		= 0x43494D53;	//"SMIC"
+	const unsigned int	CacheVersion	= 1;			//bump when a decoder's output changes
+
+	struct CacheHeader
+	{
+		unsigned int		magic;
+		unsigned int		version;
+		unsigned long long	key;
+		int					width;
+		int					height;
+	};
+
+	const unsigned long long Prime1=0x9E3779B97F4A7C15ull;
+	const unsigned long long Prime2=0xC2B2AE3D27D4EB4Full;
+
+	unsigned long long Mix(unsigned long long hash, unsigned long long word)
+	{
+		hash^=word * Prime1;
+		hash=(hash << 31) | (hash >> 33);
+		return hash * Prime2;
+	}
+}
+
+ImageCache::ImageCache()
+{
+	m_bCreated=false;
+	m_Hits=0;
+	m_Misses=0;
+	m_Writes=0;
+}
+
+void ImageCache::SetDirectory(const char* directory)
+{
+	m_Directory=directory ? directory : "";
+	m_bCreated=false;
+}
+
+bool ImageCache::IsEnabled() const
+{
+	return !m_Directory.empty();
+}
+
+unsigned long long ImageCache::Key(const unsigned char* source, size_t size, ImageConversion conversion)
+{
+	unsigned long long hash=Mix((unsigned long long)size,((unsigned long long)CacheVersion << 32) | (unsigned int)conversion);
+
+	size_t i=0;
+	for(; i + 8 <= size; i+=8)
+	{
+		unsigned long long word;
+		memcpy(&word,source + i,8);
+		hash=Mix(hash,word);
+	}
+	for(; i < size; i++)
+		hash=Mix(hash,source[i]);
+
+	//final avalanche so nearby keys don't share file name prefixes
+	hash^=hash >> 33;
+	hash*=0xFF51AFD7ED558CCDull;
+	hash^=hash >> 33;
+	hash*=0xC4CEB9FE1A85EC53ull;
+	hash^=hash >> 33;
+	return hash;
+}
+
+bool ImageCache::Load(unsigned long long key, Image& image)
+{
+	image.Release();
+	if(!IsEnabled())
+		return false;
+
+	FILE* file=fopen(EntryFile(key).c_str(),"rb");
+	if(!file)
+	{
+		m_Misses++;
+		return false;
+	}
+
+	//a truncated or foreign file is a miss, the next store replaces it
+	CacheHeader header;
+	bool bRead=fread(&header,sizeof(header),1,file) == 1 && header.magic == CacheMagic && header.version == CacheVersion &&
+			   header.key == key && header.width > 0 && header.height > 0 && header.width <= 16384 && header.height <= 16384;
+	if(bRead)
+	{
+		image.Create(header.width,header.height,0);
+		size_t pixels=(size_t)header.width * header.height;
+		bRead=fread(image.Pixels(),sizeof(unsigned int),pixels,file) == pixels;
+	}
+	fclose(file);
+
+	if(!bRead)
+	{
+		image.Release();
+		m_Misses++;
+		return false;
+	}
+	image.UpdateOpaque();
+	m_Hits++;
+	return true;
+}
+
+bool ImageCache::Store(unsigned long long key, const Image& image)
+{
+	if(!IsEnabled() || image.IsEmpty())
+		return false;
+
+	if(!m_bCreated)
+	{
+		MakeDirectory(m_Directory.c_str()); //fails harmlessly when it is there already
+		m_bCreated=true;
+	}
+
+	//another thread or a reader never sees half an entry
+	std::string entry=EntryFile(key);
+	char suffix[32];
+	sprintf(suffix,".%d.tmp",m_Writes++);
+	std::string temporary=entry + suffix;
+
+	FILE* file=fopen(temporary.c_str(),"wb");
+	if(!file)
+		return false;
+
+	CacheHeader header;
+	memset(&header,0,sizeof(header));
+	header.magic=CacheMagic;
+	header.version=CacheVersion;
+	header.key=key;
+	header.width=image.Width();
+	header.height=image.Height();
+	size_t pixels=(size_t)image.Width() * image.Height();
+	bool bWritten=fwrite(&header,sizeof(header),1,file) == 1 && fwrite(image.Pixels(),sizeof(unsigned int),pixels,file) == pixels;
+	bWritten=fclose(file) == 0 && bWritten;
+
+	remove(entry.c_str()); //Windows won't rename over an existing file
+	if(!bWritten || rename(temporary.c_str(),entry.c_str()) != 0)
+	{
+		remove(temporary.c_str());
+		return false;
+	}
+	return true;
+}
+
+int ImageCache::Hits() const
+{
+	return m_Hits;
+}
+
+int ImageCache::Misses() const
+{
+	return m_Misses;
+}
+
+std::string ImageCache::EntryFile(unsigned long long key) const
+{
+	char name[32];
+	sprintf(name,"/%08x%08x.img",(unsigned int)(key >> 32),(unsigned int)key);
+	return m_Directory + name;
+}
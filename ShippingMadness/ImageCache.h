@@ -0,0 +1,61 @@
+///////////////////////////////////////////////////////////////
+//Image Cache, decoded pixels kept on disk between runs so a
+//warm start skips the PNG decode.  Entries are named by a hash
+//of the source file's bytes and the conversion that was applied,
+//so an edited source simply misses and is decoded again
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Image.h"
+#include <atomic>
+#include <stddef.h>
+#include <string>
+
+//what was done to the source, part of the key
+enum ImageConversion
+{
+	CONVERT_PNG		= 1,	//PNG decoded to premultiplied 0xAARRGGBB as stored in the .pma.png
+	CONVERT_BC		= 2		//DDS top level decompressed for the software renderer
+};
+
+class ImageCache
+{
+public:
+	ImageCache();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		SetDirectory
+	// Parameters:	const char* directory - where entries live, created on the
+	//					first store, 0 or "" turns the cache off
+	// Return:		void
+	// Description:	Call before any Load or Store, they are safe to call from
+	//				several threads after that.
+	//////////////////////////////////////////////////////////////////////////
+	void	SetDirectory(const char* directory);
+	bool	IsEnabled() const;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Key
+	// Parameters:	const unsigned char* source - the whole source file
+	//				size_t size - its length
+	//				ImageConversion conversion - applied to get the pixels
+	// Return:		unsigned long long - 64 bit hash of both, 8 bytes a step
+	//////////////////////////////////////////////////////////////////////////
+	static unsigned long long	Key(const unsigned char* source, size_t size, ImageConversion conversion);
+
+	bool	Load(unsigned long long key, Image& image);			//false on a miss, image released
+	bool	Store(unsigned long long key, const Image& image);	//written to a temporary then renamed in
+
+	int		Hits() const;
+	int		Misses() const;
+
+private:
+	std::string	EntryFile(unsigned long long key) const;
+
+private:
+	std::string			m_Directory;
+	std::atomic<bool>	m_bCreated;		//directory made (or found) by the first store
+	std::atomic<int>	m_Hits;
+	std::atomic<int>	m_Misses;
+	std::atomic<int>	m_Writes;		//for unique temporary names
+};
@@ -0,0 +1,675 @@
+//////////////////////////////////////////////////////////////////////////
+// Name:	LinuxMain.cpp
+// Purpose: Entry point for the Linux build.  Runs the same Game as the
+//			Windows framework, rendered by the SoftwareRenderer and shown
+//			through SDLPlatform.  Needs the SDL2 development package.
+//
+//			g++ -O2 -std=c++11 -pthread -o shippingmadness LinuxMain.cpp
+//				SDLPlatform.cpp Game.cpp SoftwareRenderer.cpp RenderCommands.cpp
+//				SpriteAnimation.cpp SpriteCulling.cpp FramePacer.cpp Image.cpp
+//				DDSTexture.cpp DynamicResolution.cpp TextureResidency.cpp
+//				AssetLoader.cpp AssetArchive.cpp ImageCache.cpp AssetWatcher.cpp
+//				AssetRegistry.cpp TraceLog.cpp FrameRegression.cpp AudioClip.cpp
+//				AudioSink.cpp AudioMixer.cpp AudioResampler.cpp AudioStream.cpp
+//				AudioThread.cpp
+//				`sdl2-config --cflags --libs`
+//
+//			Run it from this folder, the textures are loaded from assets.pak
+//			("assettool pack .") or the loose files here.  A texture or
+//			sound effect saved here while the game runs is reloaded in the
+//			background and swapped in between frames, the loose file wins
+//			over the packed copy from then on.
+//
+// Options:
+//			-vsync, -unlimited or -fps N like the Windows build, the
+//			default is a 60fps cap.  -fullres turns dynamic resolution off.
+//			-texbudget MB limits the decoded textures kept in memory,
+//			64 by default, 0 for no limit.  -serialload decodes every
+//			texture before the first frame instead of showing the menu as
+//			soon as its own are in.  -nocache decodes every file rather
+//			than reading the pixels texturecache/ kept from the last run.
+//			-frames N quits after N frames and prints the pacing, loading
+//			and texture statistics, for profiling runs.  -trace [file]
+//			writes the startup timeline of every thread as Chrome trace
+//			JSON on exit, startup_trace.json by default.  -wavout file
+//			records the sound to a WAV file instead of mixing it into
+//			nothing.  -regress [dir] renders the golden frame scenarios
+//			without a window and exits with the number that failed, like
+//			the Windows build, goldens/ by default.  -update rewrites the
+//			goldens, -tolerance N is the per channel slack, 2 by default.
+//			The report and the failed frames go to -reportdir dir,
+//			regression/ by default, never into the committed goldens.
+//
+//			Record and draw run on one thread, in the same loop pass.  The
+//			sound effects are mixed on the AudioThread, clocked by the
+//			game's frame times since there is no device to play them on
+//			yet.  The music streams off its own thread from the .wav that
+//			"assettool wav" converts each .mp3 to, the game reads no MP3.
+//////////////////////////////////////////////////////////////////////////
+#include "SDLPlatform.h"
+#include "Game.h"
+#include "SoftwareRenderer.h"
+#include "RenderCommands.h"
+#include "FramePacer.h"
+#include "DDSTexture.h"
+#include "DynamicResolution.h"
+#include "TextureResidency.h"
+#include "AssetLoader.h"
+#include "AssetArchive.h"
+#include "ImageCache.h"
+#include "AssetWatcher.h"
+#include "TraceLog.h"
+#include "FrameRegression.h"
+#include "AudioThread.h"
+#include "AssetRegistry.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <atomic>
+#include <thread>
+
+#define SCREEN_WIDTH 800
+#define SCREEN_HEIGHT 600
+#define WINDOW_TITLE "GSP 362 Course Project"
+
+static const int MixRate=44100;
+static const int MixVoices=32;
+
+//value after a command line switch, 0 if the switch is not there
+static const char* CommandLineValue(int argc, char** argv, const char* name)
+{
+	for(int i=1; i < argc; i++)
+	{
+		if(!strcmp(argv[i],name))
+			return i + 1 < argc ? argv[i + 1] : "";
+	}
+	return 0;
+}
+
+//moves a decoded texture in, the software renderer takes the pixels as they are
+static bool AcceptTexture(DecodedTexture& decoded, Image* images, TextureResidency& residency)
+{
+	if(decoded.image.IsEmpty())
+	{
+		fprintf(stderr,"Missing texture %s\n",Game::TextureFile(decoded.id));
+		return false;
+	}
+
+	images[decoded.id]=std::move(decoded.image);
+	residency.SetLoaded(decoded.id,(size_t)images[decoded.id].Width() * images[decoded.id].Height() * sizeof(unsigned int));
+	return true;
+}
+
+//a .wav sound out of the archive or its loose file, the .mp3 music is skipped
+static bool LoadSound(const AssetArchive& archive, const char* filename, AudioClip& clip)
+{
+	std::string name=filename;
+	if(name.size() < 4 || name.compare(name.size() - 4,4,".wav") != 0)
+		return false;
+
+	AssetView view;
+	std::vector<unsigned char> file;
+	if(!archive.Find(filename,view))
+	{
+		FILE* source=fopen(filename,"rb");
+		if(source)
+		{
+			fseek(source,0,SEEK_END);
+			long size=ftell(source);
+			fseek(source,0,SEEK_SET);
+			file.resize(size > 0 ? (size_t)size : 0);
+			if(!file.empty() && fread(&file[0],1,file.size(),source) != file.size())
+				file.clear();
+			fclose(source);
+		}
+		view.data=file.empty() ? 0 : &file[0];
+		view.size=file.size();
+	}
+
+	if(!clip.LoadWave(view.data,view.size,MixRate))
+	{
+		fprintf(stderr,"Missing sound %s\n",filename);
+		return false;
+	}
+	return true;
+}
+
+//a sound saved while the game runs, decoded on a thread of its own so the
+//frame doesn't wait for it
+struct SoundReload
+{
+	SoundReload()
+	{
+		pClip=0;
+		bDone=false;
+		bLoaded=false;
+		bAgain=false;
+	}
+
+	std::thread			thread;
+	AudioClip*			pClip;		//being decoded or waiting to go in, 0 when idle
+	std::atomic<bool>	bDone;
+	bool				bLoaded;
+	bool				bAgain;		//saved again meanwhile, decoded once more after
+};
+
+static void DecodeSound(const AssetArchive* pArchive, int sound, SoundReload* pReload)
+{
+	pReload->bLoaded=LoadSound(*pArchive,Game::SoundInfo(sound).file,*pReload->pClip);
+	pReload->bDone=true;
+}
+
+static void StartSoundReload(const AssetArchive& archive, int sound, SoundReload& reload)
+{
+	if(reload.pClip)
+	{
+		reload.bAgain=true;
+		return;
+	}
+	reload.pClip=new AudioClip;
+	reload.bDone=false;
+	reload.bAgain=false;
+	reload.thread=std::thread(DecodeSound,&archive,sound,&reload);
+}
+
+//between frames a decoded sound takes over, the old one goes to the audio
+//thread to stop its voices and comes back to be deleted.  A broken file
+//leaves the old one playing, like the textures
+static void UpdateSoundReloads(const AssetArchive& archive, AudioThread& audio, AudioClip** sounds, SoundReload* reloads)
+{
+	for(int i=0; i < SND_COUNT; i++)
+	{
+		SoundReload& reload=reloads[i];
+		if(!reload.pClip || !reload.bDone)
+			continue;
+		if(reload.thread.joinable())
+			reload.thread.join();
+		if(!reload.bLoaded)
+		{
+			delete reload.pClip;
+		}
+		else if(audio.ReleaseClip(sounds[i]))
+		{
+			sounds[i]=reload.pClip;
+			printf("Reloaded %s\n",Game::SoundInfo(i).file);
+		}
+		else
+		{
+			continue; //no room for the command, next frame
+		}
+		reload.pClip=0;
+		if(reload.bAgain)
+			StartSoundReload(archive,i,reload);
+	}
+
+	const AudioClip* released;
+	while((released=audio.TakeReleased()) != 0)
+		delete released;
+}
+
+//music streams from the .wav "assettool wav" writes next to the .mp3 the
+//Windows build plays, out of the archive's mapping or the loose file.  One
+//that isn't there (DXclub's source isn't in the tree) stays silent
+static bool OpenMusic(const AssetArchive& archive, const char* filename, AudioStream& stream)
+{
+	std::string name=filename;
+	size_t dot=name.rfind('.');
+	name=name.substr(0,dot) + ".wav";
+
+	AssetView view;
+	if(archive.Find(name.c_str(),view))
+		return stream.Open(view.data,view.size,MixRate,true);
+	return stream.Open(name.c_str(),MixRate,true);
+}
+
+//the groups' textures, the menu's first, the same order as CDirectXFramework::LoadTextures
+static void QueueTextures(AssetLoader& loader, unsigned int groups)
+{
+	for(int i=0; i < TEX_COUNT; i++)
+	{
+		if(Game::IsMenuTexture(i) && (Game::TextureGroups(i) & groups))
+			loader.Queue(i,Game::TextureFile(i));
+	}
+	for(int i=0; i < TEX_COUNT; i++)
+	{
+		if(!Game::IsMenuTexture(i) && (Game::TextureGroups(i) & groups))
+			loader.Queue(i,Game::TextureFile(i));
+	}
+}
+
+//queues what the new groups add and releases what the game no longer wants,
+//like CDirectXFramework::ApplyTextureGroups
+static void ApplyTextureGroups(unsigned int groups, unsigned int applied, AssetLoader& loader, Image* images, TextureResidency& residency)
+{
+	for(int i=0; i < TEX_COUNT; i++)
+	{
+		unsigned int textureGroups=Game::TextureGroups(i);
+		int width=0;
+		if(!(textureGroups & groups))
+		{
+			if(residency.IsResident(i))
+			{
+				images[i].Release();
+				residency.SetEvicted(i);
+			}
+		}
+		else if(!(textureGroups & applied) && !residency.IsResident(i) && !loader.IsPending(i) &&
+				!(loader.IsFinished(i,&width,0) && !width))
+		{
+			loader.Queue(i,Game::TextureFile(i));
+		}
+	}
+}
+
+//uploads whatever has finished for the wanted groups, swaps reloaded ones in
+//and passes the sizes on, true when all of theirs are in
+static bool UpdateLoading(AssetLoader& loader, unsigned int groups, Image* images, TextureResidency& residency, Game& game, SoftwareRenderer& renderer)
+{
+	DecodedTexture decoded;
+	while(loader.Take(decoded,false))
+	{
+		int texture=decoded.id;
+		if(!decoded.width)
+		{
+			AcceptTexture(decoded,images,residency); //reported, a broken reload leaves the old one in
+		}
+		else if(decoded.bReload && residency.IsResident(texture))
+		{
+			residency.SetEvicted(texture);
+			AcceptTexture(decoded,images,residency);
+			renderer.InvalidateStaticLayers();
+			printf("Reloaded %s\n",Game::TextureFile(texture));
+		}
+		else if((Game::TextureGroups(texture) & groups) && !residency.IsResident(texture))
+		{
+			AcceptTexture(decoded,images,residency);
+		}
+	}
+
+	int wanted=0, finished=0;
+	for(int i=0; i < TEX_COUNT; i++)
+	{
+		if(!(Game::TextureGroups(i) & groups))
+			continue;
+		wanted++;
+		int width=0, height=0;
+		if(loader.IsFinished(i,&width,&height))
+		{
+			game.SetTextureSize(i,width,height);
+			finished++;
+		}
+	}
+	game.SetLoadProgress(wanted ? (float)finished / wanted : 1.0f);
+	return finished == wanted;
+}
+
+//CDirectXFramework::RunRegression for the software renderer, every texture
+//decoded up front and each scenario timed over 100 frames after the first
+static int RunRegression(const char* goldenDir, const char* outputDir, int tolerance, bool bUpdate)
+{
+	AssetArchive archive;
+	archive.Open("assets.pak");
+	Game game;
+	Image textures[TEX_COUNT];
+	TextureResidency residency;
+	residency.Reset(TEX_COUNT,0);
+	for(int i=0; i < TEX_COUNT; i++)
+	{
+		DecodedTexture decoded;
+		decoded.id=i;
+		AssetLoader::Decode(&archive,0,Game::TextureFile(i),true,decoded);
+		if(AcceptTexture(decoded,textures,residency))
+			game.SetTextureSize(i,textures[i].Width(),textures[i].Height());
+	}
+
+	SoftwareRenderer renderer;
+	renderer.Resize(SCREEN_WIDTH,SCREEN_HEIGHT);
+	game.SetViewport(SCREEN_WIDTH,SCREEN_HEIGHT);
+	game.Init();
+
+	const int timedFrames=100;
+	FrameRegression regression(goldenDir,outputDir,tolerance,bUpdate);
+	RenderCommandList frame;
+	for(int i=0; i < Game::ScenarioCount(); i++)
+	{
+		const GameScenario& scenario=Game::Scenario(i);
+		game.SetState(scenario.gameState,scenario.menuState);
+
+		double recordTime=0.0;
+		double drawTime=0.0;
+		for(int pass=0; pass <= timedFrames; pass++)
+		{
+			double start=FramePacer::Now();
+			game.Record(frame);
+			frame.Sort();
+			double recorded=FramePacer::Now();
+			renderer.DrawFrame(frame,textures,TEX_COUNT);
+			double drawn=FramePacer::Now();
+			if(pass > 0)
+			{
+				recordTime+=recorded - start;
+				drawTime+=drawn - recorded;
+			}
+		}
+
+		regression.Check(scenario.name,renderer.BackBuffer(),recordTime * 1000.0 / timedFrames,drawTime * 1000.0 / timedFrames);
+	}
+
+	printf("%s",regression.WriteReport().c_str());
+	return regression.Failures();
+}
+
+int main(int argc, char** argv)
+{
+	double startTime=FramePacer::Now();
+	bool bSerialLoad=CommandLineValue(argc,argv,"-serialload") != 0;
+	bool bImageCache=CommandLineValue(argc,argv,"-nocache") == 0;
+	bool bVsync=CommandLineValue(argc,argv,"-vsync") != 0;
+	const char* fpsArg=CommandLineValue(argc,argv,"-fps");
+	const char* framesArg=CommandLineValue(argc,argv,"-frames");
+	int frameLimit=framesArg ? atoi(framesArg) : 0;
+	const char* budgetArg=CommandLineValue(argc,argv,"-texbudget");
+	size_t textureBudget=(size_t)((budgetArg ? atof(budgetArg) : 64.0) * 1024 * 1024);
+	const char* traceArg=CommandLineValue(argc,argv,"-trace");
+	if(traceArg)
+		TraceLog::Start(*traceArg && *traceArg != '-' ? traceArg : "startup_trace.json");
+	TraceLog::NameThread("Main thread");
+
+	const char* regressArg=CommandLineValue(argc,argv,"-regress");
+	if(regressArg)
+	{
+		const char* toleranceArg=CommandLineValue(argc,argv,"-tolerance");
+		const char* reportArg=CommandLineValue(argc,argv,"-reportdir");
+		int failures=RunRegression(*regressArg && *regressArg != '-' ? regressArg : "goldens",reportArg && *reportArg ? reportArg : "regression",
+			toleranceArg ? atoi(toleranceArg) : 2,CommandLineValue(argc,argv,"-update") != 0);
+		if(traceArg)
+			TraceLog::Write();
+		return failures;
+	}
+
+	SDLPlatform platform;
+	double phaseStart=FramePacer::Now();
+	if(!platform.Init(WINDOW_TITLE,SCREEN_WIDTH,SCREEN_HEIGHT,bVsync))
+		return 1;
+	TraceLog::Record("Create window",std::string(),phaseStart,FramePacer::Now());
+
+	//without a vsynced renderer, cap at the refresh rate instead
+	FramePacer pacer;
+	if(bVsync && platform.IsVsynced())
+		pacer.SetMode(PACE_VSYNC,platform.RefreshRate());
+	else if(bVsync)
+		pacer.SetMode(PACE_CAPPED,platform.RefreshRate());
+	else if(CommandLineValue(argc,argv,"-unlimited"))
+		pacer.SetMode(PACE_UNLIMITED,0.0);
+	else if(fpsArg && atof(fpsArg) > 0.0)
+		pacer.SetMode(PACE_CAPPED,atof(fpsArg));
+	else
+		pacer.SetMode(PACE_CAPPED,60.0);
+
+	//a frame may take the whole paced period to draw, nothing else is on this thread for long
+	DynamicResolution resolution;
+	if(!CommandLineValue(argc,argv,"-fullres") && pacer.TargetHz() > 0.0)
+		resolution.SetBudget(1000.0 / pacer.TargetHz(),0.5f);
+
+	Game game;
+	Image textures[TEX_COUNT];
+	TextureResidency residency;
+	residency.Reset(TEX_COUNT,textureBudget);
+
+	//decoded on worker threads, the first frame only waits for the menu's
+	phaseStart=FramePacer::Now();
+	AssetArchive archive;
+	archive.Open("assets.pak");
+	AssetWatcher watcher;
+	watcher.Start(".");
+	ImageCache cache;
+	cache.SetDirectory(bImageCache ? "texturecache" : 0);
+	AssetLoader loader;
+	loader.SetArchive(&archive);
+	loader.SetCache(&cache);
+	loader.Start(bSerialLoad ? 1 : 0,true);
+	unsigned int groups=game.AssetGroups();
+	QueueTextures(loader,groups);
+	TraceLog::Record("Start asset loading",std::string(),phaseStart,FramePacer::Now());
+
+	//the effects are small, all of them are decoded up front.  The music is
+	//decoded as it plays, each piece starts paused and only decodes while heard
+	phaseStart=FramePacer::Now();
+	const char* wavArg=CommandLineValue(argc,argv,"-wavout");
+	NullAudioSink nullSink;
+	WaveFileSink waveSink(wavArg ? wavArg : "");
+	AudioSink& sink=wavArg ? (AudioSink&)waveSink : (AudioSink&)nullSink;
+	if(!sink.Open(MixRate))
+		fprintf(stderr,"Couldn't open %s\n",wavArg);
+	AssetRegistry soundAssets;
+	AudioClip* sounds[SND_COUNT];
+	SoundReload soundReloads[SND_COUNT];
+	AudioStream music[SND_COUNT];
+	AudioCue musicCues[SND_COUNT]={0};
+	for(int i=0; i < SND_COUNT; i++)
+	{
+		soundAssets.Add(i,Game::SoundInfo(i).file,Game::SoundInfo(i).groups);
+		sounds[i]=new AudioClip;
+		if(Game::SoundInfo(i).bMusic)
+			OpenMusic(archive,Game::SoundInfo(i).file,music[i]);
+		else
+			LoadSound(archive,Game::SoundInfo(i).file,*sounds[i]);
+	}
+	AudioThread audio;
+	audio.Start(&sink,MixRate,MixVoices,AUDIO_CLOCK_GAME);
+	for(int i=0; i < SND_COUNT; i++)
+	{
+		const GameSoundInfo& info=Game::SoundInfo(i);
+		AudioLimit limit={info.priority,info.maxVoices};
+		if(music[i].IsOpen())
+			musicCues[i]=audio.PlayStream(&music[i],info.volume,true,limit);
+	}
+	int currentMusic=-1;
+	TraceLog::Record("Load sounds",std::string(),phaseStart,FramePacer::Now());
+	phaseStart=FramePacer::Now();
+	int waiting=0;
+	for(int i=0; i < TEX_COUNT; i++)
+	{
+		if((Game::TextureGroups(i) & groups) && (bSerialLoad || Game::IsMenuTexture(i)))
+			waiting++;
+	}
+	DecodedTexture decoded;
+	while(waiting > 0 && loader.Take(decoded,true))
+	{
+		if(bSerialLoad || Game::IsMenuTexture(decoded.id))
+			waiting--;
+		if(AcceptTexture(decoded,textures,residency))
+			game.SetTextureSize(decoded.id,textures[decoded.id].Width(),textures[decoded.id].Height());
+	}
+	TraceLog::Record("Wait for first textures",std::string(),phaseStart,FramePacer::Now());
+
+	phaseStart=FramePacer::Now();
+	SoftwareRenderer renderer;
+	renderer.Resize(platform.Width(),platform.Height());
+	game.SetViewport(platform.Width(),platform.Height());
+	game.Init();
+	bool bLoading=!UpdateLoading(loader,groups,textures,residency,game,renderer);
+	TraceLog::Record("Start game",std::string(),phaseStart,FramePacer::Now());
+	if(!bLoading)
+		TraceLog::Mark("All assets loaded");
+
+	RenderCommandList frame;
+	double firstFrameMs=0.0;
+	double loadedMs=bLoading ? 0.0 : (FramePacer::Now() - startTime) * 1000.0;
+	int fps=0;
+	int framesThisSecond=0;
+	double secondStart=FramePacer::Now();
+	float dt=0.0f;
+	double mixDue=0.0;	//frames of sound owed for the time that has passed
+
+	for(int frameCount=0; !frameLimit || frameCount < frameLimit; frameCount++)
+	{
+		double frameStart=FramePacer::Now();
+		if(!platform.PumpEvents())
+			break;
+
+		//follow the window, the game lays itself out for the new size
+		if(platform.Width() != renderer.Width() || platform.Height() != renderer.Height())
+		{
+			renderer.Resize(platform.Width(),platform.Height());
+			game.SetViewport(platform.Width(),platform.Height());
+		}
+
+		if(bLoading && UpdateLoading(loader,groups,textures,residency,game,renderer))
+		{
+			bLoading=false;
+			if(!loadedMs)
+			{
+				loadedMs=(FramePacer::Now() - startTime) * 1000.0;
+				TraceLog::Mark("All assets loaded");
+			}
+		}
+
+		GameInput input;
+		platform.ReadInput(input);
+		game.Update(dt,input);
+		//each sound once a frame however often it was triggered, within its cap
+		unsigned int played=game.TakeSounds();
+		for(int sound=0; sound < SND_COUNT; sound++)
+		{
+			const GameSoundInfo& info=Game::SoundInfo(sound);
+			AudioLimit limit={info.priority,info.maxVoices};
+			if(played & (1u << sound))
+				audio.Play(sounds[sound],info.volume,AUDIO_LOOP_OFF,false,limit);
+		}
+		//only a change of music is posted, the others stay paused and idle
+		if(game.Music() >= 0 && game.Music() != currentMusic)
+		{
+			currentMusic=game.Music();
+			for(int sound=0; sound < SND_COUNT; sound++)
+			{
+				if(musicCues[sound])
+					audio.SetPaused(musicCues[sound],sound != currentMusic);
+			}
+		}
+		if(game.IsQuitRequested())
+			break;
+
+		//as much sound as the last frame took, mixed after this frame's sounds start
+		mixDue+=dt * MixRate;
+		int mixNow=(int)mixDue;
+		mixDue-=mixNow;
+		audio.Advance(mixNow);
+
+		//files saved since the last frame decode in the background, UpdateLoading
+		//swaps textures in before a frame and sounds go in here.  The packed
+		//copy is shadowed from now on.  The music reads its file as it plays
+		const std::vector<std::string>& changed=watcher.Poll();
+		for(size_t i=0; i < changed.size(); i++)
+		{
+			const char* filename=changed[i].c_str();
+			archive.Shadow(filename);
+			int texture=Game::FindTexture(filename);
+			int sound=soundAssets.Slot(soundAssets.Find(filename));
+			if(texture >= 0)
+			{
+				loader.Reload(texture,Game::TextureFile(texture));
+				bLoading=true;
+			}
+			else if(sound >= 0 && !Game::SoundInfo(soundAssets.Id(sound)).bMusic)
+			{
+				StartSoundReload(archive,soundAssets.Id(sound),soundReloads[soundAssets.Id(sound)]);
+			}
+		}
+		UpdateSoundReloads(archive,audio,sounds,soundReloads);
+
+		//a new screen, load what it and the next one use and drop the rest
+		if(game.AssetGroups() != groups)
+		{
+			ApplyTextureGroups(game.AssetGroups(),groups,loader,textures,residency);
+			groups=game.AssetGroups();
+			bLoading=true;
+		}
+
+		game.SetHud(true,fps,pacer.Stats(),resolution.Scale(),(float)resolution.AverageMs());
+		game.Record(frame);
+		frame.Sort();
+
+		//evicted textures come back from their files before the frame that needs
+		//them, ones that never loaded have no size and are not retried
+		const std::vector<int>& missing=residency.BeginFrame(frame);
+		for(size_t i=0; i < missing.size(); i++)
+		{
+			int width=0;
+			if(loader.IsFinished(missing[i],&width,0) && width)
+			{
+				decoded.id=missing[i];
+				AssetLoader::Decode(&archive,&cache,Game::TextureFile(missing[i]),true,decoded);
+				AcceptTexture(decoded,textures,residency);
+			}
+		}
+
+		double drawStart=FramePacer::Now();
+		renderer.SetRenderScale(resolution.Scale());
+		renderer.DrawFrame(frame,textures,TEX_COUNT);
+		resolution.Update((FramePacer::Now() - drawStart) * 1000.0);
+
+		int evict;
+		while((evict=residency.NextEviction()) >= 0)
+		{
+			textures[evict].Release();
+			residency.SetEvicted(evict);
+		}
+		platform.Present(renderer.BackBuffer());
+		if(!frameCount)
+		{
+			firstFrameMs=(FramePacer::Now() - startTime) * 1000.0;
+			TraceLog::Record("First frame",std::string(),frameStart,FramePacer::Now());
+			TraceLog::Mark("First frame presented");
+		}
+
+		framesThisSecond++;
+		double now=FramePacer::Now();
+		if(now - secondStart >= 1.0)
+		{
+			fps=framesThisSecond;
+			framesThisSecond=0;
+			secondStart=now;
+		}
+
+		dt=(float)pacer.Wait();
+	}
+
+	if(frameLimit)
+	{
+		const PacingStats& pacing=pacer.Stats();
+		printf("FPS: %d Frame: %.2fms (%.2f-%.2f) Err: %.2fms Missed: %d Scale: %d%% Draw: %.2fms\n",fps,pacing.meanFrameMs,pacing.minFrameMs,
+			pacing.maxFrameMs,pacing.meanErrorMs,pacing.missed,(int)(resolution.Scale() * 100.0f + 0.5f),resolution.AverageMs());
+		printf("First frame: %.1fms Loaded: %.1fms Textures: %.2fMB resident Loads: %d Evictions: %d Cached: %d/%d\n",firstFrameMs,loadedMs,
+			residency.ResidentBytes() / (1024.0 * 1024.0),residency.Loads(),residency.Evictions(),cache.Hits(),cache.Hits() + cache.Misses());
+	}
+
+	audio.Shutdown(); //mixes what is still queued
+	if(frameLimit)
+	{
+		int underruns=0;
+		for(int i=0; i < SND_COUNT; i++)
+			underruns+=music[i].Underruns();
+		printf("Audio: %.2fs mixed in %.2fms Steals: %d Dropped: %d Music underruns: %d\n",(double)audio.MixedFrames() / MixRate,
+			audio.MixSeconds() * 1000.0,audio.Steals(),audio.Dropped(),underruns);
+	}
+	if(audio.HasFailed())
+		fprintf(stderr,"Couldn't write %s\n",wavArg);
+	const AudioClip* released;
+	while((released=audio.TakeReleased()) != 0)
+		delete released;
+	for(int i=0; i < SND_COUNT; i++)
+	{
+		if(soundReloads[i].thread.joinable())
+			soundReloads[i].thread.join();
+		delete soundReloads[i].pClip;
+		delete sounds[i];
+	}
+	sink.Close();
+	platform.Shutdown();
+	loader.Stop(); //its workers are in the trace too
+	if(traceArg && !TraceLog::Write())
+		fprintf(stderr,"Couldn't write the trace\n");
+	return 0;
+}
@@ -0,0 +1,935 @@
+////////////////////////////////////////////////////////////////
+//Mp3Decoder member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "Mp3Decoder.h"
+#include <math.h>
+#include <string.h>
+
+static const double Pi=3.14159265358979323846;
+
+static const int Bitrates[16]={0,32,40,48,56,64,80,96,112,128,160,192,224,256,320,0}; //kbit/s, MPEG-1 Layer III
+static const int Rates[3]={44100,48000,32000};
+
+//scalefactor band edges in lines, long blocks then short blocks (each of
+//the three windows), by rate index
+static const int LongBands[3][23]=
+{
+	{0,4,8,12,16,20,24,30,36,44,52,62,74,90,110,134,162,196,238,288,342,418,576},
+	{0,4,8,12,16,20,24,30,36,42,50,60,72,88,106,128,156,190,230,276,330,384,576},
+	{0,4,8,12,16,20,24,30,36,44,54,66,82,102,126,156,194,240,296,364,448,550,576}
+};
+static const int ShortBands[3][14]=
+{
+	{0,4,8,12,16,22,30,40,52,66,84,106,136,192},
+	{0,4,8,12,16,22,28,38,50,64,80,100,126,192},
+	{0,4,8,12,16,22,30,42,58,78,104,138,180,192}
+};
+
+//scalefactor bits for the bands below 11 (long) or 6 (short), then above,
+//by scalefac_compress
+static const int ScalefacBits[2][16]=
+{
+	{0,0,0,0,3,1,1,1,2,2,2,3,3,3,4,4},
+	{0,1,2,3,0,1,2,3,1,2,3,1,2,3,2,3}
+};
+static const int Pretab[22]={0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,2,2,3,3,3,2,0}; //added with preflag
+
+//the big value tables a table_select picks, -1 for none, and the bits
+//added to a value of 15
+static const struct
+{
+	int		table;		//index into the code tables below
+	int		linbits;
+}
+BigValueTables[32]=
+{
+	{-1,0},{0,0},{1,0},{2,0},{-1,0},{3,0},{4,0},{5,0},
+	{6,0},{7,0},{8,0},{9,0},{10,0},{11,0},{-1,0},{12,0},
+	{13,1},{13,2},{13,3},{13,4},{13,6},{13,8},{13,10},{13,13},
+	{14,4},{14,5},{14,6},{14,7},{14,8},{14,9},{14,11},{14,13}
+};
+static const int CodeTableSizes[15]={4,9,9,16,16,36,36,36,64,64,64,256,256,256,256}; //pairs in tables 1 to 24
+static const int Count1Table=15;
+
+//the big value tables as ISO 11172-3 gives them, each pair x << 4 | y in
+//the order of its code.  Each code is the one before it plus one at its
+//own length, so the lengths are all it takes to rebuild them
+static const unsigned char HuffmanSymbols[1378]=
+{
+	//table 1
+	0x11,0x01,0x10,0x00,
+	//table 2
+	0x22,0x02,0x12,0x21,0x20,0x11,0x01,0x10,0x00,
+	//table 3
+	0x22,0x02,0x12,0x21,0x20,0x10,0x11,0x01,0x00,
+	//table 5
+	0x33,0x23,0x32,0x31,0x13,0x03,0x30,0x22,0x12,0x21,0x02,0x20,0x11,0x01,0x10,0x00,
+	//table 6
+	0x33,0x03,0x23,0x32,0x30,0x13,0x31,0x22,0x02,0x12,0x21,0x20,0x01,0x11,0x10,0x00,
+	//table 7
+	0x55,0x45,0x54,0x53,0x35,0x44,0x25,0x52,0x15,0x51,0x05,0x34,0x50,0x43,0x33,0x24,
+	0x42,0x14,0x41,0x40,0x04,0x23,0x32,0x03,0x13,0x31,0x30,0x22,0x12,0x21,0x02,0x20,
+	0x11,0x01,0x10,0x00,
+	//table 8
+	0x55,0x54,0x45,0x53,0x35,0x44,0x25,0x52,0x05,0x15,0x51,0x34,0x43,0x50,0x33,0x24,
+	0x42,0x14,0x41,0x04,0x40,0x23,0x32,0x13,0x31,0x03,0x30,0x22,0x02,0x20,0x12,0x21,
+	0x11,0x01,0x10,0x00,
+	//table 9
+	0x55,0x45,0x35,0x53,0x54,0x05,0x44,0x25,0x52,0x15,0x51,0x34,0x43,0x50,0x04,0x24,
+	0x42,0x33,0x40,0x14,0x41,0x23,0x32,0x13,0x31,0x03,0x30,0x22,0x02,0x12,0x21,0x20,
+	0x11,0x01,0x10,0x00,
+	//table 10
+	0x77,0x67,0x76,0x57,0x75,0x66,0x47,0x74,0x56,0x65,0x37,0x73,0x46,0x55,0x54,0x63,
+	0x27,0x72,0x64,0x07,0x70,0x62,0x45,0x35,0x06,0x53,0x44,0x17,0x71,0x36,0x26,0x25,
+	0x52,0x15,0x51,0x34,0x43,0x16,0x61,0x60,0x05,0x50,0x24,0x42,0x33,0x04,0x14,0x41,
+	0x40,0x23,0x32,0x03,0x13,0x31,0x30,0x22,0x12,0x21,0x02,0x20,0x11,0x01,0x10,0x00,
+	//table 11
+	0x77,0x67,0x76,0x75,0x66,0x47,0x74,0x57,0x55,0x56,0x65,0x37,0x73,0x46,0x45,0x54,
+	0x35,0x53,0x27,0x72,0x64,0x07,0x71,0x17,0x70,0x36,0x63,0x60,0x44,0x25,0x52,0x05,
+	0x15,0x62,0x26,0x06,0x16,0x61,0x51,0x34,0x50,0x43,0x33,0x24,0x42,0x14,0x41,0x04,
+	0x40,0x23,0x32,0x13,0x31,0x03,0x30,0x22,0x21,0x12,0x02,0x20,0x11,0x01,0x10,0x00,
+	//table 12
+	0x77,0x67,0x76,0x57,0x75,0x66,0x47,0x74,0x65,0x56,0x37,0x73,0x55,0x27,0x72,0x46,
+	0x64,0x17,0x71,0x07,0x70,0x36,0x63,0x45,0x54,0x44,0x06,0x05,0x26,0x62,0x61,0x16,
+	0x60,0x35,0x53,0x25,0x52,0x15,0x51,0x34,0x43,0x50,0x04,0x24,0x42,0x14,0x33,0x41,
+	0x23,0x32,0x40,0x03,0x30,0x13,0x31,0x22,0x12,0x21,0x02,0x20,0x00,0x11,0x01,0x10,
+	//table 13
+	0xFE,0xFC,0xFD,0xED,0xFF,0xEF,0xDF,0xEE,0xCF,0xDE,0xBF,0xFB,0xCE,0xDC,0xAF,0xE9,
+	0xEC,0xDD,0xFA,0xCD,0xBE,0xEB,0x9F,0xF9,0xEA,0xBD,0xDB,0x8F,0xF8,0xCC,0xAE,0x9E,
+	0x8E,0x7F,0x7E,0xF7,0xDA,0xAD,0xBC,0xCB,0xF6,0x6F,0xE8,0x5F,0x9D,0xD9,0xF5,0xE7,
+	0xAC,0xBB,0x4F,0xF4,0xCA,0xE6,0xF3,0x3F,0x8D,0xD8,0x2F,0xF2,0x6E,0x9C,0x0F,0xC9,
+	0x5E,0xAB,0x7D,0xD7,0x4E,0xC8,0xD6,0x3E,0xB9,0x9B,0xAA,0x1F,0xF1,0xF0,0xBA,0xE5,
+	0xE4,0x8C,0x6D,0xE3,0xE2,0x2E,0x0E,0x1E,0xE1,0xE0,0x5D,0xD5,0x7C,0xC7,0x4D,0x8B,
+	0xB8,0xD4,0x9A,0xA9,0x6C,0xC6,0x3D,0xD3,0x7B,0x2D,0xD2,0x1D,0xB7,0x5C,0xC5,0x99,
+	0x7A,0xC3,0xA7,0x97,0x4B,0xD1,0x0D,0xD0,0x8A,0xA8,0x4C,0xC4,0x6B,0xB6,0x3C,0x2C,
+	0xC2,0x5B,0xB5,0x89,0x1C,0xC1,0x98,0x0C,0xC0,0xB4,0x6A,0xA6,0x79,0x3B,0xB3,0x88,
+	0x5A,0x2B,0xA5,0x69,0xA4,0x78,0x87,0x94,0x77,0x76,0xB2,0x1B,0xB1,0x0B,0xB0,0x96,
+	0x4A,0x3A,0xA3,0x59,0x95,0x2A,0xA2,0x1A,0xA1,0x0A,0x68,0xA0,0x86,0x49,0x93,0x39,
+	0x58,0x85,0x67,0x29,0x92,0x57,0x75,0x38,0x83,0x66,0x47,0x74,0x56,0x65,0x73,0x19,
+	0x91,0x09,0x90,0x48,0x84,0x72,0x46,0x64,0x28,0x82,0x18,0x37,0x27,0x17,0x71,0x55,
+	0x07,0x70,0x36,0x63,0x45,0x54,0x26,0x62,0x35,0x81,0x08,0x80,0x16,0x61,0x06,0x60,
+	0x53,0x44,0x25,0x52,0x05,0x15,0x51,0x34,0x43,0x50,0x24,0x42,0x33,0x14,0x41,0x04,
+	0x40,0x23,0x32,0x13,0x31,0x03,0x30,0x22,0x12,0x21,0x02,0x20,0x11,0x01,0x10,0x00,
+	//table 15
+	0xFF,0xEF,0xFE,0xDF,0xEE,0xFD,0xCF,0xFC,0xDE,0xED,0xBF,0xFB,0xCE,0xEC,0xDD,0xAF,
+	0xFA,0xBE,0xEB,0xCD,0xDC,0x9F,0xF9,0xEA,0xBD,0xDB,0x8F,0xF8,0xCC,0x9E,0xE9,0x7F,
+	0xF7,0xAD,0xDA,0xBC,0x6F,0xAE,0x0F,0xCB,0xF6,0x8E,0xE8,0x5F,0x9D,0xF5,0x7E,0xE7,
+	0xAC,0xCA,0xBB,0xD9,0x8D,0x4F,0xF4,0x3F,0xF3,0xD8,0xE6,0x2F,0xF2,0x6E,0xF0,0x1F,
+	0xF1,0x9C,0xC9,0x5E,0xAB,0xBA,0xE5,0x7D,0xD7,0x4E,0xE4,0x8C,0xC8,0x3E,0x6D,0xD6,
+	0xE3,0x9B,0xB9,0x2E,0xAA,0xE2,0x1E,0xE1,0x0E,0xE0,0x5D,0xD5,0x7C,0xC7,0x4D,0x8B,
+	0xD4,0xB8,0x9A,0xA9,0x6C,0xC6,0x3D,0xD3,0xD2,0x2D,0x0D,0x1D,0x7B,0xB7,0xD1,0x5C,
+	0xD0,0xC5,0x8A,0xA8,0x4C,0xC4,0x6B,0xB6,0x99,0x0C,0x3C,0xC3,0x7A,0xA7,0xA6,0xC0,
+	0x0B,0xC2,0x2C,0x5B,0xB5,0x1C,0x89,0x98,0xC1,0x4B,0xB4,0x6A,0x3B,0x79,0xB3,0x97,
+	0x88,0x2B,0x5A,0xB2,0xA5,0x1B,0xB1,0xB0,0x69,0x96,0x4A,0xA4,0x78,0x87,0x3A,0xA3,
+	0x59,0x95,0x2A,0xA2,0x1A,0xA1,0x0A,0xA0,0x68,0x86,0x49,0x94,0x39,0x93,0x77,0x09,
+	0x58,0x85,0x29,0x67,0x76,0x92,0x91,0x19,0x90,0x48,0x84,0x57,0x75,0x38,0x83,0x66,
+	0x47,0x28,0x82,0x18,0x81,0x74,0x08,0x80,0x56,0x65,0x37,0x73,0x46,0x27,0x72,0x64,
+	0x17,0x55,0x71,0x07,0x70,0x36,0x63,0x45,0x54,0x26,0x62,0x16,0x06,0x60,0x35,0x61,
+	0x53,0x44,0x25,0x52,0x15,0x51,0x05,0x50,0x34,0x43,0x24,0x42,0x33,0x41,0x14,0x04,
+	0x23,0x32,0x40,0x03,0x13,0x31,0x30,0x22,0x12,0x21,0x02,0x20,0x11,0x01,0x10,0x00,
+	//table 16
+	0xEF,0xFE,0xDF,0xFD,0xCF,0xFC,0xBF,0xFB,0xAF,0xFA,0x9F,0xF9,0xF8,0x8F,0x7F,0xF7,
+	0x6F,0xF6,0xFF,0x5F,0xF5,0x4F,0xF4,0xF3,0xF0,0x3F,0xCE,0xEC,0xDD,0xDE,0xE9,0xEA,
+	0xD9,0xEE,0xED,0xEB,0xBE,0xCD,0xDC,0xDB,0xAE,0xCC,0xAD,0xDA,0x7E,0xAC,0xCA,0xC9,
+	0x7D,0x5E,0xBD,0xF2,0x2F,0x0F,0x1F,0xF1,0x9E,0xBC,0xCB,0x8E,0xE8,0x9D,0xE7,0xBB,
+	0x8D,0xD8,0x6E,0xE6,0x9C,0xAB,0xBA,0xE5,0xD7,0x4E,0xE4,0x8C,0xC8,0x3E,0x6D,0xD6,
+	0x9B,0xB9,0xAA,0xE1,0xD4,0xB8,0xA9,0x7B,0xB7,0xD0,0xE3,0x0E,0xE0,0x5D,0xD5,0x7C,
+	0xC7,0x4D,0x8B,0x9A,0x6C,0xC6,0x3D,0x5C,0xC5,0x0D,0x8A,0xA8,0x99,0x4C,0xB6,0x7A,
+	0x3C,0x5B,0x89,0x1C,0xC0,0x98,0x79,0xE2,0x2E,0x1E,0xD3,0x2D,0xD2,0xD1,0x3B,0x97,
+	0x88,0x1D,0xC4,0x6B,0xC3,0xA7,0x2C,0xC2,0xB5,0xC1,0x0C,0x4B,0xB4,0x6A,0xA6,0xB3,
+	0x5A,0xA5,0x2B,0xB2,0x1B,0xB1,0x0B,0xB0,0x69,0x96,0x4A,0xA4,0x78,0x87,0xA3,0x3A,
+	0x59,0x2A,0x95,0x68,0xA1,0x86,0x77,0x94,0x49,0x57,0x67,0xA2,0x1A,0x0A,0xA0,0x39,
+	0x93,0x58,0x85,0x29,0x92,0x76,0x09,0x19,0x91,0x90,0x48,0x84,0x75,0x38,0x83,0x66,
+	0x28,0x82,0x47,0x74,0x18,0x81,0x80,0x08,0x56,0x37,0x73,0x65,0x46,0x27,0x72,0x64,
+	0x55,0x07,0x17,0x71,0x70,0x36,0x63,0x45,0x54,0x26,0x62,0x16,0x61,0x06,0x60,0x53,
+	0x35,0x44,0x25,0x52,0x51,0x15,0x05,0x34,0x43,0x50,0x24,0x42,0x33,0x14,0x41,0x04,
+	0x40,0x23,0x32,0x13,0x31,0x03,0x30,0x22,0x12,0x21,0x02,0x20,0x11,0x01,0x10,0x00,
+	//table 24
+	0xEF,0xFE,0xDF,0xFD,0xCF,0xFC,0xBF,0xFB,0xFA,0xAF,0x9F,0xF9,0xF8,0x8F,0x7F,0xF7,
+	0x6F,0xF6,0x5F,0xF5,0x4F,0xF4,0x3F,0xF3,0x2F,0xF2,0xF1,0x1F,0xF0,0x0F,0xEE,0xDE,
+	0xED,0xCE,0xEC,0xDD,0xBE,0xEB,0xCD,0xDC,0xAE,0xEA,0xBD,0xDB,0xCC,0x9E,0xE9,0xAD,
+	0xDA,0xBC,0xCB,0x8E,0xE8,0x9D,0xD9,0x7E,0xE7,0xAC,0xFF,0xCA,0xBB,0x8D,0xD8,0x0E,
+	0xE0,0x0D,0xE6,0x6E,0x9C,0xC9,0x5E,0xBA,0xE5,0xAB,0x7D,0xD7,0xE4,0x8C,0xC8,0x4E,
+	0x2E,0x3E,0x6D,0xD6,0xE3,0x9B,0xB9,0xAA,0xE2,0x1E,0xE1,0x5D,0xD5,0x7C,0xC7,0x4D,
+	0x8B,0xB8,0xD4,0x9A,0xA9,0x6C,0xC6,0x3D,0xD3,0x2D,0xD2,0x1D,0x7B,0xB7,0xD1,0x5C,
+	0xC5,0x8A,0xA8,0x99,0x4C,0xC4,0x6B,0xB6,0xD0,0x0C,0x3C,0xC3,0x7A,0xA7,0x2C,0xC2,
+	0x5B,0xB5,0x1C,0x89,0x98,0xC1,0x4B,0xC0,0x0B,0x3B,0xB0,0x0A,0x1A,0xB4,0x6A,0xA6,
+	0x79,0x97,0xA0,0x09,0x90,0xB3,0x88,0x2B,0x5A,0xB2,0xA5,0x1B,0xB1,0x69,0x96,0xA4,
+	0x4A,0x78,0x87,0x3A,0xA3,0x59,0x95,0x2A,0xA2,0xA1,0x68,0x86,0x77,0x49,0x94,0x39,
+	0x93,0x58,0x85,0x29,0x67,0x76,0x92,0x19,0x91,0x48,0x84,0x57,0x75,0x38,0x83,0x66,
+	0x28,0x82,0x18,0x47,0x74,0x81,0x08,0x80,0x56,0x65,0x17,0x07,0x70,0x73,0x37,0x27,
+	0x72,0x46,0x64,0x55,0x71,0x36,0x63,0x45,0x54,0x26,0x62,0x16,0x61,0x06,0x60,0x35,
+	0x53,0x44,0x25,0x52,0x15,0x05,0x50,0x51,0x34,0x43,0x24,0x42,0x33,0x14,0x41,0x04,
+	0x40,0x23,0x32,0x13,0x31,0x03,0x30,0x22,0x12,0x21,0x02,0x20,0x11,0x01,0x10,0x00
+};
+static const unsigned char HuffmanLengths[1378]=
+{
+	//table 1
+	3,3,2,1,
+	//table 2
+	6,6,5,5,5,3,3,3,1,
+	//table 3
+	6,6,5,5,5,3,2,2,2,
+	//table 5
+	8,8,7,6,7,7,7,7,6,6,6,6,3,3,3,1,
+	//table 6
+	7,7,6,6,6,5,5,5,5,4,4,4,3,2,3,3,
+	//table 7
+	10,10,10,10,9,9,9,9,8,8,9,9,8,9,9,8,8,7,7,7,8,8,8,8,7,7,7,7,6,5,6,6,
+	4,3,3,1,
+	//table 8
+	11,11,10,9,10,10,9,9,9,8,8,9,9,9,9,8,8,8,7,8,8,8,8,8,8,8,8,6,6,6,4,4,
+	2,3,3,2,
+	//table 9
+	9,9,8,8,9,9,8,8,8,8,7,7,7,8,8,7,7,7,7,6,6,6,6,5,5,6,6,5,5,4,4,4,
+	3,3,3,3,
+	//table 10
+	11,11,11,11,11,11,10,10,10,10,10,10,10,11,11,10,9,9,10,10,9,9,10,10,9,10,10,8,8,9,9,10,
+	10,9,9,10,10,8,8,8,9,9,9,9,9,9,8,8,8,8,8,8,7,7,7,7,6,6,6,6,4,3,3,1,
+	//table 11
+	10,10,10,10,10,10,10,11,11,10,10,9,9,9,10,10,10,10,8,8,9,9,7,8,8,8,8,8,9,9,9,9,
+	8,7,8,8,7,7,8,8,8,9,9,8,8,8,8,8,8,7,7,6,6,7,7,6,5,4,5,5,3,3,3,2,
+	//table 12
+	10,10,9,9,9,9,9,9,9,8,8,9,9,8,8,8,8,8,8,9,9,8,8,8,8,8,9,9,7,7,7,8,
+	8,8,8,8,8,7,7,7,7,8,8,7,7,7,6,6,6,6,7,7,6,5,5,5,4,4,5,5,4,3,3,3,
+	//table 13
+	19,19,18,17,16,16,16,16,16,16,16,16,16,16,17,17,15,15,16,16,15,15,15,15,15,15,15,15,15,15,16,16,
+	15,16,16,14,14,15,15,15,15,14,14,14,14,14,14,14,14,14,14,14,15,15,14,13,14,14,13,13,14,14,13,14,
+	14,13,14,14,13,14,14,13,13,14,14,12,12,12,13,13,13,13,13,13,12,13,13,12,12,13,13,13,13,13,13,13,
+	13,13,13,13,13,12,12,13,13,12,12,12,12,13,13,13,13,12,13,13,12,11,12,12,12,12,12,12,12,12,11,11,
+	11,11,12,12,11,11,12,12,11,12,12,12,12,11,11,12,12,11,12,12,11,12,12,11,12,12,10,10,10,11,11,11,
+	11,11,11,11,11,10,10,10,10,11,11,10,11,11,10,11,11,11,11,10,10,11,11,10,10,11,11,11,11,11,11,9,
+	9,10,10,10,10,10,11,11,9,9,9,10,10,9,9,10,10,10,10,10,10,10,10,10,10,8,9,9,9,9,9,9,
+	10,10,9,9,9,8,8,9,9,9,9,9,9,8,7,8,8,8,8,7,7,7,7,7,6,6,6,6,4,4,3,1,
+	//table 15
+	13,13,13,13,12,13,13,13,13,13,13,12,13,13,12,12,12,12,12,12,12,12,12,12,12,12,12,12,12,12,12,12,
+	12,12,12,12,12,13,13,11,11,12,12,12,12,11,11,11,11,11,11,12,12,11,11,11,11,11,11,11,11,12,12,11,
+	11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,12,12,11,11,11,11,11,11,
+	10,11,11,11,11,11,11,10,10,11,11,10,10,10,10,11,11,10,10,10,10,10,10,10,11,11,10,10,10,10,10,11,
+	11,9,10,10,10,10,10,10,10,10,10,10,10,10,9,10,10,10,10,9,10,10,9,10,10,10,10,10,10,10,10,9,
+	9,9,9,9,9,9,10,10,9,9,9,9,9,9,10,10,9,9,9,9,9,9,8,9,9,9,9,9,9,9,9,9,
+	9,8,8,8,8,9,9,9,9,9,9,9,9,8,8,8,8,8,8,9,9,8,8,8,8,8,8,8,9,9,8,7,
+	8,8,7,7,7,7,8,8,7,7,7,7,7,6,7,7,6,6,7,7,6,6,6,5,5,5,5,5,3,4,4,3,
+	//table 16
+	11,11,11,11,11,11,11,11,10,11,11,11,11,10,10,10,10,10,8,10,10,9,9,9,9,10,16,17,17,15,15,16,
+	16,14,15,15,14,14,15,15,14,14,15,15,15,15,14,15,15,14,13,8,9,9,8,8,13,14,14,14,14,14,14,14,
+	14,14,14,13,13,14,14,14,14,13,14,14,13,13,13,14,14,14,14,13,13,14,14,13,14,14,12,13,13,13,13,13,
+	13,13,13,13,13,13,13,13,13,12,13,13,13,13,13,13,12,13,13,12,12,13,13,11,12,12,12,12,12,12,12,13,
+	13,11,12,12,12,12,11,12,12,12,12,12,12,12,12,11,12,12,11,11,11,11,12,12,12,12,12,12,12,12,11,12,
+	12,11,12,12,11,12,12,11,12,12,11,10,10,11,11,11,11,11,11,10,10,11,11,10,10,11,11,11,11,11,11,11,
+	11,10,11,11,10,10,10,11,11,10,10,11,11,10,10,11,11,10,9,9,10,10,10,10,10,10,9,9,9,10,10,9,
+	10,10,9,9,8,9,9,9,9,9,9,9,9,8,8,9,9,8,8,7,7,8,8,7,6,6,6,6,4,4,3,1,
+	//table 24
+	8,8,8,8,8,8,8,8,7,8,8,7,7,8,8,7,7,7,7,7,7,7,7,7,7,7,7,8,8,9,11,11,
+	11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,11,4,11,11,11,11,12,
+	12,11,10,11,11,10,10,10,10,11,11,10,10,10,10,11,11,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,
+	10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,10,11,11,10,10,10,10,10,10,
+	10,10,10,10,10,10,10,11,11,10,11,11,10,9,10,10,10,10,11,11,10,9,9,10,10,9,10,10,10,10,9,9,
+	10,10,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,9,
+	9,9,9,9,9,9,10,10,9,9,9,10,10,8,9,9,8,8,8,8,8,8,8,8,8,8,8,8,8,9,9,8,
+	8,8,8,8,8,9,9,7,8,8,7,7,7,7,7,8,8,7,7,6,6,7,7,6,5,5,6,6,4,4,4,4
+};
+//the synthesis window D[0] to D[256] in 1/65536ths
+static const int SynthesisWindow[257]=
+{
+	0,-1,-1,-1,-1,-1,-1,-2,-2,-2,-2,-3,-3,-4,-4,-5,
+	-5,-6,-7,-7,-8,-9,-10,-11,-13,-14,-16,-17,-19,-21,-24,-26,
+	-29,-31,-35,-38,-41,-45,-49,-53,-58,-63,-68,-73,-79,-85,-91,-97,
+	-104,-111,-117,-125,-132,-139,-147,-154,-161,-169,-176,-183,-190,-196,-202,-208,
+	213,218,222,225,227,228,228,227,224,221,215,208,200,189,177,163,
+	146,127,106,83,57,29,-2,-36,-72,-111,-153,-197,-244,-294,-347,-401,
+	-459,-519,-581,-645,-711,-779,-848,-919,-991,-1064,-1137,-1210,-1283,-1356,-1428,-1498,
+	-1567,-1634,-1698,-1759,-1817,-1870,-1919,-1962,-2001,-2032,-2057,-2075,-2085,-2087,-2080,-2063,
+	2037,2000,1952,1893,1822,1739,1644,1535,1414,1280,1131,970,794,605,402,185,
+	-45,-288,-545,-814,-1095,-1388,-1692,-2006,-2330,-2663,-3004,-3351,-3705,-4063,-4425,-4788,
+	-5153,-5517,-5879,-6237,-6589,-6935,-7271,-7597,-7910,-8209,-8491,-8755,-8998,-9219,-9416,-9585,
+	-9727,-9838,-9916,-9959,-9966,-9935,-9863,-9750,-9592,-9389,-9139,-8840,-8492,-8092,-7640,-7134,
+	6574,5959,5288,4561,3776,2935,2037,1082,70,-998,-2122,-3300,-4533,-5818,-7154,-8540,
+	-9975,-11455,-12980,-14548,-16155,-17799,-19478,-21189,-22929,-24694,-26482,-28289,-30112,-31947,-33791,-35640,
+	-37489,-39336,-41176,-43006,-44821,-46617,-48390,-50137,-51853,-53534,-55178,-56778,-58333,-59838,-61289,-62684,
+	-64019,-65290,-66494,-67629,-68692,-69679,-70590,-71420,-72169,-72835,-73415,-73908,-74313,-74630,-74856,-74992,
+	75038
+};
+
+//count1 table A by v << 3 | w << 2 | x << 1 | y, table B is four bits inverted
+static const unsigned char Count1Codes[16]={1,5,4,5,6,5,4,4,7,3,6,0,7,2,3,1};
+static const unsigned char Count1Lengths[16]={1,4,4,5,4,6,5,6,4,5,5,6,5,6,6,6};
+
+//aliasing butterfly coefficients between neighbouring subbands
+static const double AntialiasC[8]={-0.6,-0.535,-0.33,-0.185,-0.095,-0.041,-0.0142,-0.0037};
+
+Mp3Decoder::BitReader::BitReader(const unsigned char* data, size_t size, size_t bit)
+{
+	m_pData=data;
+	m_Bits=size * 8;
+	m_Position=bit;
+}
+
+unsigned int Mp3Decoder::BitReader::Read(int bits)
+{
+	unsigned int value=0;
+	for(int i=0; i < bits; i++, m_Position++)
+	{
+		int bit=m_Position < m_Bits ? (m_pData[m_Position >> 3] >> (7 - (m_Position & 7))) & 1 : 0;
+		value=value << 1 | bit;
+	}
+	return value;
+}
+
+size_t Mp3Decoder::BitReader::Position() const
+{
+	return m_Position;
+}
+
+void Mp3Decoder::BitReader::Seek(size_t bit)
+{
+	m_Position=bit;
+}
+
+Mp3Decoder::Mp3Decoder()
+{
+	//node 0 is a dummy so 0 can mean a branch no code uses
+	m_Tree.assign(2,(short)0);
+	int offset=0;
+	for(int i=0; i < 15; i++)
+	{
+		AddCodes(i,HuffmanSymbols + offset,HuffmanLengths + offset,CodeTableSizes[i]);
+		offset+=CodeTableSizes[i];
+	}
+	m_Roots[Count1Table]=0;
+	for(int i=0; i < 16; i++)
+		AddCode(Count1Table,Count1Codes[i],Count1Lengths[i],i);
+
+	//8191 is the largest a value with linbits gets
+	m_Pow43.resize(8207);
+	for(int i=0; i < (int)m_Pow43.size(); i++)
+		m_Pow43[i]=(float)pow((double)i,4.0 / 3.0);
+
+	for(int k=0; k < 18; k++)
+	{
+		for(int i=0; i < 36; i++)
+			m_Imdct36[k][i]=(float)cos(Pi / 72.0 * (2 * i + 19) * (2 * k + 1));
+	}
+	for(int k=0; k < 6; k++)
+	{
+		for(int i=0; i < 12; i++)
+			m_Imdct12[k][i]=(float)cos(Pi / 24.0 * (2 * i + 7) * (2 * k + 1));
+	}
+
+	//normal, start, short and stop windows
+	for(int i=0; i < 36; i++)
+	{
+		float sine=(float)sin(Pi / 36.0 * (i + 0.5));
+		m_Windows[0][i]=sine;
+		m_Windows[1][i]=i < 18 ? sine : i < 24 ? 1.0f : i < 30 ? (float)sin(Pi / 12.0 * (i - 18 + 0.5)) : 0.0f;
+		m_Windows[2][i]=i < 12 ? (float)sin(Pi / 12.0 * (i + 0.5)) : 0.0f;
+		m_Windows[3][i]=i < 6 ? 0.0f : i < 12 ? (float)sin(Pi / 12.0 * (i - 6 + 0.5)) : i < 18 ? 1.0f : sine;
+	}
+
+	for(int i=0; i < 8; i++)
+	{
+		double root=sqrt(1.0 + AntialiasC[i] * AntialiasC[i]);
+		m_Antialias[i][0]=(float)(1.0 / root);
+		m_Antialias[i][1]=(float)(AntialiasC[i] / root);
+	}
+
+	for(int i=0; i < 64; i++)
+	{
+		for(int k=0; k < 32; k++)
+			m_Matrix[i][k]=(float)cos((16 + i) * (2 * k + 1) * Pi / 64.0);
+	}
+
+	//the table is the first half and the middle in 1/65536ths, the rest
+	//mirrors it with the sign flipped away from each 64th
+	for(int i=0; i < 257; i++)
+	{
+		float value=(float)(SynthesisWindow[i] / 65536.0);
+		m_Window[i]=value;
+		if(i)
+			m_Window[512 - i]=i & 63 ? -value : value;
+	}
+
+	Reset();
+}
+
+bool Mp3Decoder::Decode(const unsigned char* data, size_t size, std::vector<float>& out, int& rate)
+{
+	Reset();
+	rate=0;
+
+	//an ID3v2 tag's size is in 7 bit bytes, the header and any footer aren't in it
+	size_t position=0;
+	if(size >= 10 && !memcmp(data,"ID3",3))
+	{
+		position=10 + ((data[6] & 0x7F) << 21 | (data[7] & 0x7F) << 14 | (data[8] & 0x7F) << 7 | (data[9] & 0x7F));
+		if(data[5] & 0x10)
+			position+=10;
+	}
+
+	//anything that isn't a frame (an ID3v1 tag at the end, damage) is
+	//stepped over a byte at a time until the next one
+	int frames=0;
+	while(position + 4 <= size)
+	{
+		FrameHeader header;
+		if(!ReadHeader(data + position,header))
+		{
+			position++;
+			continue;
+		}
+		if(position + header.size > size)
+			break;
+		if(rate && header.rate != rate)
+			break;
+
+		rate=header.rate;
+		DecodeFrame(data + position,header,out);
+		position+=header.size;
+		frames++;
+	}
+	return frames > 0;
+}
+
+bool Mp3Decoder::ReadHeader(const unsigned char* p, FrameHeader& header)
+{
+	//sync, MPEG-1, Layer III, and a bitrate and rate it has (free format isn't read)
+	if(p[0] != 0xFF || (p[1] & 0xFE) != 0xFA)
+		return false;
+	int bitrate=Bitrates[p[2] >> 4];
+	int rateIndex=(p[2] >> 2) & 3;
+	if(!bitrate || rateIndex == 3)
+		return false;
+
+	header.rateIndex=rateIndex;
+	header.rate=Rates[rateIndex];
+	header.size=144000 * bitrate / header.rate + ((p[2] >> 1) & 1);
+	header.mode=p[3] >> 6;
+	header.modeExtension=(p[3] >> 4) & 3;
+	header.channels=header.mode == 3 ? 1 : 2;
+	header.bCRC=!(p[1] & 1);
+	return true;
+}
+
+void Mp3Decoder::Reset()
+{
+	m_Reservoir.clear();
+	memset(m_ScalefacLong,0,sizeof(m_ScalefacLong));
+	memset(m_ScalefacShort,0,sizeof(m_ScalefacShort));
+	memset(m_Overlap,0,sizeof(m_Overlap));
+	memset(m_V,0,sizeof(m_V));
+	m_VOffset[0]=m_VOffset[1]=0;
+}
+
+void Mp3Decoder::DecodeFrame(const unsigned char* p, const FrameHeader& header, std::vector<float>& out)
+{
+	int channels=header.channels;
+	size_t sideOffset=header.bCRC ? 6 : 4;
+	size_t sideSize=channels == 1 ? 17 : 32;
+	size_t start=out.size();
+	out.resize(start + 1152 * 2,0.0f);
+	if(sideOffset + sideSize > (size_t)header.size)
+		return;
+
+	//side information
+	BitReader side(p + sideOffset,sideSize,0);
+	int mainDataBegin=(int)side.Read(9);
+	side.Read(channels == 1 ? 5 : 3); //private bits
+	bool scfsi[2][4];
+	for(int ch=0; ch < channels; ch++)
+	{
+		for(int band=0; band < 4; band++)
+			scfsi[ch][band]=side.Read(1) != 0;
+	}
+	Granule granules[2][2];
+	for(int gr=0; gr < 2; gr++)
+	{
+		for(int ch=0; ch < channels; ch++)
+		{
+			Granule& granule=granules[gr][ch];
+			granule.part23Length=(int)side.Read(12);
+			granule.bigValues=(int)side.Read(9);
+			granule.globalGain=(int)side.Read(8);
+			granule.scalefacCompress=(int)side.Read(4);
+			granule.bWindowSwitching=side.Read(1) != 0;
+			if(granule.bWindowSwitching)
+			{
+				granule.blockType=(int)side.Read(2);
+				granule.bMixed=side.Read(1) != 0;
+				for(int i=0; i < 2; i++)
+					granule.tableSelect[i]=(int)side.Read(5);
+				granule.tableSelect[2]=0;
+				for(int i=0; i < 3; i++)
+					granule.subblockGain[i]=(int)side.Read(3);
+				granule.region0Count=granule.blockType == 2 && !granule.bMixed ? 8 : 7;
+				granule.region1Count=20 - granule.region0Count;
+			}
+			else
+			{
+				granule.blockType=0;
+				granule.bMixed=false;
+				for(int i=0; i < 3; i++)
+					granule.tableSelect[i]=(int)side.Read(5);
+				granule.subblockGain[0]=granule.subblockGain[1]=granule.subblockGain[2]=0;
+				granule.region0Count=(int)side.Read(4);
+				granule.region1Count=(int)side.Read(3);
+			}
+			granule.bPreflag=side.Read(1) != 0;
+			granule.bScalefacScale=side.Read(1) != 0;
+			granule.bCount1TableB=side.Read(1) != 0;
+		}
+	}
+
+	//the main data can start in earlier frames, up to 511 bytes back
+	size_t available=m_Reservoir.size();
+	m_Reservoir.insert(m_Reservoir.end(),p + sideOffset + sideSize,p + header.size);
+	bool bDecodable=(size_t)mainDataBegin <= available && !m_Reservoir.empty();
+	size_t mainStart=available - mainDataBegin;
+	if(bDecodable)
+	{
+		BitReader reader(&m_Reservoir[0],m_Reservoir.size(),mainStart * 8);
+		int values[576];
+		float xr[2][576];
+		float pcm[576 * 2];
+		for(int gr=0; gr < 2; gr++)
+		{
+			int lines[2]={0,0};
+			for(int ch=0; ch < channels; ch++)
+			{
+				const Granule& granule=granules[gr][ch];
+				size_t end=reader.Position() + granule.part23Length;
+				ReadScalefactors(reader,granule,gr,ch,scfsi[ch]);
+				lines[ch]=ReadHuffman(reader,granule,end,header.rateIndex,values);
+				reader.Seek(end); //past any stuffing
+				Requantize(granule,ch,header.rateIndex,values,xr[ch]);
+			}
+
+			if(header.mode == 1 && header.modeExtension)
+				Stereo(granules[gr][1],header,lines[1],xr[0],xr[1]);
+
+			for(int ch=0; ch < channels; ch++)
+			{
+				const Granule& granule=granules[gr][ch];
+				Reorder(granule,header.rateIndex,xr[ch]);
+				Antialias(granule,xr[ch]);
+				Hybrid(granule,ch,xr[ch]);
+				Synthesize(ch,xr[ch],pcm + ch);
+			}
+			if(channels == 1)
+			{
+				for(int i=0; i < 576; i++)
+					pcm[i * 2 + 1]=pcm[i * 2];
+			}
+			memcpy(&out[start + gr * 576 * 2],pcm,sizeof(pcm));
+		}
+	}
+
+	if(m_Reservoir.size() > 511)
+		m_Reservoir.erase(m_Reservoir.begin(),m_Reservoir.end() - 511);
+}
+
+void Mp3Decoder::ReadScalefactors(BitReader& reader, const Granule& granule, int gr, int ch, const bool scfsi[4])
+{
+	int bits[2]={ScalefacBits[0][granule.scalefacCompress],ScalefacBits[1][granule.scalefacCompress]};
+	int* longFactors=m_ScalefacLong[ch];
+	int (*shortFactors)[3]=m_ScalefacShort[ch];
+
+	if(granule.bWindowSwitching && granule.blockType == 2)
+	{
+		//a mixed block's long bands cover the first three short ones
+		int first=0;
+		if(granule.bMixed)
+		{
+			for(int sfb=0; sfb < 8; sfb++)
+				longFactors[sfb]=(int)reader.Read(bits[0]);
+			first=3;
+		}
+		for(int sfb=first; sfb < 12; sfb++)
+		{
+			for(int window=0; window < 3; window++)
+				shortFactors[sfb][window]=(int)reader.Read(bits[sfb < 6 ? 0 : 1]);
+		}
+		shortFactors[12][0]=shortFactors[12][1]=shortFactors[12][2]=0;
+		return;
+	}
+
+	//the second granule can keep the first's for each group of bands
+	static const int Groups[5]={0,6,11,16,21};
+	for(int group=0; group < 4; group++)
+	{
+		if(gr == 1 && scfsi[group])
+			continue;
+		for(int sfb=Groups[group]; sfb < Groups[group + 1]; sfb++)
+			longFactors[sfb]=(int)reader.Read(bits[group < 2 ? 0 : 1]);
+	}
+	longFactors[21]=0;
+}
+
+int Mp3Decoder::ReadHuffman(BitReader& reader, const Granule& granule, size_t end, int rateIndex, int* values)
+{
+	memset(values,0,576 * sizeof(int));
+
+	//the big values are in pairs over three regions, each with its own table
+	int region1, region2;
+	if(granule.bWindowSwitching)
+	{
+		region1=36;
+		region2=576;
+	}
+	else
+	{
+		int edge1=granule.region0Count + 1;
+		int edge2=granule.region0Count + granule.region1Count + 2;
+		region1=LongBands[rateIndex][edge1 > 22 ? 22 : edge1];
+		region2=LongBands[rateIndex][edge2 > 22 ? 22 : edge2];
+	}
+
+	int bigEnd=granule.bigValues * 2 > 576 ? 576 : granule.bigValues * 2;
+	int lines=0;
+	int i=0;
+	for(; i < bigEnd; i+=2)
+	{
+		int select=granule.tableSelect[i < region1 ? 0 : i < region2 ? 1 : 2];
+		int table=BigValueTables[select].table;
+		if(table < 0)
+			continue;
+
+		int linbits=BigValueTables[select].linbits;
+		int symbol=DecodeTree(reader,table);
+		int pair[2]={symbol >> 4,symbol & 15};
+		for(int j=0; j < 2; j++)
+		{
+			if(linbits && pair[j] == 15)
+				pair[j]+=(int)reader.Read(linbits);
+			if(pair[j] && reader.Read(1))
+				pair[j]=-pair[j];
+			values[i + j]=pair[j];
+			if(pair[j])
+				lines=i + j + 1;
+		}
+	}
+
+	//then quadruples of -1, 0 and 1 until the granule's bits run out, one
+	//that runs past them is left out
+	while(i + 4 <= 576 && reader.Position() < end)
+	{
+		int symbol=granule.bCount1TableB ? 15 - (int)reader.Read(4) : DecodeTree(reader,Count1Table);
+		int quad[4]={(symbol >> 3) & 1,(symbol >> 2) & 1,(symbol >> 1) & 1,symbol & 1};
+		for(int j=0; j < 4; j++)
+		{
+			if(quad[j] && reader.Read(1))
+				quad[j]=-1;
+		}
+		if(reader.Position() > end)
+			break;
+		for(int j=0; j < 4; j++)
+		{
+			values[i + j]=quad[j];
+			if(quad[j])
+				lines=i + j + 1;
+		}
+		i+=4;
+	}
+	return lines;
+}
+
+int Mp3Decoder::DecodeTree(BitReader& reader, int table) const
+{
+	//a bit pattern no code starts with gives 0, the stream is damaged anyway
+	int node=m_Roots[table];
+	for(;;)
+	{
+		int next=m_Tree[node * 2 + reader.Read(1)];
+		if(next < 0)
+			return -next - 1;
+		if(!next)
+			return 0;
+		node=next;
+	}
+}
+
+void Mp3Decoder::Requantize(const Granule& granule, int ch, int rateIndex, const int* values, float* xr) const
+{
+	//xr = sign * |value|^(4/3) * 2^(gain / 4) * 2^-(scale * scalefactor)
+	double gain=0.25 * (granule.globalGain - 210);
+	double scale=granule.bScalefacScale ? 1.0 : 0.5;
+	const int* longBands=LongBands[rateIndex];
+	const int* shortBands=ShortBands[rateIndex];
+
+	bool bShort=granule.bWindowSwitching && granule.blockType == 2;
+	int longEnd=!bShort ? 576 : granule.bMixed ? 36 : 0;
+	for(int sfb=0; sfb < 22 && longBands[sfb] < longEnd; sfb++)
+	{
+		int factor=m_ScalefacLong[ch][sfb] + (granule.bPreflag ? Pretab[sfb] : 0);
+		float multiplier=(float)pow(2.0,gain - scale * factor);
+		for(int i=longBands[sfb]; i < longBands[sfb + 1]; i++)
+			xr[i]=values[i] < 0 ? -m_Pow43[-values[i]] * multiplier : m_Pow43[values[i]] * multiplier;
+	}
+
+	//short bands are stored a window at a time within each band
+	if(!bShort)
+		return;
+	for(int sfb=granule.bMixed ? 3 : 0; sfb < 13; sfb++)
+	{
+		int width=shortBands[sfb + 1] - shortBands[sfb];
+		for(int window=0; window < 3; window++)
+		{
+			double exponent=gain - 2.0 * granule.subblockGain[window] - scale * m_ScalefacShort[ch][sfb][window];
+			float multiplier=(float)pow(2.0,exponent);
+			int first=shortBands[sfb] * 3 + window * width;
+			for(int i=first; i < first + width; i++)
+				xr[i]=values[i] < 0 ? -m_Pow43[-values[i]] * multiplier : m_Pow43[values[i]] * multiplier;
+		}
+	}
+}
+
+void Mp3Decoder::Stereo(const Granule& granule, const FrameHeader& header, int rightLines, float* left, float* right) const
+{
+	//intensity stereo carries only the left channel above the right's last
+	//nonzero band, the right's scalefactor there is the position between
+	//them (7 is none).  The last band has no scalefactor of its own and
+	//takes the one below.  Mid/side covers every other line
+	bool bIntensity[576];
+	memset(bIntensity,0,sizeof(bIntensity));
+	if(header.modeExtension & 1)
+	{
+		const int* longBands=LongBands[header.rateIndex];
+		const int* shortBands=ShortBands[header.rateIndex];
+		float ratios[7][2];
+		for(int position=0; position < 7; position++)
+		{
+			double ratio=tan(position * Pi / 12.0);
+			ratios[position][0]=(float)(ratio / (1.0 + ratio));
+			ratios[position][1]=(float)(1.0 / (1.0 + ratio));
+		}
+
+		bool bShort=granule.bWindowSwitching && granule.blockType == 2;
+		int longEnd=!bShort ? 576 : granule.bMixed ? 36 : 0;
+		bool bLongIntensity=true;
+		if(bShort)
+		{
+			//each window from its own last nonzero band up
+			for(int window=0; window < 3; window++)
+			{
+				int first=granule.bMixed ? 3 : 0;
+				int bound=first;
+				for(int sfb=first; sfb < 13; sfb++)
+				{
+					int width=shortBands[sfb + 1] - shortBands[sfb];
+					int line=shortBands[sfb] * 3 + window * width;
+					for(int i=line; i < line + width; i++)
+					{
+						if(right[i] != 0.0f)
+							bound=sfb + 1;
+					}
+				}
+				if(bound > first)
+					bLongIntensity=false; //the long part of a mixed block is below it
+				for(int sfb=bound; sfb < 13; sfb++)
+				{
+					int position=m_ScalefacShort[1][sfb < 12 ? sfb : 11][window];
+					if(position >= 7)
+						continue;
+					int width=shortBands[sfb + 1] - shortBands[sfb];
+					int line=shortBands[sfb] * 3 + window * width;
+					for(int i=line; i < line + width; i++)
+					{
+						float value=left[i];
+						left[i]=value * ratios[position][0];
+						right[i]=value * ratios[position][1];
+						bIntensity[i]=true;
+					}
+				}
+			}
+		}
+
+		if(bLongIntensity && longEnd > 0)
+		{
+			int first=0;
+			while(first < 22 && longBands[first] < rightLines)
+				first++;
+			for(int sfb=first; sfb < 22 && longBands[sfb] < longEnd; sfb++)
+			{
+				int position=m_ScalefacLong[1][sfb < 21 ? sfb : 20];
+				if(position >= 7)
+					continue;
+				for(int i=longBands[sfb]; i < longBands[sfb + 1]; i++)
+				{
+					float value=left[i];
+					left[i]=value * ratios[position][0];
+					right[i]=value * ratios[position][1];
+					bIntensity[i]=true;
+				}
+			}
+		}
+	}
+
+	if(header.modeExtension & 2)
+	{
+		const float half=0.70710678f;
+		for(int i=0; i < 576; i++)
+		{
+			if(bIntensity[i])
+				continue;
+			float mid=left[i], sideValue=right[i];
+			left[i]=(mid + sideValue) * half;
+			right[i]=(mid - sideValue) * half;
+		}
+	}
+}
+
+void Mp3Decoder::Reorder(const Granule& granule, int rateIndex, float* xr)
+{
+	//short bands from a window at a time to the three windows interleaved,
+	//so each subband's 18 lines hold its six frequencies of each window
+	if(!granule.bWindowSwitching || granule.blockType != 2)
+		return;
+
+	const int* shortBands=ShortBands[rateIndex];
+	float band[576];
+	for(int sfb=granule.bMixed ? 3 : 0; sfb < 13; sfb++)
+	{
+		int width=shortBands[sfb + 1] - shortBands[sfb];
+		int first=shortBands[sfb] * 3;
+		for(int window=0; window < 3; window++)
+		{
+			for(int i=0; i < width; i++)
+				band[i * 3 + window]=xr[first + window * width + i];
+		}
+		memcpy(xr + first,band,width * 3 * sizeof(float));
+	}
+}
+
+void Mp3Decoder::Antialias(const Granule& granule, float* xr) const
+{
+	//between long subbands only, a mixed block's two long ones
+	bool bShort=granule.bWindowSwitching && granule.blockType == 2;
+	if(bShort && !granule.bMixed)
+		return;
+
+	int subbands=bShort ? 2 : 32;
+	for(int sb=1; sb < subbands; sb++)
+	{
+		for(int i=0; i < 8; i++)
+		{
+			float& below=xr[sb * 18 - 1 - i];
+			float& above=xr[sb * 18 + i];
+			float a=below, b=above;
+			below=a * m_Antialias[i][0] - b * m_Antialias[i][1];
+			above=b * m_Antialias[i][0] + a * m_Antialias[i][1];
+		}
+	}
+}
+
+void Mp3Decoder::Hybrid(const Granule& granule, int ch, float* xr)
+{
+	for(int sb=0; sb < 32; sb++)
+	{
+		float* in=xr + sb * 18;
+		float* overlap=m_Overlap[ch] + sb * 18;
+		int blockType=granule.bWindowSwitching ? granule.blockType : 0;
+		if(blockType == 2 && granule.bMixed && sb < 2)
+			blockType=0;
+
+		float raw[36];
+		if(blockType == 2)
+		{
+			//three overlapping 12 point transforms, six lines each
+			memset(raw,0,sizeof(raw));
+			for(int window=0; window < 3; window++)
+			{
+				for(int i=0; i < 12; i++)
+				{
+					float sum=0.0f;
+					for(int k=0; k < 6; k++)
+						sum+=in[k * 3 + window] * m_Imdct12[k][i];
+					raw[6 + window * 6 + i]+=sum * m_Windows[2][i];
+				}
+			}
+		}
+		else
+		{
+			for(int i=0; i < 36; i++)
+			{
+				float sum=0.0f;
+				for(int k=0; k < 18; k++)
+					sum+=in[k] * m_Imdct36[k][i];
+				raw[i]=sum * m_Windows[blockType][i];
+			}
+		}
+
+		//the first half with what the last granule left, the second kept
+		//for the next.  Odd subbands have every other sample negated
+		for(int i=0; i < 18; i++)
+		{
+			float sample=raw[i] + overlap[i];
+			in[i]=sb & i & 1 ? -sample : sample;
+			overlap[i]=raw[18 + i];
+		}
+	}
+}
+
+void Mp3Decoder::Synthesize(int ch, const float* xr, float* pcm)
+{
+	//the polyphase filter bank, 32 samples from each time slot's subbands.
+	//V is a ring, offset is where its newest 64 start
+	float* v=m_V[ch];
+	for(int slot=0; slot < 18; slot++)
+	{
+		int offset=(m_VOffset[ch] - 64) & 1023;
+		m_VOffset[ch]=offset;
+		for(int i=0; i < 64; i++)
+		{
+			float sum=0.0f;
+			for(int k=0; k < 32; k++)
+				sum+=m_Matrix[i][k] * xr[k * 18 + slot];
+			v[(offset + i) & 1023]=sum;
+		}
+
+		for(int j=0; j < 32; j++)
+		{
+			float sum=0.0f;
+			for(int i=0; i < 8; i++)
+			{
+				sum+=v[(offset + i * 128 + j) & 1023] * m_Window[i * 64 + j];
+				sum+=v[(offset + i * 128 + 96 + j) & 1023] * m_Window[i * 64 + 32 + j];
+			}
+			pcm[(slot * 32 + j) * 2]=sum;
+		}
+	}
+}
+
+void Mp3Decoder::AddCodes(int table, const unsigned char* symbols, const unsigned char* lengths, int count)
+{
+	//codes counted up from 0 at the top of 32 bits, so a shorter one moves
+	//the count on by more
+	m_Roots[table]=0;
+	unsigned int code=0;
+	for(int i=0; i < count; i++)
+	{
+		AddCode(table,code >> (32 - lengths[i]),lengths[i],symbols[i]);
+		code+=1u << (32 - lengths[i]);
+	}
+}
+
+void Mp3Decoder::AddCode(int table, unsigned int code, int length, int symbol)
+{
+	if(!m_Roots[table])
+	{
+		m_Roots[table]=(int)m_Tree.size() / 2;
+		m_Tree.resize(m_Tree.size() + 2,(short)0);
+	}
+
+	int node=m_Roots[table];
+	for(int bit=length - 1; bit > 0; bit--)
+	{
+		int branch=node * 2 + ((code >> bit) & 1);
+		if(!m_Tree[branch])
+		{
+			m_Tree[branch]=(short)(m_Tree.size() / 2);
+			m_Tree.resize(m_Tree.size() + 2,(short)0);
+		}
+		node=m_Tree[branch];
+	}
+	m_Tree[node * 2 + (code & 1)]=(short)(-symbol - 1);
+}
@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////
+//Mp3 Decoder, MPEG-1 Layer III to float stereo at the file's
+//rate.  The asset tool converts the music with it to WAV files
+//the AudioStream reads, so the game never decodes MP3 itself.
+//Every block type, joint stereo (mid/side and intensity) and
+//the bit reservoir, mono comes out on both channels
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+class Mp3Decoder
+{
+public:
+	Mp3Decoder(); //builds the Huffman trees and the transform tables
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Decode
+	// Parameters:	const unsigned char* data - the whole .mp3 file, ID3
+	//					tags are skipped
+	//				size_t size - its length
+	//				std::vector<float>& out - stereo frames appended, left,
+	//					right, left, ... full scale at 1
+	//				int& rate - the file's sample rate
+	// Return:		bool - false if there was no MPEG-1 Layer III frame in it
+	// Description:	1152 frames a frame of the file.  One whose main data
+	//				starts before the file does (cut from a longer stream)
+	//				comes out silent.  A frame at another rate than the
+	//				first ends the decode.
+	//////////////////////////////////////////////////////////////////////////
+	bool	Decode(const unsigned char* data, size_t size, std::vector<float>& out, int& rate);
+
+private:
+	struct FrameHeader
+	{
+		int		rate;
+		int		rateIndex;		//0 44100, 1 48000, 2 32000
+		int		size;			//bytes, header included
+		int		channels;
+		int		mode;			//0 stereo, 1 joint stereo, 2 dual channel, 3 mono
+		int		modeExtension;	//joint stereo, 1 intensity, 2 mid/side
+		bool	bCRC;
+	};
+
+	struct Granule //one channel of one granule's side information
+	{
+		int		part23Length;	//bits of scalefactors and Huffman data
+		int		bigValues;
+		int		globalGain;
+		int		scalefacCompress;
+		bool	bWindowSwitching;
+		int		blockType;		//0 normal, 1 start, 2 short, 3 stop
+		bool	bMixed;			//the lowest two subbands are long
+		int		tableSelect[3];
+		int		subblockGain[3];
+		int		region0Count;
+		int		region1Count;
+		bool	bPreflag;
+		bool	bScalefacScale;
+		bool	bCount1TableB;
+	};
+
+	class BitReader
+	{
+	public:
+		BitReader(const unsigned char* data, size_t size, size_t bit);
+
+		unsigned int	Read(int bits);	//zeros past the end
+		size_t			Position() const;
+		void			Seek(size_t bit);
+
+	private:
+		const unsigned char*	m_pData;
+		size_t					m_Bits;
+		size_t					m_Position;
+	};
+
+	static bool	ReadHeader(const unsigned char* p, FrameHeader& header);
+	void	Reset();
+	void	DecodeFrame(const unsigned char* p, const FrameHeader& header, std::vector<float>& out);
+	void	ReadScalefactors(BitReader& reader, const Granule& granule, int gr, int ch, const bool scfsi[4]);
+	int		ReadHuffman(BitReader& reader, const Granule& granule, size_t end, int rateIndex, int* values); //returns the lines up to the last nonzero
+	int		DecodeTree(BitReader& reader, int table) const;
+	void	Requantize(const Granule& granule, int ch, int rateIndex, const int* values, float* xr) const;
+	void	Stereo(const Granule& granule, const FrameHeader& header, int rightLines, float* left, float* right) const;
+	static void	Reorder(const Granule& granule, int rateIndex, float* xr);
+	void	Antialias(const Granule& granule, float* xr) const;
+	void	Hybrid(const Granule& granule, int ch, float* xr); //IMDCT, overlap and frequency inversion, in place
+	void	Synthesize(int ch, const float* xr, float* pcm); //576 samples, each a step of 2 into pcm
+
+	void	AddCodes(int table, const unsigned char* symbols, const unsigned char* lengths, int count);
+	void	AddCode(int table, unsigned int code, int length, int symbol);
+
+private:
+	//decode trees, two entries a node: a node index or -(symbol + 1)
+	std::vector<short>	m_Tree;
+	int					m_Roots[16];	//the big value code tables, then count1 table A
+
+	std::vector<float>	m_Pow43;		//|value|^(4/3)
+	float				m_Imdct36[18][36];
+	float				m_Imdct12[6][12];
+	float				m_Windows[4][36];	//by block type, short ones a 12 point window
+	float				m_Antialias[8][2];	//cs, ca
+	float				m_Matrix[64][32];	//synthesis cosines
+	float				m_Window[512];		//synthesis window D
+
+	//what carries from one frame to the next
+	std::vector<unsigned char>	m_Reservoir;
+	int					m_ScalefacLong[2][22];
+	int					m_ScalefacShort[2][13][3];
+	float				m_Overlap[2][576];
+	float				m_V[2][1024];
+	int					m_VOffset[2];
+};
@@ -0,0 +1,258 @@
+////////////////////////////////////////////////////////////////
+//RenderCommandList and RenderFrameQueue member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "RenderCommands.h"
+#include <string.h>
+#include <algorithm>
+
+static const unsigned long long SPRITE_INDEX_MASK=0xFFFFFF;
+
+RenderCommandList::RenderCommandList()
+{
+	m_ClearColor=0xFF000000;
+}
+
+void RenderCommandList::Reset(unsigned int clearColor)
+{
+	m_ClearColor=clearColor;
+	m_Sprites.clear();
+	m_Keys.clear();
+	m_Texts.clear();
+	m_TextPool.clear();
+	m_Capture.clear();
+}
+
+void RenderCommandList::AddSprite(int texture, const ImageRect* source, float centerX, float centerY, float x, float y, unsigned int color, int layer, float depth)
+{
+	//inverted so ascending keys go back to front
+	depth=depth < 0.0f ? 0.0f : (depth > 1.0f ? 1.0f : depth);
+	unsigned long long depthBits=(unsigned long long)((1.0f - depth) * 65535.0f + 0.5f);
+
+	unsigned long long key=((unsigned long long)(layer & 0xFF) << 56) |
+						   ((unsigned long long)(texture & 0xFFFF) << 40) |
+						   (depthBits << 24) |
+						   (unsigned long long)m_Sprites.size();
+	m_Keys.push_back(key);
+
+	static const ImageRect WholeTexture={0,0,0,0};
+	SpriteCommand command={texture,source ? *source : WholeTexture,centerX,centerY,x,y,color};
+	m_Sprites.push_back(command);
+}
+
+void RenderCommandList::AddText(const wchar_t* text, const ImageRect& rect, unsigned int format, unsigned int color)
+{
+	TextCommand command={m_TextPool.size(),rect,format,color};
+	m_Texts.push_back(command);
+
+	//copy the string, terminator included, the caller's buffer is gone by the time it is drawn
+	do
+	{
+		m_TextPool.push_back(*text);
+	} while(*text++);
+}
+
+void RenderCommandList::SetCapture(const std::string& filename)
+{
+	m_Capture=filename;
+}
+
+void RenderCommandList::Sort()
+{
+	size_t count=m_Keys.size();
+	if(count < 2)
+		return;
+
+	//one read to build every byte's histogram
+	static const int FIRST_PASS=3; //bytes 0-2 are the index, already in order
+	size_t histogram[8][256];
+	memset(histogram,0,sizeof(histogram));
+	for(size_t i=0; i < count; i++)
+	{
+		unsigned long long key=m_Keys[i];
+		for(int pass=FIRST_PASS; pass < 8; pass++)
+			histogram[pass][(key >> (pass * 8)) & 0xFF]++;
+	}
+
+	m_SortTemp.resize(count);
+	unsigned long long* src=&m_Keys[0];
+	unsigned long long* dst=&m_SortTemp[0];
+	for(int pass=FIRST_PASS; pass < 8; pass++)
+	{
+		size_t* counts=histogram[pass];
+		int shift=pass * 8;
+
+		//every key has the same byte here, the pass would change nothing
+		if(counts[(src[0] >> shift) & 0xFF] == count)
+			continue;
+
+		size_t offset=0;
+		for(int digit=0; digit < 256; digit++)
+		{
+			size_t digitCount=counts[digit];
+			counts[digit]=offset;
+			offset+=digitCount;
+		}
+
+		for(size_t i=0; i < count; i++)
+			dst[counts[(src[i] >> shift) & 0xFF]++]=src[i];
+
+		std::swap(src,dst);
+	}
+
+	if(src != &m_Keys[0])
+		m_Keys.swap(m_SortTemp);
+}
+
+unsigned int RenderCommandList::ClearColor() const
+{
+	return m_ClearColor;
+}
+
+size_t RenderCommandList::SpriteCount() const
+{
+	return m_Sprites.size();
+}
+
+const SpriteCommand& RenderCommandList::Sprite(size_t index) const
+{
+	return m_Sprites[(size_t)(m_Keys[index] & SPRITE_INDEX_MASK)];
+}
+
+size_t RenderCommandList::StaticSpriteCount() const
+{
+	//keys lead with the layer, so the static ones are everything below this
+	unsigned long long firstDynamic=(unsigned long long)LAYER_FIRST_DYNAMIC << 56;
+	return std::lower_bound(m_Keys.begin(),m_Keys.end(),firstDynamic) - m_Keys.begin();
+}
+
+size_t RenderCommandList::TextCount() const
+{
+	return m_Texts.size();
+}
+
+const TextCommand& RenderCommandList::Text(size_t index) const
+{
+	return m_Texts[index];
+}
+
+const wchar_t* RenderCommandList::TextString(const TextCommand& command) const
+{
+	return &m_TextPool[command.text];
+}
+
+const std::string& RenderCommandList::Capture() const
+{
+	return m_Capture;
+}
+
+StaticLayerState::StaticLayerState()
+{
+	m_ClearColor=0;
+	m_Width=0;
+	m_Height=0;
+	m_bValid=false;
+}
+
+bool StaticLayerState::Update(const RenderCommandList& frame, int width, int height)
+{
+	size_t count=frame.StaticSpriteCount();
+	bool bChanged=!m_bValid || count != m_Sprites.size() || frame.ClearColor() != m_ClearColor || width != m_Width || height != m_Height;
+	for(size_t i=0; i < count && !bChanged; i++)
+	{
+		const SpriteCommand& a=frame.Sprite(i);
+		const SpriteCommand& b=m_Sprites[i];
+		bChanged=a.texture != b.texture || memcmp(&a.source,&b.source,sizeof(ImageRect)) != 0 || a.centerX != b.centerX ||
+				 a.centerY != b.centerY || a.x != b.x || a.y != b.y || a.color != b.color;
+	}
+	if(!bChanged)
+		return false;
+
+	m_Sprites.clear();
+	for(size_t i=0; i < count; i++)
+		m_Sprites.push_back(frame.Sprite(i));
+	m_ClearColor=frame.ClearColor();
+	m_Width=width;
+	m_Height=height;
+	m_bValid=true;
+	return true;
+}
+
+void StaticLayerState::Invalidate()
+{
+	m_bValid=false;
+}
+
+RenderFrameQueue::RenderFrameQueue()
+{
+	m_Write=0;
+	m_Ready=1;
+	m_Read=2;
+	m_bFrameReady=false;
+	m_bShutdown=false;
+	m_Dropped=0;
+}
+
+RenderCommandList& RenderFrameQueue::BeginWrite()
+{
+	return m_Lists[m_Write];
+}
+
+void RenderFrameQueue::Submit()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Lock);
+		if(m_bFrameReady)
+			m_Dropped++; //renderer never got to the previous frame
+		std::swap(m_Write,m_Ready);
+		m_bFrameReady=true;
+	}
+	m_Signal.notify_one();
+}
+
+void RenderFrameQueue::WaitUntilTaken()
+{
+	std::unique_lock<std::mutex> lock(m_Lock);
+	while(m_bFrameReady && !m_bShutdown)
+		m_Signal.wait(lock);
+}
+
+const RenderCommandList* RenderFrameQueue::Acquire()
+{
+	const RenderCommandList* frame=0;
+	{
+		std::unique_lock<std::mutex> lock(m_Lock);
+		while(!m_bFrameReady && !m_bShutdown)
+			m_Signal.wait(lock);
+
+		if(!m_bShutdown)
+		{
+			std::swap(m_Read,m_Ready);
+			m_bFrameReady=false;
+			frame=&m_Lists[m_Read];
+		}
+	}
+	m_Signal.notify_all(); //a producer may be in WaitUntilTaken
+	return frame;
+}
+
+void RenderFrameQueue::Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Lock);
+		m_bShutdown=true;
+	}
+	m_Signal.notify_all();
+}
+
+void RenderFrameQueue::Restart()
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+	m_bShutdown=false;
+}
+
+unsigned int RenderFrameQueue::FramesDropped() const
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+	return m_Dropped;
+}
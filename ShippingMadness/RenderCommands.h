@@ -0,0 +1,184 @@
+///////////////////////////////////////////////////////////////
+//Render Commands, an immutable list of everything drawn in one
+//frame, handed from the game thread to the render thread
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Image.h"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+//Sprite layers, drawn in this order.  Inside a layer sprites are grouped
+//by texture, so anything that must overlap in a set order needs its own layer.
+//The layers up to LAYER_SCENERY are static: the renderer flattens them into
+//a cached image and only redraws that when their sprites change, so nothing
+//that moves belongs there
+enum
+{
+	LAYER_BACKGROUND,
+	LAYER_SCENERY,
+	LAYER_OBJECTS,
+	LAYER_INTERFACE,
+	LAYER_FIRST_DYNAMIC=LAYER_OBJECTS
+};
+
+struct SpriteCommand
+{
+	int				texture;	//texture index, resolved by whoever executes the list
+	ImageRect		source;		//part of the texture, all of it when right is 0
+	float			centerX;	//pivot inside the texture
+	float			centerY;
+	float			x;			//where the pivot lands on screen
+	float			y;
+	unsigned int	color;		//ARGB modulate colour
+};
+
+struct TextCommand
+{
+	size_t			text;		//offset of the string in the list's text pool
+	ImageRect		rect;
+	unsigned int	format;		//DT_ / TEXT_ flags
+	unsigned int	color;
+};
+
+class RenderCommandList
+{
+public:
+	RenderCommandList();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Reset
+	// Parameters:	unsigned int clearColor - ARGB colour the frame starts from
+	// Return:		void
+	// Description:	Empties the list for recording the next frame.  The arrays
+	//				keep their capacity so steady state recording never allocates.
+	//////////////////////////////////////////////////////////////////////////
+	void	Reset(unsigned int clearColor);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		AddSprite
+	// Parameters:	int texture - texture index, at most 65535
+	//				const ImageRect* source - sprite sheet frame, 0 for the
+	//					whole texture.  Frames of one sheet share the texture's
+	//					key so an animated crowd still batches into one draw
+	//				float centerX, centerY - pivot inside the texture
+	//				float x, y - where the pivot lands on screen
+	//				unsigned int color - ARGB modulate colour
+	//				int layer - LAYER_ value, 0 to 255
+	//				float depth - 0 (front) to 1 (back), back drawn first
+	//					among sprites sharing layer and texture
+	// Return:		void
+	// Description:	Records the sprite with its 64-bit sort key:
+	//				layer (8 bits) | texture (16) | inverted depth (16) | index (24)
+	//////////////////////////////////////////////////////////////////////////
+	void	AddSprite(int texture, const ImageRect* source, float centerX, float centerY, float x, float y, unsigned int color, int layer, float depth);
+	void	AddText(const wchar_t* text, const ImageRect& rect, unsigned int format, unsigned int color);
+
+	//asks the renderer to write this frame to a PNG once drawn
+	void	SetCapture(const std::string& filename);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Sort
+	// Parameters:	void
+	// Return:		void
+	// Description:	Puts the sprites in key order with a stable LSD radix sort,
+	//				8 bits per pass.  Bytes that are the same in every key are
+	//				skipped, and so are the index bytes since the keys start in
+	//				index order.  A typical frame costs one or two passes.
+	//////////////////////////////////////////////////////////////////////////
+	void	Sort();
+
+	unsigned int			ClearColor() const;
+	size_t					SpriteCount() const;
+	const SpriteCommand&	Sprite(size_t index) const; //in key order once sorted
+	size_t					StaticSpriteCount() const;	//sprites below LAYER_FIRST_DYNAMIC, first once sorted
+	size_t					TextCount() const;
+	const TextCommand&		Text(size_t index) const;
+	const wchar_t*			TextString(const TextCommand& command) const;
+	const std::string&		Capture() const;
+
+private:
+	unsigned int				m_ClearColor;
+	std::vector<SpriteCommand>	m_Sprites;
+	std::vector<unsigned long long>	m_Keys;		//sort keys, low 24 bits index m_Sprites
+	std::vector<unsigned long long>	m_SortTemp;	//radix sort scratch
+	std::vector<TextCommand>	m_Texts;
+	std::vector<wchar_t>		m_TextPool;	//all strings back to back, null terminated
+	std::string					m_Capture;
+};
+
+///////////////////////////////////////////////////////////////
+//Static Layer State, what a cached copy of a frame's static
+//layers was drawn from, so a renderer knows when to redraw it
+///////////////////////////////////////////////////////////////
+class StaticLayerState
+{
+public:
+	StaticLayerState();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Update
+	// Parameters:	const RenderCommandList& frame - sorted frame being drawn
+	//				int width, height - size of the target the cache covers
+	// Return:		bool - true if the static sprites, clear colour or size
+	//				differ from last time, the cache has to be redrawn
+	// Description:	Remembers the frame's static layers either way.
+	//////////////////////////////////////////////////////////////////////////
+	bool	Update(const RenderCommandList& frame, int width, int height);
+	void	Invalidate(); //next Update reports a change, e.g. textures reloaded
+
+private:
+	std::vector<SpriteCommand>	m_Sprites;
+	unsigned int				m_ClearColor;
+	int							m_Width;
+	int							m_Height;
+	bool						m_bValid;
+};
+
+///////////////////////////////////////////////////////////////
+//Render Frame Queue, triple buffered hand off between one
+//producer (game thread) and one consumer (render thread).
+//The producer never waits: a frame the renderer has not picked
+//up yet is replaced by the newer one.
+///////////////////////////////////////////////////////////////
+class RenderFrameQueue
+{
+public:
+	RenderFrameQueue();
+
+	//producer: list to record into, never touched by the consumer until Submit
+	RenderCommandList&			BeginWrite();
+	void						Submit();
+
+	//producer: blocks until the consumer has taken the last submitted frame,
+	//lets a consumer stuck in a vsynced Present pace the producer
+	void						WaitUntilTaken();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Acquire
+	// Parameters:	void
+	// Return:		const RenderCommandList* - newest submitted frame, 0 on Shutdown
+	// Description:	Consumer side, blocks until a frame newer than the last one
+	//				acquired is available.  The list stays valid until the next
+	//				Acquire call.
+	//////////////////////////////////////////////////////////////////////////
+	const RenderCommandList*	Acquire();
+
+	void						Shutdown();	//wakes the consumer and makes Acquire return 0
+	void						Restart();	//undo Shutdown so a new consumer can start
+
+	unsigned int				FramesDropped() const; //submitted frames the consumer never saw
+
+private:
+	RenderCommandList			m_Lists[3];
+	int							m_Write;	//owned by the producer
+	int							m_Ready;	//latest submitted frame
+	int							m_Read;		//owned by the consumer
+	bool						m_bFrameReady;
+	bool						m_bShutdown;
+	unsigned int				m_Dropped;
+	mutable std::mutex			m_Lock;
+	std::condition_variable		m_Signal;
+};
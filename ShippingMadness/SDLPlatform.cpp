@@ -0,0 +1,186 @@
+////////////////////////////////////////////////////////////////
+//SDLPlatform member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "SDLPlatform.h"
+#include <SDL.h>
+#include <stdio.h>
+
+SDLPlatform::SDLPlatform()
+{
+	m_pWindow		=0;
+	m_pRenderer		=0;
+	m_pTexture		=0;
+	m_TextureWidth	=0;
+	m_TextureHeight	=0;
+	m_Width			=0;
+	m_Height		=0;
+	m_bVsync		=false;
+	m_bInitialised	=false;
+}
+
+SDLPlatform::~SDLPlatform()
+{
+	Shutdown();
+}
+
+bool SDLPlatform::Init(const char* title, int width, int height, bool bVsync)
+{
+	if(SDL_Init(SDL_INIT_VIDEO) != 0)
+	{
+		fprintf(stderr,"SDL_Init failed: %s\n",SDL_GetError());
+		return false;
+	}
+	m_bInitialised=true;
+
+	m_pWindow=SDL_CreateWindow(title,SDL_WINDOWPOS_CENTERED,SDL_WINDOWPOS_CENTERED,width,height,SDL_WINDOW_RESIZABLE);
+	if(!m_pWindow)
+	{
+		fprintf(stderr,"SDL_CreateWindow failed: %s\n",SDL_GetError());
+		Shutdown();
+		return false;
+	}
+	SDL_GetWindowSize(m_pWindow,&m_Width,&m_Height);
+
+	//any renderer will do, even SDL's own software one beats a surface blit
+	//because it is the only way to get a vsynced present
+	m_pRenderer=SDL_CreateRenderer(m_pWindow,-1,bVsync ? SDL_RENDERER_PRESENTVSYNC : 0);
+	if(m_pRenderer)
+	{
+		SDL_RendererInfo info;
+		if(SDL_GetRendererInfo(m_pRenderer,&info) == 0)
+			m_bVsync=(info.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
+	}
+	else
+		fprintf(stderr,"SDL_CreateRenderer failed, presenting through the window surface: %s\n",SDL_GetError());
+
+	return true;
+}
+
+void SDLPlatform::Shutdown()
+{
+	if(m_pTexture)
+		SDL_DestroyTexture(m_pTexture);
+	if(m_pRenderer)
+		SDL_DestroyRenderer(m_pRenderer);
+	if(m_pWindow)
+		SDL_DestroyWindow(m_pWindow);
+	m_pTexture=0;
+	m_pRenderer=0;
+	m_pWindow=0;
+	m_TextureWidth=0;
+	m_TextureHeight=0;
+
+	if(m_bInitialised)
+		SDL_Quit();
+	m_bInitialised=false;
+}
+
+bool SDLPlatform::PumpEvents()
+{
+	bool bRunning=true;
+	SDL_Event event;
+	while(SDL_PollEvent(&event))
+	{
+		if(event.type == SDL_QUIT)
+			bRunning=false;
+		else if(event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+		{
+			m_Width=event.window.data1;
+			m_Height=event.window.data2;
+		}
+	}
+	return bRunning;
+}
+
+void SDLPlatform::ReadInput(GameInput& input) const
+{
+	//scan codes, so the keys sit in the same place on every layout
+	static const SDL_Scancode keyCodes[GAME_KEY_COUNT]=
+	{
+		SDL_SCANCODE_UP,SDL_SCANCODE_DOWN,SDL_SCANCODE_LEFT,SDL_SCANCODE_RIGHT,
+		SDL_SCANCODE_RETURN,SDL_SCANCODE_SPACE,SDL_SCANCODE_F1
+	};
+
+	const Uint8* keys=SDL_GetKeyboardState(0);
+	for(int i=0; i < GAME_KEY_COUNT; i++)
+		input.keys[i]=keys[keyCodes[i]] != 0;
+}
+
+void SDLPlatform::Present(const Image& frame)
+{
+	if(frame.IsEmpty() || !m_pWindow)
+		return;
+
+	if(!m_pRenderer)
+	{
+		PresentSurface(frame);
+		return;
+	}
+
+	if(!m_pTexture || m_TextureWidth != frame.Width() || m_TextureHeight != frame.Height())
+	{
+		if(m_pTexture)
+			SDL_DestroyTexture(m_pTexture);
+
+		//same 0xAARRGGBB words the SoftwareRenderer writes, no conversion on upload
+		m_pTexture=SDL_CreateTexture(m_pRenderer,SDL_PIXELFORMAT_ARGB8888,SDL_TEXTUREACCESS_STREAMING,frame.Width(),frame.Height());
+		if(!m_pTexture)
+		{
+			fprintf(stderr,"SDL_CreateTexture failed: %s\n",SDL_GetError());
+			m_TextureWidth=0;
+			m_TextureHeight=0;
+			return;
+		}
+		//the back buffer is already the final image, a copy not a blend
+		SDL_SetTextureBlendMode(m_pTexture,SDL_BLENDMODE_NONE);
+		m_TextureWidth=frame.Width();
+		m_TextureHeight=frame.Height();
+	}
+
+	SDL_UpdateTexture(m_pTexture,0,frame.Pixels(),frame.Width() * 4);
+	SDL_RenderCopy(m_pRenderer,m_pTexture,0,0);
+	SDL_RenderPresent(m_pRenderer);
+}
+
+bool SDLPlatform::PresentSurface(const Image& frame)
+{
+	SDL_Surface* pWindowSurface=SDL_GetWindowSurface(m_pWindow);
+	if(!pWindowSurface)
+		return false;
+
+	//wraps the pixels in place, nothing is copied until the blit
+	SDL_Surface* pFrame=SDL_CreateRGBSurfaceFrom((void*)frame.Pixels(),frame.Width(),frame.Height(),32,frame.Width() * 4,
+		0x00FF0000,0x0000FF00,0x000000FF,0);
+	if(!pFrame)
+		return false;
+
+	SDL_SetSurfaceBlendMode(pFrame,SDL_BLENDMODE_NONE);
+	int result=frame.Width() == pWindowSurface->w && frame.Height() == pWindowSurface->h
+		? SDL_BlitSurface(pFrame,0,pWindowSurface,0) : SDL_BlitScaled(pFrame,0,pWindowSurface,0);
+	SDL_FreeSurface(pFrame);
+	return result == 0 && SDL_UpdateWindowSurface(m_pWindow) == 0;
+}
+
+int SDLPlatform::Width() const
+{
+	return m_Width;
+}
+
+int SDLPlatform::Height() const
+{
+	return m_Height;
+}
+
+bool SDLPlatform::IsVsynced() const
+{
+	return m_bVsync;
+}
+
+int SDLPlatform::RefreshRate() const
+{
+	SDL_DisplayMode mode;
+	if(m_pWindow && SDL_GetWindowDisplayMode(m_pWindow,&mode) == 0 && mode.refresh_rate > 0)
+		return mode.refresh_rate;
+	return 60;
+}
@@ -0,0 +1,69 @@
+///////////////////////////////////////////////////////////////
+//SDL Platform, window, event pump and keyboard for the Linux
+//build.  Frames are rendered on the CPU by the SoftwareRenderer
+//and shown through an SDL streaming texture, or straight into
+//the window surface when no SDL renderer can be created
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Image.h"
+#include "Game.h"
+
+struct SDL_Window;
+struct SDL_Renderer;
+struct SDL_Texture;
+
+class SDLPlatform
+{
+public:
+	SDLPlatform();
+	~SDLPlatform();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Init
+	// Parameters:	const char* title - window caption
+	//				int width, height - client area in pixels
+	//				bool bVsync - let Present wait for the display
+	// Return:		bool - false if SDL or the window could not be created
+	// Description:	Opens the window and a renderer for it.  Without a
+	//				renderer Present copies into the window surface, which
+	//				can never be vsynced.
+	//////////////////////////////////////////////////////////////////////////
+	bool	Init(const char* title, int width, int height, bool bVsync);
+	void	Shutdown();
+
+	//handles every waiting event, false once the window has been closed
+	bool	PumpEvents();
+
+	//keys held down right now, by GAME_KEY_
+	void	ReadInput(GameInput& input) const;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Present
+	// Parameters:	const Image& frame - finished back buffer, ARGB
+	// Return:		void
+	// Description:	Uploads the frame and shows it, stretched to the window
+	//				if the two sizes differ.  The streaming texture is
+	//				recreated when the frame size changes.
+	//////////////////////////////////////////////////////////////////////////
+	void	Present(const Image& frame);
+
+	int		Width() const;		//client area, follows resizes
+	int		Height() const;
+	bool	IsVsynced() const;	//the renderer took the vsync request
+	int		RefreshRate() const;	//of the display the window is on, 60 if unknown
+
+private:
+	bool	PresentSurface(const Image& frame);
+
+private:
+	SDL_Window*		m_pWindow;
+	SDL_Renderer*	m_pRenderer;		//0 when presenting through the window surface
+	SDL_Texture*	m_pTexture;			//streaming, the size of the last frame
+	int				m_TextureWidth;
+	int				m_TextureHeight;
+	int				m_Width;
+	int				m_Height;
+	bool			m_bVsync;
+	bool			m_bInitialised;		//SDL_Init succeeded, SDL_Quit is owed
+};
@@ -0,0 +1,710 @@
+////////////////////////////////////////////////////////////////
+//SoftwareRenderer class member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "SoftwareRenderer.h"
+#include <math.h>
+#include <string.h>
+
+//SSE2 is always there on x64 and on x86 builds using /arch:SSE2,
+//AVX2 is only compiled in when the compiler targets it (/arch:AVX2, -mavx2)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SOFTWARE_RENDERER_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define SOFTWARE_RENDERER_AVX2
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	const unsigned int White=0xFFFFFFFF;
+
+	//5x7 glyphs for ASCII 32-126, one byte per row, bit 4 is the leftmost column
+	const unsigned char Font5x7[95][7]=
+	{
+	{0x00,0x00,0x00,0x00,0x00,0x00,0x00}, // ' '
+	{0x04,0x04,0x04,0x04,0x04,0x00,0x04}, // '!'
+	{0x0A,0x0A,0x00,0x00,0x00,0x00,0x00}, // '"'
+	{0x0A,0x0A,0x1F,0x0A,0x1F,0x0A,0x0A}, // '#'
+	{0x04,0x0F,0x14,0x0E,0x05,0x1E,0x04}, // '$'
+	{0x18,0x19,0x02,0x04,0x08,0x13,0x03}, // '%'
+	{0x0C,0x12,0x14,0x08,0x15,0x12,0x0D}, // '&'
+	{0x04,0x04,0x00,0x00,0x00,0x00,0x00}, // '''
+	{0x02,0x04,0x08,0x08,0x08,0x04,0x02}, // '('
+	{0x08,0x04,0x02,0x02,0x02,0x04,0x08}, // ')'
+	{0x00,0x04,0x15,0x0E,0x15,0x04,0x00}, // '*'
+	{0x00,0x04,0x04,0x1F,0x04,0x04,0x00}, // '+'
+	{0x00,0x00,0x00,0x00,0x0C,0x04,0x08}, // ','
+	{0x00,0x00,0x00,0x1F,0x00,0x00,0x00}, // '-'
+	{0x00,0x00,0x00,0x00,0x00,0x0C,0x0C}, // '.'
+	{0x00,0x01,0x02,0x04,0x08,0x10,0x00}, // '/'
+	{0x0E,0x11,0x13,0x15,0x19,0x11,0x0E}, // '0'
+	{0x04,0x0C,0x04,0x04,0x04,0x04,0x0E}, // '1'
+	{0x0E,0x11,0x01,0x02,0x04,0x08,0x1F}, // '2'
+	{0x1F,0x02,0x04,0x02,0x01,0x11,0x0E}, // '3'
+	{0x02,0x06,0x0A,0x12,0x1F,0x02,0x02}, // '4'
+	{0x1F,0x10,0x1E,0x01,0x01,0x11,0x0E}, // '5'
+	{0x06,0x08,0x10,0x1E,0x11,0x11,0x0E}, // '6'
+	{0x1F,0x01,0x02,0x04,0x08,0x08,0x08}, // '7'
+	{0x0E,0x11,0x11,0x0E,0x11,0x11,0x0E}, // '8'
+	{0x0E,0x11,0x11,0x0F,0x01,0x02,0x0C}, // '9'
+	{0x00,0x0C,0x0C,0x00,0x0C,0x0C,0x00}, // ':'
+	{0x00,0x0C,0x0C,0x00,0x0C,0x04,0x08}, // ';'
+	{0x02,0x04,0x08,0x10,0x08,0x04,0x02}, // '<'
+	{0x00,0x00,0x1F,0x00,0x1F,0x00,0x00}, // '='
+	{0x08,0x04,0x02,0x01,0x02,0x04,0x08}, // '>'
+	{0x0E,0x11,0x01,0x02,0x04,0x00,0x04}, // '?'
+	{0x0E,0x11,0x01,0x0D,0x15,0x15,0x0E}, // '@'
+	{0x0E,0x11,0x11,0x1F,0x11,0x11,0x11}, // 'A'
+	{0x1E,0x11,0x11,0x1E,0x11,0x11,0x1E}, // 'B'
+	{0x0E,0x11,0x10,0x10,0x10,0x11,0x0E}, // 'C'
+	{0x1C,0x12,0x11,0x11,0x11,0x12,0x1C}, // 'D'
+	{0x1F,0x10,0x10,0x1E,0x10,0x10,0x1F}, // 'E'
+	{0x1F,0x10,0x10,0x1E,0x10,0x10,0x10}, // 'F'
+	{0x0E,0x11,0x10,0x17,0x11,0x11,0x0F}, // 'G'
+	{0x11,0x11,0x11,0x1F,0x11,0x11,0x11}, // 'H'
+	{0x0E,0x04,0x04,0x04,0x04,0x04,0x0E}, // 'I'
+	{0x07,0x02,0x02,0x02,0x02,0x12,0x0C}, // 'J'
+	{0x11,0x12,0x14,0x18,0x14,0x12,0x11}, // 'K'
+	{0x10,0x10,0x10,0x10,0x10,0x10,0x1F}, // 'L'
+	{0x11,0x1B,0x15,0x15,0x11,0x11,0x11}, // 'M'
+	{0x11,0x11,0x19,0x15,0x13,0x11,0x11}, // 'N'
+	{0x0E,0x11,0x11,0x11,0x11,0x11,0x0E}, // 'O'
+	{0x1E,0x11,0x11,0x1E,0x10,0x10,0x10}, // 'P'
+	{0x0E,0x11,0x11,0x11,0x15,0x12,0x0D}, // 'Q'
+	{0x1E,0x11,0x11,0x1E,0x14,0x12,0x11}, // 'R'
+	{0x0F,0x10,0x10,0x0E,0x01,0x01,0x1E}, // 'S'
+	{0x1F,0x04,0x04,0x04,0x04,0x04,0x04}, // 'T'
+	{0x11,0x11,0x11,0x11,0x11,0x11,0x0E}, // 'U'
+	{0x11,0x11,0x11,0x11,0x11,0x0A,0x04}, // 'V'
+	{0x11,0x11,0x11,0x15,0x15,0x15,0x0A}, // 'W'
+	{0x11,0x11,0x0A,0x04,0x0A,0x11,0x11}, // 'X'
+	{0x11,0x11,0x0A,0x04,0x04,0x04,0x04}, // 'Y'
+	{0x1F,0x01,0x02,0x04,0x08,0x10,0x1F}, // 'Z'
+	{0x0E,0x08,0x08,0x08,0x08,0x08,0x0E}, // '['
+	{0x00,0x10,0x08,0x04,0x02,0x01,0x00}, // backslash
+	{0x0E,0x02,0x02,0x02,0x02,0x02,0x0E}, // ']'
+	{0x04,0x0A,0x11,0x00,0x00,0x00,0x00}, // '^'
+	{0x00,0x00,0x00,0x00,0x00,0x00,0x1F}, // '_'
+	{0x08,0x04,0x00,0x00,0x00,0x00,0x00}, // '`'
+	{0x00,0x00,0x0E,0x01,0x0F,0x11,0x0F}, // 'a'
+	{0x10,0x10,0x16,0x19,0x11,0x11,0x1E}, // 'b'
+	{0x00,0x00,0x0E,0x10,0x10,0x11,0x0E}, // 'c'
+	{0x01,0x01,0x0D,0x13,0x11,0x11,0x0F}, // 'd'
+	{0x00,0x00,0x0E,0x11,0x1F,0x10,0x0E}, // 'e'
+	{0x06,0x09,0x08,0x1C,0x08,0x08,0x08}, // 'f'
+	{0x00,0x0F,0x11,0x11,0x0F,0x01,0x0E}, // 'g'
+	{0x10,0x10,0x16,0x19,0x11,0x11,0x11}, // 'h'
+	{0x04,0x00,0x0C,0x04,0x04,0x04,0x0E}, // 'i'
+	{0x02,0x00,0x06,0x02,0x02,0x12,0x0C}, // 'j'
+	{0x10,0x10,0x12,0x14,0x18,0x14,0x12}, // 'k'
+	{0x0C,0x04,0x04,0x04,0x04,0x04,0x0E}, // 'l'
+	{0x00,0x00,0x1A,0x15,0x15,0x11,0x11}, // 'm'
+	{0x00,0x00,0x16,0x19,0x11,0x11,0x11}, // 'n'
+	{0x00,0x00,0x0E,0x11,0x11,0x11,0x0E}, // 'o'
+	{0x00,0x00,0x1E,0x11,0x1E,0x10,0x10}, // 'p'
+	{0x00,0x00,0x0D,0x13,0x0F,0x01,0x01}, // 'q'
+	{0x00,0x00,0x16,0x19,0x10,0x10,0x10}, // 'r'
+	{0x00,0x00,0x0E,0x10,0x0E,0x01,0x1E}, // 's'
+	{0x08,0x08,0x1C,0x08,0x08,0x09,0x06}, // 't'
+	{0x00,0x00,0x11,0x11,0x11,0x13,0x0D}, // 'u'
+	{0x00,0x00,0x11,0x11,0x11,0x0A,0x04}, // 'v'
+	{0x00,0x00,0x11,0x11,0x15,0x15,0x0A}, // 'w'
+	{0x00,0x00,0x11,0x0A,0x04,0x0A,0x11}, // 'x'
+	{0x00,0x00,0x11,0x11,0x0F,0x01,0x0E}, // 'y'
+	{0x00,0x00,0x1F,0x02,0x04,0x08,0x1F}, // 'z'
+	{0x02,0x04,0x04,0x08,0x04,0x04,0x02}, // '{'
+	{0x04,0x04,0x04,0x04,0x04,0x04,0x04}, // '|'
+	{0x08,0x04,0x04,0x02,0x04,0x04,0x08}, // '}'
+	{0x00,0x00,0x08,0x15,0x02,0x00,0x00}  // '~'
+	};
+
+	const int GlyphScale	= 2;	//each font pixel becomes a 2x2 block
+	const int GlyphAdvance	= 6 * GlyphScale;
+	const int LineHeight	= 30;	//matches the framework's D3DX font height
+	const int GlyphTop		= (LineHeight - 7 * GlyphScale) / 2;
+
+	//exact x / 255 for x = a * b + 128, per 8 bit channel packed in 16 bits
+	inline unsigned int Div255Packed(unsigned int x)
+	{
+		return ((x + ((x >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+	}
+
+	inline unsigned int Modulate(unsigned int s, unsigned int color)
+	{
+		unsigned int b=((s & 0xFF) * (color & 0xFF) + 128);
+		unsigned int g=(((s >> 8) & 0xFF) * ((color >> 8) & 0xFF) + 128);
+		unsigned int r=(((s >> 16) & 0xFF) * ((color >> 16) & 0xFF) + 128);
+		unsigned int a=((s >> 24) * (color >> 24) + 128);
+		return	(((a + (a >> 8)) >> 8) << 24) | (((r + (r >> 8)) >> 8) << 16) |
+				(((g + (g >> 8)) >> 8) << 8) | ((b + (b >> 8)) >> 8);
+	}
+
+	//premultiplied source: d = s + d * (255 - a) / 255, one multiply fewer than straight alpha
+	inline unsigned int BlendPremultiplied(unsigned int s, unsigned int d)
+	{
+		unsigned int a=s >> 24;
+		if(a == 255)
+			return s;
+		if(s == 0)
+			return d;
+		unsigned int ia=255 - a;
+		unsigned int rb=Div255Packed((d & 0x00FF00FF) * ia + 0x00800080);
+		unsigned int ag=Div255Packed(((d >> 8) & 0x00FF00FF) * ia + 0x00800080);
+		return s + (rb | (ag << 8)); //no carries, every channel of s is at most a
+	}
+
+	//straight alpha, used for text whose colour is not premultiplied
+	inline unsigned int BlendPixel(unsigned int s, unsigned int d)
+	{
+		unsigned int a=s >> 24;
+		if(a == 255)
+			return s;
+		if(a == 0)
+			return d;
+		unsigned int ia=255 - a;
+		unsigned int rb=Div255Packed((s & 0x00FF00FF) * a + (d & 0x00FF00FF) * ia + 0x00800080);
+		unsigned int ag=Div255Packed(((s >> 8) & 0x00FF00FF) * a + ((d >> 8) & 0x00FF00FF) * ia + 0x00800080);
+		return rb | (ag << 8);
+	}
+
+#ifdef SOFTWARE_RENDERER_SSE2
+	inline __m128i Div255(__m128i x)
+	{
+		return _mm_srli_epi16(_mm_add_epi16(x,_mm_srli_epi16(x,8)),8);
+	}
+
+	//blends 4 premultiplied pixels, channels are widened to 16 bits two pixels at a time
+	inline __m128i Blend4(__m128i s, __m128i d, bool modulate, __m128i color16)
+	{
+		const __m128i zero=_mm_setzero_si128();
+		const __m128i round=_mm_set1_epi16(128);
+		const __m128i full=_mm_set1_epi16(255);
+
+		__m128i sLo=_mm_unpacklo_epi8(s,zero);
+		__m128i sHi=_mm_unpackhi_epi8(s,zero);
+		if(modulate)
+		{
+			sLo=Div255(_mm_add_epi16(_mm_mullo_epi16(sLo,color16),round));
+			sHi=Div255(_mm_add_epi16(_mm_mullo_epi16(sHi,color16),round));
+		}
+		__m128i aLo=_mm_shufflehi_epi16(_mm_shufflelo_epi16(sLo,0xFF),0xFF);
+		__m128i aHi=_mm_shufflehi_epi16(_mm_shufflelo_epi16(sHi,0xFF),0xFF);
+		__m128i dLo=_mm_unpacklo_epi8(d,zero);
+		__m128i dHi=_mm_unpackhi_epi8(d,zero);
+
+		__m128i lo=Div255(_mm_add_epi16(_mm_mullo_epi16(dLo,_mm_sub_epi16(full,aLo)),round));
+		__m128i hi=Div255(_mm_add_epi16(_mm_mullo_epi16(dHi,_mm_sub_epi16(full,aHi)),round));
+		return _mm_packus_epi16(_mm_add_epi16(sLo,lo),_mm_add_epi16(sHi,hi));
+	}
+#endif
+
+#ifdef SOFTWARE_RENDERER_AVX2
+	inline __m256i Div255(__m256i x)
+	{
+		return _mm256_srli_epi16(_mm256_add_epi16(x,_mm256_srli_epi16(x,8)),8);
+	}
+
+	//same as Blend4, unpack and pack both work within 128 bit lanes so order is kept
+	inline __m256i Blend8(__m256i s, __m256i d, bool modulate, __m256i color16)
+	{
+		const __m256i zero=_mm256_setzero_si256();
+		const __m256i round=_mm256_set1_epi16(128);
+		const __m256i full=_mm256_set1_epi16(255);
+
+		__m256i sLo=_mm256_unpacklo_epi8(s,zero);
+		__m256i sHi=_mm256_unpackhi_epi8(s,zero);
+		if(modulate)
+		{
+			sLo=Div255(_mm256_add_epi16(_mm256_mullo_epi16(sLo,color16),round));
+			sHi=Div255(_mm256_add_epi16(_mm256_mullo_epi16(sHi,color16),round));
+		}
+		__m256i aLo=_mm256_shufflehi_epi16(_mm256_shufflelo_epi16(sLo,0xFF),0xFF);
+		__m256i aHi=_mm256_shufflehi_epi16(_mm256_shufflelo_epi16(sHi,0xFF),0xFF);
+		__m256i dLo=_mm256_unpacklo_epi8(d,zero);
+		__m256i dHi=_mm256_unpackhi_epi8(d,zero);
+
+		__m256i lo=Div255(_mm256_add_epi16(_mm256_mullo_epi16(dLo,_mm256_sub_epi16(full,aLo)),round));
+		__m256i hi=Div255(_mm256_add_epi16(_mm256_mullo_epi16(dHi,_mm256_sub_epi16(full,aHi)),round));
+		return _mm256_packus_epi16(_mm256_add_epi16(sLo,lo),_mm256_add_epi16(sHi,hi));
+	}
+#endif
+}
+
+SoftwareRenderer::SoftwareRenderer()
+{
+	m_pTarget=&m_BackBuffer;
+	m_RenderScale=1.0f;
+}
+
+void SoftwareRenderer::Resize(int width, int height)
+{
+	m_BackBuffer.Create(width,height,0xFF000000);
+	m_pTarget=&m_BackBuffer;
+}
+
+void SoftwareRenderer::SetRenderTarget(Image* target)
+{
+	m_pTarget=target ? target : &m_BackBuffer;
+}
+
+void SoftwareRenderer::Clear(unsigned int color)
+{
+	unsigned int* pixels=m_pTarget->Pixels();
+	size_t count=(size_t)m_pTarget->Width() * m_pTarget->Height();
+	for(size_t i=0; i < count; i++)
+		pixels[i]=color;
+}
+
+bool SoftwareRenderer::Copy(const Image& image)
+{
+	if(image.Width() != m_pTarget->Width() || image.Height() != m_pTarget->Height() || image.IsEmpty())
+		return false;
+
+	memcpy(m_pTarget->Pixels(),image.Pixels(),(size_t)image.Width() * image.Height() * sizeof(unsigned int));
+	return true;
+}
+
+void SoftwareRenderer::DrawSprite(const Image& image, const ImageRect* srcRect, float centerX, float centerY, float x, float y, unsigned int color)
+{
+	if(image.IsEmpty() || m_pTarget->IsEmpty())
+		return;
+
+	//source rect, clamped to the image
+	ImageRect src={0,0,image.Width(),image.Height()};
+	if(srcRect)
+	{
+		src=*srcRect;
+		if(src.left < 0) src.left=0;
+		if(src.top < 0) src.top=0;
+		if(src.right > image.Width()) src.right=image.Width();
+		if(src.bottom > image.Height()) src.bottom=image.Height();
+	}
+
+	//pivot lands on (x,y), snapped to the nearest pixel like an untransformed D3DX sprite
+	int dstX=(int)floorf(x - centerX + 0.5f);
+	int dstY=(int)floorf(y - centerY + 0.5f);
+	int width=src.right - src.left;
+	int height=src.bottom - src.top;
+
+	//clip against the target
+	if(dstX < 0) { src.left -= dstX; width += dstX; dstX=0; }
+	if(dstY < 0) { src.top -= dstY; height += dstY; dstY=0; }
+	if(dstX + width > m_pTarget->Width()) width=m_pTarget->Width() - dstX;
+	if(dstY + height > m_pTarget->Height()) height=m_pTarget->Height() - dstY;
+	if(width <= 0 || height <= 0)
+		return;
+
+	//opaque sprites with no tint are straight copies
+	if(image.IsOpaque() && color == White)
+	{
+		for(int row=0; row < height; row++)
+			memcpy(m_pTarget->Row(dstY + row) + dstX,image.Row(src.top + row) + src.left,width * sizeof(unsigned int));
+		return;
+	}
+
+	for(int row=0; row < height; row++)
+		BlendRow(m_pTarget->Row(dstY + row) + dstX,image.Row(src.top + row) + src.left,width,color);
+}
+
+void SoftwareRenderer::BlendRow(unsigned int* dst, const unsigned int* src, int count, unsigned int color)
+{
+	bool modulate=color != White;
+	int x=0;
+
+#ifdef SOFTWARE_RENDERER_AVX2
+	{
+		const __m256i alphaMask=_mm256_set1_epi32((int)0xFF000000);
+		const __m256i zero=_mm256_setzero_si256();
+		__m256i color16=_mm256_unpacklo_epi8(_mm256_set1_epi32((int)color),zero);
+		for(; x + 8 <= count; x += 8)
+		{
+			__m256i s=_mm256_loadu_si256((const __m256i*)(src + x));
+			__m256i alpha=_mm256_and_si256(s,alphaMask);
+			if(_mm256_movemask_epi8(_mm256_cmpeq_epi32(s,zero)) == -1)
+				continue; //all transparent
+			if(!modulate && _mm256_movemask_epi8(_mm256_cmpeq_epi32(alpha,alphaMask)) == -1)
+			{
+				_mm256_storeu_si256((__m256i*)(dst + x),s); //all opaque
+				continue;
+			}
+			__m256i d=_mm256_loadu_si256((const __m256i*)(dst + x));
+			_mm256_storeu_si256((__m256i*)(dst + x),Blend8(s,d,modulate,color16));
+		}
+	}
+#endif
+
+#ifdef SOFTWARE_RENDERER_SSE2
+	{
+		const __m128i alphaMask=_mm_set1_epi32((int)0xFF000000);
+		const __m128i zero=_mm_setzero_si128();
+		__m128i color16=_mm_unpacklo_epi8(_mm_set1_epi32((int)color),zero);
+		for(; x + 4 <= count; x += 4)
+		{
+			__m128i s=_mm_loadu_si128((const __m128i*)(src + x));
+			__m128i alpha=_mm_and_si128(s,alphaMask);
+			if(_mm_movemask_epi8(_mm_cmpeq_epi32(s,zero)) == 0xFFFF)
+				continue;
+			if(!modulate && _mm_movemask_epi8(_mm_cmpeq_epi32(alpha,alphaMask)) == 0xFFFF)
+			{
+				_mm_storeu_si128((__m128i*)(dst + x),s);
+				continue;
+			}
+			__m128i d=_mm_loadu_si128((const __m128i*)(dst + x));
+			_mm_storeu_si128((__m128i*)(dst + x),Blend4(s,d,modulate,color16));
+		}
+	}
+#endif
+
+	for(; x < count; x++)
+		dst[x]=BlendPremultiplied(modulate ? Modulate(src[x],color) : src[x],dst[x]);
+}
+
+void SoftwareRenderer::FillRect(int left, int top, int right, int bottom, unsigned int color)
+{
+	if(left < 0) left=0;
+	if(top < 0) top=0;
+	if(right > m_pTarget->Width()) right=m_pTarget->Width();
+	if(bottom > m_pTarget->Height()) bottom=m_pTarget->Height();
+
+	for(int y=top; y < bottom; y++)
+	{
+		unsigned int* row=m_pTarget->Row(y);
+		for(int x=left; x < right; x++)
+			row[x]=BlendPixel(color,row[x]);
+	}
+}
+
+void SoftwareRenderer::DrawString(const wchar_t* text, ImageRect& rect, unsigned int format, unsigned int color)
+{
+	//measure the lines first so the block can be aligned
+	int lines=1, longest=0, length=0;
+	for(const wchar_t* c=text; *c; c++)
+	{
+		if(*c == L'\n')
+		{
+			lines++;
+			length=0;
+		}
+		else if(++length > longest)
+		{
+			longest=length;
+		}
+	}
+	int blockHeight=lines * LineHeight;
+
+	if(format & TEXT_CALCRECT)
+	{
+		rect.right=rect.left + longest * GlyphAdvance;
+		rect.bottom=rect.top + blockHeight;
+		return;
+	}
+
+	int y=rect.top;
+	if(format & TEXT_BOTTOM)
+		y=rect.bottom - blockHeight;
+	else if(format & TEXT_VCENTER)
+		y=(rect.top + rect.bottom - blockHeight) / 2;
+
+	const wchar_t* line=text;
+	while(line)
+	{
+		const wchar_t* end=line;
+		while(*end && *end != L'\n')
+			end++;
+		int lineWidth=(int)(end - line) * GlyphAdvance;
+
+		int x=rect.left;
+		if(format & TEXT_RIGHT)
+			x=rect.right - lineWidth;
+		else if(format & TEXT_CENTER)
+			x=(rect.left + rect.right - lineWidth) / 2;
+
+		for(const wchar_t* c=line; c != end; c++, x += GlyphAdvance)
+		{
+			int glyph=(*c >= 32 && *c < 127) ? *c - 32 : '?' - 32;
+			for(int row=0; row < 7; row++)
+			{
+				unsigned char bits=Font5x7[glyph][row];
+				for(int col=0; col < 5; col++)
+				{
+					if(bits & (0x10 >> col))
+					{
+						int px=x + col * GlyphScale;
+						int py=y + GlyphTop + row * GlyphScale;
+						FillRect(px,py,px + GlyphScale,py + GlyphScale,color);
+					}
+				}
+			}
+		}
+
+		y += LineHeight;
+		line=*end ? end + 1 : 0;
+	}
+}
+
+void SoftwareRenderer::DrawFrame(const RenderCommandList& frame, const Image* textures, int textureCount)
+{
+	if(m_BackBuffer.IsEmpty())
+		return;
+
+	//below full scale the sprites go into the scene image, sized to match
+	float scale=m_RenderScale;
+	Image* scene=&m_BackBuffer;
+	if(scale < 1.0f)
+	{
+		int width=(int)(m_BackBuffer.Width() * scale + 0.5f);
+		int height=(int)(m_BackBuffer.Height() * scale + 0.5f);
+		if(width < 1) width=1;
+		if(height < 1) height=1;
+		if(m_SceneImage.Width() != width || m_SceneImage.Height() != height)
+			m_SceneImage.Create(width,height,0);
+		scene=&m_SceneImage;
+	}
+
+	size_t first=0;
+	size_t staticCount=frame.StaticSpriteCount();
+
+	//the cache is the scene's size, so a scale change redraws it
+	if(staticCount)
+	{
+		if(m_StaticLayers.Update(frame,scene->Width(),scene->Height()))
+		{
+			//the same clear and blends the back buffer would have had
+			if(m_StaticImage.Width() != scene->Width() || m_StaticImage.Height() != scene->Height())
+				m_StaticImage.Create(scene->Width(),scene->Height(),0);
+			SetRenderTarget(&m_StaticImage);
+			Clear(frame.ClearColor());
+			for(size_t i=0; i < staticCount; i++)
+				DrawCommand(frame.Sprite(i),textures,textureCount,scale);
+		}
+		SetRenderTarget(scene);
+		Copy(m_StaticImage);
+		first=staticCount;
+	}
+	else
+	{
+		SetRenderTarget(scene);
+		Clear(frame.ClearColor());
+	}
+
+	for(size_t i=first; i < frame.SpriteCount(); i++)
+		DrawCommand(frame.Sprite(i),textures,textureCount,scale);
+
+	SetRenderTarget(0);
+	if(scene != &m_BackBuffer)
+		Upscale(*scene);
+
+	for(size_t i=0; i < frame.TextCount(); i++)
+	{
+		const TextCommand& text=frame.Text(i);
+		ImageRect layout=text.rect;
+		DrawString(frame.TextString(text),layout,text.format,text.color);
+	}
+}
+
+void SoftwareRenderer::InvalidateStaticLayers()
+{
+	m_StaticLayers.Invalidate();
+}
+
+void SoftwareRenderer::SetRenderScale(float scale)
+{
+	m_RenderScale=scale < 0.25f ? 0.25f : (scale > 1.0f ? 1.0f : scale);
+}
+
+float SoftwareRenderer::RenderScale() const
+{
+	return m_RenderScale;
+}
+
+void SoftwareRenderer::DrawCommand(const SpriteCommand& sprite, const Image* textures, int textureCount, float scale)
+{
+	static const Image NoTexture;
+	const Image& image=sprite.texture >= 0 && sprite.texture < textureCount ? textures[sprite.texture] : NoTexture;
+	const ImageRect* source=sprite.source.right ? &sprite.source : 0;
+	if(scale == 1.0f)
+		DrawSprite(image,source,sprite.centerX,sprite.centerY,sprite.x,sprite.y,sprite.color);
+	else
+		DrawSpriteScaled(image,source,sprite.centerX,sprite.centerY,sprite.x,sprite.y,sprite.color,scale);
+}
+
+void SoftwareRenderer::DrawSpriteScaled(const Image& image, const ImageRect* srcRect, float centerX, float centerY, float x, float y, unsigned int color, float scale)
+{
+	if(image.IsEmpty() || m_pTarget->IsEmpty() || scale <= 0.0f)
+		return;
+
+	ImageRect src={0,0,image.Width(),image.Height()};
+	if(srcRect)
+	{
+		src=*srcRect;
+		if(src.left < 0) src.left=0;
+		if(src.top < 0) src.top=0;
+		if(src.right > image.Width()) src.right=image.Width();
+		if(src.bottom > image.Height()) src.bottom=image.Height();
+	}
+	if(src.right <= src.left || src.bottom <= src.top)
+		return;
+
+	//where the sprite's edges land on the scaled target
+	float left=(x - centerX) * scale;
+	float top=(y - centerY) * scale;
+	int dstLeft=(int)floorf(left + 0.5f);
+	int dstTop=(int)floorf(top + 0.5f);
+	int dstRight=(int)floorf(left + (src.right - src.left) * scale + 0.5f);
+	int dstBottom=(int)floorf(top + (src.bottom - src.top) * scale + 0.5f);
+
+	if(dstLeft < 0) dstLeft=0;
+	if(dstTop < 0) dstTop=0;
+	if(dstRight > m_pTarget->Width()) dstRight=m_pTarget->Width();
+	if(dstBottom > m_pTarget->Height()) dstBottom=m_pTarget->Height();
+	int width=dstRight - dstLeft;
+	if(width <= 0 || dstBottom <= dstTop)
+		return;
+
+	//source column for every destination pixel, sampled at the pixel centre
+	float step=1.0f / scale;
+	m_Columns.resize(width);
+	for(int i=0; i < width; i++)
+	{
+		int column=src.left + (int)((dstLeft + i + 0.5f - left) * step);
+		m_Columns[i]=column < src.right ? column : src.right - 1;
+	}
+	m_Row.resize(width);
+
+	bool bCopy=image.IsOpaque() && color == White;
+	for(int row=dstTop; row < dstBottom; row++)
+	{
+		int srcY=src.top + (int)((row + 0.5f - top) * step);
+		if(srcY >= src.bottom)
+			srcY=src.bottom - 1;
+
+		const unsigned int* srcRow=image.Row(srcY);
+		unsigned int* dst=m_pTarget->Row(row) + dstLeft;
+		unsigned int* gathered=bCopy ? dst : &m_Row[0];
+		for(int i=0; i < width; i++)
+			gathered[i]=srcRow[m_Columns[i]];
+		if(!bCopy)
+			BlendRow(dst,gathered,width,color);
+	}
+}
+
+void SoftwareRenderer::Upscale(const Image& image)
+{
+	int width=m_pTarget->Width();
+	int height=m_pTarget->Height();
+	int srcWidth=image.Width();
+	int srcHeight=image.Height();
+	if(image.IsEmpty() || m_pTarget->IsEmpty())
+		return;
+
+	//7 bit weights, a channel times a weight still fits in 16 bits
+	const int One=128;
+	float stepX=(float)srcWidth / width;
+	float stepY=(float)srcHeight / height;
+
+	m_Columns.resize(width);
+	m_Weights.resize(width * 4);
+	for(int x=0; x < width; x++)
+	{
+		float fx=(x + 0.5f) * stepX - 0.5f;
+		if(fx < 0.0f) fx=0.0f;
+		int column=(int)fx;
+		if(column > srcWidth - 1) column=srcWidth - 1;
+		m_Columns[x]=column;
+		unsigned short weight=(unsigned short)(column < srcWidth - 1 ? (int)((fx - column) * One + 0.5f) : 0);
+		for(int channel=0; channel < 4; channel++)
+			m_Weights[x * 4 + channel]=weight;
+	}
+	m_Row.resize(srcWidth + 1);
+
+	for(int y=0; y < height; y++)
+	{
+		float fy=(y + 0.5f) * stepY - 0.5f;
+		if(fy < 0.0f) fy=0.0f;
+		int row=(int)fy;
+		if(row > srcHeight - 1) row=srcHeight - 1;
+		int next=row < srcHeight - 1 ? row + 1 : row;
+		unsigned int wy=(unsigned int)((fy - row) * One + 0.5f);
+
+		//vertical pass into m_Row, one source row's worth
+		const unsigned int* a=image.Row(row);
+		const unsigned int* b=image.Row(next);
+		unsigned int* blended=&m_Row[0];
+		int x=0;
+#ifdef SOFTWARE_RENDERER_SSE2
+		{
+			const __m128i zero=_mm_setzero_si128();
+			__m128i wb=_mm_set1_epi16((short)wy);
+			__m128i wa=_mm_set1_epi16((short)(One - wy));
+			for(; x + 4 <= srcWidth; x += 4)
+			{
+				__m128i va=_mm_loadu_si128((const __m128i*)(a + x));
+				__m128i vb=_mm_loadu_si128((const __m128i*)(b + x));
+				__m128i lo=_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(va,zero),wa),_mm_mullo_epi16(_mm_unpacklo_epi8(vb,zero),wb));
+				__m128i hi=_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(va,zero),wa),_mm_mullo_epi16(_mm_unpackhi_epi8(vb,zero),wb));
+				_mm_storeu_si128((__m128i*)(blended + x),_mm_packus_epi16(_mm_srli_epi16(lo,7),_mm_srli_epi16(hi,7)));
+			}
+		}
+#endif
+		for(; x < srcWidth; x++)
+		{
+			unsigned int rb=(((a[x] & 0x00FF00FF) * (One - wy) + (b[x] & 0x00FF00FF) * wy) >> 7) & 0x00FF00FF;
+			unsigned int ag=((((a[x] >> 8) & 0x00FF00FF) * (One - wy) + ((b[x] >> 8) & 0x00FF00FF) * wy) >> 7) & 0x00FF00FF;
+			blended[x]=rb | (ag << 8);
+		}
+		blended[srcWidth]=blended[srcWidth - 1]; //so the last column can always read one to its right
+
+		//horizontal pass, the neighbour pairs are gathered then blended like the rows
+		unsigned int* dst=m_pTarget->Row(y);
+		const int* columns=&m_Columns[0];
+		x=0;
+#ifdef SOFTWARE_RENDERER_SSE2
+		{
+			const __m128i zero=_mm_setzero_si128();
+			const __m128i one=_mm_set1_epi16(One);
+			for(; x + 4 <= width; x += 4)
+			{
+				__m128i p0=_mm_setr_epi32((int)blended[columns[x]],(int)blended[columns[x + 1]],(int)blended[columns[x + 2]],(int)blended[columns[x + 3]]);
+				__m128i p1=_mm_setr_epi32((int)blended[columns[x] + 1],(int)blended[columns[x + 1] + 1],(int)blended[columns[x + 2] + 1],(int)blended[columns[x + 3] + 1]);
+				__m128i wLo=_mm_loadu_si128((const __m128i*)&m_Weights[x * 4]);
+				__m128i wHi=_mm_loadu_si128((const __m128i*)&m_Weights[x * 4 + 8]);
+				__m128i lo=_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(p0,zero),_mm_sub_epi16(one,wLo)),_mm_mullo_epi16(_mm_unpacklo_epi8(p1,zero),wLo));
+				__m128i hi=_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(p0,zero),_mm_sub_epi16(one,wHi)),_mm_mullo_epi16(_mm_unpackhi_epi8(p1,zero),wHi));
+				_mm_storeu_si128((__m128i*)(dst + x),_mm_packus_epi16(_mm_srli_epi16(lo,7),_mm_srli_epi16(hi,7)));
+			}
+		}
+#endif
+		for(; x < width; x++)
+		{
+			unsigned int p0=blended[columns[x]];
+			unsigned int p1=blended[columns[x] + 1];
+			unsigned int wx=m_Weights[x * 4];
+			unsigned int rb=(((p0 & 0x00FF00FF) * (One - wx) + (p1 & 0x00FF00FF) * wx) >> 7) & 0x00FF00FF;
+			unsigned int ag=((((p0 >> 8) & 0x00FF00FF) * (One - wx) + ((p1 >> 8) & 0x00FF00FF) * wx) >> 7) & 0x00FF00FF;
+			dst[x]=rb | (ag << 8);
+		}
+	}
+}
+
+int SoftwareRenderer::Width() const
+{
+	return m_BackBuffer.Width();
+}
+
+int SoftwareRenderer::Height() const
+{
+	return m_BackBuffer.Height();
+}
+
+const Image& SoftwareRenderer::BackBuffer() const
+{
+	return m_BackBuffer;
+}
+
+bool SoftwareRenderer::SaveFrame(const char* filename) const
+{
+	return m_BackBuffer.SavePNG(filename);
+}
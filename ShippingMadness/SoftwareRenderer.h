@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////
+//Software Renderer, CPU sprite and text rasteriser used when
+//no Direct3D device is available (GPU-less or headless runs)
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Image.h"
+#include "RenderCommands.h"
+#include <vector>
+
+//Text format flags, same values as the Win32 DT_ flags so the
+//framework can hand its DrawText formats straight through
+enum
+{
+	TEXT_TOP		= 0x0000,
+	TEXT_LEFT		= 0x0000,
+	TEXT_CENTER		= 0x0001,
+	TEXT_RIGHT		= 0x0002,
+	TEXT_VCENTER	= 0x0004,
+	TEXT_BOTTOM		= 0x0008,
+	TEXT_WORDBREAK	= 0x0010,	//accepted for DrawText compatibility, lines only break on '\n'
+	TEXT_NOCLIP		= 0x0100,	//likewise, text is always clipped to the target
+	TEXT_CALCRECT	= 0x0400
+};
+
+class SoftwareRenderer
+{
+public:
+	SoftwareRenderer();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Resize
+	// Parameters:	int width, int height - size of the back buffer in pixels
+	// Return:		void
+	// Description:	(Re)allocates the ARGB back buffer and makes it the target
+	//////////////////////////////////////////////////////////////////////////
+	void	Resize(int width, int height);
+
+	//draw into another image (cached layers etc), 0 restores the back buffer
+	void	SetRenderTarget(Image* target);
+
+	void	Clear(unsigned int color);
+
+	//overwrites the target with an image of the same size, no blending,
+	//how a cached layer goes back under the rest of the frame
+	bool	Copy(const Image& image);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		DrawSprite
+	// Parameters:	const Image& image - source pixels
+	//				const ImageRect* srcRect - part of the image, 0 for all
+	//				float centerX, centerY - pivot inside the source rect
+	//				float x, y - where the pivot lands on the target
+	//				unsigned int color - ARGB modulate colour, 0xFFFFFFFF for none,
+	//					premultiplied like the image
+	// Return:		void
+	// Description:	Clips and blends premultiplied pixels (One, InvSrcAlpha), the
+	//				same state the framework gives its D3DX sprite batch.  Rows are
+	//				blended 8 pixels at a time with AVX2, 4 with SSE2.
+	//////////////////////////////////////////////////////////////////////////
+	void	DrawSprite(const Image& image, const ImageRect* srcRect, float centerX, float centerY, float x, float y, unsigned int color);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		DrawString
+	// Parameters:	const wchar_t* text - string, '\n' starts a new line
+	//				ImageRect& rect - layout rect, written back for TEXT_CALCRECT
+	//				unsigned int format - TEXT_ flags
+	//				unsigned int color - ARGB text colour
+	// Return:		void
+	// Description:	Draws text with the built in 5x7 bitmap font scaled to
+	//				roughly the size of the framework's D3DX font.
+	//////////////////////////////////////////////////////////////////////////
+	void	DrawString(const wchar_t* text, ImageRect& rect, unsigned int format, unsigned int color);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		DrawFrame
+	// Parameters:	const RenderCommandList& frame - sorted frame to play back
+	//				const Image* textures - images the sprites' texture
+	//					indices refer to
+	//				int textureCount - entries in textures
+	// Return:		void
+	// Description:	Draws a whole recorded frame into the back buffer.  The
+	//				static layers (see LAYER_FIRST_DYNAMIC) are flattened into a
+	//				cached image the first time and copied in after that, until
+	//				they change or InvalidateStaticLayers is called.  Below
+	//				full render scale the sprites go into a smaller scene image
+	//				that is upscaled bilinearly, text is drawn after that at
+	//				full resolution so it stays sharp.
+	//////////////////////////////////////////////////////////////////////////
+	void	DrawFrame(const RenderCommandList& frame, const Image* textures, int textureCount);
+	void	InvalidateStaticLayers();
+
+	//size of the scene relative to the back buffer for DrawFrame, 0.25 to 1
+	void	SetRenderScale(float scale);
+	float	RenderScale() const;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		DrawSpriteScaled
+	// Parameters:	as DrawSprite, plus
+	//				float scale - size of the target relative to the frame
+	//					coordinates, positions and the sprite are both scaled
+	// Return:		void
+	// Description:	Nearest neighbour, each destination row is gathered from
+	//				the source and then blended with the same row blender as
+	//				DrawSprite, so the cost follows the scaled pixel count.
+	//////////////////////////////////////////////////////////////////////////
+	void	DrawSpriteScaled(const Image& image, const ImageRect* srcRect, float centerX, float centerY, float x, float y, unsigned int color, float scale);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Upscale
+	// Parameters:	const Image& image - smaller image to stretch
+	// Return:		void
+	// Description:	Bilinear stretch of image over the whole target, pixel
+	//				centres aligned.  Both the vertical and the horizontal
+	//				pass blend four pixels at a time with SSE2.
+	//////////////////////////////////////////////////////////////////////////
+	void	Upscale(const Image& image);
+
+	int				Width() const;
+	int				Height() const;
+	const Image&	BackBuffer() const;
+
+	//write the back buffer to a PNG, used for headless captures
+	bool	SaveFrame(const char* filename) const;
+
+private:
+	void	BlendRow(unsigned int* dst, const unsigned int* src, int count, unsigned int color);
+	void	FillRect(int left, int top, int right, int bottom, unsigned int color);
+	void	DrawCommand(const SpriteCommand& sprite, const Image* textures, int textureCount, float scale);
+
+private:
+	Image				m_BackBuffer;
+	Image*				m_pTarget;
+	Image				m_StaticImage;	//the static layers, flattened
+	StaticLayerState	m_StaticLayers;	//what m_StaticImage was drawn from
+	float				m_RenderScale;
+	Image				m_SceneImage;	//sprites below full render scale, upscaled into the back buffer
+	std::vector<int>			m_Columns;	//scratch for DrawSpriteScaled and Upscale
+	std::vector<unsigned short>	m_Weights;	//Upscale, each column's weight once per channel
+	std::vector<unsigned int>	m_Row;
+};
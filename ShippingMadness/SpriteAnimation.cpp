@@ -0,0 +1,194 @@
+////////////////////////////////////////////////////////////////
+//SpriteAnimationTable and SpriteAnimator member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "SpriteAnimation.h"
+#include <math.h>
+
+static const ImageRect NoFrame={0,0,0,0};
+
+SpriteAnimationTable::SpriteAnimationTable()
+{
+}
+
+int SpriteAnimationTable::AddSheetClip(int sheetWidth, int sheetHeight, int frameWidth, int frameHeight, int firstCell, int frameCount, float framesPerSecond, bool bLoop)
+{
+	if(frameWidth <= 0 || frameHeight <= 0 || firstCell < 0)
+		return -1;
+
+	int columns=sheetWidth / frameWidth;
+	int cells=columns * (sheetHeight / frameHeight);
+	if(frameCount <= 0)
+		frameCount=cells - firstCell;
+	if(frameCount <= 0 || firstCell + frameCount > cells)
+		return -1;
+
+	AnimationClip clip;
+	clip.firstFrame=(int)m_Frames.size();
+	clip.frameCount=frameCount;
+	clip.framesPerSecond=framesPerSecond > 0.0f ? framesPerSecond : 0.0f;
+	clip.bLoop=bLoop;
+
+	for(int cell=firstCell; cell < firstCell + frameCount; cell++)
+	{
+		ImageRect rect;
+		rect.left=(cell % columns) * frameWidth;
+		rect.top=(cell / columns) * frameHeight;
+		rect.right=rect.left + frameWidth;
+		rect.bottom=rect.top + frameHeight;
+		m_Frames.push_back(rect);
+	}
+
+	m_Clips.push_back(clip);
+	return (int)m_Clips.size() - 1;
+}
+
+int SpriteAnimationTable::AddStripClip(int sheetWidth, int sheetHeight, float framesPerSecond, bool bLoop)
+{
+	//narrower than tall is a single frame, not an empty strip
+	int frameWidth=sheetHeight < sheetWidth ? sheetHeight : sheetWidth;
+	return AddSheetClip(sheetWidth,sheetHeight,frameWidth,sheetHeight,0,0,framesPerSecond,bLoop);
+}
+
+void SpriteAnimationTable::Clear()
+{
+	m_Clips.clear();
+	m_Frames.clear();
+}
+
+int SpriteAnimationTable::ClipCount() const
+{
+	return (int)m_Clips.size();
+}
+
+const AnimationClip& SpriteAnimationTable::Clip(int clip) const
+{
+	return m_Clips[clip];
+}
+
+int SpriteAnimationTable::FrameCount() const
+{
+	return (int)m_Frames.size();
+}
+
+const ImageRect& SpriteAnimationTable::Frame(int frame) const
+{
+	return m_Frames[frame];
+}
+
+//frame of the clip a clock lands on, wrapping (or holding) the clock at the end
+static int ClipFrame(const AnimationClip& clip, float& time)
+{
+	int frame=(int)(time * clip.framesPerSecond);
+	if(frame < clip.frameCount)
+		return frame;
+
+	//wrap the clock too, a float counting up for hours loses its fraction
+	float length=clip.frameCount / clip.framesPerSecond;
+	if(!clip.bLoop)
+	{
+		time=length;
+		return clip.frameCount - 1;
+	}
+
+	time=fmodf(time,length);
+	frame=(int)(time * clip.framesPerSecond);
+	return frame < clip.frameCount ? frame : clip.frameCount - 1;
+}
+
+SpriteAnimator::SpriteAnimator()
+{
+	m_pTable=0;
+}
+
+void SpriteAnimator::SetTable(const SpriteAnimationTable* table)
+{
+	m_pTable=table;
+}
+
+int SpriteAnimator::Add(int clip, float startTime)
+{
+	m_Clip.push_back(clip);
+	m_Time.push_back(0.0f);
+	m_Frame.push_back(m_pTable && clip >= 0 ? m_pTable->Clip(clip).firstFrame : -1);
+
+	//a zero step from the start time puts it in range and picks its frame
+	int index=(int)m_Clip.size() - 1;
+	if(m_pTable && clip >= 0)
+	{
+		float time=startTime > 0.0f ? startTime : 0.0f;
+		m_Frame[index]=m_pTable->Clip(clip).firstFrame + ClipFrame(m_pTable->Clip(clip),time);
+		m_Time[index]=time;
+	}
+	return index;
+}
+
+void SpriteAnimator::Remove(int index)
+{
+	int last=(int)m_Clip.size() - 1;
+	if(index < 0 || index > last)
+		return;
+
+	m_Clip[index]=m_Clip[last];
+	m_Time[index]=m_Time[last];
+	m_Frame[index]=m_Frame[last];
+	m_Clip.pop_back();
+	m_Time.pop_back();
+	m_Frame.pop_back();
+}
+
+void SpriteAnimator::Clear()
+{
+	m_Clip.clear();
+	m_Time.clear();
+	m_Frame.clear();
+}
+
+void SpriteAnimator::Play(int index, int clip)
+{
+	if(m_Clip[index] == clip)
+		return;
+
+	m_Clip[index]=clip;
+	m_Time[index]=0.0f;
+	m_Frame[index]=m_pTable && clip >= 0 ? m_pTable->Clip(clip).firstFrame : -1;
+}
+
+void SpriteAnimator::Advance(float dt)
+{
+	if(!m_pTable)
+		return;
+
+	int count=(int)m_Clip.size();
+	const int* clips=count ? &m_Clip[0] : 0;
+	float* times=count ? &m_Time[0] : 0;
+	int* frames=count ? &m_Frame[0] : 0;
+
+	for(int i=0; i < count; i++)
+	{
+		if(clips[i] < 0)
+			continue;
+
+		const AnimationClip& clip=m_pTable->Clip(clips[i]);
+		float time=times[i] + dt;
+		int frame=ClipFrame(clip,time);
+		times[i]=time;
+		frames[i]=clip.firstFrame + frame;
+	}
+}
+
+int SpriteAnimator::Count() const
+{
+	return (int)m_Clip.size();
+}
+
+int SpriteAnimator::FrameIndex(int index) const
+{
+	return m_Frame[index];
+}
+
+const ImageRect& SpriteAnimator::Frame(int index) const
+{
+	int frame=m_Frame[index];
+	return m_pTable && frame >= 0 ? m_pTable->Frame(frame) : NoFrame;
+}
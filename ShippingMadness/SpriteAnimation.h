@@ -0,0 +1,101 @@
+///////////////////////////////////////////////////////////////
+//Sprite Animation, sprite sheet clips flattened into one frame
+//rect table, and per entity playback state kept in parallel
+//arrays so thousands of entities advance in one tight loop
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include "Image.h"
+#include <vector>
+
+//a run of frames in the table, played at a fixed rate
+struct AnimationClip
+{
+	int		firstFrame;			//index of the first rect in the frame table
+	int		frameCount;
+	float	framesPerSecond;
+	bool	bLoop;				//false holds the last frame
+};
+
+class SpriteAnimationTable
+{
+public:
+	SpriteAnimationTable();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		AddSheetClip
+	// Parameters:	int sheetWidth, sheetHeight - size of the texture in texels
+	//				int frameWidth, frameHeight - size of one cell
+	//				int firstCell - cell the clip starts on, counted left to
+	//					right then top to bottom
+	//				int frameCount - cells in the clip, 0 for the rest of the sheet
+	//				float framesPerSecond - playback rate
+	//				bool bLoop - wrap around or stop on the last frame
+	// Return:		int - clip index, -1 if the sheet has no such cells
+	// Description:	Works every cell's rect out once and appends them to the
+	//				frame table, so playback never divides or multiplies to
+	//				find a cell.  The rects are in texels, what D3DXSprite and
+	//				the SoftwareRenderer take as a source rect.
+	//////////////////////////////////////////////////////////////////////////
+	int		AddSheetClip(int sheetWidth, int sheetHeight, int frameWidth, int frameHeight, int firstCell, int frameCount, float framesPerSecond, bool bLoop);
+
+	//a strip of square frames (cells as wide as the sheet is tall), one frame
+	//for an ordinary single image texture
+	int		AddStripClip(int sheetWidth, int sheetHeight, float framesPerSecond, bool bLoop);
+
+	void	Clear();
+
+	int						ClipCount() const;
+	const AnimationClip&	Clip(int clip) const;
+	int						FrameCount() const;
+	const ImageRect&		Frame(int frame) const;
+
+private:
+	std::vector<AnimationClip>	m_Clips;
+	std::vector<ImageRect>		m_Frames;	//every clip's rects back to back
+};
+
+class SpriteAnimator
+{
+public:
+	SpriteAnimator();
+
+	//table the clips and frames are looked up in, must outlive the animator
+	void	SetTable(const SpriteAnimationTable* table);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Add
+	// Parameters:	int clip - clip from the table to play
+	//				float startTime - seconds into the clip, so a crowd of
+	//					entities does not flap in step
+	// Return:		int - index of the new entity
+	//////////////////////////////////////////////////////////////////////////
+	int		Add(int clip, float startTime);
+
+	//swaps the last entity into index, whoever held the last index now holds this one
+	void	Remove(int index);
+	void	Clear();
+
+	//changes the clip from its first frame, keeping the same clip keeps playing
+	void	Play(int index, int clip);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Advance
+	// Parameters:	float dt - simulation time step in seconds
+	// Return:		void
+	// Description:	Moves every entity's clock on and looks up its frame in the
+	//				table.  Called from Update with the simulation step, so a
+	//				paused or slowed game animates at the same rate it moves.
+	//////////////////////////////////////////////////////////////////////////
+	void	Advance(float dt);
+
+	int					Count() const;
+	int					FrameIndex(int index) const;	//into the table, as of the last Advance
+	const ImageRect&	Frame(int index) const;			//source rect to draw the entity with
+
+private:
+	const SpriteAnimationTable*	m_pTable;
+	std::vector<int>			m_Clip;		//structure of arrays, one entry per entity
+	std::vector<float>			m_Time;		//seconds into the clip
+	std::vector<int>			m_Frame;	//frame table index, written by Advance
+};
@@ -0,0 +1,145 @@
+////////////////////////////////////////////////////////////////
+//CullSprites and ProjectileArray member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "SpriteCulling.h"
+
+//same test as the software renderer uses to pick its SSE2 path
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPRITE_CULLING_SSE2
+#include <emmintrin.h>
+#endif
+
+size_t CullSprites(const float* x, const float* y, size_t count, float halfWidth, float halfHeight, const CullRect& bounds, int* visible)
+{
+	//a sprite overlaps when its centre is inside bounds grown by its half size
+	float minX=bounds.left - halfWidth;
+	float maxX=bounds.right + halfWidth;
+	float minY=bounds.top - halfHeight;
+	float maxY=bounds.bottom + halfHeight;
+
+	size_t kept=0;
+	size_t i=0;
+
+#ifdef SPRITE_CULLING_SSE2
+	__m128 vMinX=_mm_set1_ps(minX);
+	__m128 vMaxX=_mm_set1_ps(maxX);
+	__m128 vMinY=_mm_set1_ps(minY);
+	__m128 vMaxY=_mm_set1_ps(maxY);
+	for(; i + 4 <= count; i+=4)
+	{
+		__m128 vx=_mm_loadu_ps(x + i);
+		__m128 vy=_mm_loadu_ps(y + i);
+		__m128 inside=_mm_and_ps(_mm_and_ps(_mm_cmpgt_ps(vx,vMinX),_mm_cmplt_ps(vx,vMaxX)),
+								 _mm_and_ps(_mm_cmpgt_ps(vy,vMinY),_mm_cmplt_ps(vy,vMaxY)));
+		int mask=_mm_movemask_ps(inside);
+		if(!mask)
+			continue;
+
+		//always write, only advance past the ones that are in
+		visible[kept]=(int)i;		kept+=mask & 1;
+		visible[kept]=(int)i + 1;	kept+=(mask >> 1) & 1;
+		visible[kept]=(int)i + 2;	kept+=(mask >> 2) & 1;
+		visible[kept]=(int)i + 3;	kept+=(mask >> 3) & 1;
+	}
+#endif
+
+	for(; i < count; i++)
+	{
+		visible[kept]=(int)i;
+		kept+=(x[i] > minX && x[i] < maxX && y[i] > minY && y[i] < maxY) ? 1 : 0;
+	}
+	return kept;
+}
+
+ProjectileArray::ProjectileArray()
+{
+}
+
+void ProjectileArray::Add(float x, float y, float velocityX, float velocityY)
+{
+	m_X.push_back(x);
+	m_Y.push_back(y);
+	m_VelocityX.push_back(velocityX);
+	m_VelocityY.push_back(velocityY);
+}
+
+void ProjectileArray::Remove(int index)
+{
+	if(index < 0 || index >= Count())
+		return;
+
+	m_X.erase(m_X.begin() + index);
+	m_Y.erase(m_Y.begin() + index);
+	m_VelocityX.erase(m_VelocityX.begin() + index);
+	m_VelocityY.erase(m_VelocityY.begin() + index);
+}
+
+void ProjectileArray::Clear()
+{
+	m_X.clear();
+	m_Y.clear();
+	m_VelocityX.clear();
+	m_VelocityY.clear();
+}
+
+void ProjectileArray::Step(float dt)
+{
+	int count=Count();
+	for(int i=0; i < count; i++)
+	{
+		m_X[i]+=m_VelocityX[i] * dt;
+		m_Y[i]+=m_VelocityY[i] * dt;
+	}
+}
+
+int ProjectileArray::Retire(const CullRect& bounds, float halfWidth, float halfHeight)
+{
+	int count=Count();
+	if(!count)
+		return 0;
+
+	m_Visible.resize(count);
+	int kept=(int)CullSprites(&m_X[0],&m_Y[0],count,halfWidth,halfHeight,bounds,&m_Visible[0]);
+	if(kept == count)
+		return 0;
+
+	//survivors come back in ascending order, so they can be packed down in place
+	for(int i=0; i < kept; i++)
+	{
+		int from=m_Visible[i];
+		m_X[i]=m_X[from];
+		m_Y[i]=m_Y[from];
+		m_VelocityX[i]=m_VelocityX[from];
+		m_VelocityY[i]=m_VelocityY[from];
+	}
+	m_X.resize(kept);
+	m_Y.resize(kept);
+	m_VelocityX.resize(kept);
+	m_VelocityY.resize(kept);
+	return count - kept;
+}
+
+const std::vector<int>& ProjectileArray::Cull(const CullRect& bounds, float halfWidth, float halfHeight)
+{
+	int count=Count();
+	m_Visible.resize(count);
+	if(count)
+		m_Visible.resize(CullSprites(&m_X[0],&m_Y[0],count,halfWidth,halfHeight,bounds,&m_Visible[0]));
+	return m_Visible;
+}
+
+int ProjectileArray::Count() const
+{
+	return (int)m_X.size();
+}
+
+float ProjectileArray::X(int index) const
+{
+	return m_X[index];
+}
+
+float ProjectileArray::Y(int index) const
+{
+	return m_Y[index];
+}
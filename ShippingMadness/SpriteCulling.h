@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////
+//Sprite Culling, finds which of a batch of sprites overlap a
+//region, run over plain position arrays four at a time
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+//region in screen pixels, right and bottom exclusive like ImageRect
+struct CullRect
+{
+	float left;
+	float top;
+	float right;
+	float bottom;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Name:		CullSprites
+// Parameters:	const float* x, y - sprite centres, count of each
+//				size_t count - sprites in the batch
+//				float halfWidth, halfHeight - half the size every sprite
+//					in the batch shares
+//				const CullRect& bounds - region to keep
+//				int* visible - receives the indices, room for count of them
+// Return:		size_t - sprites overlapping bounds, written to visible in
+//				ascending order
+// Description:	Compares four centres per step with SSE2 and writes the
+//				survivors without branching, scalar for the rest.
+//////////////////////////////////////////////////////////////////////////
+size_t CullSprites(const float* x, const float* y, size_t count, float halfWidth, float halfHeight, const CullRect& bounds, int* visible);
+
+//Projectiles in structure of arrays form, moved and retired in bulk
+class ProjectileArray
+{
+public:
+	ProjectileArray();
+
+	void	Add(float x, float y, float velocityX, float velocityY);
+	void	Remove(int index);	//keeps the order of the rest
+	void	Clear();
+
+	//moves every projectile by its velocity, dt in seconds
+	void	Step(float dt);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Retire
+	// Parameters:	const CullRect& bounds - play area
+	//				float halfWidth, halfHeight - projectile sprite half size
+	// Return:		int - projectiles removed
+	// Description:	Drops every projectile no longer overlapping bounds, so
+	//				shots that fly off screen stop costing update and draw time.
+	//////////////////////////////////////////////////////////////////////////
+	int		Retire(const CullRect& bounds, float halfWidth, float halfHeight);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Cull
+	// Parameters:	const CullRect& bounds - usually the viewport
+	//				float halfWidth, halfHeight - projectile sprite half size
+	// Return:		const std::vector<int>& - indices to draw, valid until the
+	//				next call that changes the array
+	//////////////////////////////////////////////////////////////////////////
+	const std::vector<int>&	Cull(const CullRect& bounds, float halfWidth, float halfHeight);
+
+	int		Count() const;
+	float	X(int index) const;
+	float	Y(int index) const;
+
+private:
+	std::vector<float>	m_X;
+	std::vector<float>	m_Y;
+	std::vector<float>	m_VelocityX;
+	std::vector<float>	m_VelocityY;
+	std::vector<int>	m_Visible;	//scratch for Cull and Retire
+};
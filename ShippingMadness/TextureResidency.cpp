@@ -0,0 +1,144 @@
+////////////////////////////////////////////////////////////////
+//TextureResidency member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "TextureResidency.h"
+
+TextureResidency::TextureResidency()
+{
+	Reset(0,0);
+}
+
+void TextureResidency::Reset(int count, size_t budgetBytes)
+{
+	Entry empty={0,-1,-1,-1,false};
+	m_Entries.assign(count > 0 ? count : 0,empty);
+	m_Missing.clear();
+	m_Head=-1;
+	m_Tail=-1;
+	m_Frame=0;
+	m_Budget=budgetBytes;
+	m_Resident=0;
+	m_Loads=0;
+	m_Evictions=0;
+}
+
+void TextureResidency::SetLoaded(int texture, size_t bytes)
+{
+	if(texture < 0 || texture >= (int)m_Entries.size())
+		return;
+
+	Entry& entry=m_Entries[texture];
+	if(entry.bResident)
+	{
+		m_Resident-=entry.bytes;
+		Unlink(texture);
+	}
+	entry.bytes=bytes;
+	entry.bResident=true;
+	m_Resident+=bytes;
+	m_Loads++;
+
+	//counts as used now, so a texture loaded for this frame is not the first to go
+	PushFront(texture);
+}
+
+void TextureResidency::SetEvicted(int texture)
+{
+	if(texture < 0 || texture >= (int)m_Entries.size() || !m_Entries[texture].bResident)
+		return;
+
+	Entry& entry=m_Entries[texture];
+	Unlink(texture);
+	m_Resident-=entry.bytes;
+	entry.bResident=false;
+	m_Evictions++;
+}
+
+bool TextureResidency::IsResident(int texture) const
+{
+	return texture >= 0 && texture < (int)m_Entries.size() && m_Entries[texture].bResident;
+}
+
+const std::vector<int>& TextureResidency::BeginFrame(const RenderCommandList& frame)
+{
+	m_Frame++;
+	m_Missing.clear();
+
+	int count=(int)m_Entries.size();
+	for(size_t i=0; i < frame.SpriteCount(); i++)
+	{
+		int texture=frame.Sprite(i).texture;
+		if(texture < 0 || texture >= count || m_Entries[texture].lastUsed == m_Frame)
+			continue;
+
+		Entry& entry=m_Entries[texture];
+		entry.lastUsed=m_Frame;
+		if(entry.bResident)
+		{
+			Unlink(texture);
+			PushFront(texture);
+		}
+		else
+			m_Missing.push_back(texture);
+	}
+	return m_Missing;
+}
+
+int TextureResidency::NextEviction() const
+{
+	if(!m_Budget || m_Resident <= m_Budget || m_Tail < 0)
+		return -1;
+
+	//the list is in order of use, once the tail was used this frame so was everything else
+	if(m_Entries[m_Tail].lastUsed == m_Frame)
+		return -1;
+	return m_Tail;
+}
+
+size_t TextureResidency::ResidentBytes() const
+{
+	return m_Resident;
+}
+
+size_t TextureResidency::Budget() const
+{
+	return m_Budget;
+}
+
+int TextureResidency::Loads() const
+{
+	return m_Loads;
+}
+
+int TextureResidency::Evictions() const
+{
+	return m_Evictions;
+}
+
+void TextureResidency::Unlink(int texture)
+{
+	Entry& entry=m_Entries[texture];
+	if(entry.prev >= 0)
+		m_Entries[entry.prev].next=entry.next;
+	else if(m_Head == texture)
+		m_Head=entry.next;
+	if(entry.next >= 0)
+		m_Entries[entry.next].prev=entry.prev;
+	else if(m_Tail == texture)
+		m_Tail=entry.prev;
+	entry.prev=-1;
+	entry.next=-1;
+}
+
+void TextureResidency::PushFront(int texture)
+{
+	Entry& entry=m_Entries[texture];
+	entry.prev=-1;
+	entry.next=m_Head;
+	if(m_Head >= 0)
+		m_Entries[m_Head].prev=texture;
+	m_Head=texture;
+	if(m_Tail < 0)
+		m_Tail=texture;
+}
@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////
+//Texture Residency, which textures are loaded, how much memory
+//they take and which one was used longest ago, so a renderer
+//can keep its textures under a budget.  Only the bookkeeping,
+//the renderer loads and releases the textures itself
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include "RenderCommands.h"
+#include <stddef.h>
+#include <vector>
+
+class TextureResidency
+{
+public:
+	TextureResidency();
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Reset
+	// Parameters:	int count - textures tracked, indices 0 to count - 1
+	//				size_t budgetBytes - memory the resident textures may
+	//					take, 0 for no limit
+	// Return:		void
+	// Description:	Forgets everything, every texture starts out not resident.
+	//////////////////////////////////////////////////////////////////////////
+	void	Reset(int count, size_t budgetBytes);
+
+	void	SetLoaded(int texture, size_t bytes);	//the renderer just loaded it
+	void	SetEvicted(int texture);				//the renderer just released it
+	bool	IsResident(int texture) const;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		BeginFrame
+	// Parameters:	const RenderCommandList& frame - sorted frame about to be drawn
+	// Return:		const std::vector<int>& - textures the frame draws that
+	//				are not resident, load them before drawing
+	// Description:	Starts a new frame and marks every texture the frame
+	//				uses as the most recently used.  The list is sorted by
+	//				layer and texture, so each run of one texture costs a
+	//				single move to the front.
+	//////////////////////////////////////////////////////////////////////////
+	const std::vector<int>&	BeginFrame(const RenderCommandList& frame);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		NextEviction
+	// Parameters:	void
+	// Return:		int - least recently used resident texture while over
+	//				budget, -1 once under budget or when everything left
+	//				was used this frame
+	// Description:	Call after drawing, release each texture it returns and
+	//				report it with SetEvicted before asking again.
+	//////////////////////////////////////////////////////////////////////////
+	int		NextEviction() const;
+
+	size_t	ResidentBytes() const;
+	size_t	Budget() const;
+	int		Loads() const;		//since Reset, including the first load of each texture
+	int		Evictions() const;
+
+private:
+	void	Unlink(int texture);
+	void	PushFront(int texture);
+
+private:
+	struct Entry
+	{
+		size_t	bytes;
+		int		lastUsed;	//frame number, -1 if never drawn
+		int		prev;		//recently used list, most recent at m_Head
+		int		next;
+		bool	bResident;
+	};
+
+	std::vector<Entry>	m_Entries;
+	std::vector<int>	m_Missing;		//returned by BeginFrame
+	int					m_Head;			//most recently used resident texture
+	int					m_Tail;			//least recently used, evicted first
+	int					m_Frame;
+	size_t				m_Budget;
+	size_t				m_Resident;
+	int					m_Loads;
+	int					m_Evictions;
+};
@@ -0,0 +1,199 @@
+////////////////////////////////////////////////////////////////
+//TraceLog member function definitions
+////////////////////////////////////////////////////////////////
+
+#include "TraceLog.h"
+#include "FramePacer.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <stdio.h>
+
+static const size_t MaxSpans=100000;
+
+struct TraceSpan
+{
+	const char*	name;
+	std::string	detail;
+	double		start;		//seconds since Start, the end too
+	double		end;
+	int			thread;		//index in Threads
+	bool		bMark;
+};
+
+struct TraceThread
+{
+	std::thread::id	id;
+	std::string		name;
+};
+
+//the whole log, the spans and threads under Lock
+static std::atomic<bool>			Enabled(false);
+static std::mutex					Lock;
+static std::string					Filename;
+static double						Epoch=0.0;
+static std::vector<TraceSpan>		Spans;
+static std::vector<TraceThread>		Threads;
+
+//the calling thread's row, added the first time it records.  Call with Lock held
+static int ThreadIndex()
+{
+	std::thread::id id=std::this_thread::get_id();
+	for(size_t i=0; i < Threads.size(); i++)
+	{
+		if(Threads[i].id == id)
+			return (int)i;
+	}
+
+	TraceThread thread;
+	thread.id=id;
+	Threads.push_back(thread);
+	return (int)Threads.size() - 1;
+}
+
+//a span or mark on the calling thread's row, dropped once the log is full or stopped
+static void AddSpan(const char* name, const std::string& detail, double start, double end, bool bMark)
+{
+	std::lock_guard<std::mutex> lock(Lock);
+	if(!Enabled || Spans.size() >= MaxSpans)
+		return;
+
+	TraceSpan span;
+	span.name=name;
+	span.detail=detail;
+	span.start=start - Epoch;
+	span.end=end - Epoch;
+	span.thread=ThreadIndex();
+	span.bMark=bMark;
+	Spans.push_back(span);
+}
+
+//quotes and backslashes escaped, control characters dropped
+static void WriteString(FILE* file, const char* text)
+{
+	fputc('"',file);
+	for(; *text; text++)
+	{
+		if(*text == '"' || *text == '\\')
+			fputc('\\',file);
+		if((unsigned char)*text >= 0x20)
+			fputc(*text,file);
+	}
+	fputc('"',file);
+}
+
+void TraceLog::Start(const char* filename)
+{
+	std::lock_guard<std::mutex> lock(Lock);
+	Filename=filename ? filename : "";
+	Epoch=FramePacer::Now();
+	Spans.clear();
+	Spans.reserve(4096);
+	Threads.clear();
+	Enabled=!Filename.empty();
+}
+
+bool TraceLog::IsEnabled()
+{
+	return Enabled.load(std::memory_order_relaxed);
+}
+
+void TraceLog::NameThread(const char* name)
+{
+	if(!IsEnabled())
+		return;
+
+	std::lock_guard<std::mutex> lock(Lock);
+	Threads[ThreadIndex()].name=name;
+}
+
+void TraceLog::Record(const char* name, const std::string& detail, double start, double end)
+{
+	if(IsEnabled())
+		AddSpan(name,detail,start,end,false);
+}
+
+void TraceLog::Mark(const char* name)
+{
+	if(!IsEnabled())
+		return;
+
+	double now=FramePacer::Now();
+	AddSpan(name,std::string(),now,now,true);
+}
+
+bool TraceLog::Write()
+{
+	if(!IsEnabled())
+		return true;
+
+	std::lock_guard<std::mutex> lock(Lock);
+	Enabled=false;
+
+	FILE* file=fopen(Filename.c_str(),"w");
+	if(!file)
+		return false;
+
+	//microseconds, one row per thread, named where the host named it
+	fprintf(file,"{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	fprintf(file,"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"Shipping Madness\"}}");
+	for(size_t i=0; i < Threads.size(); i++)
+	{
+		if(Threads[i].name.empty())
+			continue;
+		fprintf(file,",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",(int)i + 1);
+		WriteString(file,Threads[i].name.c_str());
+		fprintf(file,"}}");
+	}
+
+	for(size_t i=0; i < Spans.size(); i++)
+	{
+		const TraceSpan& span=Spans[i];
+		fprintf(file,",\n{\"name\":");
+		WriteString(file,span.name);
+		if(span.bMark)
+			fprintf(file,",\"ph\":\"i\",\"s\":\"p\",\"ts\":%.3f",span.start * 1e6);
+		else
+			fprintf(file,",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f",span.start * 1e6,(span.end - span.start) * 1e6);
+		fprintf(file,",\"pid\":1,\"tid\":%d",span.thread + 1);
+		if(!span.detail.empty())
+		{
+			fprintf(file,",\"args\":{\"asset\":");
+			WriteString(file,span.detail.c_str());
+			fprintf(file,"}");
+		}
+		fprintf(file,"}");
+	}
+	fprintf(file,"\n]}\n");
+
+	bool bWritten=!ferror(file);
+	if(fclose(file) != 0)
+		bWritten=false;
+	Spans.clear();
+	Threads.clear();
+	return bWritten;
+}
+
+TraceScope::TraceScope(const char* name)
+{
+	m_Name=name;
+	m_Start=TraceLog::IsEnabled() ? FramePacer::Now() : 0.0;
+}
+
+TraceScope::TraceScope(const char* name, const std::string& detail)
+{
+	m_Name=name;
+	m_Start=0.0;
+	if(TraceLog::IsEnabled())
+	{
+		m_Detail=detail; //only copied when it will be written
+		m_Start=FramePacer::Now();
+	}
+}
+
+TraceScope::~TraceScope()
+{
+	if(m_Start != 0.0)
+		TraceLog::Record(m_Name,m_Detail,m_Start,FramePacer::Now());
+}
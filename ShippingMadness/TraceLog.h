@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////
+//Trace Log, timed spans from every thread written out as Chrome
+//trace JSON (chrome://tracing or ui.perfetto.dev) so the startup
+//timeline shows which work is on the path to the first frame.
+//Off unless a host starts it, a TraceScope then costs one atomic
+//load.  Times come from FramePacer::Now
+///////////////////////////////////////////////////////////////
+#pragma once
+
+#include <string>
+
+class TraceLog
+{
+public:
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Start
+	// Parameters:	const char* filename - where Write puts the JSON
+	// Return:		void
+	// Description:	Times are from this call.  Call it before the threads
+	//				being traced start, then Record is safe from any thread.
+	//////////////////////////////////////////////////////////////////////////
+	static void	Start(const char* filename);
+	static bool	IsEnabled();
+
+	//shown as the calling thread's name in the viewer
+	static void	NameThread(const char* name);
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Record
+	// Parameters:	const char* name - what ran, a literal
+	//				const std::string& detail - the asset or file it ran
+	//					for, empty for none
+	//				double start, end - FramePacer::Now() before and after
+	// Return:		void
+	// Description:	One span on the calling thread's row.  Past 100000
+	//				spans the rest are dropped.
+	//////////////////////////////////////////////////////////////////////////
+	static void	Record(const char* name, const std::string& detail, double start, double end);
+	static void	Mark(const char* name); //instant event, the first frame
+
+	//////////////////////////////////////////////////////////////////////////
+	// Name:		Write
+	// Parameters:	void
+	// Return:		bool - false if the file couldn't be written
+	// Description:	Call on exit once the traced threads have stopped.  The
+	//				log stops with it, so a second call writes nothing.
+	//////////////////////////////////////////////////////////////////////////
+	static bool	Write();
+};
+
+//records the span from construction to destruction when the log is on
+class TraceScope
+{
+public:
+	explicit TraceScope(const char* name);
+	TraceScope(const char* name, const std::string& detail);
+	~TraceScope();
+
+private:
+	const char*	m_Name;
+	std::string	m_Detail;
+	double		m_Start;	//0 when the log was off
+};
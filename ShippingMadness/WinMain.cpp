@@ -31,6 +31,7 @@ using namespace std;
 HWND				g_hWnd;			// Handle to the window
 HINSTANCE			g_hInstance;	// Handle to the application instance
 bool				g_bWindowed;	// Boolean for windowed or full-screen
+bool				g_bHeadless;	// Hidden borderless window for automated runs (-regress)
 
 //*************************************************************************
 // This is where you declare the instance of your DirectXFramework Class
@@ -67,7 +68,7 @@ void InitWindow(void)
 
 	g_hWnd = CreateWindow(
 		WINDOW_TITLE, WINDOW_TITLE, 							// window class name and title
-		g_bWindowed ? WS_OVERLAPPEDWINDOW | WS_VISIBLE:(WS_POPUP | WS_VISIBLE),// window style
+		g_bHeadless ? WS_POPUP : g_bWindowed ? WS_OVERLAPPEDWINDOW | WS_VISIBLE:(WS_POPUP | WS_VISIBLE),// window style, headless keeps the client area exactly 800x600
 		CW_USEDEFAULT, CW_USEDEFAULT,							// x and y coordinates
 		SCREEN_WIDTH, SCREEN_HEIGHT,							// width and height of window
 		NULL, NULL,												// parent window and menu
@@ -75,17 +76,47 @@ void InitWindow(void)
 		NULL);
 
 	// Display the window
-	ShowWindow(g_hWnd, SW_SHOW);
-	UpdateWindow(g_hWnd);
+	if(!g_bHeadless)
+	{
+		ShowWindow(g_hWnd, SW_SHOW);
+		UpdateWindow(g_hWnd);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Returns the word after name on the command line, or def if it isn't there
+//////////////////////////////////////////////////////////////////////////
+std::string CommandLineValue(const wchar_t* cmdLine, const wchar_t* name, const char* def)
+{
+	const wchar_t* arg=wcsstr(cmdLine,name);
+	if(!arg)
+		return def;
+
+	arg+=wcslen(name);
+	while(*arg == L' ')
+		arg++;
+
+	std::string value;
+	while(*arg && *arg != L' ')
+		value+=(char)*arg++;
+	return value.empty() || value[0] == '-' ? def : value; //next switch, no value given
 }
 
 int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPTSTR lpCmdLine, int nCmdShow )
 {
 	g_hInstance = hInstance;	// Store application handle
 	g_bWindowed = true;			// Windowed mode or full-screen
+	g_bHeadless = wcsstr(lpCmdLine,L"-regress") != 0;
+
+	// -trace [file] times the startup on every thread, written as Chrome trace
+	// JSON on exit (startup_trace.json by default), for chrome://tracing or Perfetto
+	if(wcsstr(lpCmdLine,L"-trace"))
+		TraceLog::Start(CommandLineValue(lpCmdLine,L"-trace","startup_trace.json").c_str());
 
 	// Init the window
+	double windowStart=FramePacer::Now();
 	InitWindow();
+	TraceLog::Record("Create window",std::string(),windowStart,FramePacer::Now());
 	
 	// Use this msg structure to catch window messages
 	MSG msg; 
@@ -101,7 +132,50 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPTSTR lpCmdLi
 	
 	//*************************************************************************
 	// Initialize DirectX/Game here (call the Init method of your framwork)
+	// -software renders on the CPU, Init also falls back to it without a GPU
+	if(wcsstr(lpCmdLine,L"-software"))
+		DirectFrame.UseSoftwareRenderer(true);
+	// -vsync, -unlimited (benchmarking) or -fps N, the default is a 60fps cap
+	const wchar_t* fpsArg=wcsstr(lpCmdLine,L"-fps");
+	if(wcsstr(lpCmdLine,L"-vsync"))
+		DirectFrame.SetPacing(PACE_VSYNC,60.0);
+	else if(wcsstr(lpCmdLine,L"-unlimited"))
+		DirectFrame.SetPacing(PACE_UNLIMITED,0.0);
+	else if(fpsArg && _wtof(fpsArg + 4) > 0.0)
+		DirectFrame.SetPacing(PACE_CAPPED,_wtof(fpsArg + 4));
+	// -fullres keeps the scene at full resolution however long frames take to draw
+	if(wcsstr(lpCmdLine,L"-fullres"))
+		DirectFrame.SetDynamicResolution(false);
+	// -serialload loads every asset one after another before the first frame, to compare with
+	if(wcsstr(lpCmdLine,L"-serialload"))
+		DirectFrame.SetSerialLoad(true);
+	// -nocache decodes every texture file instead of reading texturecache\ from the last run
+	if(wcsstr(lpCmdLine,L"-nocache"))
+		DirectFrame.SetImageCache(false);
+	// -texbudget MB caps the memory textures may take, 0 for no limit, 64 by default
+	if(wcsstr(lpCmdLine,L"-texbudget"))
+		DirectFrame.SetTextureBudget((size_t)(atof(CommandLineValue(lpCmdLine,L"-texbudget","64").c_str()) * 1024 * 1024));
+	// -regress [dir] renders the golden frame scenarios headlessly and exits with
+	// the number of failures, -update rewrites the goldens, -tolerance N per channel
+	// slack.  The report and failed frames go to -reportdir dir (regression\ by default)
+	if(g_bHeadless)
+		DirectFrame.SetHeadless(true);
 	DirectFrame.Init(g_hWnd,g_hInstance,g_bWindowed);
+	if(g_bHeadless)
+	{
+		// report to the console that started us, if any
+		if(AttachConsole(ATTACH_PARENT_PROCESS))
+			freopen("CONOUT$","w",stdout);
+
+		int failures=DirectFrame.RunRegression(CommandLineValue(lpCmdLine,L"-regress","goldens").c_str(),
+			CommandLineValue(lpCmdLine,L"-reportdir","regression").c_str(),
+			atoi(CommandLineValue(lpCmdLine,L"-tolerance","2").c_str()),wcsstr(lpCmdLine,L"-update") != 0);
+		DirectFrame.Shutdown();
+		TraceLog::Write();
+		DestroyWindow(g_hWnd);
+		UnregisterClass(WINDOW_TITLE, g_hInstance);
+		return failures;
+	}
 
 	//*************************************************************************
 
@@ -121,13 +195,17 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPTSTR lpCmdLi
 		float dt = (currTimeStamp - prevTimeStamp) * secsPerCnt;
 
 		DirectFrame.Update(dt); //Update the frame
-		DirectFrame.Render(dt); //render the updated frame
+		DirectFrame.Render(dt); //record the updated frame, the render thread draws it
+		DirectFrame.Pace(); //wait for the next frame slot
 
 		prevTimeStamp=currTimeStamp;
 
 		//*************************************************************************
 
 	}
+	//stop the render thread now, not during static destruction after wWinMain returns
+	DirectFrame.Shutdown();
+	TraceLog::Write();
 	return (int)msg.wParam;
 	//*************************************************************************
 	//Shutdown DirectXFramework/Game here
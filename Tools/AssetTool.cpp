@@ -0,0 +1,820 @@
+//////////////////////////////////////////////////////////////////////////
+// Name:	AssetTool.cpp
+// Purpose: Offline asset conversion for ShippingMadness, runs on any
+//			machine with a C++ compiler (the build and art machines are
+//			Linux), no Direct3D needed.
+//
+//			g++ -O2 -std=c++11 -pthread -I../ShippingMadness -o assettool AssetTool.cpp
+//				../ShippingMadness/Image.cpp ../ShippingMadness/DDSTexture.cpp
+//				../ShippingMadness/AssetArchive.cpp ../ShippingMadness/ImageCache.cpp
+//				../ShippingMadness/AudioClip.cpp ../ShippingMadness/AudioSink.cpp
+//				../ShippingMadness/AudioMixer.cpp ../ShippingMadness/AudioResampler.cpp
+//				../ShippingMadness/AudioStream.cpp ../ShippingMadness/TraceLog.cpp
+//				../ShippingMadness/FramePacer.cpp ../ShippingMadness/Mp3Decoder.cpp
+//
+//			Add -mavx to have the mixer's and resampler's AVX loops built in.
+//
+// Commands:
+//			premultiply [-key AARRGGBB] file.png ...
+//				Turns the colour key (default FF00FF00, pure green) into
+//				real transparency, premultiplies and writes file.pma.png
+//				next to each source.  The game loads the .pma.png files
+//				without a colour key and blends them with (One, InvSrcAlpha).
+//
+//			dds [-bc1 | -bc3] [-nomips] file.pma.png ...
+//				Block compresses each premultiplied PNG with its full mip
+//				chain and writes file.dds.  BC1 is picked when every texel
+//				of every mip is fully opaque or fully transparent, BC3
+//				otherwise, unless forced.
+//
+//			wav file.mp3 ...
+//				Decodes each MPEG-1 Layer III file and writes file.wav next
+//				to it, 16 bit stereo PCM at the file's own rate.  The SDL
+//				build streams its music from these, the Windows build plays
+//				the .mp3 through FMOD.  Commit both after a change.
+//
+//			pack [-o assets.pak] directory
+//				Packs every file the game loads from the directory (.dds,
+//				.pma.png, .wav, .mp3 and .otf) into one AssetArchive, written
+//				to directory/assets.pak by default.  The game maps it and
+//				falls back to the loose files without it, rerun after any
+//				of them changes.
+//
+//			loadbench [-runs N] directory
+//				Times the startup conversions of every texture in the
+//				directory (PNG decode, and DDS decompress for the software
+//				renderer) without the image cache, into an empty cache (a
+//				cold start) and out of the filled cache (a warm start).
+//				Best of N runs, 5 by default.  The cache is written to
+//				directory/benchcache and left there for inspection.
+//
+//			mixbench [-voices N] [-seconds S] directory
+//				Loops N voices (64 by default) over the directory's .wav
+//				files through the AudioMixer into a null sink for S seconds
+//				of sound (10 by default), panning and fading them as it
+//				goes, once with each mixing loop built in.  Prints the CPU
+//				time a second of sound takes and how many voices one core
+//				could keep mixing in real time.
+//
+//			resamplebench [-seconds S]
+//				Converts test tones between the rates the game's sounds
+//				come in and the mixer's, S seconds of output each (2 by
+//				default), once with each filter loop built in, and prints
+//				the CPU cycles an output frame takes.  Then checks the best
+//				loop's output against the tone worked out exactly at the
+//				output rate: the worst signal to noise ratio over tones up
+//				to 0.3 of the lower rate, and for conversions down by a
+//				half or more how far under a tone the output can't hold is
+//				pushed.  Linear interpolation, what clips were loaded with
+//				before, is measured beside it.
+//////////////////////////////////////////////////////////////////////////
+#include "Image.h"
+#include "DDSTexture.h"
+#include "AssetArchive.h"
+#include "ImageCache.h"
+#include "AudioMixer.h"
+#include "Mp3Decoder.h"
+#include <chrono>
+#include <dirent.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+static const unsigned int DefaultColorKey=0xFF00FF00; //D3DCOLOR_XRGB(0,255,0), what the game used to pass D3DX
+
+//file.png -> file<suffix>
+static std::string ReplaceExtension(const std::string& filename, const char* suffix)
+{
+	size_t dot=filename.rfind('.');
+	size_t slash=filename.find_last_of("/\\");
+	if(dot == std::string::npos || (slash != std::string::npos && dot < slash))
+		return filename + suffix;
+	return filename.substr(0,dot) + suffix;
+}
+
+static bool EndsWith(const std::string& text, const char* ending)
+{
+	size_t length=strlen(ending);
+	return text.size() >= length && text.compare(text.size() - length,length,ending) == 0;
+}
+
+static int Premultiply(int argc, char** argv)
+{
+	unsigned int key=DefaultColorKey;
+	int converted=0, failed=0;
+
+	for(int i=0; i < argc; i++)
+	{
+		if(!strcmp(argv[i],"-key") && i + 1 < argc)
+		{
+			key=(unsigned int)strtoul(argv[++i],0,16);
+			continue;
+		}
+
+		std::string source=argv[i];
+		if(EndsWith(source,".pma.png"))
+			continue; //already converted, lets "assettool premultiply *.png" be rerun
+
+		Image image;
+		if(!image.LoadPNG(source.c_str()))
+		{
+			fprintf(stderr,"%s: not a readable PNG\n",source.c_str());
+			failed++;
+			continue;
+		}
+
+		image.ColorKey(key);
+		image.Premultiply();
+
+		std::string output=ReplaceExtension(source,".pma.png");
+		if(!image.SavePNG(output.c_str()))
+		{
+			fprintf(stderr,"%s: could not write\n",output.c_str());
+			failed++;
+			continue;
+		}
+
+		printf("%s -> %s (%dx%d%s)\n",source.c_str(),output.c_str(),image.Width(),image.Height(),image.IsOpaque() ? ", opaque" : "");
+		converted++;
+	}
+
+	printf("%d converted, %d failed\n",converted,failed);
+	return failed ? 1 : 0;
+}
+
+static int CompressDDS(int argc, char** argv)
+{
+	int forced=-1; //DDS_BC1, DDS_BC3 or pick per image
+	bool bMips=true;
+	int converted=0, failed=0;
+
+	for(int i=0; i < argc; i++)
+	{
+		if(!strcmp(argv[i],"-bc1")) { forced=DDS_BC1; continue; }
+		if(!strcmp(argv[i],"-bc3")) { forced=DDS_BC3; continue; }
+		if(!strcmp(argv[i],"-nomips")) { bMips=false; continue; }
+
+		std::string source=argv[i];
+		Image image;
+		if(!image.LoadPNG(source.c_str()))
+		{
+			fprintf(stderr,"%s: not a readable PNG\n",source.c_str());
+			failed++;
+			continue;
+		}
+
+		DDSFormat format=forced >= 0 ? (DDSFormat)forced : (DDSTexture::FitsBC1(image,bMips) ? DDS_BC1 : DDS_BC3);
+		DDSTexture texture;
+		texture.Create(image,format,bMips);
+
+		std::string output=EndsWith(source,".pma.png") ? source.substr(0,source.size() - 8) + ".dds" : ReplaceExtension(source,".dds");
+		if(!texture.Save(output.c_str()))
+		{
+			fprintf(stderr,"%s: could not write\n",output.c_str());
+			failed++;
+			continue;
+		}
+
+		//how far the top level moved from the source, worst channel and RMS
+		Image decoded;
+		texture.Decompress(0,decoded);
+		double sum=0.0;
+		int worst=0;
+		for(int y=0; y < image.Height(); y++)
+		{
+			for(int x=0; x < image.Width(); x++)
+			{
+				for(int shift=0; shift < 32; shift+=8)
+				{
+					int difference=(int)((image.Row(y)[x] >> shift) & 0xFF) - (int)((decoded.Row(y)[x] >> shift) & 0xFF);
+					sum+=difference * difference;
+					if(abs(difference) > worst)
+						worst=abs(difference);
+				}
+			}
+		}
+		double rms=sqrt(sum / ((double)image.Width() * image.Height() * 4));
+
+		size_t bytes=0;
+		for(int level=0; level < texture.LevelCount(); level++)
+			bytes+=texture.LevelSize(level);
+		printf("%s -> %s (%s, %d levels, %u bytes vs %u uncompressed, rms %.2f, worst %d)\n",source.c_str(),output.c_str(),
+			format == DDS_BC1 ? "BC1" : "BC3",texture.LevelCount(),(unsigned int)bytes,(unsigned int)(image.Width() * image.Height() * 4),rms,worst);
+		converted++;
+	}
+
+	printf("%d converted, %d failed\n",converted,failed);
+	return failed ? 1 : 0;
+}
+
+//what the game loads, anything else in the directory is left out
+static bool PackFormat(const std::string& name, AssetFormat& format)
+{
+	std::string lower=name;
+	for(size_t i=0; i < lower.size(); i++)
+		lower[i]=(char)tolower((unsigned char)lower[i]);
+
+	if(EndsWith(lower,".dds"))		{ format=ASSET_DDS; return true; }
+	if(EndsWith(lower,".pma.png"))	{ format=ASSET_PNG; return true; }
+	if(EndsWith(lower,".wav"))		{ format=ASSET_WAV; return true; }
+	if(EndsWith(lower,".mp3"))		{ format=ASSET_MP3; return true; }
+	if(EndsWith(lower,".otf"))		{ format=ASSET_FONT; return true; }
+	return false;
+}
+
+static bool ReadFile(const std::string& filename, std::vector<unsigned char>& data)
+{
+	FILE* file=fopen(filename.c_str(),"rb");
+	if(!file)
+		return false;
+
+	fseek(file,0,SEEK_END);
+	long size=ftell(file);
+	fseek(file,0,SEEK_SET);
+	data.resize(size > 0 ? (size_t)size : 0);
+	bool bRead=size >= 0 && (data.empty() || fread(&data[0],1,data.size(),file) == data.size());
+	fclose(file);
+	return bRead;
+}
+
+static int ConvertWave(int argc, char** argv)
+{
+	Mp3Decoder decoder;
+	int converted=0, failed=0;
+
+	for(int i=0; i < argc; i++)
+	{
+		std::string source=argv[i];
+		std::vector<unsigned char> data;
+		std::vector<float> samples;
+		int rate=0;
+		if(!ReadFile(source,data) || data.empty() || !decoder.Decode(&data[0],data.size(),samples,rate))
+		{
+			fprintf(stderr,"%s: not a readable MP3\n",source.c_str());
+			failed++;
+			continue;
+		}
+
+		std::string output=ReplaceExtension(source,".wav");
+		int frames=(int)(samples.size() / 2);
+		WaveFileSink sink(output.c_str());
+		bool bWritten=sink.Open(rate) && sink.Write(&samples[0],frames);
+		sink.Close();
+		if(!bWritten)
+		{
+			fprintf(stderr,"%s: could not write\n",output.c_str());
+			failed++;
+			continue;
+		}
+
+		printf("%s -> %s (%d frames at %dHz, %.2fs)\n",source.c_str(),output.c_str(),frames,rate,(double)frames / rate);
+		converted++;
+	}
+
+	printf("%d converted, %d failed\n",converted,failed);
+	return failed ? 1 : 0;
+}
+
+struct PackFile
+{
+	std::string					name;
+	unsigned int				hash;
+	AssetFormat					format;
+	std::vector<unsigned char>	data;
+};
+
+static bool PackOrder(const PackFile* a, const PackFile* b)
+{
+	//the order AssetArchive::Find searches in
+	if(a->hash != b->hash)
+		return a->hash < b->hash;
+	return a->name < b->name;
+}
+
+static int Pack(int argc, char** argv)
+{
+	std::string directory, output;
+	for(int i=0; i < argc; i++)
+	{
+		if(!strcmp(argv[i],"-o") && i + 1 < argc)
+			output=argv[++i];
+		else
+			directory=argv[i];
+	}
+	if(directory.empty())
+	{
+		fprintf(stderr,"pack: no directory given\n");
+		return 2;
+	}
+	if(output.empty())
+		output=directory + "/assets.pak";
+
+	DIR* dir=opendir(directory.c_str());
+	if(!dir)
+	{
+		fprintf(stderr,"%s: can't open the directory\n",directory.c_str());
+		return 1;
+	}
+
+	std::vector<PackFile> files;
+	struct dirent* item;
+	while((item=readdir(dir)) != 0)
+	{
+		PackFile file;
+		file.name=item->d_name;
+		if(!PackFormat(file.name,file.format))
+			continue;
+		if(!ReadFile(directory + "/" + file.name,file.data))
+		{
+			fprintf(stderr,"%s: could not read\n",file.name.c_str());
+			closedir(dir);
+			return 1;
+		}
+		file.hash=AssetArchive::HashName(file.name.c_str());
+		files.push_back(file);
+	}
+	closedir(dir);
+
+	std::vector<const PackFile*> order;
+	for(size_t i=0; i < files.size(); i++)
+		order.push_back(&files[i]);
+	std::sort(order.begin(),order.end(),PackOrder);
+
+	//two names that only differ in case would be the same asset to the game
+	for(size_t i=1; i < order.size(); i++)
+	{
+		if(order[i]->hash == order[i - 1]->hash && AssetArchive::SameName(order[i]->name.c_str(),order[i - 1]->name.c_str()))
+		{
+			fprintf(stderr,"%s and %s: same name to the game\n",order[i - 1]->name.c_str(),order[i]->name.c_str());
+			return 1;
+		}
+	}
+
+	//header, index, names, then the data each on an aligned offset
+	std::vector<unsigned char> names;
+	std::vector<ArchiveEntry> entries(order.size());
+	for(size_t i=0; i < order.size(); i++)
+	{
+		entries[i].hash=order[i]->hash;
+		entries[i].nameOffset=(unsigned int)names.size();
+		entries[i].format=order[i]->format;
+		entries[i].reserved=0;
+		names.insert(names.end(),order[i]->name.begin(),order[i]->name.end());
+		names.push_back(0);
+	}
+
+	ArchiveHeader header;
+	memset(&header,0,sizeof(header));
+	header.magic=ARCHIVE_MAGIC;
+	header.version=ARCHIVE_VERSION;
+	header.entryCount=(unsigned int)entries.size();
+	header.namesOffset=(unsigned int)(sizeof(ArchiveHeader) + entries.size() * sizeof(ArchiveEntry));
+	header.namesSize=(unsigned int)names.size();
+
+	size_t offset=header.namesOffset + names.size();
+	for(size_t i=0; i < order.size(); i++)
+	{
+		offset=(offset + ARCHIVE_ALIGNMENT - 1) & ~(size_t)(ARCHIVE_ALIGNMENT - 1);
+		entries[i].offset=(unsigned int)offset;
+		entries[i].size=(unsigned int)order[i]->data.size();
+		offset+=order[i]->data.size();
+	}
+	if(offset > 0xFFFFFFFF)
+	{
+		fprintf(stderr,"pack: over 4GB, the offsets are 32 bit\n");
+		return 1;
+	}
+
+	FILE* file=fopen(output.c_str(),"wb");
+	if(!file)
+	{
+		fprintf(stderr,"%s: could not write\n",output.c_str());
+		return 1;
+	}
+	bool bWritten=fwrite(&header,sizeof(header),1,file) == 1 &&
+				  (entries.empty() || fwrite(&entries[0],sizeof(ArchiveEntry),entries.size(),file) == entries.size()) &&
+				  (names.empty() || fwrite(&names[0],1,names.size(),file) == names.size());
+	size_t written=header.namesOffset + names.size();
+	static const unsigned char Padding[ARCHIVE_ALIGNMENT]={0};
+	for(size_t i=0; bWritten && i < order.size(); i++)
+	{
+		bWritten=fwrite(Padding,1,entries[i].offset - written,file) == entries[i].offset - written &&
+				 (order[i]->data.empty() || fwrite(&order[i]->data[0],1,order[i]->data.size(),file) == order[i]->data.size());
+		written=entries[i].offset + order[i]->data.size();
+	}
+	bWritten=fclose(file) == 0 && bWritten;
+	if(!bWritten)
+	{
+		fprintf(stderr,"%s: could not write\n",output.c_str());
+		return 1;
+	}
+
+	printf("%d files, %u bytes -> %s\n",(int)order.size(),(unsigned int)written,output.c_str());
+	return 0;
+}
+
+static double Seconds()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void EmptyDirectory(const std::string& directory)
+{
+	DIR* dir=opendir(directory.c_str());
+	if(!dir)
+		return;
+	struct dirent* item;
+	while((item=readdir(dir)) != 0)
+	{
+		if(EndsWith(item->d_name,".img"))
+			remove((directory + "/" + item->d_name).c_str());
+	}
+	closedir(dir);
+}
+
+//one conversion of one source, the same steps AssetLoader takes with and without the cache
+static bool BenchConvert(ImageCache* pCache, ImageConversion conversion, const std::vector<unsigned char>& source)
+{
+	unsigned long long key=0;
+	Image image;
+	if(pCache)
+	{
+		key=ImageCache::Key(&source[0],source.size(),conversion);
+		if(pCache->Load(key,image))
+			return true;
+	}
+
+	bool bConverted;
+	if(conversion == CONVERT_BC)
+	{
+		DDSTexture texture;
+		bConverted=texture.LoadFromMemory(&source[0],source.size()) && texture.Decompress(0,image);
+	}
+	else
+	{
+		bConverted=image.LoadPNGFromMemory(&source[0],source.size());
+	}
+
+	if(bConverted && pCache)
+		pCache->Store(key,image);
+	return bConverted;
+}
+
+static int LoadBench(int argc, char** argv)
+{
+	std::string directory;
+	int runs=5;
+	for(int i=0; i < argc; i++)
+	{
+		if(!strcmp(argv[i],"-runs") && i + 1 < argc)
+			runs=atoi(argv[++i]);
+		else
+			directory=argv[i];
+	}
+	if(directory.empty() || runs < 1)
+	{
+		fprintf(stderr,"loadbench: no directory given\n");
+		return 2;
+	}
+
+	//every source the game converts at startup, read up front so only the conversion is timed
+	struct Source
+	{
+		std::string					name;
+		ImageConversion				conversion;
+		std::vector<unsigned char>	data;
+		double						best[3];
+	};
+	std::vector<Source> sources;
+	DIR* dir=opendir(directory.c_str());
+	if(!dir)
+	{
+		fprintf(stderr,"%s: can't open the directory\n",directory.c_str());
+		return 1;
+	}
+	struct dirent* item;
+	while((item=readdir(dir)) != 0)
+	{
+		Source source;
+		source.name=item->d_name;
+		if(EndsWith(source.name,".pma.png"))
+			source.conversion=CONVERT_PNG;
+		else if(EndsWith(source.name,".dds"))
+			source.conversion=CONVERT_BC;
+		else
+			continue;
+		if(!ReadFile(directory + "/" + source.name,source.data) || source.data.empty())
+			continue;
+		source.best[0]=source.best[1]=source.best[2]=1e30;
+		sources.push_back(source);
+	}
+	closedir(dir);
+
+	ImageCache cache;
+	std::string cacheDirectory=directory + "/benchcache";
+	cache.SetDirectory(cacheDirectory.c_str());
+
+	//uncached, into an empty cache (cold start), out of the filled one (warm start)
+	for(int run=0; run < runs; run++)
+	{
+		EmptyDirectory(cacheDirectory);
+		for(int mode=0; mode < 3; mode++)
+		{
+			for(size_t i=0; i < sources.size(); i++)
+			{
+				double start=Seconds();
+				if(!BenchConvert(mode ? &cache : 0,sources[i].conversion,sources[i].data))
+				{
+					fprintf(stderr,"%s: could not convert\n",sources[i].name.c_str());
+					return 1;
+				}
+				double seconds=Seconds() - start;
+				if(seconds < sources[i].best[mode])
+					sources[i].best[mode]=seconds;
+			}
+		}
+	}
+
+	//PNG and DDS separately, the Direct3D build only converts PNGs
+	printf("%-40s %10s %10s %10s\n","best of runs","uncached","cold","warm");
+	for(int conversion=CONVERT_PNG; conversion <= CONVERT_BC; conversion++)
+	{
+		double totals[3]={0.0,0.0,0.0};
+		for(size_t i=0; i < sources.size(); i++)
+		{
+			if(sources[i].conversion != conversion)
+				continue;
+			printf("%-40s %8.2fms %8.2fms %8.2fms\n",sources[i].name.c_str(),sources[i].best[0] * 1000.0,sources[i].best[1] * 1000.0,sources[i].best[2] * 1000.0);
+			for(int mode=0; mode < 3; mode++)
+				totals[mode]+=sources[i].best[mode];
+		}
+		printf("%-40s %8.2fms %8.2fms %8.2fms\n\n",conversion == CONVERT_PNG ? "total PNG decode" : "total DDS decompress",
+			totals[0] * 1000.0,totals[1] * 1000.0,totals[2] * 1000.0);
+	}
+	return 0;
+}
+
+static int MixBench(int argc, char** argv)
+{
+	std::string directory;
+	int voices=64;
+	double seconds=10.0;
+	for(int i=0; i < argc; i++)
+	{
+		if(!strcmp(argv[i],"-voices") && i + 1 < argc)
+			voices=atoi(argv[++i]);
+		else if(!strcmp(argv[i],"-seconds") && i + 1 < argc)
+			seconds=atof(argv[++i]);
+		else
+			directory=argv[i];
+	}
+	if(directory.empty() || voices < 1 || seconds <= 0.0)
+	{
+		fprintf(stderr,"mixbench: no directory given\n");
+		return 2;
+	}
+
+	const int rate=44100;
+	std::vector<AudioClip> clips;
+	DIR* dir=opendir(directory.c_str());
+	if(!dir)
+	{
+		fprintf(stderr,"%s: can't open the directory\n",directory.c_str());
+		return 1;
+	}
+	struct dirent* item;
+	while((item=readdir(dir)) != 0)
+	{
+		std::vector<unsigned char> data;
+		AudioClip clip;
+		if(EndsWith(item->d_name,".wav") && ReadFile(directory + "/" + item->d_name,data) && !data.empty() &&
+		   clip.LoadWave(&data[0],data.size(),rate))
+			clips.push_back(clip);
+	}
+	closedir(dir);
+	if(clips.empty())
+	{
+		fprintf(stderr,"%s: no .wav files it can read\n",directory.c_str());
+		return 1;
+	}
+
+	static const char* PathNames[]={"scalar","SSE","AVX"};
+	int blocks=(int)(seconds * rate / AudioMixer::BlockFrames);
+	printf("%d voices, %d clips, %.1fs at %dHz\n",voices,(int)clips.size(),seconds,rate);
+	for(int path=AUDIO_MIX_SCALAR; path <= AudioMixer::BestMixPath(); path++)
+	{
+		AudioMixer mixer;
+		mixer.Init(rate,voices);
+		mixer.SetMixPath((AudioMixPath)path);
+		std::vector<AudioVoice> playing(voices);
+		for(int i=0; i < voices; i++)
+			playing[i]=mixer.Play(&clips[i % clips.size()],0.5f,AUDIO_LOOP_NORMAL,false);
+
+		//one voice starts a new pan and volume ramp every block
+		NullAudioSink sink;
+		sink.Open(rate);
+		double start=Seconds();
+		for(int block=0; block < blocks; block++)
+		{
+			int voice=block % voices;
+			mixer.SetPan(playing[voice],(block & 1) ? -0.5f : 0.5f);
+			mixer.SetVolume(playing[voice],(block & 2) ? 0.25f : 0.75f);
+			mixer.Render(sink,AudioMixer::BlockFrames);
+		}
+		double cpu=Seconds() - start;
+		double audio=(double)sink.Frames() / rate;
+		printf("%-8s %8.2fms per second of sound, %8.0f voices in real time\n",PathNames[path],
+			cpu * 1000.0 / audio,voices * audio / cpu);
+	}
+	return 0;
+}
+
+//time stamp counter, 0 where there isn't one
+static unsigned long long Cycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+//a half scale sine on the left and cosine on the right
+static void Tone(std::vector<float>& out, int frames, int rate, double hz)
+{
+	out.resize((size_t)frames * 2);
+	for(int i=0; i < frames; i++)
+	{
+		double angle=2.0 * 3.14159265358979323846 * hz * i / rate;
+		out[i * 2]=(float)(0.5 * sin(angle));
+		out[i * 2 + 1]=(float)(0.5 * cos(angle));
+	}
+}
+
+//what AudioClip used to do, for comparison
+static void LinearResample(const std::vector<float>& in, double step, std::vector<float>& out, int frames)
+{
+	int inFrames=(int)(in.size() / 2);
+	out.resize((size_t)frames * 2);
+	for(int i=0; i < frames; i++)
+	{
+		double position=i * step;
+		int frame=(int)position;
+		float t=(float)(position - frame);
+		int next=frame + 1 < inFrames ? frame + 1 : frame;
+		out[i * 2]=in[frame * 2] + (in[next * 2] - in[frame * 2]) * t;
+		out[i * 2 + 1]=in[frame * 2 + 1] + (in[next * 2 + 1] - in[frame * 2 + 1]) * t;
+	}
+}
+
+//signal to noise against the exact tone in dB, or with hz 0 the level
+//relative to a half scale tone.  The filter's length at each end is left out
+static double CompareTone(const std::vector<float>& out, int rate, double hz)
+{
+	std::vector<float> exact;
+	int frames=(int)(out.size() / 2);
+	Tone(exact,frames,rate,hz);
+	double signal=0.0, noise=0.0;
+	for(int i=AudioResampler::Taps * 2; i < (frames - AudioResampler::Taps) * 2; i++)
+	{
+		double error=out[i] - (hz ? exact[i] : 0.0f);
+		signal+=hz ? (double)exact[i] * exact[i] : 0.125;
+		noise+=error * error;
+	}
+	if(noise <= 0.0)
+		return 200.0;
+	return 10.0 * log10(hz ? signal / noise : noise / signal);
+}
+
+static int ResampleBench(int argc, char** argv)
+{
+	double seconds=2.0;
+	for(int i=0; i < argc; i++)
+	{
+		if(!strcmp(argv[i],"-seconds") && i + 1 < argc)
+			seconds=atof(argv[++i]);
+	}
+	if(seconds <= 0.0)
+	{
+		fprintf(stderr,"resamplebench: -seconds must be more than 0\n");
+		return 2;
+	}
+
+	//the effects' rates up to the mixer's, a 48kHz file, and steps of 2 like
+	//an octave up of pitch
+	static const struct
+	{
+		int		from;
+		int		to;
+	}
+	conversions[]=
+	{
+		{8000,44100},
+		{22050,44100},
+		{48000,44100},
+		{44100,22050},
+		{88200,44100}
+	};
+	static const double ToneFractions[]={0.01,0.05,0.1,0.2,0.3};
+	static const char* PathNames[]={"scalar","SSE","AVX"};
+
+	printf("%d taps, %d phases, %.1fs of output each\n",AudioResampler::Taps,AudioResampler::Phases,seconds);
+	for(int c=0; c < (int)(sizeof(conversions) / sizeof(conversions[0])); c++)
+	{
+		int from=conversions[c].from, to=conversions[c].to;
+		double step=(double)from / to;
+		int outFrames=(int)(seconds * to);
+		int inFrames=(int)(outFrames * step) + 1;
+		AudioResampler resampler;
+		resampler.Init(step);
+		std::vector<float> in, out((size_t)outFrames * 2), linear;
+		printf("%dHz -> %dHz\n",from,to);
+
+		Tone(in,inFrames,from,from * 0.1);
+		for(int path=AUDIO_MIX_SCALAR; path <= AudioResampler::BestMixPath(); path++)
+		{
+			resampler.SetMixPath((AudioMixPath)path);
+			double position=0.0;
+			double start=Seconds();
+			unsigned long long cycles=Cycles();
+			resampler.Process(&in[0],inFrames,false,position,step,&out[0],outFrames);
+			cycles=Cycles() - cycles;
+			double cpu=Seconds() - start;
+			printf("  %-8s %7.1f cycles %7.1fns per output frame\n",PathNames[path],(double)cycles / outFrames,cpu * 1e9 / outFrames);
+		}
+
+		//the same tones through both, the worst is what is heard
+		double worst=200.0, worstLinear=200.0;
+		int lower=from < to ? from : to;
+		for(int t=0; t < (int)(sizeof(ToneFractions) / sizeof(ToneFractions[0])); t++)
+		{
+			double hz=lower * ToneFractions[t];
+			Tone(in,inFrames,from,hz);
+			double position=0.0;
+			resampler.Process(&in[0],inFrames,false,position,step,&out[0],outFrames);
+			LinearResample(in,step,linear,outFrames);
+			worst=std::min(worst,CompareTone(out,to,hz));
+			worstLinear=std::min(worstLinear,CompareTone(linear,to,hz));
+		}
+		printf("  SNR      %7.1fdB polyphase %7.1fdB linear, tones to %.0fHz\n",worst,worstLinear,lower * 0.3);
+
+		if(from >= to * 2)
+		{
+			double hz=to * 0.7;
+			Tone(in,inFrames,from,hz);
+			double position=0.0;
+			resampler.Process(&in[0],inFrames,false,position,step,&out[0],outFrames);
+			LinearResample(in,step,linear,outFrames);
+			printf("  alias    %7.1fdB polyphase %7.1fdB linear, a %.0fHz tone\n",CompareTone(out,to,0.0),CompareTone(linear,to,0.0),hz);
+		}
+	}
+	return 0;
+}
+
+static void Usage()
+{
+	fprintf(stderr,
+		"usage: assettool <command> [options] files...\n"
+		"  premultiply [-key AARRGGBB] file.png ...   colour key to premultiplied alpha, writes file.pma.png\n"
+		"  dds [-bc1|-bc3] [-nomips] file.pma.png ...  BC1/BC3 with mips, writes file.dds\n"
+		"  wav file.mp3 ...                            MP3 to 16 bit PCM for the SDL build's music, writes file.wav\n"
+		"  pack [-o assets.pak] directory              every file the game loads into one archive\n"
+		"  loadbench [-runs N] directory               texture conversion times with and without the image cache\n"
+		"  mixbench [-voices N] [-seconds S] directory software mixer CPU time, every loop built in\n"
+		"  resamplebench [-seconds S]                  resampler cycles per frame and quality against exact tones\n");
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		Usage();
+		return 2;
+	}
+
+	if(!strcmp(argv[1],"premultiply"))
+		return Premultiply(argc - 2,argv + 2);
+	if(!strcmp(argv[1],"dds"))
+		return CompressDDS(argc - 2,argv + 2);
+	if(!strcmp(argv[1],"wav"))
+		return ConvertWave(argc - 2,argv + 2);
+	if(!strcmp(argv[1],"pack"))
+		return Pack(argc - 2,argv + 2);
+	if(!strcmp(argv[1],"loadbench"))
+		return LoadBench(argc - 2,argv + 2);
+	if(!strcmp(argv[1],"mixbench"))
+		return MixBench(argc - 2,argv + 2);
+	if(!strcmp(argv[1],"resamplebench"))
+		return ResampleBench(argc - 2,argv + 2);
+
+	Usage();
+	return 2;
+}